@@ -0,0 +1,32 @@
+// SHARED BY cube.vert, cube_strip.vert AND splat.vert (EXPANDED BY CreateShaderProgramFromFiles, NO #version)
+
+// ATTRIBUTE MASKS (CLASS 0 - 255 AND RETURN 0 - 15 BITS, INCLUSIVE WINDOWS), SET BY AttributeMask
+uniform uint uClassMask[8];
+uniform uint uReturnMask;
+uniform bool uLastReturnOnly;
+uniform uvec2 uSourceRange;
+uniform uvec2 uIntensityRange;
+uniform vec2 uElevationRange;
+
+// BITS 0-7 CLASSIFICATION, 8-11 RETURN NUMBER, 12-15 NUMBER OF RETURNS, 16-31 POINT SOURCE ID (CubeInstance::PackAttributes)
+bool IsVisible(uint attributes, uint intensity, float elevation) {
+    uint classification = attributes & 0xFFu;
+    uint returnNumber = (attributes >> 8u) & 0xFu;
+    uint returnCount = (attributes >> 12u) & 0xFu;
+    uint sourceId = attributes >> 16u;
+    return ((uClassMask[classification >> 5u] >> (classification & 31u)) & 1u) != 0u
+        && ((uReturnMask >> returnNumber) & 1u) != 0u
+        && (!uLastReturnOnly || returnNumber >= returnCount)
+        && sourceId >= uSourceRange.x && sourceId <= uSourceRange.y
+        && intensity >= uIntensityRange.x && intensity <= uIntensityRange.y
+        && elevation >= uElevationRange.x && elevation <= uElevationRange.y;
+}
+
+// OCTAHEDRAL DECODE (MATCHES NormalEstimator::DecodeNormal)
+vec3 DecodeNormal(uint encoded) {
+    vec2 folded = vec2(float(encoded & 0xFFu), float(encoded >> 8u)) / 255.0 * 2.0 - 1.0;
+    vec3 normal = vec3(folded, 1.0 - abs(folded.x) - abs(folded.y));
+    float t = max(-normal.z, 0.0);
+    normal.xy += vec2(normal.x >= 0.0 ? -t : t, normal.y >= 0.0 ? -t : t);
+    return normalize(normal);
+}
@@ -0,0 +1,17 @@
+#version 430 core
+
+out vec4 FragColor;
+
+uniform sampler2D uColor;       // ACCUMULATED CUBE COLORS
+uniform sampler2D uDepth;       // ACCUMULATED CUBE DEPTHS (1.0 WHERE NOTHING WAS DRAWN YET)
+uniform ivec2 uViewportOrigin;  // THE TARGET STARTS AT THE VIEWPORT'S LOWER-LEFT CORNER
+
+void main() {
+    // THE TARGET MATCHES THE VIEWPORT, SO EVERY FRAGMENT READS ITS OWN TEXEL
+    ivec2 texel = ivec2(gl_FragCoord.xy) - uViewportOrigin;
+    float depth = texelFetch(uDepth, texel, 0).r;
+    if (depth >= 1.0) discard;
+
+    FragColor = vec4(texelFetch(uColor, texel, 0).rgb, 1.0);
+    gl_FragDepth = depth;
+}
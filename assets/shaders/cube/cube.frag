@@ -1,12 +1,22 @@
 #version 430 core
 
 in float vIntensity;
+flat in vec3 vNormal;
 
 out vec4 FragColor;
 
 uniform sampler1D uColorLUT;
+uniform bool uUseNormals;
+
+// LAMBERT SHADING FROM A FIXED SUN (THE WHOLE CUBE TAKES THE POINT'S SURFACE NORMAL)
+const vec3 LightDirection = normalize(vec3(0.4, 0.3, 1.0));
+const float Ambient = 0.35;
 
 void main() {
     vec3 color = texture(uColorLUT, clamp(vIntensity, 0.0, 1.0)).rgb;
+    if (uUseNormals) {
+        float diffuse = max(dot(normalize(vNormal), LightDirection), 0.0);
+        color *= Ambient + (1.0 - Ambient) * diffuse;
+    }
     FragColor = vec4(color, 1.0);
 }
\ No newline at end of file
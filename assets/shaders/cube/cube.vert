@@ -5,22 +5,74 @@ layout(location = 1) in vec4 aModelRow0;        // Instance model matrix row 0
 layout(location = 2) in vec4 aModelRow1;        // Instance model matrix row 1
 layout(location = 3) in vec4 aModelRow2;        // Instance model matrix row 2
 layout(location = 4) in vec4 aModelRow3;        // Instance model matrix row 3
-layout(location = 5) in float aIntensity;       // PER-INSTANCE COLOR
+layout(location = 5) in uint aIntensity;        // PER-INSTANCE RAW INTENSITY (UINT16)
+layout(location = 6) in uvec2 aAttributes;      // PER-INSTANCE OCTAHEDRAL NORMAL (2 x 8 BITS), PACKED LAS ATTRIBUTES
 
 out float vIntensity;
+flat out vec3 vNormal;
 
 uniform mat4 uViewProjection;
 uniform float uGlobalScale;
+uniform vec3 uCameraPosition;
+uniform float uFarDistance;              // INSTANCES BEYOND IT ARE DRAWN BY THE HEIGHTMAP (ZERO KEEPS EVERY INSTANCE)
+uniform samplerBuffer uIntensityMap;     // RAW INTENSITY -> [0, 1] (65536 ENTRIES)
+uniform bool uUseNormals;
+uniform bool uPullInstances;             // GPU-CULLED OR PROGRESSIVE DRAW: gl_InstanceID INDEXES THE VISIBLE LIST, INSTANCE DATA COMES FROM THE BUFFERS BELOW
+uniform uint uFirstInstance;             // FIRST ENTRY OF THE VISIBLE LIST (PROGRESSIVE BATCHES, gl_InstanceID STARTS AT ZERO)
+
+// SURVIVORS OF instance_cull.comp (OR THE PROGRESSIVE DRAW ORDER) AND THE INSTANCE BUFFERS THEY INDEX (THE SAME STORAGE AS THE ATTRIBUTES ABOVE)
+layout(std430, binding = 0) readonly buffer VisibleIndexBuffer {
+    uint visibleIndices[];
+};
+layout(std430, binding = 1) readonly buffer InstanceModelBuffer {
+    mat4 instanceModels[];
+};
+layout(std430, binding = 2) readonly buffer InstanceIntensityBuffer {
+    uint packedIntensities[];
+};
+layout(std430, binding = 3) readonly buffer InstanceAttributeBuffer {
+    uvec2 instanceAttributes[];
+};
+
+// ATTRIBUTE MASKS, IsVisible AND DecodeNormal, FAILING INSTANCES ARE COLLAPSED
+#include "../common/point_attributes.glsl"
 
 void main() {
+    vec4 modelRow0 = aModelRow0;
+    vec4 modelRow1 = aModelRow1;
+    vec4 modelRow2 = aModelRow2;
+    vec4 modelRow3 = aModelRow3;
+    uint intensity = aIntensity;
+    uvec2 attributes = aAttributes;
+    if (uPullInstances) {
+        uint instance = visibleIndices[uFirstInstance + uint(gl_InstanceID)];
+        mat4 instanceModel = instanceModels[instance];
+        modelRow0 = instanceModel[0];
+        modelRow1 = instanceModel[1];
+        modelRow2 = instanceModel[2];
+        modelRow3 = instanceModel[3];
+        intensity = (packedIntensities[instance >> 1u] >> ((instance & 1u) * 16u)) & 0xFFFFu;
+        attributes = instanceAttributes[instance];
+    }
+
+    // FAR-FIELD OR MASKED INSTANCE: EVERY VERTEX OUTSIDE THE CLIP VOLUME, SO ITS TRIANGLES ARE CLIPPED BEFORE RASTERIZATION
+    bool farField = uFarDistance > 0.0 && distance(modelRow3.xyz, uCameraPosition) > uFarDistance;
+    if (farField || !IsVisible(attributes.y, intensity, modelRow3.z)) {
+        gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+        vIntensity = 0.0;
+        vNormal = vec3(0.0, 0.0, 1.0);
+        return;
+    }
+
     // APPLY GLOBAL SCALE (INLINE FOR PERFORMANCE)
     mat4 model = mat4(
-        aModelRow0 * vec4(uGlobalScale, uGlobalScale, uGlobalScale, 1.0),
-        aModelRow1 * vec4(uGlobalScale, uGlobalScale, uGlobalScale, 1.0),
-        aModelRow2 * vec4(uGlobalScale, uGlobalScale, uGlobalScale, 1.0),
-        aModelRow3
+        modelRow0 * vec4(uGlobalScale, uGlobalScale, uGlobalScale, 1.0),
+        modelRow1 * vec4(uGlobalScale, uGlobalScale, uGlobalScale, 1.0),
+        modelRow2 * vec4(uGlobalScale, uGlobalScale, uGlobalScale, 1.0),
+        modelRow3
     );
 
     gl_Position = uViewProjection * model * vec4(aPos, 1.0);
-    vIntensity = aIntensity;
+    vIntensity = texelFetch(uIntensityMap, int(intensity)).r;
+    vNormal = uUseNormals ? DecodeNormal(attributes.x) : vec3(0.0, 0.0, 1.0);
 }
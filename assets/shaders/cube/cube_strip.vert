@@ -0,0 +1,73 @@
+#version 430 core
+#extension GL_ARB_shader_draw_parameters : enable
+
+// NO VERTEX ATTRIBUTES: THE INSTANCE COMES FROM THE STORAGE BUFFERS, THE CORNER FROM gl_VertexID (0 - 8)
+
+out float vIntensity;
+flat out vec3 vNormal;
+
+uniform mat4 uViewProjection;
+uniform float uGlobalScale;
+uniform vec3 uCameraPosition;
+uniform float uFarDistance;              // INSTANCES BEYOND IT ARE DRAWN BY THE HEIGHTMAP (ZERO KEEPS EVERY INSTANCE)
+uniform samplerBuffer uIntensityMap;     // RAW INTENSITY -> [0, 1] (65536 ENTRIES)
+uniform bool uUseNormals;
+uniform bool uPullInstances;             // GPU-CULLED OR PROGRESSIVE DRAW: gl_InstanceID INDEXES THE VISIBLE LIST
+uniform uint uFirstInstance;             // FIRST ENTRY OF THE VISIBLE LIST (PROGRESSIVE BATCHES, gl_InstanceID STARTS AT ZERO)
+
+// SURVIVORS OF instance_cull.comp (OR THE PROGRESSIVE DRAW ORDER) AND THE INSTANCE BUFFERS (SAME BINDINGS AS cube.vert)
+layout(std430, binding = 0) readonly buffer VisibleIndexBuffer {
+    uint visibleIndices[];
+};
+layout(std430, binding = 1) readonly buffer InstanceModelBuffer {
+    mat4 instanceModels[];
+};
+layout(std430, binding = 2) readonly buffer InstanceIntensityBuffer {
+    uint packedIntensities[];
+};
+layout(std430, binding = 3) readonly buffer InstanceAttributeBuffer {
+    uvec2 instanceAttributes[];
+};
+
+// ATTRIBUTE MASKS, IsVisible AND DecodeNormal, FAILING INSTANCES ARE COLLAPSED
+#include "../common/point_attributes.glsl"
+
+// MULTI-DRAW RECORDS START AT THEIR baseInstance, WHICH gl_InstanceID DOES NOT INCLUDE
+// (WITHOUT THE EXTENSION THE RENDERER ONLY USES THIS SHADER FOR DRAWS STARTING AT INSTANCE ZERO)
+#ifdef GL_ARB_shader_draw_parameters
+#define BASE_INSTANCE uint(gl_BaseInstanceARB)
+#else
+#define BASE_INSTANCE 0u
+#endif
+
+// THREE FACES TOWARD THE CAMERA AS ONE STRIP, EACH ENTRY FLIPS THE CAMERA-FACING CORNER ALONG X (1), Y (2) AND Z (4).
+// TRIANGLES 0-1 ARE THE Y FACE, 2-3 THE X FACE, 4 REPEATS 3 TO TURN AROUND THE SHARED CORNER, 5-6 THE Z FACE
+const uint StripCorners[9] = uint[9](5u, 1u, 4u, 0u, 6u, 2u, 0u, 3u, 1u);
+
+void main() {
+    uint instance = uPullInstances ? visibleIndices[uFirstInstance + uint(gl_InstanceID)] : BASE_INSTANCE + uint(gl_InstanceID);
+
+    // INSTANCE MODELS ARE PURE TRANSLATIONS (CubeRenderer::UpdateInstancePosition AND THE GPU FILTER), ONLY THE LAST COLUMN IS READ
+    vec3 center = instanceModels[instance][3].xyz;
+    uint intensity = (packedIntensities[instance >> 1u] >> ((instance & 1u) * 16u)) & 0xFFFFu;
+    uvec2 attributes = instanceAttributes[instance];
+
+    // FAR-FIELD OR MASKED INSTANCE: EVERY VERTEX OUTSIDE THE CLIP VOLUME, SO ITS TRIANGLES ARE CLIPPED BEFORE RASTERIZATION
+    bool farField = uFarDistance > 0.0 && distance(center, uCameraPosition) > uFarDistance;
+    if (farField || !IsVisible(attributes.y, intensity, center.z)) {
+        gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+        vIntensity = 0.0;
+        vNormal = vec3(0.0, 0.0, 1.0);
+        return;
+    }
+
+    // SAME CORNERS AS THE INDEXED CUBE (EDGE uGlobalScale). FACES AWAY FROM THE CAMERA ARE NEVER VISIBLE THROUGH A CONVEX
+    // CUBE, AND A FACE SEEN EDGE-ON (CAMERA INSIDE ITS SLAB) LIES BEHIND THE OTHER TWO, SO THE DEPTH TEST GIVES THE SAME IMAGE
+    vec3 facing = mix(vec3(-1.0), vec3(1.0), greaterThanEqual(uCameraPosition, center));
+    uint flips = StripCorners[gl_VertexID];
+    vec3 corner = facing * vec3((flips & 1u) != 0u ? -0.5 : 0.5, (flips & 2u) != 0u ? -0.5 : 0.5, (flips & 4u) != 0u ? -0.5 : 0.5);
+
+    gl_Position = uViewProjection * vec4(center + corner * uGlobalScale, 1.0);
+    vIntensity = texelFetch(uIntensityMap, int(intensity)).r;
+    vNormal = uUseNormals ? DecodeNormal(attributes.x) : vec3(0.0, 0.0, 1.0);
+}
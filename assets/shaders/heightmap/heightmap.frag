@@ -0,0 +1,21 @@
+#version 430 core
+
+in vec3 vWorldPosition;
+in float vIntensity;
+
+out vec4 FragColor;
+
+uniform sampler1D uColorLUT;
+uniform vec3 uCameraPosition;
+uniform float uNearDistance;     // CUBES ARE DRAWN INSIDE THIS DISTANCE
+
+void main() {
+    if (distance(vWorldPosition, uCameraPosition) < uNearDistance) discard;
+
+    // SLOPE SHADING FROM THE SCREEN-SPACE NORMAL (THE RAMP ALONE FLATTENS THE TERRAIN)
+    vec3 normal = normalize(cross(dFdx(vWorldPosition), dFdy(vWorldPosition)));
+    float shade = 0.6 + 0.4 * abs(normal.z);
+
+    vec3 color = texture(uColorLUT, clamp(vIntensity, 0.0, 1.0)).rgb;
+    FragColor = vec4(color * shade, 1.0);
+}
@@ -0,0 +1,16 @@
+#version 430 core
+
+layout(location = 0) in vec3 aPos;              // GRID VERTEX (STORE COORDINATES)
+layout(location = 1) in float aIntensity;       // MEAN RAW INTENSITY OF THE CELL BLOCK
+
+out vec3 vWorldPosition;
+out float vIntensity;
+
+uniform mat4 uViewProjection;
+uniform samplerBuffer uIntensityMap;     // RAW INTENSITY -> [0, 1] (65536 ENTRIES, SHARED WITH THE CUBES)
+
+void main() {
+    gl_Position = uViewProjection * vec4(aPos, 1.0);
+    vWorldPosition = aPos;
+    vIntensity = texelFetch(uIntensityMap, int(clamp(aIntensity + 0.5, 0.0, 65535.0))).r;
+}
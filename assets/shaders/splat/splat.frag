@@ -0,0 +1,41 @@
+#version 430 core
+
+in float vIntensity;
+flat in vec3 vNormal;
+flat in float vDepthOffset;
+
+out vec4 FragColor;
+
+// SPLATS ONLY EVER MOVE TOWARD THE CAMERA, SO THE DRIVER KEEPS ITS CONSERVATIVE EARLY DEPTH TEST
+layout(depth_less) out float gl_FragDepth;
+
+uniform sampler1D uColorLUT;
+uniform bool uUseNormals;
+uniform int uShape;                     // 0 ROUND, 1 PARABOLOID (SplatShape)
+
+// SAME SUN AS cube.frag
+const vec3 LightDirection = normalize(vec3(0.4, 0.3, 1.0));
+const float Ambient = 0.35;
+
+void main() {
+    // DISC INSIDE THE POINT SQUARE
+    vec2 offset = gl_PointCoord * 2.0 - 1.0;
+    float radiusSquared = dot(offset, offset);
+    if (radiusSquared > 1.0) discard;
+
+    vec3 color = texture(uColorLUT, clamp(vIntensity, 0.0, 1.0)).rgb;
+    if (uUseNormals) {
+        float diffuse = max(dot(normalize(vNormal), LightDirection), 0.0);
+        color *= Ambient + (1.0 - Ambient) * diffuse;
+    }
+
+    // PARABOLOID: HEIGHT OF THE BULGE DARKENS THE RIM AND PULLS THE CENTER FORWARD (NEIGHBORING SPLATS INTERSECT SMOOTHLY)
+    if (uShape == 1) {
+        float height = 1.0 - radiusSquared;
+        color *= 0.6 + 0.4 * height;
+        gl_FragDepth = gl_FragCoord.z + vDepthOffset * height;
+    } else {
+        gl_FragDepth = gl_FragCoord.z;
+    }
+    FragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,51 @@
+#version 430 core
+
+layout(location = 0) in vec3 aPosition;         // INSTANCE TRANSLATION (LAST COLUMN OF THE INSTANCE MODEL MATRIX)
+layout(location = 1) in uint aIntensity;        // RAW INTENSITY (UINT16)
+layout(location = 2) in uvec2 aAttributes;      // OCTAHEDRAL NORMAL (2 x 8 BITS), PACKED LAS ATTRIBUTES
+
+out float vIntensity;
+flat out vec3 vNormal;
+flat out float vDepthOffset;
+
+uniform mat4 uViewProjection;
+uniform float uGlobalScale;              // SPLAT DIAMETER IN WORLD UNITS (THE CUBE EDGE)
+uniform vec3 uCameraPosition;
+uniform float uFarDistance;              // POINTS BEYOND IT ARE DRAWN BY THE HEIGHTMAP (ZERO KEEPS EVERY POINT)
+uniform float uPixelsPerUnit;            // PIXELS SPANNED BY ONE WORLD UNIT AT CLIP W = 1
+uniform float uMaxPointSize;             // PIXELS (AT MOST THE DRIVER'S POINT SIZE RANGE)
+uniform samplerBuffer uIntensityMap;     // RAW INTENSITY -> [0, 1] (65536 ENTRIES)
+uniform bool uUseNormals;
+
+// ATTRIBUTE MASKS, IsVisible AND DecodeNormal, FAILING POINTS ARE MOVED OUTSIDE THE CLIP VOLUME
+#include "../common/point_attributes.glsl"
+
+void main() {
+    bool farField = uFarDistance > 0.0 && distance(aPosition, uCameraPosition) > uFarDistance;
+    if (farField || !IsVisible(aAttributes.y, aIntensity, aPosition.z)) {
+        gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+        gl_PointSize = 1.0;
+        vIntensity = 0.0;
+        vNormal = vec3(0.0, 0.0, 1.0);
+        vDepthOffset = 0.0;
+        return;
+    }
+
+    // SAME SCREEN FOOTPRINT AS A CUBE OF EDGE (uGlobalScale), SHRINKING WITH CLIP W
+    vec4 center = uViewProjection * vec4(aPosition, 1.0);
+    float w = max(center.w, 1e-4);
+    gl_Position = center;
+    gl_PointSize = clamp(uGlobalScale * uPixelsPerUnit / w, 1.0, uMaxPointSize);
+
+    // WINDOW-DEPTH CHANGE OF HALF A SPLAT TOWARD THE CAMERA (PARABOLOID SPLATS BULGE BY IT, NEVER AWAY FROM THE CAMERA)
+    vec3 toCamera = uCameraPosition - aPosition;
+    float cameraDistance = length(toCamera);
+    vDepthOffset = 0.0;
+    if (cameraDistance > uGlobalScale) {
+        vec4 front = uViewProjection * vec4(aPosition + toCamera * (0.5 * uGlobalScale / cameraDistance), 1.0);
+        vDepthOffset = min(0.5 * (front.z / max(front.w, 1e-4) - center.z / w), 0.0);
+    }
+
+    vIntensity = texelFetch(uIntensityMap, int(aIntensity)).r;
+    vNormal = uUseNormals ? DecodeNormal(aAttributes.x) : vec3(0.0, 0.0, 1.0);
+}
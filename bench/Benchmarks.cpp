@@ -0,0 +1,35 @@
+#include <cstdint>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+#include <Benchmarks.hpp>
+#include <Parallel.hpp>
+
+namespace Benchmarks {
+
+    std::vector<unsigned> ThreadCounts(unsigned maxThreads) {
+        if (maxThreads == 0) maxThreads = Parallel::ThreadCount();
+
+        std::vector<unsigned> counts;
+        for (unsigned threads = 1; threads < maxThreads; threads *= 2) counts.push_back(threads);
+        counts.push_back(maxThreads);
+        return counts;
+    }
+
+    uint64_t SystemMemoryBytes() {
+        return uint64_t(SDL_GetSystemRAM()) * 1024 * 1024;
+    }
+
+    double SecondsSince(uint64_t startTicks) {
+        return double(SDL_GetTicksNS() - startTicks) / 1.0e9;
+    }
+
+    uint64_t MixBits(uint64_t index) {
+        uint64_t z = index * 0x9E3779B97F4A7C15ull + 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Benchmarks {
+
+    // THREAD COUNTS TO MEASURE: 1, 2, 4, ... AND THE HARDWARE THREAD COUNT (OR (maxThreads) WHEN NON-ZERO)
+    std::vector<unsigned> ThreadCounts(unsigned maxThreads = 0);
+
+    // PHYSICAL MEMORY IN BYTES, SIZES THAT DO NOT FIT ARE SKIPPED INSTEAD OF SWAPPING
+    uint64_t SystemMemoryBytes();
+
+    // SECONDS SINCE (startTicks) (SDL_GetTicksNS)
+    double SecondsSince(uint64_t startTicks);
+
+    // SPLITMIX64 OF AN INDEX, THE SAME SYNTHETIC INPUT FOR EVERY RUN AND THREAD COUNT
+    uint64_t MixBits(uint64_t index);
+
+    // RADIX SORT OF SYNTHETIC MORTON-WIDTH KEYS, (sizes) IN KEYS, EVERY THREAD COUNT MUST GIVE THE SAME ORDER
+    // RETURNS FALSE ON A MISMATCH
+    bool RunSortBenchmark(const std::vector<uint64_t>& sizes, unsigned maxThreads);
+
+    struct VoxelOptions {
+        std::vector<std::string> files;     // LAS/LAZ INPUTS, EMPTY = EVERY .laz IN (dataDirectory)
+        std::string dataDirectory = "../data";
+        uint64_t syntheticPoints = 100000000ull;
+        uint64_t renderBudget = 10000000ull;
+        bool compress = false;
+        unsigned maxThreads = 0;
+    };
+
+    // BOTH VOXEL BACKENDS ON THE SAME STORES (FILES AND A SYNTHETIC CLOUD), THE CPU BACKEND WITH EVERY THREAD COUNT
+    // RETURNS FALSE WHEN THE CPU OUTPUT DEPENDS ON THE THREAD COUNT (THE GPU IS COMPARED AGAINST IT AND REPORTED)
+    bool RunVoxelBenchmark(const VoxelOptions& options);
+
+}
@@ -0,0 +1,104 @@
+#include <cstdint>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+#include <Benchmarks.hpp>
+#include <Morton.hpp>
+#include <Parallel.hpp>
+#include <RadixSort.hpp>
+
+namespace Benchmarks {
+
+    namespace {
+
+        // KEYS, VALUES AND THE SORT SCRATCH (PING-PONG COPIES OF BOTH)
+        constexpr uint64_t SortBytesPerKey = 2 * (sizeof(uint64_t) + sizeof(uint32_t));
+
+        void FillKeys(std::vector<uint64_t>& keys, std::vector<uint32_t>& values, uint64_t count) {
+            const uint64_t keyMask = (uint64_t(1) << Spatial::MortonKeyBits) - 1;
+            keys.resize(count);
+            values.resize(count);
+            Parallel::For(count, [&](size_t begin, size_t end, unsigned) {
+                for (size_t i = begin; i < end; ++i) {
+                    keys[i] = MixBits(i) & keyMask;
+                    values[i] = static_cast<uint32_t>(i);
+                }
+            });
+        }
+
+        // ORDER-SENSITIVE HASH OF THE SORTED VALUES (STABLE SORT, SO EQUAL KEYS MUST KEEP THEIR INPUT ORDER TOO)
+        uint64_t OrderHash(const std::vector<uint64_t>& keys, const std::vector<uint32_t>& values, bool& sorted) {
+            uint64_t hash = 0xCBF29CE484222325ull;
+            sorted = true;
+            for (size_t i = 0; i < values.size(); ++i) {
+                if (i > 0 && keys[i - 1] > keys[i]) sorted = false;
+                hash = (hash ^ values[i]) * 0x100000001B3ull;
+            }
+            return hash;
+        }
+
+    }
+
+    bool RunSortBenchmark(const std::vector<uint64_t>& sizes, unsigned maxThreads) {
+        const std::vector<unsigned> threadCounts = ThreadCounts(maxThreads);
+        const uint64_t memoryBytes = SystemMemoryBytes();
+        bool identical = true;
+
+        std::vector<uint64_t> keys;
+        std::vector<uint32_t> values;
+        Spatial::SortScratch scratch;
+
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "RADIX SORT: %u-BIT KEYS, %s MORTON KEYS ON THIS CPU", Spatial::MortonKeyBits, Spatial::HasBmi2() ? "BMI2" : "SCALAR");
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "%12s %8s %12s %12s %8s", "KEYS", "THREADS", "SECONDS", "MKEYS/S", "SPEEDUP");
+
+        for (uint64_t count : sizes) {
+            // VALUES ARE 32-BIT INDICES, LARGER SETS ARE NOT SORTED BY THE STORE EITHER
+            if (count == 0 || count > UINT32_MAX) {
+                SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "%12llu SKIPPED (OUTSIDE 1 - %u KEYS)", static_cast<unsigned long long>(count), UINT32_MAX);
+                continue;
+            }
+            if (memoryBytes > 0 && count * SortBytesPerKey > memoryBytes * 3 / 4) {
+                SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "%12llu SKIPPED (NEEDS %.1f GB OF %.1f GB)", static_cast<unsigned long long>(count),
+                    double(count * SortBytesPerKey) / 1.0e9, double(memoryBytes) / 1.0e9);
+                continue;
+            }
+
+            double singleThreadSeconds = 0.0;
+            uint64_t referenceHash = 0;
+
+            for (unsigned threads : threadCounts) {
+                FillKeys(keys, values, count);
+
+                uint64_t start = SDL_GetTicksNS();
+                Spatial::RadixSort(keys, values, scratch, Spatial::MortonKeyBits, threads);
+                double seconds = SecondsSince(start);
+
+                bool sorted = false;
+                uint64_t hash = OrderHash(keys, values, sorted);
+                if (threads == threadCounts.front()) {
+                    referenceHash = hash;
+                    singleThreadSeconds = seconds;
+                }
+
+                if (!sorted || hash != referenceHash) {
+                    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%12llu %8u MISMATCH (%s)", static_cast<unsigned long long>(count), threads,
+                        sorted ? "ORDER DIFFERS FROM ONE THREAD" : "KEYS NOT SORTED");
+                    identical = false;
+                    continue;
+                }
+
+                SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "%12llu %8u %12.3f %12.1f %7.2fx", static_cast<unsigned long long>(count), threads, seconds,
+                    seconds > 0.0 ? double(count) / seconds / 1.0e6 : 0.0,
+                    seconds > 0.0 ? singleThreadSeconds / seconds : 0.0);
+            }
+        }
+
+        // RELEASE BEFORE THE NEXT BENCHMARK
+        std::vector<uint64_t>().swap(keys);
+        std::vector<uint32_t>().swap(values);
+        scratch = Spatial::SortScratch();
+        return identical;
+    }
+
+}
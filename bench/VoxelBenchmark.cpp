@@ -0,0 +1,206 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <Benchmarks.hpp>
+#include <CpuVoxelDownsampleFilter.hpp>
+#include <CubeInstance.hpp>
+#include <LazReader.hpp>
+#include <MemoryPool.hpp>
+#include <PointStore.hpp>
+#include <VoxelDownsampleFilter.hpp>
+
+namespace Benchmarks {
+
+    namespace {
+
+        // SYNTHETIC CLOUD: ROLLING TERRAIN OVER A SQUARE OF THIS EDGE (METERS) WITH SOME VERTICAL SCATTER
+        constexpr float SyntheticExtent = 2000.0f;
+
+        // HIDDEN WINDOW WITH A GL 4.3 CORE CONTEXT FOR THE COMPUTE BACKEND (SAME ATTRIBUTES AS THE VIEWER)
+        struct GLContext {
+            SDL_Window* window = nullptr;
+            SDL_GLContext context = nullptr;
+
+            bool Create() {
+                if (!SDL_Init(SDL_INIT_VIDEO)) return false;
+
+                SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+                SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+                SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+
+                window = SDL_CreateWindow("Voxel Benchmark", 64, 64, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+                if (!window) return false;
+                context = SDL_GL_CreateContext(window);
+                return context && gladLoadGLLoader((GLADloadproc) SDL_GL_GetProcAddress);
+            }
+
+            void Destroy() {
+                if (context) SDL_GL_DestroyContext(context);
+                if (window) SDL_DestroyWindow(window);
+                context = nullptr;
+                window = nullptr;
+                SDL_Quit();
+            }
+        };
+
+        bool LoadFile(const std::string& path, Data::PointStore& store, const VoxelOptions& options) {
+            // STORED POSITIONS ARE CENTERED ON THE HEADER BOUNDS (AS IN THE VIEWER), THE FIRST READER ONLY PARSES THE HEADER
+            CustomReader::LazReader headerReader(path, &store, glm::dvec3(0.0));
+            std::shared_ptr<LazHeader> header = headerReader.GetHeader();
+            if (!header) return false;
+
+            glm::dvec3 origin(
+                (header->minX + header->maxX) / 2.0,
+                (header->minY + header->maxY) / 2.0,
+                (header->minZ + header->maxZ) / 2.0
+            );
+
+            store.Reset(header->pointCount(), options.compress, 0.001f);
+            CustomReader::LazReader reader(path, &store, origin);
+            reader.ReadPointData();
+            return !store.Empty();
+        }
+
+        void BuildSyntheticStore(uint64_t count, Data::PointStore& store, const VoxelOptions& options) {
+            store.Reset(count, options.compress, 0.001f);
+            for (uint64_t i = 0; i < count; ++i) {
+                uint64_t bits = MixBits(i);
+                float x = (float(bits & 0xFFFFFu) / float(0xFFFFFu) - 0.5f) * SyntheticExtent;
+                float y = (float((bits >> 20) & 0xFFFFFu) / float(0xFFFFFu) - 0.5f) * SyntheticExtent;
+                float scatter = float((bits >> 40) & 0xFFu) / 255.0f;
+                float z = 20.0f * std::sin(x * 0.01f) * std::cos(y * 0.013f) + 2.0f * scatter;
+
+                uint16_t intensity = static_cast<uint16_t>(bits >> 48);
+                uint32_t attributes = CubeInstance::PackAttributes(scatter > 0.5f ? 5 : 2, 1, 1, 1);
+                store.Add(glm::vec3(x, y, z), intensity, attributes);
+            }
+            store.Finalize();
+        }
+
+        bool SameOutput(const std::vector<CubeInstance>& a, const std::vector<CubeInstance>& b) {
+            return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(CubeInstance)) == 0);
+        }
+
+        // RETURNS FALSE WHEN THE CPU OUTPUT CHANGES WITH THE THREAD COUNT
+        bool MeasureStore(const std::string& name, const Data::PointStore& store, const VoxelOptions& options,
+            Filters::VoxelDownsampleFilter* gpuFilter) {
+            const std::vector<unsigned> threadCounts = ThreadCounts(options.maxThreads);
+            bool identical = true;
+
+            SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "%s: %llu POINTS (%s), RENDER BUDGET %llu", name.c_str(),
+                static_cast<unsigned long long>(store.Size()), store.IsCompressed() ? "COMPRESSED" : "UNCOMPRESSED",
+                static_cast<unsigned long long>(options.renderBudget));
+            SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "%8s %8s %12s %12s %12s %8s", "BACKEND", "THREADS", "SECONDS", "MPOINTS/S", "OUTPUT", "SAME");
+
+            Data::AllocationStats loadStats;
+            Filters::CpuVoxelDownsampleFilter cpuFilter;
+            cpuFilter.SetRenderBudget(options.renderBudget);
+
+            // WARM-UP RUN, THE TIMED RUNS REUSE THE POOLED WORK BUFFERS (AS REPEATED LOADS IN THE VIEWER DO)
+            std::vector<CubeInstance> reference;
+            std::vector<CubeInstance> output;
+            cpuFilter.SetThreadCount(threadCounts.front());
+            cpuFilter.ProcessPoints(store, reference, loadStats);
+
+            for (unsigned threads : threadCounts) {
+                cpuFilter.SetThreadCount(threads);
+
+                uint64_t start = SDL_GetTicksNS();
+                cpuFilter.ProcessPoints(store, output, loadStats);
+                double seconds = SecondsSince(start);
+
+                bool same = SameOutput(output, reference);
+                identical = identical && same;
+                SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "%8s %8u %12.3f %12.1f %12llu %8s", cpuFilter.GetName(), threads, seconds,
+                    seconds > 0.0 ? double(store.Size()) / seconds / 1.0e6 : 0.0,
+                    static_cast<unsigned long long>(output.size()), same ? "YES" : "NO");
+            }
+
+            if (!identical) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s: CPU OUTPUT DEPENDS ON THE THREAD COUNT", name.c_str());
+            }
+
+            // GPU AGAINST THE CPU REFERENCE (SAME LOWEST-INDEX RULE, SO ONLY BOUNDS ROUNDING CAN SEPARATE THEM)
+            if (gpuFilter) {
+                gpuFilter->SetRenderBudget(options.renderBudget);
+                gpuFilter->ProcessPoints(store, output, loadStats);
+
+                uint64_t start = SDL_GetTicksNS();
+                bool filtered = gpuFilter->ProcessPoints(store, output, loadStats);
+                glFinish();
+                double seconds = SecondsSince(start);
+
+                if (!filtered) {
+                    SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "%8s FAILED (STORE TOO LARGE FOR THE DEVICE?)", gpuFilter->GetName());
+                }
+                else {
+                    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "%8s %8s %12.3f %12.1f %12llu %8s", gpuFilter->GetName(), "-", seconds,
+                        seconds > 0.0 ? double(store.Size()) / seconds / 1.0e6 : 0.0,
+                        static_cast<unsigned long long>(output.size()), SameOutput(output, reference) ? "YES" : "NO");
+                }
+            }
+
+            return identical;
+        }
+
+    }
+
+    bool RunVoxelBenchmark(const VoxelOptions& options) {
+        std::vector<std::string> files = options.files;
+        if (files.empty()) {
+            std::error_code error;
+            for (const auto& entry : std::filesystem::directory_iterator(options.dataDirectory, error)) {
+                if (entry.path().extension() == ".laz") files.push_back(entry.path().string());
+            }
+        }
+
+        // THE GPU BACKEND IS OPTIONAL (NO DISPLAY OR NO GL 4.3), THE CPU RESULTS STILL COUNT
+        GLContext glContext;
+        std::unique_ptr<Filters::VoxelDownsampleFilter> gpuFilter;
+        if (glContext.Create()) {
+            gpuFilter = std::make_unique<Filters::VoxelDownsampleFilter>();
+            if (!gpuFilter->IsAvailable()) gpuFilter.reset();
+        }
+        if (!gpuFilter) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "GPU BACKEND UNAVAILABLE, ONLY THE CPU BACKEND IS MEASURED");
+        }
+
+        bool identical = true;
+        Data::PointStore store;
+
+        for (const std::string& file : files) {
+            if (!LoadFile(file, store, options)) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "FAILED TO LOAD %s", file.c_str());
+                continue;
+            }
+            identical = MeasureStore(file, store, options, gpuFilter.get()) && identical;
+        }
+
+        // STORE AND ONE FULL-SIZE OUTPUT (THE FILTER'S WORK BUFFERS ARE A FEW MORE BYTES PER POINT)
+        const uint64_t syntheticBytes = options.syntheticPoints * 2 * sizeof(CubeInstance);
+        const uint64_t memoryBytes = SystemMemoryBytes();
+        if (options.syntheticPoints > 0 && memoryBytes > 0 && syntheticBytes > memoryBytes / 2) {
+            SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "SYNTHETIC %llu POINTS SKIPPED (NEEDS %.1f GB OF %.1f GB)",
+                static_cast<unsigned long long>(options.syntheticPoints), double(syntheticBytes) / 1.0e9, double(memoryBytes) / 1.0e9);
+        }
+        else if (options.syntheticPoints > 0) {
+            BuildSyntheticStore(options.syntheticPoints, store, options);
+            identical = MeasureStore("SYNTHETIC", store, options, gpuFilter.get()) && identical;
+        }
+
+        // FILTER BUFFERS BEFORE THEIR CONTEXT
+        gpuFilter.reset();
+        glContext.Destroy();
+        return identical;
+    }
+
+}
@@ -0,0 +1,49 @@
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+#include <Benchmarks.hpp>
+
+// USAGE:
+//   benchmarks sort [MILLIONS OF KEYS ...] [--threads N]
+//   benchmarks voxel [FILES ...] [--data DIR] [--synthetic MILLIONS] [--budget MILLIONS] [--compress] [--threads N]
+// SORT DEFAULTS TO 10M, 100M AND 500M KEYS, VOXEL TO EVERY .laz IN ../data AND 100M SYNTHETIC POINTS,
+// BOTH WITH 1, 2, 4, ... THREADS. RUN FROM THE VIEWER'S WORKING DIRECTORY (SHADERS ARE LOADED FROM ../assets)
+int main(int argc, char** argv) {
+    std::string mode = argc > 1 ? argv[1] : "sort";
+    unsigned maxThreads = 0;
+    std::vector<std::string> arguments;
+    Benchmarks::VoxelOptions voxelOptions;
+
+    auto millions = [](const char* text) { return std::strtoull(text, nullptr, 10) * 1000000ull; };
+
+    for (int i = 2; i < argc; ++i) {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (argument == "--threads" && hasValue) maxThreads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        else if (argument == "--data" && hasValue) voxelOptions.dataDirectory = argv[++i];
+        else if (argument == "--synthetic" && hasValue) voxelOptions.syntheticPoints = millions(argv[++i]);
+        else if (argument == "--budget" && hasValue) voxelOptions.renderBudget = millions(argv[++i]);
+        else if (argument == "--compress") voxelOptions.compress = true;
+        else arguments.push_back(argument);
+    }
+
+    if (mode == "sort") {
+        std::vector<uint64_t> sizes;
+        for (const std::string& argument : arguments) sizes.push_back(millions(argument.c_str()));
+        if (sizes.empty()) sizes = { 10000000ull, 100000000ull, 500000000ull };
+        return Benchmarks::RunSortBenchmark(sizes, maxThreads) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (mode == "voxel") {
+        voxelOptions.files = arguments;
+        voxelOptions.maxThreads = maxThreads;
+        return Benchmarks::RunVoxelBenchmark(voxelOptions) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "UNKNOWN BENCHMARK '%s' (EXPECTED: sort OR voxel)", mode.c_str());
+    return EXIT_FAILURE;
+}
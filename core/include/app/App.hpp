@@ -50,6 +50,15 @@ namespace Application {
             bool CreateSDLWindow(const char* title);
             bool CreateGLContext(bool enableVsync);
             void RenderScene(float deltaTime);
+            void PickPoint(float x, float y);
+
+            // WORLD-SPACE RAY UNDER THE MOUSE (SCREEN CENTER IN FREE CAMERA MODE), FALSE WHILE LOADING OR OVER THE GUI
+            bool MouseRay(float x, float y, glm::vec3& origin, glm::vec3& direction);
+
+            // PROFILE TOOL: PRESS ANCHORS THE SEGMENT, DRAGGING MOVES ITS END OVER THE ANCHOR'S HEIGHT
+            void BeginProfile(float x, float y);
+            void DragProfile(float x, float y);
+            void CutProfile();
 
             SDL_Window* window = nullptr;
             SDL_GLContext glContext = nullptr;
@@ -8,9 +8,13 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <BudgetGovernor.hpp>
+#include <ChangeDetector.hpp>
 #include <CubeRenderer.hpp>
+#include <DatasetStats.hpp>
 #include <FreeCamera.hpp>
 #include <OrbitalCamera.hpp>
+#include <ProfileExtractor.hpp>
 #include <TextRenderer.hpp>
 
 #define WINDOW_WIDTH 1280
@@ -22,6 +26,9 @@
 
 #define GLSL_VERSION "#version 330"
 
+#define MAIN_DATASET "Main"
+#define REFERENCE_DATASET "Reference"
+
 namespace Application {
 
     struct AppContext {
@@ -39,9 +46,39 @@ namespace Application {
         std::unique_ptr<CubeRenderer> cubeRenderer;
         std::unique_ptr<TextRenderer> textRenderer;
 
+        // RAM/VRAM BUDGET (DECIMATION, VOXEL SIZE, RENDER BUDGET)
+        std::unique_ptr<Data::BudgetGovernor> budgetGovernor;
+
+        // STATISTICS OF THE LOADED FILE (WRITTEN BY THE READER THREAD BEFORE IT RAISES doneReadingFlag)
+        Data::DatasetStats datasetStats;
+
+        // LAST POINT PICKED WITH THE MOUSE (CLEARED WITH EVERY LOAD)
+        bool hasPickedPoint = false;
+        PickedPoint pickedPoint;
+
+        // CROSS-SECTION TOOL (SEGMENT IN STORE COORDINATES, DRAWN BY DRAGGING WITH THE LEFT MOUSE BUTTON)
+        // MOUSE MOTION ONLY MARKS THE CUT DIRTY, IT IS RE-CUT AT MOST ONCE PER FRAME
+        bool profileMode = false;
+        bool profileDragging = false;
+        bool profileDirty = false;
+        glm::vec3 profileStart = glm::vec3(0.0f);
+        glm::vec3 profileEnd = glm::vec3(0.0f);
+        float profileWidth = 1.0f;
+        Spatial::ProfileExtractor profile;
+
+        // CHANGE DETECTION AGAINST A REFERENCE SCAN (LOADED INTO THE SAME ORIGIN AS THE MAIN FILE)
+        // WHILE SHOWN, THE QUANTIZED DISTANCES SIT IN THE STORE'S INTENSITY CHANNEL AND THE RAW INTENSITIES IN (swappedIntensities)
+        Filters::ChangeDetector changeDetector;
+        std::string referencePath;
+        bool showChanges = false;
+        bool changesApplied = false;
+        float changeRange = 1.0f;
+        std::vector<uint16_t> swappedIntensities;
+
         // MULTI-THREAD FLAGS FOR READING POINT DATA
         std::atomic<bool> isReadingFlag { false };
         std::atomic<bool> doneReadingFlag { false };
+        std::atomic<bool> doneComparingFlag { false };
 
         AppContext() {
             filepath = "";
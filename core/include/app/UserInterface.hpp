@@ -97,8 +97,28 @@ namespace UserInterface {
 
     void DrawCubeSettings(Application::AppContext* appContext);
 
+    void DrawDatasetStatistics(Application::AppContext* appContext);
+
+    // CLASS / RETURN / SOURCE ID MASKS AND INTENSITY / ELEVATION WINDOWS (UNIFORM UPDATES ONLY)
+    void DrawAttributeFilters(Application::AppContext* appContext);
+
+    void DrawPickedPoint(Application::AppContext* appContext);
+
+    void DrawProfileSettings(Application::AppContext* appContext);
+
+    void DrawProfileWindow(Application::AppContext* appContext);
+
+    void DrawChangeDetection(Application::AppContext* appContext);
+
+    void DrawTerrainSettings(Application::AppContext* appContext);
+
+    // SWAPS THE CHANGE DISTANCES INTO (OR OUT OF) THE INTENSITY CHANNEL AND RE-UPLOADS THE POINTS (MAIN THREAD)
+    void UpdateChangeView(Application::AppContext* appContext);
+
     void DrawOrbitalCameraSettings(Application::AppContext* appContext);
 
+    void DrawMemoryBudget(Application::AppContext* appContext);
+
     void RenderMainPanel(Application::AppContext* appContext);
 
 }
\ No newline at end of file
@@ -28,6 +28,19 @@ class Camera {
         }
 
         glm::mat4 GetViewProjection() const { return projection * view; }
+        glm::vec3 GetPosition() const { return glm::vec3(glm::inverse(view)[3]); }
+
+        // WORLD-SPACE RAY THROUGH A WINDOW POSITION (TOP-LEFT ORIGIN, WINDOW COORDINATES)
+        void ScreenRay(float x, float y, int windowWidth, int windowHeight, glm::vec3& origin, glm::vec3& direction) const {
+            const glm::mat4 inverseViewProjection = glm::inverse(projection * view);
+            const float ndcX = 2.0f * x / float(windowWidth) - 1.0f;
+            const float ndcY = 1.0f - 2.0f * y / float(windowHeight);
+
+            glm::vec4 nearPoint = inverseViewProjection * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+            glm::vec4 farPoint = inverseViewProjection * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+            origin = glm::vec3(nearPoint) / nearPoint.w;
+            direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - origin);
+        }
 
     protected:
         glm::mat4 view;
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace Data {
+
+    struct MemoryInfo {
+        uint64_t totalSystemBytes = 0;
+        uint64_t availableSystemBytes = 0;
+
+        // ZERO WHEN THE DRIVER DOES NOT EXPOSE MEMORY INFO (NVX/ATI EXTENSIONS)
+        uint64_t totalDeviceBytes = 0;
+        uint64_t availableDeviceBytes = 0;
+        bool deviceMemoryKnown = false;
+    };
+
+    // BUDGET DECISIONS FOR ONE LOADED DATASET
+    struct DatasetBudget {
+        std::string name;
+
+        uint64_t filePointCount = 0;
+        uint64_t loadedPointCount = 0;
+        uint64_t renderBudget = 0;
+        uint64_t decimationStep = 1;
+        float voxelSize = 0.0f;
+
+        // ESTIMATED RESIDENT MEMORY
+        uint64_t hostBytes = 0;
+        uint64_t deviceBytes = 0;
+
+        // PART OF (hostBytes) HELD BY BUFFERS DERIVED AFTER THE LOAD (E.G. CHANGE DISTANCES), NOT PART OF THE PLAN
+        uint64_t auxiliaryHostBytes = 0;
+    };
+
+    class BudgetGovernor {
+        public:
+            // PER-POINT COSTS OF THE CURRENT PIPELINE (BYTES)
+            static constexpr uint64_t HostBytesPerRenderedPoint = 20;     // CubeInstance (MAPPED INSTANCE BUFFERS ARE FILLED FROM IT)
+            static constexpr uint64_t DeviceBytesPerRenderedPoint = 84;   // mat4 + uint16 + uvec2 INSTANCE ATTRIBUTES + uint VISIBLE INDEX + uint DRAW ORDER
+            static constexpr uint64_t DeviceBytesPerFilteredPoint = 40;   // vec4 + uvec2 INPUT + uint FLAG + uint OFFSET + 2 HASH SLOTS (VOXEL FILTER)
+
+            // VOXEL SIZE LIMITS (METERS)
+            static constexpr float MinVoxelSize = 0.05f;
+            static constexpr float MaxVoxelSize = 10.0f;
+
+            // ASSUMED WHEN THE DRIVER DOES NOT REPORT VIDEO MEMORY
+            static constexpr uint64_t FallbackDeviceBytes = 2ull * 1024 * 1024 * 1024;
+
+            BudgetGovernor() = default;
+
+            // MUST BE CALLED ON THE THREAD THAT OWNS THE GL CONTEXT
+            void UpdateMemoryInfo();
+
+            // (RE-)PLAN A DATASET, MEMORY HELD BY THE OTHER DATASETS IS SUBTRACTED FROM THE BUDGET
+            const DatasetBudget& PlanDataset(const std::string& name, uint64_t filePointCount, double storeBytesPerPoint);
+            void UpdateVoxelSize(const std::string& name, float voxelSize);
+
+            // CHARGES (bytes) OF DERIVED HOST BUFFERS TO A PLANNED DATASET (REPLACES THE PREVIOUS CHARGE, ZERO RELEASES IT)
+            // DATASETS PLANNED AFTERWARDS SEE LESS OF THE HOST BUDGET, RE-PLANNING THE DATASET DROPS THE CHARGE
+            void SetAuxiliaryHostBytes(const std::string& name, uint64_t bytes);
+            void RemoveDataset(const std::string& name);
+
+            // VOXEL SIZE WHOSE OCCUPIED CELL COUNT ROUGHLY MATCHES THE RENDER BUDGET
+            // WHEN THE BUDGET COVERS EVERY POINT THE DEFAULT POWER LAW OF THE POINT COUNT IS KEPT (0.25 - 6)
+            static float VoxelSizeForBudget(uint64_t pointCount, glm::vec3 extent, uint64_t renderBudget);
+
+            // ACCESSORS
+            const MemoryInfo& GetMemoryInfo() const { return memoryInfo; }
+            const std::vector<DatasetBudget>& GetDatasets() const { return datasets; }
+            uint64_t GetHostBudget() const;
+            uint64_t GetDeviceBudget() const;
+            uint64_t GetHostUsage() const;
+            uint64_t GetDeviceUsage() const;
+            float& GetHostFraction() { return hostFraction; }
+            float& GetDeviceFraction() { return deviceFraction; }
+
+        private:
+            DatasetBudget* FindDataset(const std::string& name);
+
+        private:
+            MemoryInfo memoryInfo;
+            std::vector<DatasetBudget> datasets;
+
+            // SHARE OF THE AVAILABLE MEMORY THE VIEWER MAY USE
+            float hostFraction = 0.6f;
+            float deviceFraction = 0.7f;
+    };
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace Data {
+
+    // WHOLE-DATASET STATISTICS GATHERED WHILE DECODING (TRUE FILE COORDINATES, NOT THE HEADER BOUNDS)
+    struct DatasetStats {
+        static constexpr size_t IntensityBins = 65536;
+        static constexpr size_t ClassCount = 256;
+        static constexpr size_t ReturnCount = 16;
+
+        uint64_t pointCount = 0;
+        glm::dvec3 minimum = glm::dvec3(DBL_MAX);
+        glm::dvec3 maximum = glm::dvec3(-DBL_MAX);
+        uint16_t minIntensity = UINT16_MAX;
+        uint16_t maxIntensity = 0;
+
+        // AVERAGE DISTANCE BETWEEN NEIGHBORING POINTS IN PLAN VIEW (SQRT OF OCCUPIED AREA PER POINT)
+        double meanSpacing = 0.0;
+
+        // ONE BIN PER RAW INTENSITY, POINTS PER CLASSIFICATION CODE AND PER RETURN NUMBER
+        std::vector<uint64_t> intensityHistogram;
+        std::array<uint64_t, ClassCount> classCounts {};
+        std::array<uint64_t, ReturnCount> returnCounts {};
+
+        inline bool Empty() const { return pointCount == 0; }
+        inline glm::dvec3 Center() const { return 0.5 * (minimum + maximum); }
+    };
+
+    // ACCUMULATES STATISTICS INLINE WITH THE DECODE CALLBACK (NO LOCKS, NO SECOND PASS OVER THE POINTS)
+    class StatsAccumulator {
+        public:
+            // PLAN-VIEW OCCUPANCY GRID USED FOR THE SPACING ESTIMATE (ONE BIT PER CELL)
+            static constexpr uint32_t SpacingGridSize = 1024;
+            static constexpr double MinPointsPerCell = 4.0;
+
+            StatsAccumulator() = default;
+
+            // (minimum, maximum) ONLY PLACE THE SPACING GRID (HEADER BOUNDS), POINTS OUTSIDE LAND ON ITS EDGE
+            void Reset(const glm::dvec3& minimum, const glm::dvec3& maximum);
+
+            inline void Add(const glm::dvec3& position, uint16_t intensity, uint8_t classification, uint8_t returnNumber) {
+                stats.pointCount++;
+                stats.minimum = glm::min(stats.minimum, position);
+                stats.maximum = glm::max(stats.maximum, position);
+                stats.minIntensity = std::min(stats.minIntensity, intensity);
+                stats.maxIntensity = std::max(stats.maxIntensity, intensity);
+                stats.intensityHistogram[intensity]++;
+                stats.classCounts[classification]++;
+                stats.returnCounts[std::min<size_t>(returnNumber, DatasetStats::ReturnCount - 1)]++;
+
+                const double cellX = std::clamp((position.x - gridOrigin.x) * gridScale.x, 0.0, double(SpacingGridSize - 1));
+                const double cellY = std::clamp((position.y - gridOrigin.y) * gridScale.y, 0.0, double(SpacingGridSize - 1));
+                const size_t cellIndex = size_t(cellY) * SpacingGridSize + size_t(cellX);
+                occupancy[cellIndex >> 6] |= uint64_t(1) << (cellIndex & 63);
+            }
+
+            void Finish(DatasetStats& output) const;
+
+        private:
+            DatasetStats stats;
+
+            glm::dvec2 gridOrigin = glm::dvec2(0.0);
+            glm::dvec2 gridScale = glm::dvec2(0.0);
+            double cellArea = 0.0;
+            std::vector<uint64_t> occupancy;
+    };
+
+    // IDENTIFIES THE POINT FILE A SIDECAR WAS COMPUTED FROM
+    struct FileKey {
+        uint64_t fileSize = 0;
+        int64_t modifiedTime = 0;
+        uint64_t decimationStep = 1;
+
+        bool operator == (const FileKey& other) const {
+            return fileSize == other.fileSize && modifiedTime == other.modifiedTime && decimationStep == other.decimationStep;
+        }
+    };
+
+    bool GetFileKey(const std::string& filepath, uint64_t decimationStep, FileKey& key);
+
+    // SIDECAR FILE NEXT TO THE POINT FILE ("<file>.stats"), VALID WHILE THE FILE SIZE, MODIFICATION TIME
+    // AND DECIMATION STEP MATCH, OTHERWISE THE NEXT LOAD RECOMPUTES AND OVERWRITES IT
+    bool SaveDatasetStats(const std::string& filepath, uint64_t decimationStep, const DatasetStats& stats);
+    bool LoadDatasetStats(const std::string& filepath, uint64_t decimationStep, DatasetStats& stats);
+
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+
+#include <glm/glm.hpp>
+
+#include <ElevationGrid.hpp>
+
+namespace Data {
+
+    // NO-DATA VALUE OF EMPTY CELLS (GDAL_NODATA TAG)
+    static constexpr float GeoTiffNoData = -9999.0f;
+
+    // WRITES THE GRID AS AN UNCOMPRESSED FLOAT32 GEOTIFF, FOUR BANDS PER PIXEL: MIN, MAX, MEAN ELEVATION, MEAN INTENSITY
+    // (origin) IS THE FILE COORDINATE OF THE STORE ORIGIN, THE FILE HAS NO CRS KEYS (THE LAS CRS IS NOT PARSED)
+    bool WriteElevationGeoTiff(const std::string& filepath, const Spatial::ElevationGrid& grid, const glm::dvec3& origin);
+
+}
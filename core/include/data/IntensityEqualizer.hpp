@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <CubeInstance.hpp>
+#include <MemoryPool.hpp>
+
+namespace Data {
+
+    // HOST-SIDE HISTOGRAM AND CDF OF 16-BIT INTENSITIES, FILLS THE SAME 65536-ENTRY TABLE AS intensity_map.comp
+    // (FALLBACK OF THE GPU INTENSITY MAP WHEN ITS COMPUTE PROGRAMS ARE UNAVAILABLE)
+    class IntensityEqualizer {
+        public:
+            // EVERY UINT16 VALUE HAS ITS OWN BIN
+            static constexpr size_t BinCount = 65536;
+
+            IntensityEqualizer() = default;
+
+            // REBUILDS THE CDF FROM (count) POINTS, PER-THREAD HISTOGRAMS MERGED OVER BIN RANGES IN PARALLEL
+            void Build(const CubeInstance* points, size_t count, AllocationStats& loadStats);
+
+            // EQUALIZED (CDF / COUNT) OR LINEAR BETWEEN THE BINS HOLDING THE TWO FRACTIONS OF THE POINTS
+            void WriteTable(bool equalize, float lowFraction, float highFraction, float* table) const;
+
+            inline bool Empty() const { return cumulative.empty(); }
+
+        private:
+            // FIRST BIN WHOSE CUMULATIVE COUNT REACHES (threshold)
+            size_t FirstBinReaching(uint64_t threshold) const;
+
+        private:
+            std::vector<uint64_t> cumulative;
+
+            // POOLED PER-THREAD HISTOGRAMS (KEPT BETWEEN LOADS)
+            std::vector<uint32_t> threadHistograms;
+    };
+
+}
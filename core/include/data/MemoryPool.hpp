@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Data {
+
+    // ALLOCATIONS MADE WHILE LOADING ONE FILE (RESET AT THE START OF EVERY LOAD)
+    struct AllocationStats {
+        uint64_t allocationCount = 0;
+        uint64_t allocatedBytes = 0;
+        uint64_t reusedBytes = 0;
+
+        uint64_t deviceAllocationCount = 0;
+        uint64_t deviceAllocatedBytes = 0;
+
+        inline void Reset() { *this = AllocationStats(); }
+
+        inline void RecordAllocation(uint64_t bytes) {
+            allocationCount++;
+            allocatedBytes += bytes;
+        }
+
+        inline void RecordReuse(uint64_t bytes) { reusedBytes += bytes; }
+
+        inline void RecordDeviceAllocation(uint64_t bytes) {
+            deviceAllocationCount++;
+            deviceAllocatedBytes += bytes;
+        }
+    };
+
+    // NON-OWNING VIEW OVER CONTIGUOUS MEMORY HANDED BETWEEN PIPELINE STAGES
+    template <typename T>
+    struct Span {
+        T* data = nullptr;
+        size_t size = 0;
+
+        inline T* begin() const { return data; }
+        inline T* end() const { return data + size; }
+        inline T& operator[](size_t index) const { return data[index]; }
+        inline bool empty() const { return size == 0; }
+    };
+
+    // RESIZE A POOLED BUFFER, ONLY ALLOCATES WHEN THE RETAINED CAPACITY IS TOO SMALL
+    template <typename T>
+    inline void AcquireBuffer(std::vector<T>& buffer, size_t count, AllocationStats& stats) {
+        if (buffer.capacity() < count) {
+            stats.RecordAllocation(count * sizeof(T));
+        } else {
+            stats.RecordReuse(count * sizeof(T));
+        }
+        buffer.resize(count);
+    }
+
+    // RESERVE A POOLED BUFFER, ONLY ALLOCATES WHEN THE RETAINED CAPACITY IS TOO SMALL
+    template <typename T>
+    inline void ReserveBuffer(std::vector<T>& buffer, size_t count, AllocationStats& stats) {
+        if (buffer.capacity() < count) {
+            stats.RecordAllocation(count * sizeof(T));
+        } else {
+            stats.RecordReuse(count * sizeof(T));
+        }
+        buffer.reserve(count);
+    }
+
+    // LOAD-SCOPED MONOTONIC ARENA, RESET REWINDS IT WITHOUT RELEASING ITS CHUNKS
+    class LoadArena {
+        public:
+            explicit LoadArena(size_t chunkSize = 4 * 1024 * 1024) : chunkSize(chunkSize) {}
+
+            // TRIVIAL TYPES ONLY, MEMORY IS NOT INITIALIZED
+            template <typename T>
+            Span<T> Allocate(size_t count) {
+                static_assert(std::is_trivially_destructible<T>::value, "ARENA TYPES MUST BE TRIVIALLY DESTRUCTIBLE");
+                void* memory = AllocateBytes(count * sizeof(T), alignof(T));
+                return Span<T> { static_cast<T*>(memory), count };
+            }
+
+            void Reset(AllocationStats* loadStats);
+
+            // ACCESSORS
+            size_t CapacityBytes() const;
+
+        private:
+            void* AllocateBytes(size_t bytes, size_t alignment);
+
+        private:
+            struct Chunk {
+                std::unique_ptr<uint8_t[]> memory;
+                size_t size = 0;
+                size_t used = 0;
+            };
+
+            size_t chunkSize;
+            size_t currentChunk = 0;
+            std::vector<Chunk> chunks;
+
+            AllocationStats* stats = nullptr;
+
+        private:
+            // NON-COPYABLE (OWNS MEMORY HANDED OUT AS SPANS)
+            LoadArena(const LoadArena&) = delete;
+            LoadArena& operator = (const LoadArena&) = delete;
+    };
+
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <PointStore.hpp>
+
+namespace Data {
+
+    // SIDECAR FILE NEXT TO THE POINT FILE ("<file>.normals") HOLDING THE ENCODED NORMALS IN STORE ORDER
+    // VALID WHILE THE FILE KEY, NEIGHBOR COUNT AND STORE LAYOUT (FIRST POINT OF EVERY BLOCK) MATCH,
+    // SO A LOAD WITH DIFFERENT FILTERING OR DOWNSAMPLING SETTINGS RECOMPUTES AND OVERWRITES IT
+    bool SavePointNormals(const std::string& filepath, uint64_t decimationStep, uint32_t neighborCount,
+        const PointStore& pointStore, const std::vector<uint16_t>& encodedNormals);
+    bool LoadPointNormals(const std::string& filepath, uint64_t decimationStep, uint32_t neighborCount,
+        const PointStore& pointStore, std::vector<uint16_t>& encodedNormals, AllocationStats& loadStats);
+
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <CubeInstance.hpp>
+#include <MemoryPool.hpp>
+#include <RadixSort.hpp>
+
+namespace Data {
+
+    // FIXED-SIZE BLOCK OF QUANTIZED POINTS, EACH FIELD STORED AS A
+    // BIT-PACKED DELTA FROM THE BLOCK MINIMUM (FRAME OF REFERENCE)
+    struct PointBlock {
+        uint32_t count = 0;
+        uint64_t byteOffset = 0;
+
+        glm::ivec3 positionBase = glm::ivec3(0);
+        uint32_t attributeBase = 0;
+        uint16_t intensityBase = 0;
+
+        uint8_t positionBits[3] = { 0, 0, 0 };
+        uint8_t intensityBits = 0;
+        uint8_t attributeBits = 0;
+    };
+
+    class PointStore {
+        public:
+            // POINTS PER BLOCK (ALSO THE SIZE OF THE PER-THREAD DECODE SCRATCH BUFFER)
+            // EVERY BLOCK BUT THE LAST IS FULL, SO BLOCK (i) STARTS AT POINT (i * BlockSize)
+            static constexpr uint32_t BlockSize = 4096;
+
+            // COMPRESSED LOADS MORTON-SORT THIS MANY BLOCKS AT A TIME BEFORE ENCODING THEM
+            static constexpr uint32_t SortChunkBlocks = 64;
+
+            PointStore() = default;
+
+            // BUFFERS ARE POOLED, RESET/CLEAR KEEP THEIR CAPACITY FOR THE NEXT LOAD
+            void Reset(uint64_t expectedCount, bool compress, float quantization, AllocationStats* loadStats = nullptr);
+            void Clear();
+
+            // (attributes) ARE PACKED WITH CubeInstance::PackAttributes
+            void Add(const glm::vec3& position, uint16_t intensity, uint32_t attributes = 0);
+
+            // UNCOMPRESSED STORES ARE REORDERED ALONG A MORTON CURVE OVER THEIR BOUNDS,
+            // COMPRESSED STORES ARE ALREADY MORTON-ORDERED PER SORT CHUNK
+            void Finalize();
+
+            // DROPS EVERY POINT WHOSE FLAG (STORE ORDER) IS ZERO, KEEPS THE ORDER OF THE REST
+            // COMPRESSED STORES ARE RE-ENCODED SO EVERY BLOCK BUT THE LAST IS FULL AGAIN
+            void RemovePoints(const std::vector<uint8_t>& keepFlags);
+
+            // EXCHANGES THE STORED INTENSITIES WITH (intensities) (STORE ORDER, ONE PER POINT), CALLING IT TWICE RESTORES THEM
+            void SwapIntensities(std::vector<uint16_t>& intensities);
+
+            // PER-POINT OCTAHEDRAL NORMALS (STORE ORDER), WRITTEN INTO THE POINTS WHEN UNCOMPRESSED,
+            // KEPT AS A SEPARATE 2-BYTE STREAM NEXT TO COMPRESSED BLOCKS AND FILLED IN ON DECODE
+            void SetNormals(const std::vector<uint16_t>& encodedNormals);
+            inline bool HasNormals() const { return hasNormals; }
+
+            // RETURNS THE POINTS OF A BLOCK, COMPRESSED BLOCKS ARE DECODED INTO A
+            // PER-THREAD SCRATCH BUFFER (VALID UNTIL THE NEXT CALL ON THAT THREAD)
+            // SAFE TO CALL FROM SEVERAL THREADS ONCE THE STORE IS FINALIZED
+            const CubeInstance* GetBlock(size_t blockIndex, uint32_t& count) const;
+
+            // CALLBACK SIGNATURE: (const CubeInstance* points, uint32_t count, uint64_t firstIndex)
+            template <typename Callable>
+            void ForEachBlock(Callable&& callback) const {
+                uint64_t firstIndex = 0;
+                for (size_t blockIndex = 0; blockIndex < BlockCount(); ++blockIndex) {
+                    uint32_t count = 0;
+                    const CubeInstance* points = GetBlock(blockIndex, count);
+                    callback(points, count, firstIndex);
+                    firstIndex += count;
+                }
+            }
+
+            // ACCESSORS
+            inline uint64_t Size() const { return pointCount; }
+            inline bool Empty() const { return pointCount == 0; }
+            inline bool IsCompressed() const { return compressed; }
+            inline float GetQuantization() const { return quantization; }
+            size_t BlockCount() const;
+            size_t ResidentBytes() const;
+
+            // EXPECTED RESIDENT COST OF ONE POINT IN THE GIVEN MODE (FROM THE LAST COMPRESSED LOAD)
+            double EstimatedBytesPerPoint(bool compress) const;
+
+        private:
+            void FlushStaging();
+            void SortSpatially(std::vector<CubeInstance>& input, unsigned threadCount);
+            void EncodeBlock(const CubeInstance* points, uint32_t count);
+            void DecodeBlock(const PointBlock& block, const uint8_t* bytes, CubeInstance* output) const;
+
+        private:
+            bool compressed = false;
+            float quantization = 0.001f;
+            uint64_t pointCount = 0;
+
+            // UNCOMPRESSED POINTS (OR STAGING FOR THE NEXT COMPRESSED BLOCK)
+            std::vector<CubeInstance> points;
+
+            // MORTON SORT BUFFERS (KEPT FOR COMPRESSED CHUNKS, RELEASED AFTER A FULL SORT)
+            std::vector<uint64_t> sortKeys;
+            std::vector<uint32_t> sortOrder;
+            Spatial::SortScratch sortScratch;
+
+            // COMPRESSED BLOCKS
+            std::vector<PointBlock> blocks;
+            std::vector<uint8_t> packedBytes;
+            std::vector<uint16_t> normals;
+            bool hasNormals = false;
+
+            // COMPRESSED SIZE OF THE PREVIOUS LOAD (USED TO RESERVE THE NEXT ONE)
+            double packedBytesPerPoint = 8.0;
+            size_t reservedPackedBytes = 0;
+
+            AllocationStats* stats = nullptr;
+    };
+
+}
@@ -59,7 +59,9 @@
 #include <pdal/filters/StreamCallbackFilter.hpp>
 
 #include <CubeRenderer.hpp>
+#include <DatasetStats.hpp>
 #include <LazHeader.hpp>
+#include <PointStore.hpp>
 
 using namespace pdal;
 
@@ -68,29 +70,59 @@ namespace CustomReader {
     struct ReaderOptions {
         std::string filepath;
         std::shared_ptr<LazHeader> header;
-        CubeRenderer* cubeRenderer;
+        CubeRenderer* cubeRenderer = nullptr;
+        Data::DatasetStats* stats = nullptr;
+        uint64_t decimationStep = 1;
+
+        // SECONDARY LOADS (CHANGE DETECTION REFERENCE) FILL THEIR OWN STORE AROUND AN EXISTING ORIGIN
+        Data::PointStore* targetStore = nullptr;
+        bool hasOrigin = false;
+        glm::dvec3 origin = glm::dvec3(0.0);
     };
 
+    // POINTS PER STREAMING CHUNK (PDAL TABLE SIZE DOES NOT SCALE WITH THE FILE)
+    static constexpr uint64_t StreamChunkSize = 65536;
+
     class LazReader {
         public:
             LazReader(
                 const std::string& filepath, 
-                CubeRenderer* cubeRenderer
+                CubeRenderer* cubeRenderer,
+                Data::DatasetStats* stats
+            );
+
+            // READS INTO (targetStore) CENTERED ON (origin), THE STORE MUST BE RESET BY THE CALLER
+            LazReader(
+                const std::string& filepath,
+                Data::PointStore* targetStore,
+                const glm::dvec3& origin
             );
 
             void ReadPointData();
+
+            // STATISTICS FROM A PREVIOUS LOAD (SIDECAR FILE), CALL ONCE THE DECIMATION STEP IS SET
+            // WHEN FOUND THE DECODE SKIPS ACCUMULATION AND CENTERS ON THE TRUE BOUNDS
+            bool LoadCachedStats();
+            inline bool HasCachedStats() const { return cachedStats; }
             
             // ACCESSORS
             inline std::shared_ptr<LazHeader> GetHeader() const { return options.header; }
+            inline void SetDecimationStep(uint64_t step) { options.decimationStep = step; }
 
         private:
             ReaderOptions options;
 
+            bool cachedStats = false;
+            Data::StatsAccumulator statsAccumulator;
+
+            // LOCAL ORIGIN OF THE LOADED POSITIONS (DOUBLE PRECISION FILE COORDINATES)
+            glm::dvec3 GetOrigin() const;
+
             std::shared_ptr<LazHeader> GetLazHeader(const std::string& filepath);
 
             Stage* CreateLazReader(const std::string& filepath, StageFactory& factory);
 
-            Stage* AddDecimationFilter(uint64_t* pointCount, Stage* lastStage, StageFactory& factory);
+            Stage* AddDecimationFilter(uint64_t decimationStep, uint64_t* pointCount, Stage* lastStage, StageFactory& factory);
 
             std::unique_ptr<StreamCallbackFilter> CreateStreamCallback(Stage* lastStage, StageFactory& factory);
             
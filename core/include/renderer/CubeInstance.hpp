@@ -1,14 +1,28 @@
 #pragma once
 
+#include <cstdint>
+
 #include <glm/glm.hpp>
 
 struct CubeInstance {
     glm::vec3 position;
-    uint16_t intensity;
-    float normalized_intensity = 0.0f;
+    uint16_t intensity = 0;
+    uint16_t normal = 0;            // OCTAHEDRAL 2 x 8-BIT UNIT NORMAL (ZERO UNTIL NORMALS ARE ESTIMATED), FILLS THE PADDING
+    uint32_t attributes = 0;        // PACKED LAS ATTRIBUTES (SEE PackAttributes, UNPACKED THE SAME WAY IN cube.vert)
+
+    CubeInstance() = default;
     
-    CubeInstance(const glm::vec3& position, const uint16_t intensity) {
+    CubeInstance(const glm::vec3& position, const uint16_t intensity, const uint32_t attributes = 0) {
         this->position = position;
         this->intensity = intensity;
+        this->attributes = attributes;
+    }
+
+    // BITS 0-7 CLASSIFICATION, 8-11 RETURN NUMBER, 12-15 NUMBER OF RETURNS, 16-31 POINT SOURCE ID
+    static inline uint32_t PackAttributes(uint8_t classification, uint8_t returnNumber, uint8_t returnCount, uint16_t sourceId) {
+        return uint32_t(classification)
+            | (uint32_t(returnNumber & 0xF) << 8)
+            | (uint32_t(returnCount & 0xF) << 12)
+            | (uint32_t(sourceId) << 16);
     }
-};
\ No newline at end of file
+};
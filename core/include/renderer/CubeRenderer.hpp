@@ -9,17 +9,45 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/common.hpp>
 
+#include <AttributeMask.hpp>
 #include <ColorLUT.hpp>
 #include <ColorRamp.hpp>
+#include <CpuVoxelDownsampleFilter.hpp>
 #include <CubeInstance.hpp>
+#include <CubeStripPass.hpp>
+#include <ElevationGrid.hpp>
+#include <HeightmapMesh.hpp>
+#include <InstanceCullPass.hpp>
+#include <InstanceCuller.hpp>
+#include <IntensityMap.hpp>
+#include <KdTree.hpp>
+#include <LodSelector.hpp>
+#include <MemoryPool.hpp>
+#include <NormalEstimator.hpp>
+#include <PointSplatPass.hpp>
+#include <PointStore.hpp>
+#include <ProgressiveRefiner.hpp>
+#include <RenderBenchmark.hpp>
 #include <RendererHelper.hpp>
+#include <StatisticalOutlierFilter.hpp>
 #include <VoxelDownsampleFilter.hpp>
+#include <VoxelFilter.hpp>
+#include <VoxelPyramid.hpp>
 
 // FORWARD DECLARATION
 class Camera;
 
 using namespace Renderer;
 
+// STORED POINT HIT BY A PICK RAY
+struct PickedPoint {
+    uint64_t index = 0;
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::dvec3 worldPosition = glm::dvec3(0.0);
+    uint16_t intensity = 0;
+    float distance = 0.0f;
+};
+
 class CubeRenderer {
     public:
         // CONSTRUCTOR / DESTRUCTOR
@@ -29,34 +57,209 @@ class CubeRenderer {
         void Init(Data::ColorRampType rampType);
         void Shutdown();
 
-        void Render(const glm::mat4& viewProjection, float globalScale);
-        void UpdateBufferSize(uint64_t pointCount);
+        // CUBES BEYOND THE FAR DISTANCE ARE DROPPED IN THE VERTEX SHADER AND THE HEIGHTMAP IS DRAWN THERE INSTEAD
+        void Render(const glm::mat4& viewProjection, const glm::vec3& cameraPosition, float globalScale);
+        void UpdateBufferSize(uint64_t pointCount, float quantization = 0.001f);
         void UpdateBuffers();
 
-        void AddCube(glm::vec3 position, uint16_t intensity);
-        void UpdateInstancePosition(uint64_t index, glm::vec3 position);
-        void UpdateInstanceIntensity(uint64_t index, float intensity);
+        void AddCube(glm::vec3 position, uint16_t intensity, uint32_t attributes = 0);
+
+        // SORTS/SEALS THE STORE, THEN DROPS STATISTICAL OUTLIERS AND ESTIMATES NORMALS WHEN ENABLED (CALLED ON THE READER THREAD)
+        void FinalizePoints();
+
+        // POINT FILE OF THE CURRENT LOAD (KEYS THE NORMAL SIDECAR), SET BEFORE (FinalizePoints)
+        void SetSourceFile(const std::string& filepath, uint64_t decimationStep) {
+            sourceFile = filepath;
+            sourceDecimationStep = decimationStep;
+        }
+
+        // TRUE BOUNDS OF THE STORED POSITIONS (FROM THE DATASET STATISTICS), CLEARED BY THE NEXT LOAD
+        void SetPointBounds(const glm::vec3& minimum, const glm::vec3& maximum);
+        bool GetPointBounds(glm::vec3& minimum, glm::vec3& maximum) const;
+
+        // FILE COORDINATES OF THE STORE ORIGIN (STORED POSITIONS ARE CENTERED AROUND IT)
+        void SetPointOrigin(const glm::dvec3& origin) { pointOrigin = origin; }
+        const glm::dvec3& GetPointOrigin() const { return pointOrigin; }
+
+        // FIRST STORED POINT ALONG THE RAY WITHIN (pointRadius), FALSE WITHOUT A POINT INDEX
+        bool PickPoint(const glm::vec3& origin, const glm::vec3& direction, float pointRadius, PickedPoint& picked) const;
+
+        void ReportLoadAllocations() const;
+
+        // SURVIVOR COUNT OF THE LAST FILTER RUN (FALSE WHILE A DEVICE-SIDE COUNT IS STILL IN FLIGHT)
+        bool GetRenderedCount(uint64_t& count) const;
 
-        void NormalizeIntensities();
+        // RAW INTENSITIES STAY ON THE DEVICE, ONLY THE 65536-ENTRY LOOKUP TABLE IS REWRITTEN
+        void SetIntensityMapping(Utils::IntensityMapping mapping, float clipPercent);
         void UpdateColorRamp(Data::ColorRampType rampType);
+
+        // EXCHANGES THE STORED INTENSITIES (STORE ORDER) WITH (intensities), CALL VoxelDownsample AND UpdateBuffers AFTER
+        // SWAPPING TWICE RESTORES THE ORIGINAL VALUES (CHANGE DETECTION SHOWS DISTANCES THROUGH THE INTENSITY RAMP)
+        void SwapIntensities(std::vector<uint16_t>& intensities);
         
-        // GPU FILTERS
+        // FILTERS
         void VoxelDownsample();
 
+        // VOXEL PYRAMID (SWITCHING LEVELS ONLY REWRITES THE DRAW COMMAND)
+        bool HasVoxelPyramid() const { return pyramidActive; }
+        const Spatial::VoxelPyramid& GetVoxelPyramid() const { return voxelPyramid; }
+        int GetPyramidLevel() const { return pyramidLevel; }
+        void SetPyramidLevel(int level);
+
+        // SCREEN-SPACE-ERROR LEVEL OF DETAIL OVER THE PYRAMID (REPLACES THE FIXED LEVEL), BUDGET FOLLOWS THE FRAME RATE
+        bool& GetUseLod() { return useLod; }
+        Utils::LodSelector& GetLodSelector() { return lodSelector; }
+        bool IsLodActive() const { return useLod && pyramidActive && voxelPyramid.NodeCount() > 0 && !IsRefining(); }
+        void UpdateFrameRate(float fps) { lodSelector.AdaptBudget(fps); }
+
         void Clear();
 
+        // ELEVATION GRID OF THE STORED POINTS (FAR-FIELD TERRAIN, GEOTIFF EXPORT), BUILT ON DEMAND WHEN THE FAR FIELD IS OFF
+        bool BuildElevationGrid();
+        const Spatial::ElevationGrid& GetElevationGrid() const { return elevationGrid; }
+        void SetUseFarField(bool enabled);
+        bool GetUseFarField() const { return useFarField; }
+        float& GetFarDistance() { return farDistance; }
+        GLsizei GetFarFieldTriangleCount() const { return farField.GetTriangleCount(); }
+
+        // ACCESSORS
+        bool& GetCompressPoints() { return compressPoints; }
+        const Data::PointStore& GetPointStore() const { return pointStore; }
+        int& GetVoxelBackend() { return voxelBackend; }
+        bool& GetUseVoxelPyramid() { return useVoxelPyramid; }
+        bool& GetSolveVoxelSize() { return solveVoxelSize; }
+        uint64_t& GetTargetPointCount() { return targetPointCount; }
+        uint64_t GetRenderBudget() const { return cpuVoxelFilter.GetRenderBudget(); }
+        bool& GetRemoveOutliers() { return removeOutliers; }
+        bool& GetBuildPointIndex() { return buildPointIndex; }
+        const Spatial::KdTree& GetPointIndex() const { return pointIndex; }
+        Filters::StatisticalOutlierFilter& GetOutlierFilter() { return outlierFilter; }
+        bool& GetEstimateNormals() { return estimateNormals; }
+        bool& GetShadeNormals() { return shadeNormals; }
+        Filters::NormalEstimator& GetNormalEstimator() { return normalEstimator; }
+        Utils::AttributeMask& GetAttributeMask() { return attributeMask; }
+        bool& GetFrustumCulling() { return frustumCulling; }
+        const Utils::InstanceCuller& GetInstanceCuller() const { return instanceCuller; }
+        bool& GetGpuCulling() { return gpuCulling; }
+        bool HasGpuCulling() const { return instanceCullPass.IsAvailable(); }
+        Utils::InstanceCullPass& GetInstanceCullPass() { return instanceCullPass; }
+        bool& GetProgressiveRefinement() { return progressiveRefinement; }
+        bool HasProgressiveRefinement() const { return progressiveRefiner.IsAvailable(); }
+        const Utils::ProgressiveRefiner& GetProgressiveRefiner() const { return progressiveRefiner; }
+        int& GetRefinementBatchSize() { return progressiveRefiner.GetBatchSize(); }
+        bool IsRefining() const { return progressiveRefinement && progressiveRefiner.IsAvailable(); }
+
+        // RENDER MODE (SPLATS READ THE SAME INSTANCE BUFFERS, CULLING BY NODES ONLY) AND ITS BENCHMARK
+        int& GetRenderMode() { return renderMode; }
+        bool HasSplats() const { return splatPass.IsAvailable(); }
+        Utils::PointSplatPass& GetSplatPass() { return splatPass; }
+        // NOTHING TO DRAW, NOTHING TO MEASURE (A RUN WOULD NEVER FINISH)
+        void RunRenderBenchmark() { if (HasDrawInstances()) renderBenchmark.Start(); }
+        bool HasDrawInstances() const { return maxDrawInstances > 0; }
+        const Utils::RenderBenchmark& GetRenderBenchmark() const { return renderBenchmark; }
+
+        // PROCEDURAL CUBES (THREE CAMERA-FACING FACES PER INSTANCE, PULLED FROM THE INSTANCE BUFFERS)
+        bool& GetUseStripCubes() { return useStripCubes; }
+        bool HasStripCubes() const { return stripPass.IsAvailable(); }
+        float GetVoxelSize() const {
+            if (pyramidActive) return voxelPyramid.LevelSize(uint32_t(pyramidLevel));
+            return lastVoxelFilter ? lastVoxelFilter->GetVoxelSize() : 0.0f;
+        }
+        void SetRenderBudget(uint64_t budget) {
+            gpuVoxelFilter.SetRenderBudget(budget);
+            cpuVoxelFilter.SetRenderBudget(budget);
+        }
+
+    private:
+        void EnsureInstanceCapacity(uint64_t instanceCount);
+        // MODEL, PACKED INTENSITY AND (ENCODED NORMAL, PACKED LAS ATTRIBUTES) OF EVERY INSTANCE, CAPACITY ENSURED BY THE CALLER
+        void WriteInstances(Data::Span<const CubeInstance> instances);
+        void WriteDrawCommand(GLuint instanceCount);
+        void PollRenderedCount();
+        bool BuildVoxelPyramid();
+        bool BuildPointIndex();
+        void BuildFarField();
+        void RemoveOutliers();
+        void EstimateNormals();
+        uint64_t GetDrawCount() const;
+        void RebuildIntensityMap();
+        void BuildCullingNodes();
+        void BuildDeviceCullingNodes();
+
+        // RAW UINT16 INTENSITIES ARE PACKED TWO PER WORD, ROUNDED UP SO SHADERS CAN READ WHOLE WORDS
+        static size_t IntensityBufferBytes(uint64_t instanceCount) { return size_t((instanceCount + 1) / 2) * sizeof(GLuint); }
+
     private:
         Utils::ColorLUT colorLUT;
 
+        // LOADED POINTS (OPTIONALLY BLOCK-COMPRESSED)
+        Data::PointStore pointStore;
+        bool compressPoints = false;
+        bool hasPointBounds = false;
+        glm::vec3 pointMinimum = glm::vec3(0.0f);
+        glm::vec3 pointMaximum = glm::vec3(0.0f);
+        glm::dvec3 pointOrigin = glm::dvec3(0.0);
+
+        // SPATIAL INDEX OVER THE STORED POINTS (PICKING, NEIGHBOR QUERIES, OUTLIER REMOVAL)
+        Spatial::KdTree pointIndex;
+        bool buildPointIndex = true;
+
+        // RENDERED POINTS (AFTER FILTERING), CONVERTED STRAIGHT INTO THE MAPPED INSTANCE BUFFERS BY (WriteInstances)
         std::vector<CubeInstance> cubes;
 
-        // INSTANCE BUFFERS
-        std::vector<glm::mat4> instanceModels;
-        std::vector<float> instanceIntensities;
+        // RAW INTENSITY -> [0, 1] TABLE (HISTOGRAM / CDF BUILT ON THE GPU)
+        Utils::IntensityMap intensityMap;
+
+        // POOLED MEMORY (KEPT BETWEEN LOADS)
+        Data::AllocationStats loadStats;
+        size_t instanceModelCapacity = 0;
+        size_t instanceIntensityCapacity = 0;
+        size_t instanceAttributeCapacity = 0;
+
+        // DRAW STATE (INSTANCES WRITTEN BY THE GPU FILTER NEVER PASS THROUGH THE HOST ARRAYS)
+        bool instancesOnDevice = false;
+        uint64_t maxDrawInstances = 0;
+        uint64_t renderedCount = 0;
+        uint64_t filterInputCount = 0;
+        GLsync renderedCountFence = nullptr;
+
+        // PER-INSTANCE VISIBILITY (UNIFORMS ONLY, EVALUATED IN THE VERTEX SHADER)
+        Utils::AttributeMask attributeMask;
+
+        // FRUSTUM CULLING OVER INSTANCE RANGES (DEVICE-WRITTEN RANGES ARRIVE WITH THE SURVIVOR COUNT)
+        Utils::InstanceCuller instanceCuller;
+        std::vector<GLuint> blockOffsets;
+        bool frustumCulling = true;
+
+        // PER-INSTANCE FRUSTUM AND SCREEN-SIZE CULLING ON THE GPU (REFINES THE VISIBLE NODES, OR EVERY INSTANCE WITHOUT THEM)
+        Utils::InstanceCullPass instanceCullPass;
+        bool gpuCulling = true;
+
+        // PROGRESSIVE REFINEMENT (REPLACES CULLING AND LEVEL OF DETAIL), RESTARTED WHEN THE UNIFORMS BELOW CHANGE
+        Utils::ProgressiveRefiner progressiveRefiner;
+        bool progressiveRefinement = false;
+        float refinedGlobalScale = 0.0f;
+        float refinedFarDistance = 0.0f;
+        bool refinedUseNormals = false;
+        Utils::AttributeMask refinedMask;
+
+        // POINT SPLATS AND THE MODE BENCHMARK
+        Utils::PointSplatPass splatPass;
+        Utils::RenderBenchmark renderBenchmark;
+        int renderMode = static_cast<int>(Utils::RenderMode::Cubes);
+
+        // PROCEDURAL CUBES (INDEXED CUBES WHEN UNAVAILABLE OR DISABLED)
+        Utils::CubeStripPass stripPass;
+        bool useStripCubes = true;
 
         // GPU UNIFORMS
         GLint uViewProjectionLocation = -1;
         GLint uGlobalScaleLocation = -1;
+        GLint uCameraPositionLocation = -1;
+        GLint uFarDistanceLocation = -1;
+        GLint uUseNormalsLocation = -1;
+        GLint uPullInstancesLocation = -1;
+        GLint uFirstInstanceLocation = -1;
 
         // GPU RESOURCES
         GLuint cubeShader = 0;
@@ -65,9 +268,48 @@ class CubeRenderer {
         GLuint ebo = 0;
         GLuint instanceVBO = 0;
         GLuint instanceIntensityVBO = 0;
+        GLuint instanceAttributeVBO = 0;
+        GLuint drawCommandBuffer = 0;
         
-        // FILTERS
-        Filters::VoxelDownsampleFilter voxelDownsampleFilter;
+        // FILTERS (BACKEND SELECTED AT RUNTIME, CPU WHEN THE GPU ONE IS UNAVAILABLE OR FAILS)
+        Filters::VoxelDownsampleFilter gpuVoxelFilter;
+        Filters::CpuVoxelDownsampleFilter cpuVoxelFilter;
+        const Filters::VoxelFilter* lastVoxelFilter = nullptr;
+        int voxelBackend = static_cast<int>(Filters::VoxelBackend::GPU);
+        bool solveVoxelSize = false;
+
+        // SOLVER TARGET (ZERO FOLLOWS THE RENDER BUDGET, NEVER ABOVE IT)
+        uint64_t targetPointCount = 0;
+
+        // OUTLIER REMOVAL (RUNS ONCE PER LOAD, BEFORE ANY VOXEL FILTER SEES THE STORE)
+        Filters::StatisticalOutlierFilter outlierFilter;
+        std::vector<uint8_t> outlierKeepFlags;
+        bool removeOutliers = false;
+
+        // NORMAL ESTIMATION (RUNS ONCE PER LOAD AFTER OUTLIER REMOVAL, CACHED NEXT TO THE POINT FILE)
+        Filters::NormalEstimator normalEstimator;
+        std::vector<uint16_t> encodedNormals;
+        std::string sourceFile;
+        uint64_t sourceDecimationStep = 1;
+        bool estimateNormals = false;
+        bool shadeNormals = true;
+
+        // VOXEL PYRAMID (RENDER BUFFER ORDERED COARSE TO FINE, EACH LEVEL IS A PREFIX OF IT)
+        static constexpr float PyramidBaseSize = 0.125f;
+        static constexpr uint32_t PyramidLevelCount = 7;
+        Spatial::VoxelPyramid voxelPyramid;
+        bool useVoxelPyramid = false;
+        bool pyramidActive = false;
+        int pyramidLevel = 0;
+        Utils::LodSelector lodSelector;
+        bool useLod = true;
+
+        // FAR FIELD (GRID REBUILT WITH EVERY DOWNSAMPLE WHILE ENABLED, THE STORE'S INTENSITIES MAY HAVE CHANGED)
+        static constexpr uint32_t ElevationGridResolution = 1024;
+        Spatial::ElevationGrid elevationGrid;
+        Utils::HeightmapMesh farField;
+        bool useFarField = false;
+        float farDistance = 500.0f;
 
         // CUBE VERTICES (CORNER POSITIONS)
         static constexpr float cubeVertices[24] = {
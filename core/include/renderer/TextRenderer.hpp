@@ -23,6 +23,9 @@ public:
 
     void UpdateFPS();
 
+    // LAST FRAME-RATE SAMPLE (REFRESHED EVERY HALF SECOND)
+    float GetFPS() const { return frameRate.fps; }
+
     void Render(int windowWidth, int windowHeight);
 
     private:
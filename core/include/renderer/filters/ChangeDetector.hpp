@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <KdTree.hpp>
+#include <MemoryPool.hpp>
+#include <PointStore.hpp>
+
+namespace Filters {
+
+    // CLOUD-TO-CLOUD CHANGE DETECTION: EVERY COMPARED POINT GETS THE DISTANCE TO THE NEAREST REFERENCE POINT
+    // THE REFERENCE IS READ INTO ITS OWN STORE (SAME ORIGIN AS THE COMPARED CLOUD) AND INDEXED IN A KD-TREE
+    class ChangeDetector {
+        public:
+            static constexpr uint32_t HistogramBins = 4096;
+
+            // HOST COST PER COMPARED POINT: FLOAT DISTANCE + THE UINT16 INTENSITY SWAPPED IN FOR THE CHANGE VIEW
+            static constexpr uint64_t HostBytesPerComparedPoint = sizeof(float) + sizeof(uint16_t);
+
+            ChangeDetector() = default;
+
+            // THE READER FILLS THIS STORE, Compute INDEXES IT
+            inline Data::PointStore& GetReferenceStore() { return referenceStore; }
+            inline const Data::PointStore& GetReferenceStore() const { return referenceStore; }
+
+            // NEAREST REFERENCE DISTANCE FOR EVERY POINT OF (compared), IN STORE ORDER
+            bool Compute(const Data::PointStore& compared, Data::AllocationStats& loadStats);
+
+            // DISTANCES MAPPED ONTO THE INTENSITY RANGE (0 AT NO CHANGE, 65535 AT (range) OR MORE)
+            void Quantize(float range, std::vector<uint16_t>& values) const;
+
+            void Clear();
+
+            inline bool HasDistances() const { return !distances.empty(); }
+            inline uint64_t GetReferenceCount() const { return referenceStore.Size(); }
+            inline float GetMeanDistance() const { return meanDistance; }
+            inline float GetMaxDistance() const { return maxDistance; }
+            inline float GetPercentileDistance() const { return percentileDistance; }
+
+        private:
+            Data::PointStore referenceStore;
+            Spatial::KdTree referenceIndex;
+
+            float meanDistance = 0.0f;
+            float maxDistance = 0.0f;
+
+            // 95TH PERCENTILE (HISTOGRAM BIN EDGE), A USEFUL DEFAULT COLOR RANGE
+            float percentileDistance = 0.0f;
+
+            // POOLED WORK BUFFERS (KEPT BETWEEN LOADS)
+            std::vector<float> distances;
+    };
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <CubeInstance.hpp>
+#include <MemoryPool.hpp>
+#include <PointStore.hpp>
+#include <RadixSort.hpp>
+#include <VoxelFilter.hpp>
+
+namespace Filters {
+
+    // MULTITHREADED CPU BACKEND (NO GL CONTEXT REQUIRED)
+    // KEEPS THE LOWEST-INDEX POINT OF EVERY OCCUPIED VOXEL, SO THE OUTPUT DOES NOT DEPEND ON THE THREAD COUNT
+    class CpuVoxelDownsampleFilter : public VoxelFilter {
+        public:
+            CpuVoxelDownsampleFilter() = default;
+
+            bool ProcessPoints(const Data::PointStore& pointStore, std::vector<CubeInstance>& output, Data::AllocationStats& loadStats) override;
+
+            inline const char* GetName() const override { return "CPU"; }
+
+            // 0 = ALL HARDWARE THREADS
+            inline void SetThreadCount(unsigned count) { threadCount = count; }
+
+            // BOUNDS FROM THE DATASET STATISTICS SKIP THE BOUNDS SCAN (MUST ENCLOSE EVERY STORED POINT)
+            inline void SetKnownBounds(const glm::vec3& minimum, const glm::vec3& maximum) {
+                knownMinimum = minimum;
+                knownMaximum = maximum;
+                hasKnownBounds = true;
+            }
+            inline void ClearKnownBounds() { hasKnownBounds = false; }
+
+        private:
+            void CalculateBounds(const Data::PointStore& pointStore);
+            void GenerateKeys(const Data::PointStore& pointStore, Data::AllocationStats& loadStats);
+            void SelectPoints(Data::AllocationStats& loadStats);
+
+        private:
+            unsigned threadCount = 0;
+
+            bool hasKnownBounds = false;
+            glm::vec3 knownMinimum = glm::vec3(0.0f);
+            glm::vec3 knownMaximum = glm::vec3(0.0f);
+
+            // POOLED WORK BUFFERS (KEPT BETWEEN LOADS, THE SORT WORKS ON VECTORS)
+            std::vector<uint64_t> voxelKeys;
+            std::vector<uint32_t> pointIndices;
+            Spatial::SortScratch sortScratch;
+
+            // PER-RUN SCRATCH CARVED FROM ONE ARENA, REWOUND (NOT RELEASED) AT THE START OF EVERY RUN
+            Data::LoadArena workArena;
+            Data::Span<uint8_t> keepFlags;
+            Data::Span<uint32_t> blockOffsets;
+    };
+
+}
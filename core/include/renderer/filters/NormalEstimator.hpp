@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <KdTree.hpp>
+#include <MemoryPool.hpp>
+#include <PointStore.hpp>
+
+namespace Filters {
+
+    // PER-POINT NORMALS FROM PCA OVER THE (k) NEAREST NEIGHBORS: THE NORMAL IS THE EIGENVECTOR OF THE SMALLEST
+    // EIGENVALUE OF THE NEIGHBORHOOD COVARIANCE, ORIENTED UP (+Z, AERIAL SCANS ARE SEEN FROM ABOVE)
+    // NORMALS ARE OCTAHEDRAL ENCODED INTO 2 x 8 BITS (ONE uint16_t PER POINT, DECODED THE SAME WAY IN cube.vert)
+    class NormalEstimator {
+        public:
+            static constexpr uint32_t MaxNeighbors = 32;
+
+            // HOST MEMORY PER POINT WHILE RENDERING (THE ENCODED NORMAL, THE GPU COPY IS THE SAME SIZE)
+            static constexpr double BytesPerPoint = sizeof(uint16_t);
+
+            NormalEstimator() = default;
+
+            // FILLS (encodedNormals) IN STORE ORDER ((tree) INDEXES THE STORE)
+            void Compute(const Spatial::KdTree& tree, const Data::PointStore& pointStore, std::vector<uint16_t>& encodedNormals,
+                Data::AllocationStats& loadStats);
+
+            // SETTINGS
+            inline void SetNeighborCount(uint32_t count) { neighborCount = count < 3 ? 3 : (count > MaxNeighbors ? MaxNeighbors : count); }
+            inline uint32_t GetNeighborCount() const { return neighborCount; }
+
+            // COST OF THE LAST ESTIMATE (ZERO WHEN THE NORMALS CAME FROM THE SIDECAR)
+            inline double GetMilliseconds() const { return milliseconds; }
+            inline double GetNanosecondsPerPoint() const { return nanosecondsPerPoint; }
+            inline void SetCached(double loadMilliseconds) { milliseconds = loadMilliseconds; nanosecondsPerPoint = 0.0; }
+
+            static inline uint16_t EncodeNormal(const glm::vec3& normal) {
+                const float sum = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+                float x = normal.x / sum;
+                float y = normal.y / sum;
+                if (normal.z < 0.0f) {
+                    const float foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+                    const float foldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+                    x = foldedX;
+                    y = foldedY;
+                }
+                const uint32_t packedX = static_cast<uint32_t>(std::lround(std::clamp(x * 0.5f + 0.5f, 0.0f, 1.0f) * 255.0f));
+                const uint32_t packedY = static_cast<uint32_t>(std::lround(std::clamp(y * 0.5f + 0.5f, 0.0f, 1.0f) * 255.0f));
+                return static_cast<uint16_t>(packedX | (packedY << 8));
+            }
+
+            static inline glm::vec3 DecodeNormal(uint16_t encoded) {
+                float x = float(encoded & 0xFF) / 255.0f * 2.0f - 1.0f;
+                float y = float(encoded >> 8) / 255.0f * 2.0f - 1.0f;
+                const float z = 1.0f - std::abs(x) - std::abs(y);
+                const float t = std::max(-z, 0.0f);
+                x += x >= 0.0f ? -t : t;
+                y += y >= 0.0f ? -t : t;
+                const float length = std::sqrt(x * x + y * y + z * z);
+                return glm::vec3(x / length, y / length, z / length);
+            }
+
+        private:
+            uint32_t neighborCount = 10;
+
+            double milliseconds = 0.0;
+            double nanosecondsPerPoint = 0.0;
+    };
+
+}
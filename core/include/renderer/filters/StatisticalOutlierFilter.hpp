@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <KdTree.hpp>
+#include <MemoryPool.hpp>
+#include <PointStore.hpp>
+
+namespace Filters {
+
+    // STATISTICAL OUTLIER REMOVAL: EVERY POINT GETS THE MEAN DISTANCE TO ITS (k) NEAREST NEIGHBORS, POINTS WHOSE
+    // MEAN IS MORE THAN (multiplier) STANDARD DEVIATIONS ABOVE THE MEAN OF ALL POINTS ARE OUTLIERS
+    class StatisticalOutlierFilter {
+        public:
+            static constexpr uint32_t MaxNeighbors = 64;
+
+            StatisticalOutlierFilter() = default;
+
+            // FILLS (keepFlags) IN STORE ORDER AND RETURNS THE OUTLIER COUNT ((tree) INDEXES THE STORE)
+            uint64_t MarkPoints(const Spatial::KdTree& tree, const Data::PointStore& pointStore, std::vector<uint8_t>& keepFlags,
+                Data::AllocationStats& loadStats);
+
+            // SETTINGS (DEFAULTS MATCH PDAL'S OUTLIER FILTER)
+            inline void SetNeighborCount(uint32_t count) { neighborCount = count < 1 ? 1 : (count > MaxNeighbors ? MaxNeighbors : count); }
+            inline void SetMultiplier(float value) { multiplier = value > 0.0f ? value : 0.0f; }
+            inline uint32_t GetNeighborCount() const { return neighborCount; }
+            inline float GetMultiplier() const { return multiplier; }
+
+            // BOUNDS OF THE KEPT POINTS FROM THE LAST CALL
+            inline const glm::vec3& GetMinimum() const { return keptMinimum; }
+            inline const glm::vec3& GetMaximum() const { return keptMaximum; }
+
+        private:
+            uint32_t neighborCount = 8;
+            float multiplier = 2.0f;
+
+            glm::vec3 keptMinimum = glm::vec3(0.0f);
+            glm::vec3 keptMaximum = glm::vec3(0.0f);
+
+            // POOLED WORK BUFFERS (KEPT BETWEEN LOADS)
+            std::vector<float> meanDistances;
+    };
+
+}
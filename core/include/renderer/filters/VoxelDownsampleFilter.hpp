@@ -12,39 +12,105 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <CubeInstance.hpp>
+#include <MemoryPool.hpp>
+#include <PointStore.hpp>
+#include <PrefixSum.hpp>
 #include <RendererHelper.hpp>
+#include <VoxelFilter.hpp>
 
 namespace Filters {
 
-    class VoxelDownsampleFilter {
+    // LAYOUT OF THE INDIRECT DRAW BUFFER WRITTEN BY THE COMPACTION PASS (glDrawElementsIndirect)
+    struct DrawElementsIndirectCommand {
+        GLuint count = 0;
+        GLuint instanceCount = 0;
+        GLuint firstIndex = 0;
+        GLint baseVertex = 0;
+        GLuint baseInstance = 0;
+
+        // NOT READ BY GL: SURVIVORS BEFORE CLAMPING TO THE INSTANCE CAPACITY
+        GLuint survivorCount = 0;
+    };
+
+    // COMPUTE SHADER BACKEND (REQUIRES A GL 4.3 CONTEXT)
+    // VOXELS ARE DEDUPLICATED IN A SPARSE HASH TABLE SIZED FROM THE POINT COUNT, NOT THE BOUNDING BOX
+    class VoxelDownsampleFilter : public VoxelFilter {
         public:
             VoxelDownsampleFilter();
-            ~VoxelDownsampleFilter();
+            ~VoxelDownsampleFilter() override;
+
+            // HOST OUTPUT (READS THE KEEP FLAGS BACK)
+            bool ProcessPoints(const Data::PointStore& pointStore, std::vector<CubeInstance>& output, Data::AllocationStats& loadStats) override;
+
+            // DEVICE-ONLY PATH: (MarkPoints) FLAGS ONE POINT PER VOXEL, (WriteInstances) COMPACTS THE
+            // SURVIVORS STRAIGHT INTO THE RENDER INSTANCE BUFFERS, THE SURVIVOR COUNT ONLY LANDS IN (drawCommandBuffer)
+            bool MarkPoints(const Data::PointStore& pointStore, Data::AllocationStats& loadStats);
+            // (attributeBuffer) RECEIVES ONE UVEC2 PER INSTANCE (ENCODED NORMAL, PACKED LAS ATTRIBUTES)
+            void WriteInstances(GLuint modelBuffer, GLuint intensityBuffer, GLuint attributeBuffer, GLuint drawCommandBuffer, uint64_t instanceCapacity,
+                GLuint indexCount, Data::AllocationStats& loadStats);
 
-            std::vector<CubeInstance> ProcessPoints(std::vector<CubeInstance>& cubes);
+            // FIRST INSTANCE OF EVERY STORE BLOCK AFTER (WriteInstances), FOLLOWED BY THE SURVIVOR COUNT (BLOCK COUNT + 1 VALUES)
+            // READ IT ONCE THE COMPACTION HAS COMPLETED (FENCED), OTHERWISE THE READBACK STALLS
+            bool ReadBlockOffsets(std::vector<GLuint>& offsets, Data::AllocationStats& loadStats) const;
+
+            // BOUNDS OF EVERY STORE BLOCK OF THE LAST UPLOAD (CULLING BOXES OF THE DEVICE-WRITTEN INSTANCES)
+            inline const std::vector<glm::vec3>& GetBlockMinimum() const { return blockMinimum; }
+            inline const std::vector<glm::vec3>& GetBlockMaximum() const { return blockMaximum; }
+
+            // UPPER BOUND ON THE SURVIVORS OF THE LAST (MarkPoints), USED TO SIZE THE INSTANCE BUFFERS
+            // (OCCUPIED VOXELS CANNOT EXCEED THE POINT COUNT OR THE CELLS OF THE BOUNDING GRID)
+            inline uint64_t GetMaxSurvivorCount() const { return std::min<uint64_t>(pointCount, voxelCount); }
+
+            inline bool IsAvailable() const override { return computeProgram != 0; }
+            inline bool CanCompact() const { return IsAvailable() && scatterProgram != 0 && prefixSum.IsAvailable(); }
+            inline const char* GetName() const override { return "GPU"; }
 
         private:
-            void CalculateVoxelSize();
-            void UpdateBufferSize();
+            void UploadPoints(const Data::PointStore& pointStore, Data::AllocationStats& loadStats);
+            void UpdateBufferSize(Data::AllocationStats& loadStats);
 
         private:
-            float voxelSize = 0.0f;
-            uint32_t voxelCount = 0;
-            glm::vec3 voxelOrigin = glm::vec3(0.0f);
-            glm::vec3 voxelBounds = glm::vec3(0.0f);
+            // ONE BLOCK OF PADDED POSITIONS (STD430 VEC3 ARRAYS HAVE A 16-BYTE STRIDE, W IS 1), AND OF
+            // (RAW INTENSITY | ENCODED NORMAL << 16, PACKED LAS ATTRIBUTES) AS INTEGERS (NEVER THROUGH FLOAT BITS)
+            std::vector<glm::vec4> uploadBlock;
+            std::vector<glm::uvec2> uploadAttributes;
+            std::vector<glm::vec3> blockMinimum;
+            std::vector<glm::vec3> blockMaximum;
 
-            std::vector<glm::vec3> pointData;
+            // GPU BUFFER CAPACITIES (RE-SPECIFIED ONLY WHEN A LOAD NEEDS MORE)
+            size_t inputPointCapacity = 0;
+            size_t voxelTableCapacity = 0;
+            GLuint voxelTableSize = 0;
+            size_t keepFlagCapacity = 0;
+            size_t offsetCapacity = 0;
+            size_t blockOffsetCapacity = 0;
+            GLuint blockCount = 0;
 
             // GPU UNIFORMS
             GLint uVoxelSize = -1;
-            GLint uVoxelCount = -1;
             GLint uVoxelOrigin = -1;
-            GLint uVoxelBounds = -1;
+            GLint uTableMask = -1;
+            GLint uPointCount = -1;
+            GLint uPass = -1;
+            GLint uScatterPointCount = -1;
+            GLint uScatterCapacity = -1;
+            GLint uScatterIndexCount = -1;
+            GLint uBlockPointCount = -1;
+            GLint uBlockSize = -1;
+            GLint uBlockCount = -1;
 
             // GPU RESOURCES
             GLuint computeProgram = 0;
+            GLuint scatterProgram = 0;
+            GLuint blockOffsetProgram = 0;
             GLuint inputPointSSBO = 0;
-            GLuint outputFlagSSBO = 0;
+            GLuint inputAttributeSSBO = 0;
+            GLuint voxelTableSSBO = 0;
+            GLuint keepFlagSSBO = 0;
+            GLuint offsetSSBO = 0;
+            GLuint blockOffsetSSBO = 0;
+
+            Renderer::Utils::PrefixSum prefixSum;
 
         private:
             // NON-COPYABLE (OWNS GPU RESOURCES)
@@ -52,4 +118,4 @@ namespace Filters {
             VoxelDownsampleFilter& operator = (const VoxelDownsampleFilter&) = delete;
     };
 
-}
\ No newline at end of file
+}
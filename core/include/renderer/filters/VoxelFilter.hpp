@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <CubeInstance.hpp>
+#include <MemoryPool.hpp>
+#include <PointStore.hpp>
+#include <VoxelSizeSolver.hpp>
+
+namespace Filters {
+
+    enum class VoxelBackend {
+        GPU,
+        CPU
+    };
+
+    static inline const char* VoxelBackendNames[2] = {
+        "GPU (Compute Shader)",
+        "CPU (Multithreaded)"
+    };
+
+    // COMMON INTERFACE OF THE VOXEL DOWNSAMPLING BACKENDS (ONE POINT KEPT PER OCCUPIED VOXEL)
+    class VoxelFilter {
+        public:
+            virtual ~VoxelFilter() = default;
+
+            // WRITES SURVIVING POINTS INTO (output), RETURNS FALSE IF THE FILTER COULD NOT RUN
+            virtual bool ProcessPoints(const Data::PointStore& pointStore, std::vector<CubeInstance>& output, Data::AllocationStats& loadStats) = 0;
+
+            // FALSE WHEN THE BACKEND CANNOT RUN IN THIS CONTEXT (E.G. COMPUTE PROGRAM FAILED TO BUILD)
+            virtual bool IsAvailable() const { return true; }
+            virtual const char* GetName() const = 0;
+
+            // TARGET NUMBER OF SURVIVING POINTS (FROM THE BUDGET GOVERNOR)
+            inline void SetRenderBudget(uint64_t budget) { renderBudget = budget; }
+            inline uint64_t GetRenderBudget() const { return renderBudget; }
+            inline float GetVoxelSize() const { return voxelSize; }
+
+            // SOLVE THE VOXEL SIZE FOR A TARGET SURVIVOR COUNT INSTEAD OF THE GOVERNOR'S AREA POWER LAW
+            // (ZERO TARGETS THE RENDER BUDGET, LARGER TARGETS ARE CAPPED BY IT)
+            inline void SetSolveVoxelSize(bool solve) { solveVoxelSize = solve; }
+            inline void SetTargetPointCount(uint64_t count) { targetPointCount = count; }
+
+        protected:
+            // VOXEL SIZE, ORIGIN AND GRID FROM (pointCount, minPoint, maxPoint)
+            void CalculateVoxelSize(const Data::PointStore& pointStore, Data::AllocationStats& loadStats);
+
+            // VOXEL OF A POSITION (SAME ROUNDING AS voxelCoords IN voxel_downsample_filter.comp)
+            inline glm::ivec3 VoxelCoord(const glm::vec3& position) const {
+                return glm::ivec3(glm::floor((position - voxelOrigin) / voxelSize + 0.5f));
+            }
+
+        protected:
+            float voxelSize = 0.0f;
+            uint64_t voxelCount = 0;
+            uint64_t renderBudget = 0;
+            bool solveVoxelSize = false;
+            uint64_t targetPointCount = 0;
+            Spatial::VoxelSizeSolver sizeSolver;
+            glm::vec3 voxelOrigin = glm::vec3(0.0f);
+            glm::vec3 voxelBounds = glm::vec3(0.0f);
+
+            uint64_t pointCount = 0;
+            glm::vec3 minPoint = glm::vec3(0.0f);
+            glm::vec3 maxPoint = glm::vec3(0.0f);
+    };
+
+}
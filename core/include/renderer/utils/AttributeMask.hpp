@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+namespace Renderer::Utils {
+
+    // ASPRS STANDARD CLASSIFICATION NAMES (LAS 1.4, CODES 19-63 RESERVED, 64-255 USER DEFINABLE)
+    static inline const char* ClassificationNames[19] = {
+        "Never Classified",
+        "Unclassified",
+        "Ground",
+        "Low Vegetation",
+        "Medium Vegetation",
+        "High Vegetation",
+        "Building",
+        "Low Point (Noise)",
+        "Model Key-Point",
+        "Water",
+        "Rail",
+        "Road Surface",
+        "Overlap",
+        "Wire - Guard",
+        "Wire - Conductor",
+        "Transmission Tower",
+        "Wire-Structure Connector",
+        "Bridge Deck",
+        "High Noise"
+    };
+
+    // PER-INSTANCE VISIBILITY EVALUATED IN cube.vert FROM THE PACKED ATTRIBUTES (CubeInstance::PackAttributes)
+    // HIDDEN INSTANCES ARE COLLAPSED OUTSIDE THE CLIP VOLUME, A CHANGE ONLY REWRITES UNIFORMS (NO UPLOAD, NO PER-POINT WORK)
+    class AttributeMask {
+        public:
+            static constexpr uint32_t ClassCount = 256;
+            static constexpr uint32_t ReturnCount = 16;
+
+            AttributeMask() { Reset(); }
+
+            // EVERYTHING VISIBLE, WINDOWS OPEN
+            void Reset();
+
+            // UNIFORM LOCATIONS OF (program), THEN UPLOAD WITH (Apply) WHILE IT IS BOUND
+            void GetLocations(GLuint program);
+            void Apply() const;
+
+            // CLASSIFICATION CODES (0 - 255)
+            inline bool IsClassVisible(uint32_t code) const { return (classMask[code >> 5] >> (code & 31)) & 1u; }
+            inline void SetClassVisible(uint32_t code, bool visible) {
+                if (visible) classMask[code >> 5] |= 1u << (code & 31);
+                else classMask[code >> 5] &= ~(1u << (code & 31));
+            }
+
+            // RETURN NUMBERS (0 - 15), OPTIONALLY ONLY THE LAST RETURN OF EVERY PULSE
+            inline bool IsReturnVisible(uint32_t number) const { return (returnMask >> number) & 1u; }
+            inline void SetReturnVisible(uint32_t number, bool visible) {
+                if (visible) returnMask |= 1u << number;
+                else returnMask &= ~(1u << number);
+            }
+            bool& GetLastReturnOnly() { return lastReturnOnly; }
+
+            // INCLUSIVE WINDOWS (ELEVATION IN STORED, ORIGIN-CENTERED COORDINATES)
+            void SetSourceRange(uint32_t minimum, uint32_t maximum) { sourceRange = glm::uvec2(minimum, maximum); }
+            void SetIntensityRange(uint32_t minimum, uint32_t maximum) { intensityRange = glm::uvec2(minimum, maximum); }
+            void SetElevationRange(float minimum, float maximum) { elevationRange = glm::vec2(minimum, maximum); }
+            const glm::uvec2& GetSourceRange() const { return sourceRange; }
+            const glm::uvec2& GetIntensityRange() const { return intensityRange; }
+            const glm::vec2& GetElevationRange() const { return elevationRange; }
+
+            // SAME VISIBILITY (UNIFORM LOCATIONS ARE NOT COMPARED)
+            bool operator == (const AttributeMask& other) const;
+            bool operator != (const AttributeMask& other) const { return !(*this == other); }
+
+            // TAKES THE VISIBILITY OF (other) AND KEEPS THIS MASK'S UNIFORM LOCATIONS (ONE MASK PER PROGRAM)
+            void CopyVisibility(const AttributeMask& other);
+
+        private:
+            uint32_t classMask[ClassCount / 32];
+            uint32_t returnMask = 0;
+            bool lastReturnOnly = false;
+            glm::uvec2 sourceRange = glm::uvec2(0u);
+            glm::uvec2 intensityRange = glm::uvec2(0u);
+            glm::vec2 elevationRange = glm::vec2(0.0f);
+
+            // GPU UNIFORMS
+            GLint uClassMask = -1;
+            GLint uReturnMask = -1;
+            GLint uLastReturnOnly = -1;
+            GLint uSourceRange = -1;
+            GLint uIntensityRange = -1;
+            GLint uElevationRange = -1;
+    };
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <AttributeMask.hpp>
+
+namespace Renderer::Utils {
+
+    // PROCEDURAL CUBES (cube_strip.vert / cube.frag): NO VERTEX ATTRIBUTES, EACH INSTANCE IS PULLED FROM THE STORAGE BUFFERS
+    // AND ONLY ITS THREE CAMERA-FACING FACES ARE EMITTED AS ONE 9-VERTEX TRIANGLE STRIP (gl_VertexID PICKS THE CORNER).
+    // THE ELEMENT BUFFER IS THE IDENTITY (0 - 8), SO THE EXISTING INDIRECT COMMANDS DRAW IT WITH (VertexCount) INDICES
+    class CubeStripPass {
+        public:
+            static constexpr GLuint VertexCount = 9;
+
+            CubeStripPass() = default;
+            ~CubeStripPass() { Shutdown(); }
+
+            // FALSE WITHOUT THE STRIP PROGRAM OR WITHOUT VERTEX SHADER STORAGE BLOCKS (THE INDEXED CUBES STAY THE ONLY PATH)
+            bool Init(GLuint modelBuffer, GLuint intensityBuffer, GLuint attributeBuffer);
+            void Shutdown();
+
+            // BINDS THE PROGRAM, VAO AND INSTANCE BUFFERS (BINDINGS 1 - 3) AND SETS THE FRAME'S UNIFORMS,
+            // (pullInstances) READS THE INSTANCE THROUGH THE LIST AT BINDING 0 (BOUND BY THE CALLER)
+            void Begin(const glm::mat4& viewProjection, const glm::vec3& cameraPosition, float globalScale, float farDistance,
+                bool useNormals, bool pullInstances, const AttributeMask& mask, GLuint colorLUTUnit, GLuint intensityMapUnit);
+            void End() const;
+
+            // INSTANCES [0, N) WITH N TAKEN FROM (drawCommandBuffer) ON THE DEVICE (THE CUBE COMMAND'S INDEX COUNT DIFFERS)
+            void DrawIndirect(GLuint drawCommandBuffer) const;
+
+            // (count) ENTRIES OF THE PULLED LIST STARTING AT (first)
+            void DrawPulled(uint64_t first, uint64_t count) const;
+
+            // ACCESSORS
+            inline bool IsAvailable() const { return stripShader != 0; }
+            inline bool HasBaseInstance() const { return hasBaseInstance; }
+            inline GLint GetGlobalScaleLocation() const { return uGlobalScaleLocation; }
+
+        private:
+            // gl_BaseInstanceARB IN THE VERTEX SHADER (MULTI-DRAW RECORDS START PAST INSTANCE ZERO)
+            bool hasBaseInstance = false;
+
+            // VISIBILITY UNIFORMS OF THE STRIP PROGRAM (STATE COPIED FROM THE CUBE RENDERER'S MASK EVERY FRAME)
+            AttributeMask stripMask;
+
+            // INSTANCE BUFFERS (OWNED BY THE CUBE RENDERER)
+            GLuint modelBuffer = 0;
+            GLuint intensityBuffer = 0;
+            GLuint attributeBuffer = 0;
+
+            // GPU UNIFORMS
+            GLint uViewProjectionLocation = -1;
+            GLint uGlobalScaleLocation = -1;
+            GLint uCameraPositionLocation = -1;
+            GLint uFarDistanceLocation = -1;
+            GLint uUseNormalsLocation = -1;
+            GLint uPullInstancesLocation = -1;
+            GLint uFirstInstanceLocation = -1;
+            GLint uColorLUTLocation = -1;
+            GLint uIntensityMapLocation = -1;
+
+            // GPU RESOURCES
+            GLuint stripShader = 0;
+            GLuint vao = 0;
+            GLuint ebo = 0;
+            GLuint commandBuffer = 0;
+
+        private:
+            // NON-COPYABLE (OWNS GPU RESOURCES)
+            CubeStripPass(const CubeStripPass&) = delete;
+            CubeStripPass& operator = (const CubeStripPass&) = delete;
+    };
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <ElevationGrid.hpp>
+
+namespace Renderer::Utils {
+
+    // FAR-FIELD TERRAIN: THE ELEVATION GRID AS A COARSE TRIANGLE MESH (MEAN HEIGHT, MEAN RAW INTENSITY PER VERTEX)
+    // FRAGMENTS CLOSER THAN THE FAR DISTANCE ARE DISCARDED, THE CUBE SHADER DROPS INSTANCES BEYOND IT
+    class HeightmapMesh {
+        public:
+            // MAXIMUM VERTICES ALONG THE LONGER GRID AXIS (64 -> AT MOST ABOUT 8K TRIANGLES)
+            static constexpr uint32_t MeshResolution = 64;
+
+            HeightmapMesh() = default;
+            ~HeightmapMesh() { Shutdown(); }
+
+            bool Init();
+            void Shutdown();
+
+            // AVERAGES (stride x stride) GRID CELLS PER VERTEX, QUADS WITH AN EMPTY CORNER ARE LEFT OUT
+            void Build(const Spatial::ElevationGrid& grid);
+            void Clear();
+
+            // (intensityMap) AND (colorLUT) ARE THE CUBE RENDERER'S TABLES, SO BOTH PATHS SHARE ONE COLORING
+            void Render(const glm::mat4& viewProjection, const glm::vec3& cameraPosition, float nearDistance,
+                GLuint colorLUTUnit, GLuint intensityMapUnit) const;
+
+            inline bool Empty() const { return indexCount == 0; }
+            inline GLsizei GetTriangleCount() const { return indexCount / 3; }
+
+        private:
+            struct Vertex {
+                glm::vec3 position;
+                float intensity;
+            };
+
+        private:
+            GLsizei indexCount = 0;
+
+            std::vector<Vertex> vertices;
+            std::vector<GLuint> indices;
+
+            // GPU UNIFORMS
+            GLint uViewProjectionLocation = -1;
+            GLint uCameraPositionLocation = -1;
+            GLint uNearDistanceLocation = -1;
+            GLint uColorLUTLocation = -1;
+            GLint uIntensityMapLocation = -1;
+
+            // GPU RESOURCES
+            GLuint shader = 0;
+            GLuint vao = 0;
+            GLuint vbo = 0;
+            GLuint ebo = 0;
+
+        private:
+            // NON-COPYABLE (OWNS GPU RESOURCES)
+            HeightmapMesh(const HeightmapMesh&) = delete;
+            HeightmapMesh& operator = (const HeightmapMesh&) = delete;
+    };
+
+}
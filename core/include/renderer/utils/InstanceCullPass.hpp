@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <MemoryPool.hpp>
+#include <PrefixSum.hpp>
+
+namespace Renderer::Utils {
+
+    // GPU-DRIVEN PER-INSTANCE CULLING (instance_cull.comp), RUN EVERY FRAME BEFORE THE CUBES ARE DRAWN
+    // SURVIVORS OF THE FRUSTUM AND MINIMUM SCREEN-SIZE TESTS ARE APPENDED TO A VISIBLE-INDEX BUFFER AND COUNTED
+    // INTO AN INDIRECT DRAW COMMAND, SO THE HOST NEVER LEARNS THE VISIBLE SET. WITH NODES, EACH NODE'S SURVIVORS ARE
+    // COUNTED FIRST AND WRITTEN AT THEIR SCANNED OFFSET, SO THE DRAW KEEPS THE CULLER'S FRONT-TO-BACK NODE ORDER
+    class InstanceCullPass {
+        public:
+            InstanceCullPass() = default;
+            ~InstanceCullPass() { Shutdown(); }
+
+            // FALSE WITHOUT THE COMPUTE PROGRAM OR WITHOUT ENOUGH VERTEX SHADER STORAGE BLOCKS TO PULL INSTANCES
+            bool Init();
+            void Shutdown();
+
+            // TESTS THE INSTANCES OF (nodeCount) RECORDS IN (nodeCommandBuffer), OR EVERY INSTANCE DRAWN BY (drawCommandBuffer)
+            // WHEN (nodeCommandBuffer) IS ZERO. (modelBuffer) HOLDS THE INSTANCE MATRICES, CUBES HAVE AN EDGE OF (cubeSize)
+            void Run(const glm::mat4& viewProjection, float cubeSize, GLuint modelBuffer, GLuint drawCommandBuffer, uint64_t instanceCapacity,
+                GLuint nodeCommandBuffer, GLuint nodeCount, GLuint indexCount, Data::AllocationStats& loadStats);
+
+            // VISIBLE-INDEX BUFFER FOR THE VERTEX SHADER, THEN ONE INDIRECT DRAW OF (primitive) WITH THE BOUND PROGRAM AND VAO
+            void BindVisibleIndices(GLuint binding) const;
+            void Draw(GLenum primitive) const;
+
+            // ACCESSORS
+            inline bool IsAvailable() const { return cullProgram != 0; }
+            float& GetMinScreenSize() { return minScreenSize; }
+
+        private:
+            float minScreenSize = 0.5f;
+
+            // GPU UNIFORMS
+            GLint uPlanes = -1;
+            GLint uDepthRow = -1;
+            GLint uRadius = -1;
+            GLint uProjectedSize = -1;
+            GLint uMinScreenSize = -1;
+            GLint uCapacity = -1;
+            GLint uUseNodes = -1;
+            GLint uNodeCount = -1;
+            GLint uPass = -1;
+
+            // SURVIVOR OFFSETS OF THE NODES
+            PrefixSum prefixSum;
+
+            // GPU RESOURCES
+            GLuint cullProgram = 0;
+            GLuint visibleIndexSSBO = 0;
+            GLuint culledCommandBuffer = 0;
+            size_t visibleIndexCapacity = 0;
+            GLuint nodeSurvivorSSBO = 0;
+            size_t nodeSurvivorCapacity = 0;
+
+        private:
+            // NON-COPYABLE (OWNS GPU RESOURCES)
+            InstanceCullPass(const InstanceCullPass&) = delete;
+            InstanceCullPass& operator = (const InstanceCullPass&) = delete;
+    };
+
+}
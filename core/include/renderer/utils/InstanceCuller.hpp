@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <CubeInstance.hpp>
+#include <RadixSort.hpp>
+
+namespace Renderer::Utils {
+
+    // ONE RECORD OF A glMultiDrawElementsIndirect BUFFER (TIGHTLY PACKED)
+    struct NodeDrawCommand {
+        GLuint count = 0;
+        GLuint instanceCount = 0;
+        GLuint firstIndex = 0;
+        GLint baseVertex = 0;
+        GLuint baseInstance = 0;
+    };
+
+    // CPU FRUSTUM CULLING OVER CONTIGUOUS INSTANCE RANGES (NODES)
+    // INSTANCES ARE IN MORTON ORDER, SO EVERY RANGE IS A COMPACT OCTREE-LIKE CELL WITH A TIGHT BOX.
+    // VISIBLE NODES ARE SORTED FRONT TO BACK AND DRAWN WITH ONE glMultiDrawElementsIndirect (baseInstance = RANGE START)
+    class InstanceCuller {
+        public:
+            static constexpr uint32_t NodeSize = 1024;
+
+            InstanceCuller() = default;
+            ~InstanceCuller() { Shutdown(); }
+
+            void Init();
+            void Shutdown();
+
+            // DROPS EVERY NODE, THE CALLER FALLS BACK TO ITS SINGLE DRAW
+            void Clear();
+
+            // SPLITS INSTANCES [first, first + count) INTO NODES OF (NodeSize), NODES NEVER SPAN TWO CALLS
+            void AddInstances(const CubeInstance* instances, uint64_t first, uint64_t count);
+
+            // ONE NODE WITH KNOWN BOUNDS OF ITS INSTANCE CENTERS (INSTANCES THAT NEVER REACH THE HOST)
+            void AddNode(uint32_t first, uint32_t count, const glm::vec3& minimum, const glm::vec3& maximum);
+
+            // TESTS THE NODES BELOW (drawLimit) AGAINST THE FRUSTUM OF (viewProjection), CUBES REACH (halfExtent) PAST THEIR CENTERS.
+            // NODES ENTIRELY BEYOND (farDistance) ARE CULLED AS WELL (ZERO KEEPS THEM), THEN THE COMMAND BUFFER IS REWRITTEN
+            void Cull(const glm::mat4& viewProjection, const glm::vec3& cameraPosition, float halfExtent, float farDistance,
+                uint64_t drawLimit, GLuint indexCount);
+
+            // DRAWS THE LAST CULL RESULT WITH THE BOUND PROGRAM AND VAO ((indexCount) INDICES OF (primitive) PER INSTANCE)
+            void Draw(GLenum primitive) const;
+
+            // ACCESSORS
+            inline bool Empty() const { return nodeFirst.empty(); }
+            inline size_t NodeCount() const { return nodeFirst.size(); }
+            inline size_t VisibleNodeCount() const { return commands.size(); }
+            inline uint64_t GetDrawnCount() const { return drawnCount; }
+            inline uint64_t GetCulledCount() const { return culledCount; }
+            inline double GetMilliseconds() const { return milliseconds; }
+
+            // VISIBLE NODE RECORDS OF THE LAST CULL (INPUT OF THE GPU INSTANCE CULL PASS)
+            inline GLuint GetCommandBuffer() const { return commandBuffer; }
+            inline const std::vector<NodeDrawCommand>& GetCommands() const { return commands; }
+
+        private:
+            bool IsVisible(size_t node, const glm::vec4* planes, const glm::vec3& cameraPosition, float halfExtent, float farDistanceSquared) const;
+            float DistanceSquared(size_t node, const glm::vec3& cameraPosition) const;
+
+        private:
+            // NODE BOXES AS STRUCTURE OF ARRAYS (FOUR NODES PER SSE TEST), RANGES ASCENDING
+            std::vector<float> minX, minY, minZ;
+            std::vector<float> maxX, maxY, maxZ;
+            std::vector<uint32_t> nodeFirst;
+            std::vector<uint32_t> nodeCount;
+
+            // PER-FRAME SCRATCH (CAPACITY KEPT BETWEEN FRAMES)
+            std::vector<uint64_t> sortKeys;
+            std::vector<uint32_t> sortNodes;
+            Spatial::SortScratch sortScratch;
+            std::vector<NodeDrawCommand> commands;
+
+            // LAST CULL
+            uint64_t drawnCount = 0;
+            uint64_t culledCount = 0;
+            double milliseconds = 0.0;
+
+            // GPU RESOURCES
+            GLuint commandBuffer = 0;
+            size_t commandCapacity = 0;
+
+        private:
+            // NON-COPYABLE (OWNS GPU RESOURCES)
+            InstanceCuller(const InstanceCuller&) = delete;
+            InstanceCuller& operator = (const InstanceCuller&) = delete;
+    };
+
+}
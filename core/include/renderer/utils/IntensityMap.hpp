@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <CubeInstance.hpp>
+#include <IntensityEqualizer.hpp>
+#include <MemoryPool.hpp>
+#include <PrefixSum.hpp>
+
+namespace Renderer::Utils {
+
+    enum class IntensityMapping {
+        Equalize,
+        Linear,
+        PercentileClip
+    };
+
+    static inline const char* IntensityMappingNames[3] = {
+        "Histogram Equalization",
+        "Linear (Min / Max)",
+        "Percentile Clip"
+    };
+
+    // MAPS RAW UINT16 INTENSITIES TO [0, 1] THROUGH A 65536-ENTRY TABLE SAMPLED BY THE CUBE SHADER
+    // THE HISTOGRAM AND CDF OF THE DRAWN INSTANCES ARE BUILT ON THE GPU, SWITCHING MODES ONLY REWRITES THE TABLE
+    // (WITHOUT COMPUTE PROGRAMS BOTH ARE BUILT ON THE CPU FROM THE RENDERED POINTS AND THE TABLE IS UPLOADED)
+    class IntensityMap {
+        public:
+            static constexpr GLuint BinCount = 65536;
+
+            IntensityMap() = default;
+            ~IntensityMap() { Shutdown(); }
+
+            // FALSE WITHOUT COMPUTE PROGRAMS (ONLY BuildOnHost FILLS THE TABLE, A LINEAR RAMP OVER THE UINT16 RANGE UNTIL THEN)
+            bool Init();
+            void Shutdown();
+
+            // HISTOGRAM + CDF OF THE INSTANCES DRAWN BY (drawCommandBuffer), (intensityBuffer) HOLDS PACKED UINT16 VALUES
+            void Build(GLuint intensityBuffer, GLuint drawCommandBuffer, uint64_t instanceCapacity, Data::AllocationStats& loadStats);
+
+            // CPU FALLBACK OF (Build) FOR THE FIRST (count) HOST INSTANCES (THE DRAWN ONES)
+            void BuildOnHost(const CubeInstance* instances, uint64_t count, Data::AllocationStats& loadStats);
+
+            // O(65536) TABLE UPDATE, NO PER-POINT WORK (CLIP PERCENT IS CUT FROM EACH END)
+            void SetMapping(IntensityMapping mapping, float clipPercent);
+
+            void Bind(GLuint textureUnit) const;
+
+            inline bool IsAvailable() const { return histogramProgram != 0 && mapProgram != 0 && prefixSum.IsAvailable(); }
+
+        private:
+            void UpdateTable();
+
+        private:
+            IntensityMapping mapping = IntensityMapping::Equalize;
+            float clipPercent = 2.0f;
+            bool hasHistogram = false;
+            bool hasHostHistogram = false;
+
+            // CPU FALLBACK (HISTOGRAM, CDF AND THE TABLE BEFORE ITS UPLOAD)
+            Data::IntensityEqualizer hostEqualizer;
+            std::vector<float> hostTable;
+
+            // GPU UNIFORMS
+            GLint uMapMode = -1;
+            GLint uMapLowFraction = -1;
+            GLint uMapHighFraction = -1;
+
+            // GPU RESOURCES
+            GLuint histogramProgram = 0;
+            GLuint mapProgram = 0;
+            GLuint cumulativeSSBO = 0;
+            GLuint tableBuffer = 0;
+            GLuint tableTexture = 0;
+
+            PrefixSum prefixSum;
+
+        private:
+            // NON-COPYABLE (OWNS GPU RESOURCES)
+            IntensityMap(const IntensityMap&) = delete;
+            IntensityMap& operator = (const IntensityMap&) = delete;
+    };
+
+}
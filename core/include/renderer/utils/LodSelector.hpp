@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <InstanceCuller.hpp>
+#include <VoxelPyramid.hpp>
+
+namespace Renderer::Utils {
+
+    // SCREEN-SPACE-ERROR LEVEL OF DETAIL OVER THE VOXEL PYRAMID NODES
+    // EVERY VISIBLE NODE STARTS AT THE COARSEST LEVEL AND THE NODE WITH THE LARGEST PROJECTED VOXEL IS REFINED FIRST,
+    // UNTIL EVERY VOXEL IS BELOW THE ERROR THRESHOLD OR THE POINT BUDGET IS SPENT. THE BUDGET FOLLOWS THE FRAME RATE
+    class LodSelector {
+        public:
+            LodSelector() = default;
+            ~LodSelector() { Shutdown(); }
+
+            void Init();
+            void Shutdown();
+
+            // ONE FRAME-RATE SAMPLE (THE SAME SAMPLE TWICE IS IGNORED), SHRINKS THE BUDGET BELOW THE TARGET
+            // AND GROWS IT ABOVE THE TARGET WHILE THE BUDGET WAS WHAT STOPPED THE REFINEMENT
+            void AdaptBudget(float fps);
+
+            // PICKS A LEVEL PER NODE AND REWRITES THE COMMAND BUFFER, CUBES ARE AT LEAST (globalScale) WIDE.
+            // NODES ENTIRELY BEYOND (farDistance) ARE SKIPPED (ZERO KEEPS THEM)
+            void Select(const Spatial::VoxelPyramid& pyramid, const glm::mat4& viewProjection, const glm::vec3& cameraPosition,
+                float globalScale, float farDistance, GLuint indexCount);
+
+            // ONE MULTI-DRAW OF (primitive) PER SELECTED LEVEL WITH THE BOUND PROGRAM AND VAO, CUBES SCALED TO THE LEVEL'S VOXEL SIZE
+            void Draw(GLenum primitive, GLint scaleLocation) const;
+
+            // ACCESSORS
+            float& GetErrorThreshold() { return errorThreshold; }
+            float& GetTargetFps() { return targetFps; }
+            inline uint64_t GetPointBudget() const { return pointBudget; }
+            inline uint64_t GetSelectedCount() const { return selectedCount; }
+            inline bool IsBudgetLimited() const { return budgetLimited; }
+            inline size_t VisibleNodeCount() const { return visibleNodes.size(); }
+            inline double GetMilliseconds() const { return milliseconds; }
+
+        private:
+            // COMMANDS [first, first + count) OF THE COMMAND BUFFER SHARE ONE LEVEL
+            struct LevelGroup {
+                uint32_t level = 0;
+                float scale = 1.0f;
+                size_t first = 0;
+                size_t count = 0;
+            };
+
+        private:
+            float errorThreshold = 1.0f;
+            float targetFps = 60.0f;
+
+            // ADAPTIVE BUDGET (ZERO UNTIL THE FIRST SELECTION, THEN CLAMPED TO THE PYRAMID'S COARSEST AND BUFFERED COUNTS)
+            uint64_t pointBudget = 0;
+            float lastFps = 0.0f;
+            bool budgetLimited = false;
+
+            // PER-FRAME SCRATCH (CAPACITY KEPT BETWEEN FRAMES)
+            std::vector<uint32_t> visibleNodes;
+            std::vector<float> nodeDistances;
+            std::vector<uint32_t> nodeLevels;
+            std::vector<uint32_t> drawOrder;
+            std::vector<NodeDrawCommand> commands;
+            std::vector<LevelGroup> groups;
+
+            // LAST SELECTION
+            uint64_t selectedCount = 0;
+            double milliseconds = 0.0;
+
+            // GPU RESOURCES
+            GLuint commandBuffer = 0;
+            size_t commandCapacity = 0;
+
+        private:
+            // NON-COPYABLE (OWNS GPU RESOURCES)
+            LodSelector(const LodSelector&) = delete;
+            LodSelector& operator = (const LodSelector&) = delete;
+    };
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <AttributeMask.hpp>
+#include <InstanceCuller.hpp>
+
+namespace Renderer::Utils {
+
+    // HOW THE RENDERED POINTS ARE DRAWN
+    enum class RenderMode {
+        Cubes,
+        Splats
+    };
+
+    static inline const char* RenderModeNames[2] = {
+        "Cubes",
+        "Splats"
+    };
+
+    // SPLAT FOOTPRINT (PARABOLOID SPLATS ALSO BULGE TOWARD THE CAMERA IN THE DEPTH BUFFER)
+    enum class SplatShape {
+        Round,
+        Paraboloid
+    };
+
+    static inline const char* SplatShapeNames[2] = {
+        "Round",
+        "Paraboloid"
+    };
+
+    // SCREEN-ALIGNED POINT SPLATS (splat.vert / splat.frag), ONE GL_POINTS VERTEX PER RENDERED POINT
+    // READS THE CUBE RENDERER'S INSTANCE BUFFERS AS PER-VERTEX ATTRIBUTES (ONLY TRANSLATION, INTENSITY AND ATTRIBUTES),
+    // SO SWITCHING MODES NEVER TOUCHES THE DATA. SPLATS COVER AS MANY PIXELS AS A CUBE OF THE SAME SCALE WOULD
+    class PointSplatPass {
+        public:
+            PointSplatPass() = default;
+            ~PointSplatPass() { Shutdown(); }
+
+            // FALSE WITHOUT THE SPLAT PROGRAM (THE CUBES STAY THE ONLY MODE)
+            bool Init(GLuint modelBuffer, GLuint intensityBuffer, GLuint attributeBuffer);
+            void Shutdown();
+
+            // BINDS THE PROGRAM AND VAO AND SETS THE FRAME'S UNIFORMS (TABLES ARE THE CUBE RENDERER'S, ALREADY BOUND)
+            void Begin(const glm::mat4& viewProjection, const glm::vec3& cameraPosition, float globalScale, float farDistance,
+                bool useNormals, const AttributeMask& mask, GLuint colorLUTUnit, GLuint intensityMapUnit);
+            void End() const;
+
+            // POINTS [first, first + count), OR THE VISIBLE NODES OF THE LAST CULL (FRONT TO BACK)
+            void Draw(uint64_t first, uint64_t count) const;
+            void DrawNodes(const InstanceCuller& culler);
+
+            // ACCESSORS
+            inline bool IsAvailable() const { return splatShader != 0; }
+            int& GetShape() { return shape; }
+            float& GetMaxPointSize() { return maxPointSize; }
+            inline float GetPointSizeLimit() const { return pointSizeLimit; }
+
+        private:
+            int shape = static_cast<int>(SplatShape::Round);
+            float maxPointSize = 64.0f;
+            float pointSizeLimit = 1.0f;
+
+            // VISIBILITY UNIFORMS OF THE SPLAT PROGRAM (STATE COPIED FROM THE CUBE RENDERER'S MASK EVERY FRAME)
+            AttributeMask splatMask;
+
+            // NODE RANGES AS glMultiDrawArrays INPUT (CAPACITY KEPT BETWEEN FRAMES)
+            std::vector<GLint> nodeFirsts;
+            std::vector<GLsizei> nodeCounts;
+
+            // GPU UNIFORMS
+            GLint uViewProjectionLocation = -1;
+            GLint uGlobalScaleLocation = -1;
+            GLint uCameraPositionLocation = -1;
+            GLint uFarDistanceLocation = -1;
+            GLint uPixelsPerUnitLocation = -1;
+            GLint uMaxPointSizeLocation = -1;
+            GLint uUseNormalsLocation = -1;
+            GLint uShapeLocation = -1;
+            GLint uColorLUTLocation = -1;
+            GLint uIntensityMapLocation = -1;
+
+            // GPU RESOURCES
+            GLuint splatShader = 0;
+            GLuint vao = 0;
+
+        private:
+            // NON-COPYABLE (OWNS GPU RESOURCES)
+            PointSplatPass(const PointSplatPass&) = delete;
+            PointSplatPass& operator = (const PointSplatPass&) = delete;
+    };
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <MemoryPool.hpp>
+
+namespace Renderer::Utils {
+
+    // IN-PLACE GPU PREFIX SUM OVER A UINT SHADER STORAGE BUFFER
+    // EACH WORKGROUP SCANS 256 VALUES, GROUP TOTALS ARE SCANNED RECURSIVELY AND ADDED BACK
+    class PrefixSum {
+        public:
+            static constexpr GLuint GroupSize = 256;
+
+            PrefixSum() = default;
+            ~PrefixSum() { Shutdown(); }
+
+            // RETURNS FALSE WHEN THE COMPUTE PROGRAMS COULD NOT BE BUILT
+            bool Init();
+            void Shutdown();
+
+            // SCANS (count) VALUES AT THE START OF (buffer), ISSUES ITS OWN MEMORY BARRIERS
+            void Scan(GLuint buffer, GLuint count, bool inclusive, Data::AllocationStats& loadStats);
+
+            inline bool IsAvailable() const { return localProgram != 0 && addProgram != 0; }
+
+        private:
+            void ScanLevel(GLuint buffer, GLintptr offset, GLuint count, bool inclusive, size_t level);
+
+        private:
+            // GROUP TOTALS OF EVERY LEVEL, PACKED INTO ONE BUFFER
+            std::vector<GLintptr> levelOffsets;
+            size_t scratchCapacity = 0;
+            GLint offsetAlignment = 256;
+
+            // GPU UNIFORMS
+            GLint uLocalCount = -1;
+            GLint uLocalInclusive = -1;
+            GLint uAddCount = -1;
+
+            // GPU RESOURCES
+            GLuint localProgram = 0;
+            GLuint addProgram = 0;
+            GLuint scratchSSBO = 0;
+
+        private:
+            // NON-COPYABLE (OWNS GPU RESOURCES)
+            PrefixSum(const PrefixSum&) = delete;
+            PrefixSum& operator = (const PrefixSum&) = delete;
+    };
+
+}
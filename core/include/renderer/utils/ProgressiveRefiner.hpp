@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <MemoryPool.hpp>
+
+namespace Renderer::Utils {
+
+    // INTERACTION-AWARE PROGRESSIVE DRAWING WITHOUT A HIERARCHY
+    // INSTANCES ARE VISITED IN A STRATIFIED ORDER (GOLDEN-RATIO STRIDE OVER THE MORTON-ORDERED BUFFER), SO EVERY PREFIX
+    // OF THE ORDER COVERS THE WHOLE CLOUD EVENLY. WHILE THE VIEW MOVES ONLY THE FIRST BATCH IS DRAWN, AT REST THE
+    // FOLLOWING BATCHES ARE ADDED FRAME BY FRAME INTO A PERSISTENT COLOR AND DEPTH TARGET THAT IS COPIED TO THE SCREEN
+    class ProgressiveRefiner {
+        public:
+            ProgressiveRefiner() = default;
+            ~ProgressiveRefiner() { Shutdown(); }
+
+            // FALSE WITHOUT THE COMPOSITE PROGRAM OR WITHOUT VERTEX SHADER STORAGE BLOCKS (cube.vert PULLS THE ORDER)
+            bool Init();
+            void Shutdown();
+
+            // THE NEXT FRAME STARTS FROM THE FIRST BATCH AGAIN (DRAWN DATA OR ITS APPEARANCE CHANGED)
+            inline void Invalidate() { restart = true; }
+
+            // DRAW ORDER OF INSTANCES [0, instanceCount), REWRITTEN ONLY WHEN THE COUNT CHANGES
+            void UpdateOrder(uint64_t instanceCount, Data::AllocationStats& loadStats);
+
+            // BINDS THE TARGET (CLEARED WHEN THE VIEW OR VIEWPORT CHANGED) AND RETURNS THE ORDER SLOTS [first, first + count)
+            // TO DRAW THIS FRAME, COUNT IS ZERO ONCE EVERY INSTANCE IS ACCUMULATED
+            void Begin(const glm::mat4& viewProjection, uint64_t& first, uint64_t& count);
+
+            // RESTORES THE PREVIOUS FRAMEBUFFER AND DEPTH-TESTS THE TARGET'S COLOR AND DEPTH INTO IT (GL_LESS, EARLIER AND
+            // LATER DRAWS BOTH KEEP WHAT IS IN FRONT)
+            void End();
+
+            // ORDER BUFFER FOR THE VERTEX SHADER (INSTANCE = order[first + gl_InstanceID])
+            void BindOrder(GLuint binding) const;
+
+            // ACCESSORS
+            inline bool IsAvailable() const { return compositeShader != 0; }
+            inline bool IsMoving() const { return moving; }
+            inline uint64_t GetAccumulatedCount() const { return accumulatedCount; }
+            inline uint64_t GetInstanceCount() const { return orderCount; }
+            int& GetBatchSize() { return batchSize; }
+
+        private:
+            void ResizeTarget(GLsizei width, GLsizei height);
+
+        private:
+            // INSTANCES PER FRAME (THE WHOLE DRAW WHILE MOVING, ONE INCREMENT AT REST)
+            int batchSize = 1000000;
+
+            // ACCUMULATION STATE
+            glm::mat4 lastViewProjection = glm::mat4(0.0f);
+            uint64_t accumulatedCount = 0;
+            bool restart = true;
+            bool moving = false;
+
+            // PREVIOUS FRAMEBUFFER AND VIEWPORT (RESTORED BY End)
+            GLint previousFramebuffer = 0;
+            GLint previousViewport[4] = {};
+
+            // GPU UNIFORMS
+            GLint uColorLocation = -1;
+            GLint uDepthLocation = -1;
+            GLint uViewportOriginLocation = -1;
+
+            // GPU RESOURCES
+            GLuint compositeShader = 0;
+            GLuint vao = 0;
+            GLuint framebuffer = 0;
+            GLuint colorTexture = 0;
+            GLuint depthTexture = 0;
+            GLsizei targetWidth = 0;
+            GLsizei targetHeight = 0;
+            GLuint orderSSBO = 0;
+            uint64_t orderCount = 0;
+            size_t orderCapacity = 0;
+
+        private:
+            // NON-COPYABLE (OWNS GPU RESOURCES)
+            ProgressiveRefiner(const ProgressiveRefiner&) = delete;
+            ProgressiveRefiner& operator = (const ProgressiveRefiner&) = delete;
+    };
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glad/glad.h>
+
+#include <PointSplatPass.hpp>
+
+namespace Renderer::Utils {
+
+    // GPU TIME OF THE POINT DRAW IN EVERY RENDER MODE (GL_TIME_ELAPSED QUERIES, READ BACK WITHOUT STALLING)
+    // WHILE RUNNING, THE RENDERER DRAWS EVERY POINT WITH THE PLAIN PATH OF THE MODE GIVEN BY (GetMode), SO THE MODES
+    // ARE COMPARED ON THE SAME POINTS AND VIEW
+    class RenderBenchmark {
+        public:
+            static constexpr uint32_t ModeCount = 2;
+            static constexpr uint32_t WarmupFrames = 10;
+            static constexpr uint32_t MeasuredFrames = 120;
+            static constexpr uint32_t QueryCount = 8;
+
+            // AVERAGES OF THE MEASURED FRAMES OF ONE MODE
+            struct Result {
+                uint32_t frameCount = 0;
+                double milliseconds = 0.0;
+                double pointsPerSecond = 0.0;
+                double verticesPerSecond = 0.0;
+            };
+
+            RenderBenchmark() = default;
+            ~RenderBenchmark() { Shutdown(); }
+
+            void Init();
+            void Shutdown();
+
+            // RESTARTS WITH THE FIRST MODE, EARLIER RESULTS ARE DROPPED
+            void Start();
+
+            // STOPS WITHOUT RESULTS (E.G. THE POINTS WERE CLEARED), QUERIES STILL IN FLIGHT ARE NEVER READ
+            void Cancel();
+            inline bool IsRunning() const { return running; }
+            inline bool HasResults() const { return finished; }
+            inline RenderMode GetMode() const { return static_cast<RenderMode>(modeIndex); }
+            inline const Result& GetResult(RenderMode mode) const { return results[static_cast<uint32_t>(mode)]; }
+
+            // BRACKET THE POINT DRAW OF ONE FRAME, (pointCount) POINTS OF (verticesPerPoint) VERTICES EACH WERE SUBMITTED
+            // IN THE CURRENT MODE (36 INDEXED OR 9 PROCEDURAL FOR CUBES, 1 FOR SPLATS)
+            void BeginFrame();
+            void EndFrame(uint64_t pointCount, uint32_t verticesPerPoint);
+
+        private:
+            // RETIRES EVERY FINISHED QUERY, THEN STOPS ONCE THE LAST MODE IS DONE AND NOTHING IS PENDING
+            void Collect();
+            void Finish();
+
+        private:
+            struct Query {
+                GLuint id = 0;
+                bool pending = false;
+                uint32_t mode = 0;
+                uint64_t pointCount = 0;
+                uint64_t vertexCount = 0;
+            };
+
+            struct Totals {
+                uint32_t frameCount = 0;
+                uint64_t nanoseconds = 0;
+                uint64_t pointCount = 0;
+                uint64_t vertexCount = 0;
+            };
+
+        private:
+            bool running = false;
+            bool finished = false;
+            bool issuing = false;
+            uint32_t modeIndex = 0;
+            uint32_t modeFrames = 0;
+            int activeQuery = -1;
+
+            Query queries[QueryCount];
+            Totals totals[ModeCount];
+            Result results[ModeCount];
+
+        private:
+            // NON-COPYABLE (OWNS GPU RESOURCES)
+            RenderBenchmark(const RenderBenchmark&) = delete;
+            RenderBenchmark& operator = (const RenderBenchmark&) = delete;
+    };
+
+}
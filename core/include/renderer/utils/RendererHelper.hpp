@@ -6,11 +6,16 @@
 
 #include <glad/glad.h>
 #include <SDL3/SDL.h>
+#include <glm/glm.hpp>
 
 namespace Renderer {
 
     std::string LoadTextFile(const std::string& filepath);
 
+    // SHADER SOURCE WITH EVERY #include "FILE" LINE REPLACED BY THAT FILE (PATH RELATIVE TO THE INCLUDING SHADER)
+    // USED BY BOTH PROGRAM BUILDERS, SHARED SNIPPETS LIVE IN assets/shaders/common
+    std::string LoadShaderSource(const std::string& filepath);
+
     GLuint CreateShader(const std::string& source, GLenum type);
 
     bool ValidateShaderProgram(GLuint shaderProgram);
@@ -19,4 +24,17 @@ namespace Renderer {
 
     GLuint CreateComputeShaderProgram(const std::string& computeShaderPath);
 
+    // SPLITS LARGE 1D DISPATCHES OVER Y (GROUP COUNTS PER DIMENSION ARE LIMITED TO 65535)
+    // SHADERS RECOVER THE LINEAR GROUP AS: gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x
+    void DispatchCompute1D(GLuint groupCount);
+
+    // TRUE WHEN THE CURRENT CONTEXT EXPOSES THE NAMED EXTENSION
+    bool HasExtension(const char* name);
+
+    // INWARD CLIP PLANES (LEFT, RIGHT, BOTTOM, TOP, NEAR, FAR) OF A VIEW-PROJECTION, NORMALIZED SO THEY GIVE DISTANCES
+    void ExtractFrustumPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6]);
+
+    // PIXELS SPANNED BY ONE WORLD UNIT AT CLIP W = 1 IN THE CURRENT VIEWPORT (SCREEN-SPACE SIZE = SIZE * SCALE / W)
+    float PixelsPerUnit(const glm::mat4& viewProjection);
+
 }
\ No newline at end of file
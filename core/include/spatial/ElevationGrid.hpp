@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <MemoryPool.hpp>
+#include <PointStore.hpp>
+
+namespace Spatial {
+
+    // DIGITAL ELEVATION MODEL OF THE STORED POINTS: MIN / MAX / MEAN HEIGHT AND MEAN INTENSITY PER SQUARE XY CELL
+    // CELL (column, row) COVERS [origin + (column, row) * cellSize, origin + (column + 1, row + 1) * cellSize), ROW 0 IS THE MINIMUM Y EDGE
+    class ElevationGrid {
+        public:
+            static constexpr uint32_t TileSize = 64;
+            static constexpr uint32_t MaxResolution = 8192;
+
+            ElevationGrid() = default;
+
+            // (resolution) CELLS ALONG THE LONGER HORIZONTAL AXIS
+            // EVERY THREAD ACCUMULATES INTO ITS OWN TILES, OPENED ON FIRST TOUCH (MORTON-ORDERED BLOCKS KEEP EACH
+            // THREAD'S RANGE COMPACT, SO A THREAD OPENS ABOUT 1 / THREADS OF THE TILES), THEN TILES ARE MERGED IN PARALLEL
+            bool Build(const Data::PointStore& pointStore, uint32_t resolution, Data::AllocationStats& loadStats);
+
+            void Clear();
+
+            // ACCESSORS (VALUES OF EMPTY CELLS ARE ZERO, CHECK THE COUNT)
+            inline bool Empty() const { return counts.empty(); }
+            inline uint32_t GetColumns() const { return columns; }
+            inline uint32_t GetRows() const { return rows; }
+            inline float GetCellSize() const { return cellSize; }
+            inline const glm::vec2& GetOrigin() const { return origin; }
+            inline uint64_t GetFilledCount() const { return filledCount; }
+            inline size_t CellIndex(uint32_t column, uint32_t row) const { return size_t(row) * columns + column; }
+            inline const std::vector<uint32_t>& GetCounts() const { return counts; }
+            inline const std::vector<float>& GetMinimums() const { return minimums; }
+            inline const std::vector<float>& GetMaximums() const { return maximums; }
+            inline const std::vector<float>& GetMeans() const { return means; }
+            inline const std::vector<float>& GetIntensities() const { return intensities; }
+
+        private:
+            struct CellAccumulator {
+                float minimum;
+                float maximum;
+                double heightSum;
+                uint64_t intensitySum;
+                uint32_t count;
+            };
+
+            // PER-THREAD TILE STORAGE (SLOT -1 WHEN THE THREAD NEVER TOUCHED THE TILE)
+            struct ThreadTiles {
+                std::vector<int32_t> slots;
+                std::vector<CellAccumulator> cells;
+            };
+
+        private:
+            uint32_t columns = 0;
+            uint32_t rows = 0;
+            float cellSize = 0.0f;
+            glm::vec2 origin = glm::vec2(0.0f);
+            uint64_t filledCount = 0;
+
+            std::vector<uint32_t> counts;
+            std::vector<float> minimums;
+            std::vector<float> maximums;
+            std::vector<float> means;
+            std::vector<float> intensities;
+
+            // POOLED WORK BUFFERS (KEPT BETWEEN LOADS)
+            std::vector<ThreadTiles> threadTiles;
+    };
+
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <CubeInstance.hpp>
+#include <MemoryPool.hpp>
+#include <PointStore.hpp>
+
+namespace Spatial {
+
+    struct KdNeighbor {
+        float distanceSquared = 0.0f;
+        uint32_t index = 0;
+    };
+
+    struct KdRayHit {
+        float distance = 0.0f;
+        uint32_t index = 0;
+    };
+
+    // BALANCED KD-TREE OVER POINT POSITIONS (MEDIAN SPLITS ALONG THE AXIS OF WIDEST SPREAD)
+    // NODES ARE IMPLICIT (CHILDREN OF NODE i ARE 2i+1 AND 2i+2) WITH ONE BOUNDING BOX EACH, POINTS ARE STORED IN LEAF
+    // ORDER NEXT TO THEIR SOURCE INDEX, SO A LEAF IS ONE CONTIGUOUS RUN AND EVERY LEVEL IS PARTITIONED IN PARALLEL
+    // QUERIES ARE CONST AND SAFE FROM SEVERAL THREADS
+    class KdTree {
+        public:
+            static constexpr uint32_t LeafSize = 16;
+
+            struct Entry {
+                glm::vec3 position;
+                uint32_t index;
+            };
+
+            // RESIDENT COST PER INDEXED POINT (ENTRY PLUS ITS SHARE OF THE NODE BOXES AND LEAF OFFSETS)
+            static constexpr double BytesPerPoint = double(sizeof(Entry)) + 2.0 * 2.0 * sizeof(glm::vec3) / LeafSize + 8.0 / LeafSize;
+
+            KdTree() = default;
+
+            // SOURCE INDICES ARE STORE ORDER (AT MOST UINT32_MAX POINTS)
+            void Build(const Data::PointStore& pointStore, Data::AllocationStats& loadStats);
+            void Build(const std::vector<CubeInstance>& points, Data::AllocationStats& loadStats);
+
+            // DROPS EVERY ENTRY WHOSE FLAG (SOURCE ORDER) IS ZERO AND RENUMBERS THE REST TO MATCH A SOURCE COMPACTED
+            // THE SAME WAY, THE SPLITS ARE KEPT AND ONLY THE BOXES ARE REFITTED (NO REBUILD)
+            void RemovePoints(const std::vector<uint8_t>& keepFlags);
+
+            // RELEASES THE ENTRIES (THE TREE IS AS LARGE AS AN UNCOMPRESSED STORE)
+            void Clear();
+
+            // UP TO (k) NEAREST POINTS TO (position), CLOSEST FIRST, RETURNS HOW MANY WERE FOUND
+            // (positions), WHEN GIVEN, RECEIVES THE NEIGHBOR POSITIONS IN THE SAME ORDER
+            uint32_t FindNearest(const glm::vec3& position, uint32_t k, KdNeighbor* neighbors, glm::vec3* positions = nullptr) const;
+
+            // SINGLE NEAREST POINT (LEAVES ARE SCANNED FOUR ENTRIES AT A TIME WITH SSE WHEN AVAILABLE)
+            bool FindClosest(const glm::vec3& position, KdNeighbor& nearest) const;
+
+            // EVERY POINT WITHIN (radius) OF (position), CLOSEST FIRST
+            void FindInRadius(const glm::vec3& position, float radius, std::vector<KdNeighbor>& neighbors) const;
+
+            // EVERY POINT WITHIN (halfWidth) OF THE XY SEGMENT (start, end) AT ANY HEIGHT (A VERTICAL SLAB), UNORDERED
+            // SUBTREES ARE SEARCHED IN PARALLEL, NODES FULLY INSIDE THE SLAB ARE COPIED WITHOUT PER-POINT TESTS
+            void FindInSlab(const glm::vec2& start, const glm::vec2& end, float halfWidth, std::vector<uint64_t>& indices) const;
+
+            // FIRST POINT ALONG THE RAY WHOSE SPHERE OF (pointRadius) THE RAY ENTERS ((direction) MUST BE NORMALIZED)
+            bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float pointRadius, KdRayHit& hit) const;
+
+            // ACCESSORS (ENTRIES IN LEAF ORDER, NEIGHBORING ENTRIES ARE NEIGHBORS IN SPACE)
+            inline size_t Size() const { return entries.size(); }
+            inline bool Empty() const { return entries.empty(); }
+            inline const Entry& GetEntry(size_t slot) const { return entries[slot]; }
+            inline glm::vec3 GetMinimum() const { return nodeMinimums.empty() ? glm::vec3(0.0f) : nodeMinimums[0]; }
+            inline glm::vec3 GetMaximum() const { return nodeMaximums.empty() ? glm::vec3(0.0f) : nodeMaximums[0]; }
+            size_t ResidentBytes() const;
+
+        private:
+            // SLAB IN XY: CENTER, UNIT AXIS ALONG THE SEGMENT AND ITS NORMAL, HALF EXTENTS ALONG BOTH
+            struct Slab {
+                float centerX, centerY;
+                float axisX, axisY;
+                float normalX, normalY;
+                float halfLength, halfWidth;
+            };
+
+            // SUBTREES SEARCHED AS SEPARATE PARALLEL TASKS (2^SlabTaskLevel OF THEM)
+            static constexpr uint32_t SlabTaskLevel = 6;
+
+            void BuildNodes(Data::AllocationStats& loadStats);
+
+            // FITS THE LEAF BOXES TO THEIR ENTRIES, THEN EVERY INTERNAL BOX TO ITS CHILDREN
+            void RefitBoxes();
+
+            // ENTRY RANGE OF A NODE (THE RUN OF LEAVES BELOW IT)
+            inline void NodeRange(size_t node, uint32_t level, size_t& begin, size_t& end) const {
+                const size_t levelIndex = node + 1 - (size_t(1) << level);
+                const size_t span = size_t(1) << (depth - level);
+                begin = leafOffsets[levelIndex * span];
+                end = leafOffsets[(levelIndex + 1) * span];
+            }
+
+            inline float BoxDistanceSquared(size_t node, const glm::vec3& position) const {
+                const glm::vec3 delta = glm::max(glm::max(nodeMinimums[node] - position, position - nodeMaximums[node]), glm::vec3(0.0f));
+                return delta.x * delta.x + delta.y * delta.y + delta.z * delta.z;
+            }
+
+            void SearchNearest(size_t node, uint32_t level, const glm::vec3& position, uint32_t k, KdNeighbor* neighbors, glm::vec3* positions,
+                uint32_t& found) const;
+            void SearchClosest(size_t node, uint32_t level, const glm::vec3& position, KdNeighbor& nearest) const;
+            void SearchRadius(size_t node, uint32_t level, const glm::vec3& position, float radiusSquared, std::vector<KdNeighbor>& neighbors) const;
+            void SearchSlab(size_t node, uint32_t level, const Slab& slab, std::vector<uint64_t>& indices) const;
+            void SearchRay(size_t node, uint32_t level, const glm::vec3& origin, const glm::vec3& inverseDirection, const glm::vec3& direction,
+                float pointRadius, KdRayHit& hit, bool& found) const;
+
+        private:
+            uint32_t depth = 0;
+
+            // POOLED WORK BUFFERS (KEPT BETWEEN LOADS UNLESS CLEARED)
+            std::vector<Entry> entries;
+            std::vector<size_t> leafOffsets;
+            std::vector<uint8_t> splitAxes;
+            std::vector<glm::vec3> nodeMinimums;
+            std::vector<glm::vec3> nodeMaximums;
+            std::vector<uint32_t> indexRemap;
+    };
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+#include <glm/glm.hpp>
+
+namespace Spatial {
+
+    // 21 BITS PER AXIS, INTERLEAVED INTO A 63-BIT KEY (X IN BIT 0, Y IN BIT 1, Z IN BIT 2)
+    static constexpr uint32_t MortonAxisBits = 21;
+    static constexpr uint32_t MortonKeyBits = 3 * MortonAxisBits;
+    static constexpr uint32_t MortonAxisMax = (1u << MortonAxisBits) - 1;
+
+    // SCALAR (MAGIC BITS) FALLBACK
+    inline uint64_t SpreadBits(uint32_t value) {
+        uint64_t x = value & MortonAxisMax;
+        x = (x | x << 32) & 0x001F00000000FFFFull;
+        x = (x | x << 16) & 0x001F0000FF0000FFull;
+        x = (x | x << 8) & 0x100F00F00F00F00Full;
+        x = (x | x << 4) & 0x10C30C30C30C30C3ull;
+        x = (x | x << 2) & 0x1249249249249249ull;
+        return x;
+    }
+
+    inline uint32_t CompactBits(uint64_t value) {
+        uint64_t x = value & 0x1249249249249249ull;
+        x = (x | x >> 2) & 0x10C30C30C30C30C3ull;
+        x = (x | x >> 4) & 0x100F00F00F00F00Full;
+        x = (x | x >> 8) & 0x001F0000FF0000FFull;
+        x = (x | x >> 16) & 0x001F00000000FFFFull;
+        x = (x | x >> 32) & MortonAxisMax;
+        return static_cast<uint32_t>(x);
+    }
+
+    inline uint64_t MortonEncode(uint32_t x, uint32_t y, uint32_t z) {
+        return SpreadBits(x) | (SpreadBits(y) << 1) | (SpreadBits(z) << 2);
+    }
+
+    inline glm::uvec3 MortonDecode(uint64_t key) {
+        return glm::uvec3(CompactBits(key), CompactBits(key >> 1), CompactBits(key >> 2));
+    }
+
+    // INDEX OF THE HIGHEST SET BIT OF A NON-ZERO VALUE
+    // TWO KEYS SHARE THEIR CELL AT LEVEL (L) WHILE HighestBit(a ^ b) < 3 * L
+    inline uint32_t HighestBit(uint64_t value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index = 0;
+        _BitScanReverse64(&index, value);
+        return static_cast<uint32_t>(index);
+#else
+        return 63u - static_cast<uint32_t>(__builtin_clzll(value));
+#endif
+    }
+
+    // MAPS WORLD POSITIONS ONTO THE 2^21 INTEGER GRID OF A BOUNDING BOX
+    struct MortonGrid {
+        glm::vec3 origin = glm::vec3(0.0f);
+        float scale = 1.0f;     // GRID CELLS PER WORLD UNIT (SAME FOR EVERY AXIS)
+
+        static MortonGrid FromBounds(const glm::vec3& minimum, const glm::vec3& maximum);
+
+        inline glm::uvec3 Cell(const glm::vec3& position) const {
+            glm::vec3 cell = glm::clamp((position - origin) * scale, glm::vec3(0.0f), glm::vec3(float(MortonAxisMax)));
+            return glm::uvec3(cell);
+        }
+    };
+
+    // TRUE WHEN THE CPU SUPPORTS BMI2 (PDEP IS USED FOR KEY GENERATION)
+    bool HasBmi2();
+
+    // BATCH KEY GENERATION, USES PDEP WHEN AVAILABLE AND THE MAGIC BITS FALLBACK OTHERWISE
+    // (positions) IS STRIDED SO IT CAN READ STRAIGHT FROM POINT STRUCTS
+    void ComputeMortonKeys(const glm::vec3* positions, size_t stride, size_t count, const MortonGrid& grid, uint64_t* keys);
+
+}
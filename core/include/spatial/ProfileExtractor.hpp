@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <KdTree.hpp>
+#include <MemoryPool.hpp>
+#include <PointStore.hpp>
+#include <RadixSort.hpp>
+
+namespace Spatial {
+
+    struct ProfilePoint {
+        float along = 0.0f;     // DISTANCE FROM THE SEGMENT START
+        float height = 0.0f;    // STORED Z
+        uint16_t intensity = 0;
+    };
+
+    // ONE CANVAS CELL OF A RASTERIZED PROFILE
+    struct ProfileCell {
+        uint32_t count = 0;
+        float meanIntensity = 0.0f;
+    };
+
+    // CROSS-SECTION THROUGH THE INDEXED POINTS: EVERY POINT IN A VERTICAL SLAB AROUND AN XY SEGMENT,
+    // PROJECTED ONTO (DISTANCE ALONG THE SEGMENT, HEIGHT)
+    class ProfileExtractor {
+        public:
+            ProfileExtractor() = default;
+
+            // RETURNS THE NUMBER OF POINTS WITHIN (width / 2) OF THE SEGMENT ((index) MUST INDEX (pointStore))
+            size_t Extract(const KdTree& index, const Data::PointStore& pointStore, const glm::vec2& start, const glm::vec2& end, float width);
+
+            // BINS THE POINTS INTO (columns x rows) CELLS OVER [0, LENGTH] x [MIN HEIGHT, MAX HEIGHT], ROW 0 AT THE TOP
+            // A CANVAS DRAWS ONE RECTANGLE PER OCCUPIED CELL, SO ITS COST FOLLOWS ITS SIZE, NOT THE POINT COUNT
+            void Rasterize(uint32_t columns, uint32_t rows);
+
+            void Clear();
+
+            // ACCESSORS
+            inline bool Empty() const { return points.empty(); }
+            inline const std::vector<ProfilePoint>& GetPoints() const { return points; }
+            inline const std::vector<ProfileCell>& GetCells() const { return cells; }
+            inline uint32_t GetColumns() const { return columns; }
+            inline uint32_t GetRows() const { return rows; }
+            inline float GetLength() const { return length; }
+            inline float GetMinHeight() const { return minHeight; }
+            inline float GetMaxHeight() const { return maxHeight; }
+            inline uint16_t GetMinIntensity() const { return minIntensity; }
+            inline uint16_t GetMaxIntensity() const { return maxIntensity; }
+            inline double GetExtractMilliseconds() const { return extractMilliseconds; }
+
+        private:
+            float length = 0.0f;
+            float minHeight = 0.0f;
+            float maxHeight = 0.0f;
+            uint16_t minIntensity = 0;
+            uint16_t maxIntensity = 0;
+            double extractMilliseconds = 0.0;
+
+            // RASTER OF THE LAST (Rasterize) CALL, REBUILT ONLY WHEN THE POINTS OR THE SIZE CHANGE
+            uint32_t columns = 0;
+            uint32_t rows = 0;
+            bool rasterValid = false;
+
+            // POOLED WORK BUFFERS (KEPT BETWEEN CUTS)
+            std::vector<ProfilePoint> points;
+            std::vector<ProfileCell> cells;
+            std::vector<uint64_t> hitIndices;
+            std::vector<uint32_t> hitSlots;
+            SortScratch sortScratch;
+            std::vector<uint32_t> threadCounts;
+            std::vector<float> threadSums;
+    };
+
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Spatial {
+
+    // PING-PONG BUFFERS FOR (RadixSort), KEEP ONE AROUND TO REUSE ITS CAPACITY
+    struct SortScratch {
+        std::vector<uint64_t> keys;
+        std::vector<uint32_t> values;
+    };
+
+    // STABLE PARALLEL LSD RADIX SORT OF (keys, values) BY THE LOW (keyBits) BITS OF EACH KEY
+    // 8-BIT DIGITS, PASSES WHERE EVERY KEY SHARES THE SAME DIGIT ARE SKIPPED
+    // THE RESULT IS THE SAME FOR ANY THREAD COUNT (0 = ALL HARDWARE THREADS)
+    void RadixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values, SortScratch& scratch, uint32_t keyBits = 64, unsigned threadCount = 0);
+
+    // FILLS (order) WITH THE PERMUTATION THAT SORTS (keys), (keys) IS SORTED IN PLACE
+    void SortedOrder(std::vector<uint64_t>& keys, std::vector<uint32_t>& order, SortScratch& scratch, uint32_t keyBits = 64, unsigned threadCount = 0);
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <CubeInstance.hpp>
+#include <MemoryPool.hpp>
+#include <PointStore.hpp>
+#include <RadixSort.hpp>
+
+namespace Spatial {
+
+    // MULTI-RESOLUTION VOXEL LEVELS OVER ONE ORDERED POINT BUFFER
+    // LEVEL (L) HAS CELLS OF (baseSize * 2^L) AND KEEPS THE FIRST POINT (MORTON ORDER) OF EVERY OCCUPIED CELL.
+    // POINTS ARE ORDERED COARSEST-RANK FIRST, SO EVERY LEVEL IS THE PREFIX [0, LevelPointCount(L)) OF THE BUFFER.
+    // WITHIN A RANK THE POINTS STAY IN MORTON ORDER, SO THE POINTS OF ONE OCTREE CELL (LOD NODE) AND RANK ARE ONE RANGE
+    class VoxelPyramid {
+        public:
+            static constexpr uint32_t MaxLevels = 16;
+            static constexpr uint32_t MaxNodes = 4096;
+
+            // BUFFER RANGE OF ONE NODE'S POINTS OF ONE RANK
+            struct NodeRange {
+                uint32_t first = 0;
+                uint32_t count = 0;
+            };
+
+            VoxelPyramid() = default;
+
+            // WRITES THE LEVELS THAT FIT IN (maxOutput) POINTS INTO (output), ONE-TIME COST AFTER A LOAD
+            void Build(const Data::PointStore& pointStore, float baseSize, uint32_t levelCount, uint64_t maxOutput,
+                std::vector<CubeInstance>& output, Data::AllocationStats& loadStats);
+            void Clear();
+
+            // ACCESSORS
+            inline bool Empty() const { return levelCounts.empty(); }
+            inline uint32_t LevelCount() const { return static_cast<uint32_t>(levelCounts.size()); }
+            inline uint64_t LevelPointCount(uint32_t level) const { return levelCounts[level]; }
+            inline float LevelSize(uint32_t level) const { return cellSize * float(1u << level); }
+
+            // FINEST LEVEL WHOSE POINTS ARE IN THE OUTPUT BUFFER (FINER ONES DID NOT FIT THE BUDGET)
+            inline uint32_t FinestLevel() const { return finestLevel; }
+
+            // LOD NODES: OCTREE CELLS AT LEAST AS COARSE AS THE COARSEST LEVEL, AT MOST (MaxNodes) OF THEM
+            // DRAWING A NODE AT LEVEL (L) DRAWS ITS RANGES OF EVERY RANK >= L
+            inline size_t NodeCount() const { return nodeMinimum.size(); }
+            inline const glm::vec3& NodeMinimum(size_t node) const { return nodeMinimum[node]; }
+            inline const glm::vec3& NodeMaximum(size_t node) const { return nodeMaximum[node]; }
+            inline const NodeRange& GetNodeRange(size_t node, uint32_t rank) const { return nodeRanges[node * levelCounts.size() + rank]; }
+            inline uint64_t NodePointCount(size_t node, uint32_t level) const { return nodeLevelCounts[node * levelCounts.size() + level]; }
+
+        private:
+            void BuildNodes(const std::vector<CubeInstance>& output, int coarsestLevel, Data::AllocationStats& loadStats);
+
+        private:
+            float cellSize = 0.0f;
+            uint32_t finestLevel = 0;
+            std::vector<uint64_t> levelCounts;
+
+            // PER NODE: BOUNDS OF ITS BUFFERED POINTS, ONE RANGE PER RANK, POINTS DRAWN PER LEVEL (BOTH LEVEL-MINOR)
+            std::vector<glm::vec3> nodeMinimum;
+            std::vector<glm::vec3> nodeMaximum;
+            std::vector<NodeRange> nodeRanges;
+            std::vector<uint64_t> nodeLevelCounts;
+
+            // POOLED WORK BUFFERS (KEPT BETWEEN LOADS)
+            std::vector<uint64_t> mortonKeys;
+            std::vector<uint32_t> sortedOrder;
+            SortScratch sortScratch;
+    };
+
+}
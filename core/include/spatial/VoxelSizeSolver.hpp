@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <MemoryPool.hpp>
+#include <PointStore.hpp>
+#include <RadixSort.hpp>
+
+namespace Spatial {
+
+    struct VoxelSizeSolution {
+        float voxelSize = 0.0f;
+        uint64_t estimatedCount = 0;
+        uint32_t iterations = 0;
+    };
+
+    // SOLVES FOR THE VOXEL SIZE THAT KEEPS ABOUT (targetCount) OCCUPIED VOXELS
+    // MORTON-PREFIX COUNTS OF A STRIDED SAMPLE BRACKET THE SIZE BETWEEN TWO POWERS OF TWO, THEN SECANT STEPS IN
+    // LOG-LOG SPACE REFINE IT AGAINST HYPERLOGLOG COUNTS OF THE FILTER'S OWN GRID (ONE STREAMING PASS EACH, NO SORT)
+    class VoxelSizeSolver {
+        public:
+            static constexpr uint64_t BracketSamples = 1 << 18;
+            static constexpr uint64_t MinSamplesPerCell = 4;
+            static constexpr uint32_t MaxIterations = 8;
+            static constexpr double Tolerance = 0.02;
+
+            // 2^14 REGISTERS: ~0.8% STANDARD ERROR
+            static constexpr uint32_t SketchBits = 14;
+            static constexpr uint32_t SketchRegisters = 1u << SketchBits;
+
+            VoxelSizeSolver() = default;
+
+            // (minPoint) IS THE FILTER'S VOXEL ORIGIN, CELLS USE THE SAME ROUNDING AS VoxelFilter::VoxelCoord
+            VoxelSizeSolution Solve(const Data::PointStore& pointStore, const glm::vec3& minPoint, const glm::vec3& maxPoint,
+                uint64_t targetCount, float minVoxelSize, Data::AllocationStats& loadStats);
+
+        private:
+            void DrawSample(const Data::PointStore& pointStore, Data::AllocationStats& loadStats);
+
+            // OCCUPIED CELL ESTIMATES AT (cellSize * 2^L) FOR EVERY MORTON LEVEL, ONE SORT OF THE SAMPLE
+            // RETURNS THE FINEST LEVEL WITH (MinSamplesPerCell) SAMPLES PER CELL (FINER ONES ARE UNDERSAMPLED)
+            uint32_t CountMortonLevels(const glm::vec3& minPoint, const glm::vec3& maxPoint, float& cellSize, std::vector<uint64_t>& levelCounts);
+
+            // OCCUPIED VOXEL ESTIMATE OVER EVERY STORED POINT
+            uint64_t CountVoxels(const Data::PointStore& pointStore, float voxelSize, const glm::vec3& minPoint, const glm::vec3& maxPoint);
+
+        private:
+            uint64_t pointCount = 0;
+            uint64_t sampleStride = 1;
+
+            // POOLED WORK BUFFERS (KEPT BETWEEN LOADS)
+            std::vector<glm::vec3> samples;
+            std::vector<uint64_t> sampleKeys;
+            std::vector<uint32_t> sampleOrder;
+            SortScratch sortScratch;
+            std::vector<uint8_t> sketches;
+    };
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace Parallel {
+
+    // WORKER COUNT USED WHEN A CALLER DOES NOT ASK FOR ONE
+    inline unsigned ThreadCount() {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // SPLITS [0, count) INTO ONE CONTIGUOUS RANGE PER THREAD
+    // CALLBACK SIGNATURE: (size_t begin, size_t end, unsigned threadIndex)
+    template <typename Callable>
+    void For(size_t count, Callable&& callback, unsigned threadCount = 0) {
+        if (count == 0) return;
+        if (threadCount == 0) threadCount = ThreadCount();
+        threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, count));
+
+        if (threadCount == 1) {
+            callback(size_t(0), count, 0u);
+            return;
+        }
+
+        std::vector<std::thread> workers;
+        workers.reserve(threadCount - 1);
+        const size_t chunk = (count + threadCount - 1) / threadCount;
+        for (unsigned thread = 1; thread < threadCount; ++thread) {
+            size_t begin = std::min(count, thread * chunk);
+            size_t end = std::min(count, begin + chunk);
+            workers.emplace_back([&callback, begin, end, thread]() { callback(begin, end, thread); });
+        }
+
+        // CALLING THREAD TAKES THE FIRST RANGE
+        callback(size_t(0), std::min(count, chunk), 0u);
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    // SAME SPLIT AS (For), RETURNS THE RANGE OWNED BY A THREAD
+    inline void Range(size_t count, unsigned threadCount, unsigned threadIndex, size_t& begin, size_t& end) {
+        const size_t chunk = (count + threadCount - 1) / threadCount;
+        begin = std::min(count, threadIndex * chunk);
+        end = std::min(count, begin + chunk);
+    }
+
+}
@@ -1,3 +1,4 @@
+#include <cmath>
 #include <memory>
 #include <vector>
 #include <string>
@@ -5,6 +6,7 @@
 #include <SDL3/SDL.h>
 #include <SDL3_ttf/SDL_ttf.h>
 #include <glad/glad.h>
+#include <glm/glm.hpp>
 #include <imgui.h>
 #include <imgui_impl_sdl3.h>
 #include <imgui_impl_opengl3.h>
@@ -50,6 +52,9 @@ namespace Application {
         appContext.cubeRenderer = std::make_unique<CubeRenderer>();
         appContext.cubeRenderer->Init(Data::ColorRampType::HeatMap);
 
+        appContext.budgetGovernor = std::make_unique<Data::BudgetGovernor>();
+        appContext.budgetGovernor->UpdateMemoryInfo();
+
         TTF_Init();
         TTF_Font* textFont = TTF_OpenFont("../assets/fonts/Roboto-Regular.ttf", 18.0f);
         appContext.textRenderer = std::make_unique<TextRenderer>();
@@ -87,6 +92,20 @@ namespace Application {
                 break;
             case SDL_EVENT_MOUSE_MOTION:
                 appContext.activeCamera->ProcessMouseMotion(event->motion.xrel, event->motion.yrel);
+                if (appContext.profileDragging) {
+                    DragProfile(event->motion.x, event->motion.y);
+                }
+                break;
+            case SDL_EVENT_MOUSE_BUTTON_DOWN:
+                if (event->button.button == SDL_BUTTON_LEFT) {
+                    if (appContext.profileMode) BeginProfile(event->button.x, event->button.y);
+                    else PickPoint(event->button.x, event->button.y);
+                }
+                break;
+            case SDL_EVENT_MOUSE_BUTTON_UP:
+                if (event->button.button == SDL_BUTTON_LEFT) {
+                    appContext.profileDragging = false;
+                }
                 break;
         }
 
@@ -98,6 +117,82 @@ namespace Application {
         return SDL_APP_CONTINUE;
     }
 
+    bool App::MouseRay(float x, float y, glm::vec3& origin, glm::vec3& direction) {
+        // NOT WHILE THE READER THREAD OWNS THE POINT STORE, NOT THROUGH THE GUI
+        if (appContext.isReadingFlag.load(std::memory_order_acquire)) return false;
+        const bool freeCameraActive = appContext.activeCamera == appContext.freeCamera.get();
+        if (!freeCameraActive && ImGui::GetIO().WantCaptureMouse) return false;
+
+        // THE FREE CAMERA HIDES THE CURSOR, PICK THROUGH THE SCREEN CENTER INSTEAD
+        int windowWidth = 0;
+        int windowHeight = 0;
+        SDL_GetWindowSize(window, &windowWidth, &windowHeight);
+        if (freeCameraActive) {
+            x = 0.5f * float(windowWidth);
+            y = 0.5f * float(windowHeight);
+        }
+
+        appContext.activeCamera->ScreenRay(x, y, windowWidth, windowHeight, origin, direction);
+        return true;
+    }
+
+    void App::PickPoint(float x, float y) {
+        glm::vec3 origin;
+        glm::vec3 direction;
+        if (!MouseRay(x, y, origin, direction)) return;
+
+        // RENDERED CUBES ARE UNIT CUBES SCALED BY THE GLOBAL SCALE, PICK WITHIN HALF OF ONE
+        appContext.hasPickedPoint = appContext.cubeRenderer->PickPoint(origin, direction, 0.5f * appContext.globalScale, appContext.pickedPoint);
+    }
+
+    void App::BeginProfile(float x, float y) {
+        glm::vec3 origin;
+        glm::vec3 direction;
+        if (!MouseRay(x, y, origin, direction)) return;
+
+        // ANCHOR ON THE POINT UNDER THE MOUSE, OTHERWISE ON THE STORE'S CENTER PLANE (Z = 0)
+        PickedPoint picked;
+        glm::vec3 anchor;
+        if (appContext.cubeRenderer->PickPoint(origin, direction, 0.5f * appContext.globalScale, picked)) {
+            anchor = picked.position;
+        } else {
+            if (direction.z >= 0.0f) return;
+            anchor = origin + direction * (-origin.z / direction.z);
+        }
+
+        appContext.profileStart = anchor;
+        appContext.profileEnd = anchor;
+        appContext.profileDragging = true;
+        appContext.profile.Clear();
+    }
+
+    void App::DragProfile(float x, float y) {
+        glm::vec3 origin;
+        glm::vec3 direction;
+        if (!MouseRay(x, y, origin, direction)) return;
+
+        // END POINT ON THE HORIZONTAL PLANE THROUGH THE ANCHOR
+        const float height = appContext.profileStart.z;
+        if (std::fabs(direction.z) < 1.0e-6f) return;
+        const float distance = (height - origin.z) / direction.z;
+        if (distance <= 0.0f) return;
+        appContext.profileEnd = origin + direction * distance;
+        appContext.profileDirty = true;
+    }
+
+    void App::CutProfile() {
+        appContext.profileDirty = false;
+        const size_t count = appContext.profile.Extract(
+            appContext.cubeRenderer->GetPointIndex(),
+            appContext.cubeRenderer->GetPointStore(),
+            glm::vec2(appContext.profileStart.x, appContext.profileStart.y),
+            glm::vec2(appContext.profileEnd.x, appContext.profileEnd.y),
+            appContext.profileWidth
+        );
+        SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "PROFILE: %zu POINTS OVER %.2f IN %.2f MS",
+            count, appContext.profile.GetLength(), appContext.profile.GetExtractMilliseconds());
+    }
+
     void App::RenderScene(float deltaTime) {
         // DRAW BACKGROUND/CLEAR FRAMEBUFFER
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
@@ -106,8 +201,11 @@ namespace Application {
         appContext.activeCamera->ProcessKeyboard(deltaTime);
         appContext.activeCamera->Update(deltaTime);
 
+        // THE LEVEL-OF-DETAIL BUDGET FOLLOWS THE MEASURED FRAME RATE
+        appContext.cubeRenderer->UpdateFrameRate(appContext.textRenderer->GetFPS());
         appContext.cubeRenderer->Render(
             appContext.activeCamera->GetViewProjection(),
+            appContext.activeCamera->GetPosition(),
             appContext.globalScale
         );
 
@@ -116,10 +214,38 @@ namespace Application {
             appContext.isReadingFlag.store(false, std::memory_order_release);
             appContext.doneReadingFlag.store(false, std::memory_order_release);
 
+            // TRUE EXTENT FROM THE DATASET STATISTICS (THE HEADER BOUNDS ARE NOT ALWAYS TIGHT)
+            glm::vec3 minimum;
+            glm::vec3 maximum;
+            if (appContext.cubeRenderer->GetPointBounds(minimum, maximum)) {
+                float radius = 0.5f * glm::length(maximum - minimum);
+                appContext.freeCamera->UpdateBounds(0.5f * (minimum + maximum), radius);
+                appContext.orbitalCamera->UpdateBounds(0.5f * (minimum + maximum), radius);
+            }
+
             appContext.cubeRenderer->VoxelDownsample();
+            appContext.budgetGovernor->UpdateVoxelSize(MAIN_DATASET, appContext.cubeRenderer->GetVoxelSize());
 
-            appContext.cubeRenderer->NormalizeIntensities();
+            // RAW INTENSITIES ARE UPLOADED AS-IS, THE GPU BUILDS THE INTENSITY MAPPING FROM THEM
             appContext.cubeRenderer->UpdateBuffers();
+            appContext.cubeRenderer->ReportLoadAllocations();
+        }
+
+        // SHOW THE CHANGES ONCE THE REFERENCE IS READ AND COMPARED
+        if (appContext.doneComparingFlag.load(std::memory_order_acquire)) {
+            appContext.isReadingFlag.store(false, std::memory_order_release);
+            appContext.doneComparingFlag.store(false, std::memory_order_release);
+
+            // DEFAULT COLOR RANGE: 95% OF THE POINTS BELOW THE TOP OF THE RAMP
+            const Filters::ChangeDetector& detector = appContext.changeDetector;
+            appContext.changeRange = detector.GetPercentileDistance() > 0.0f ? detector.GetPercentileDistance() : 1.0f;
+            appContext.showChanges = detector.HasDistances();
+            UserInterface::UpdateChangeView(&appContext);
+        }
+
+        // RE-CUT THE PROFILE ONCE PER FRAME, HOWEVER MANY MOTION EVENTS ARRIVED
+        if (appContext.profileDirty && !appContext.isReadingFlag.load(std::memory_order_acquire)) {
+            CutProfile();
         }
 
         appContext.textRenderer->UpdateFPS();
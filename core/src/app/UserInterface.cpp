@@ -1,7 +1,10 @@
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <string>
 #include <cmath>
+#include <cstdio>
+#include <cfloat>
 #include <thread>
 
 #include <glm/glm.hpp>
@@ -12,14 +15,47 @@
 
 #include <App.hpp>
 #include <AppContext.hpp>
+#include <AttributeMask.hpp>
+#include <ChangeDetector.hpp>
+#include <ColorRamp.hpp>
 #include <CubeRenderer.hpp>
+#include <ElevationGrid.hpp>
+#include <GeoTiff.hpp>
+#include <InstanceCullPass.hpp>
+#include <InstanceCuller.hpp>
+#include <IntensityMap.hpp>
+#include <KdTree.hpp>
 #include <LazReader.hpp>
+#include <LodSelector.hpp>
+#include <NormalEstimator.hpp>
 #include <OrbitalCamera.hpp>
+#include <PointSplatPass.hpp>
+#include <ProgressiveRefiner.hpp>
+#include <ProfileExtractor.hpp>
+#include <RenderBenchmark.hpp>
+#include <StatisticalOutlierFilter.hpp>
+#include <VoxelFilter.hpp>
+#include <VoxelPyramid.hpp>
 
 namespace UserInterface {
 
     static bool showTooltipIcons = false;
     static int selectedColorRampIndex = 0;
+    static int selectedIntensityMappingIndex = 0;
+    static float intensityClipPercent = 2.0f;
+
+    // DROPS THE REFERENCE SCAN (THE CALLER CLEARS OR RELOADS THE MAIN STORE, SO THE INTENSITIES ARE NOT SWAPPED BACK)
+    static void ClearChanges(Application::AppContext* appContext) {
+        appContext->changeDetector.Clear();
+        appContext->referencePath.clear();
+        appContext->showChanges = false;
+        appContext->changesApplied = false;
+        appContext->swappedIntensities.clear();
+        appContext->budgetGovernor->RemoveDataset(REFERENCE_DATASET);
+        appContext->budgetGovernor->SetAuxiliaryHostBytes(MAIN_DATASET, 0);
+        appContext->cubeRenderer->SetIntensityMapping(
+            static_cast<Renderer::Utils::IntensityMapping>(selectedIntensityMappingIndex), intensityClipPercent);
+    }
 
     void SetCustomTheme() {
         ImGuiStyle& style = ImGui::GetStyle();
@@ -130,21 +166,46 @@ namespace UserInterface {
 
                     std::shared_ptr<CustomReader::LazReader> reader = std::make_shared<CustomReader::LazReader>(
                         appContext->filepath,
-                        appContext->cubeRenderer.get()
+                        appContext->cubeRenderer.get(),
+                        &appContext->datasetStats
                     );
                     std::shared_ptr<LazHeader> header = reader->GetHeader(); 
 
-                    // UPDATE CAMERA BOUNDING BOX
-                    glm::vec3 minDistance(header->minX, header->minY, header->minZ);
-                    glm::vec3 maxDistance(header->maxX, header->maxY, header->maxZ);
-                    glm::vec3 center = 0.5f * (minDistance + maxDistance);
-                    float radius = 0.5f * glm::length(maxDistance - minDistance);
+                    // A REFERENCE FROM THE PREVIOUS FILE NO LONGER APPLIES (AND NO LONGER NEEDS ITS SHARE OF THE BUDGET)
+                    ClearChanges(appContext);
+
+                    // UPDATE GPU INSTANCE BUFFER SIZES
+                    // PLAN DECIMATION AND RENDER BUDGET FOR THE AVAILABLE RAM/VRAM
+                    bool compressPoints = appContext->cubeRenderer->GetCompressPoints();
+                    const Data::DatasetBudget& budget = appContext->budgetGovernor->PlanDataset(
+                        MAIN_DATASET,
+                        header->pointCount(),
+                        appContext->cubeRenderer->GetPointStore().EstimatedBytesPerPoint(compressPoints)
+                            + (appContext->cubeRenderer->GetBuildPointIndex() ? Spatial::KdTree::BytesPerPoint : 0.0)
+                            // UNCOMPRESSED POINTS HOLD THEIR NORMAL IN THE INSTANCE PADDING, COMPRESSED STORES KEEP A SEPARATE STREAM
+                            + (appContext->cubeRenderer->GetEstimateNormals() && compressPoints ? Filters::NormalEstimator::BytesPerPoint : 0.0)
+                    );
+                    reader->SetDecimationStep(budget.decimationStep);
+                    appContext->cubeRenderer->SetRenderBudget(budget.renderBudget);
+
+                    // UPDATE CAMERA BOUNDING BOX (TRUE EXTENT WHEN A PREVIOUS LOAD CACHED IT, HEADER BOUNDS OTHERWISE)
+                    appContext->datasetStats = Data::DatasetStats();
+                    appContext->hasPickedPoint = false;
+                    appContext->profile.Clear();
+                    glm::dvec3 minDistance(header->minX, header->minY, header->minZ);
+                    glm::dvec3 maxDistance(header->maxX, header->maxY, header->maxZ);
+                    if (reader->LoadCachedStats()) {
+                        minDistance = appContext->datasetStats.minimum;
+                        maxDistance = appContext->datasetStats.maximum;
+                    }
+                    float radius = 0.5f * static_cast<float>(glm::length(maxDistance - minDistance));
                     appContext->freeCamera->UpdateBounds(glm::vec3(0.0f), radius);
                     appContext->orbitalCamera->UpdateBounds(glm::vec3(0.0f), radius);
 
-                    // UPDATE GPU INSTANCE BUFFER SIZES
+                    // NOTE: POINT STORE QUANTIZATION MATCHES THE FILE PRECISION (LAS SCALE FACTORS)
+                    float quantization = static_cast<float>(std::min({ header->scaleX, header->scaleY, header->scaleZ }));
                     appContext->cubeRenderer->Clear();
-                    appContext->cubeRenderer->UpdateBufferSize(header->pointCount());
+                    appContext->cubeRenderer->UpdateBufferSize(budget.loadedPointCount, quantization);
 
                     // READ LAS/LAZ FILE DATA (SEPERATE THREAD)
                     // NOTE: CANNOT UPDATE OPENGL BUFFERS OUTSIDE OF MAIN THREAD
@@ -183,12 +244,78 @@ namespace UserInterface {
             ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(style.FramePadding.x, style.FramePadding.y));
             if (ImGui::Button("X")) {
                 appContext->filepath.clear();
+                appContext->datasetStats = Data::DatasetStats();
+                appContext->hasPickedPoint = false;
+                appContext->profile.Clear();
+                ClearChanges(appContext);
                 appContext->cubeRenderer->Clear();
+                appContext->budgetGovernor->RemoveDataset(MAIN_DATASET);
             }
             ImGui::PopStyleVar();
 
             ImGui::PopStyleColor(3);
             ImGui::EndDisabled();
+
+            // IN-MEMORY POINT COMPRESSION (APPLIES TO THE NEXT SELECTED FILE)
+            ImGui::BeginDisabled(isButtonDisabled);
+            TooltipInfoIcon(showTooltipIcons, "Keeps loaded points block-compressed in memory, applies to the next selected file.", appContext);
+            ImGui::Checkbox("Compress Points", &appContext->cubeRenderer->GetCompressPoints());
+
+            // VOXEL DOWNSAMPLING BACKEND (APPLIES TO THE NEXT SELECTED FILE)
+            TooltipInfoIcon(showTooltipIcons, "Runs voxel downsampling as a compute shader or on all CPU threads, applies to the next selected file.", appContext);
+            ImGui::Combo("Voxel Backend", &appContext->cubeRenderer->GetVoxelBackend(), Filters::VoxelBackendNames, IM_ARRAYSIZE(Filters::VoxelBackendNames));
+
+            // VOXEL PYRAMID (APPLIES TO THE NEXT SELECTED FILE)
+            TooltipInfoIcon(showTooltipIcons, "Precomputes every voxel level after loading so the level can be switched instantly, applies to the next selected file.", appContext);
+            ImGui::Checkbox("Voxel Pyramid", &appContext->cubeRenderer->GetUseVoxelPyramid());
+
+            // VOXEL SIZE SOLVER (APPLIES TO THE NEXT SELECTED FILE)
+            TooltipInfoIcon(showTooltipIcons, "Solves for the voxel size that keeps about the target point count, applies to the next selected file.", appContext);
+            ImGui::Checkbox("Solve Voxel Size", &appContext->cubeRenderer->GetSolveVoxelSize());
+            if (appContext->cubeRenderer->GetSolveVoxelSize()) {
+                // ZERO (OR THE FULL BUDGET) FOLLOWS THE RENDER BUDGET OF THE NEXT FILE, THE FILTER CAPS LARGER TARGETS
+                uint64_t& targetPointCount = appContext->cubeRenderer->GetTargetPointCount();
+                const uint64_t renderBudget = appContext->cubeRenderer->GetRenderBudget();
+                uint64_t shownCount = targetPointCount > 0 && (renderBudget == 0 || targetPointCount < renderBudget) ? targetPointCount : renderBudget;
+                const uint64_t step = 100000;
+                const uint64_t fastStep = 1000000;
+
+                TooltipInfoIcon(showTooltipIcons, "Points the solver aims for, defaults to the render budget and is capped by it.", appContext);
+                if (ImGui::InputScalar("Target Points", ImGuiDataType_U64, &shownCount, &step, &fastStep)) {
+                    targetPointCount = renderBudget > 0 && shownCount >= renderBudget ? 0 : shownCount;
+                }
+            }
+
+            // SPATIAL INDEX FOR POINT PICKING (APPLIES TO THE NEXT SELECTED FILE)
+            TooltipInfoIcon(showTooltipIcons, "Builds a spatial index after loading so points can be picked with the mouse, applies to the next selected file.", appContext);
+            ImGui::Checkbox("Point Picking", &appContext->cubeRenderer->GetBuildPointIndex());
+
+            // STATISTICAL OUTLIER REMOVAL (APPLIES TO THE NEXT SELECTED FILE)
+            TooltipInfoIcon(showTooltipIcons, "Drops points whose mean distance to their nearest neighbors is far above average, applies to the next selected file.", appContext);
+            ImGui::Checkbox("Remove Outliers", &appContext->cubeRenderer->GetRemoveOutliers());
+            if (appContext->cubeRenderer->GetRemoveOutliers()) {
+                Filters::StatisticalOutlierFilter& outlierFilter = appContext->cubeRenderer->GetOutlierFilter();
+                int neighborCount = static_cast<int>(outlierFilter.GetNeighborCount());
+                float multiplier = outlierFilter.GetMultiplier();
+
+                TooltipInfoIcon(showTooltipIcons, "Number of nearest neighbors averaged per point.", appContext);
+                if (ImGui::SliderInt("Outlier Neighbors", &neighborCount, 2, 32)) outlierFilter.SetNeighborCount(uint32_t(neighborCount));
+                TooltipInfoIcon(showTooltipIcons, "Standard deviations above the mean neighbor distance before a point is dropped.", appContext);
+                if (ImGui::SliderFloat("Outlier Sigma", &multiplier, 0.5f, 5.0f, "%.1f")) outlierFilter.SetMultiplier(multiplier);
+            }
+
+            // NORMAL ESTIMATION (APPLIES TO THE NEXT SELECTED FILE, CACHED NEXT TO IT)
+            TooltipInfoIcon(showTooltipIcons, "Estimates a surface normal for every point from its nearest neighbors for shading, applies to the next selected file.", appContext);
+            ImGui::Checkbox("Estimate Normals", &appContext->cubeRenderer->GetEstimateNormals());
+            if (appContext->cubeRenderer->GetEstimateNormals()) {
+                Filters::NormalEstimator& normalEstimator = appContext->cubeRenderer->GetNormalEstimator();
+                int neighborCount = static_cast<int>(normalEstimator.GetNeighborCount());
+                TooltipInfoIcon(showTooltipIcons, "Number of nearest neighbors fitted with a plane per point.", appContext);
+                if (ImGui::SliderInt("Normal Neighbors", &neighborCount, 3, int(Filters::NormalEstimator::MaxNeighbors))) {
+                    normalEstimator.SetNeighborCount(uint32_t(neighborCount));
+                }
+            }
+            ImGui::EndDisabled();
         });
     }
 
@@ -203,7 +330,523 @@ namespace UserInterface {
             if (ImGui::Combo("Gradient", &selectedColorRampIndex, Data::ColorRampNames, IM_ARRAYSIZE(Data::ColorRampNames))) {
                 Data::ColorRampType selectedRamp = static_cast<Data::ColorRampType>(selectedColorRampIndex);
                 appContext->cubeRenderer->UpdateColorRamp(selectedRamp);
-                appContext->cubeRenderer->UpdateBuffers();
+            }
+
+            // INTENSITY MAPPING (ONLY THE LOOKUP TABLE IS REWRITTEN, POINT DATA IS NOT TOUCHED)
+            // THE CHANGE VIEW NEEDS THE LINEAR TABLE, THE SELECTION IS RESTORED WHEN IT IS TURNED OFF
+            ImGui::BeginDisabled(appContext->changesApplied);
+            TooltipInfoIcon(showTooltipIcons, "Selects how raw intensities are spread over the gradient.", appContext);
+            bool mappingChanged = ImGui::Combo("Intensity Mapping", &selectedIntensityMappingIndex,
+                Renderer::Utils::IntensityMappingNames, IM_ARRAYSIZE(Renderer::Utils::IntensityMappingNames));
+            Renderer::Utils::IntensityMapping selectedMapping = static_cast<Renderer::Utils::IntensityMapping>(selectedIntensityMappingIndex);
+            if (selectedMapping == Renderer::Utils::IntensityMapping::PercentileClip) {
+                TooltipInfoIcon(showTooltipIcons, "Percent of the points clipped from each end of the intensity range.", appContext);
+                mappingChanged |= ImGui::SliderFloat("Clip Percent", &intensityClipPercent, 0.0f, 25.0f, "%.1f%%");
+            }
+            if (mappingChanged) {
+                appContext->cubeRenderer->SetIntensityMapping(selectedMapping, intensityClipPercent);
+            }
+            ImGui::EndDisabled();
+
+            // NORMAL SHADING (ONLY WHEN THE LOADED POINTS HAVE NORMALS)
+            if (appContext->cubeRenderer->GetPointStore().HasNormals()) {
+                const Filters::NormalEstimator& normalEstimator = appContext->cubeRenderer->GetNormalEstimator();
+                TooltipInfoIcon(showTooltipIcons, "Shades the cubes by their estimated surface normal.", appContext);
+                ImGui::Checkbox("Shade Normals", &appContext->cubeRenderer->GetShadeNormals());
+                if (normalEstimator.GetNanosecondsPerPoint() > 0.0) {
+                    ImGui::Text("Normals: %.1f ms (%.0f ns/point, %.0f bytes/point)", normalEstimator.GetMilliseconds(),
+                        normalEstimator.GetNanosecondsPerPoint(), Filters::NormalEstimator::BytesPerPoint);
+                } else {
+                    ImGui::Text("Normals: cached, loaded in %.1f ms (%.0f bytes/point)", normalEstimator.GetMilliseconds(),
+                        Filters::NormalEstimator::BytesPerPoint);
+                }
+            }
+
+            // RENDER MODE (SPLATS USE THE SAME BUFFERS, ONLY FRUSTUM CULLING APPLIES TO THEM)
+            if (appContext->cubeRenderer->HasSplats()) {
+                TooltipInfoIcon(showTooltipIcons, "Draws each point as a cube or as a single screen-space splat.", appContext);
+                ImGui::Combo("Render Mode", &appContext->cubeRenderer->GetRenderMode(),
+                    Renderer::Utils::RenderModeNames, IM_ARRAYSIZE(Renderer::Utils::RenderModeNames));
+                if (appContext->cubeRenderer->GetRenderMode() == static_cast<int>(Renderer::Utils::RenderMode::Splats)) {
+                    Renderer::Utils::PointSplatPass& splatPass = appContext->cubeRenderer->GetSplatPass();
+                    TooltipInfoIcon(showTooltipIcons, "Round splats are flat discs, paraboloid splats are shaded and bulge toward the camera.", appContext);
+                    ImGui::Combo("Splat Shape", &splatPass.GetShape(), Renderer::Utils::SplatShapeNames, IM_ARRAYSIZE(Renderer::Utils::SplatShapeNames));
+                    TooltipInfoIcon(showTooltipIcons, "Largest splat diameter on screen, close points are clamped to it.", appContext);
+                    ImGui::SliderFloat("Max Splat Size", &splatPass.GetMaxPointSize(), 1.0f, splatPass.GetPointSizeLimit(), "%.0f px");
+                }
+
+                // PROCEDURAL CUBES (SAME IMAGE, FEWER VERTICES)
+                if (appContext->cubeRenderer->HasStripCubes() && appContext->cubeRenderer->GetRenderMode() == static_cast<int>(Renderer::Utils::RenderMode::Cubes)) {
+                    TooltipInfoIcon(showTooltipIcons, "Builds each cube in the vertex shader from its three faces toward the camera instead of the full indexed cube.", appContext);
+                    ImGui::Checkbox("Procedural Cubes", &appContext->cubeRenderer->GetUseStripCubes());
+                }
+
+                // BENCHMARK (EVERY MODE IN TURN OVER THE CURRENT VIEW, GPU TIME ONLY)
+                const Renderer::Utils::RenderBenchmark& benchmark = appContext->cubeRenderer->GetRenderBenchmark();
+                TooltipInfoIcon(showTooltipIcons, "Times every point drawn in each render mode from the current view, keep the camera still while it runs.", appContext);
+                ImGui::BeginDisabled(benchmark.IsRunning() || !appContext->cubeRenderer->HasDrawInstances());
+                if (ImGui::Button("Run Benchmark")) appContext->cubeRenderer->RunRenderBenchmark();
+                ImGui::EndDisabled();
+                if (benchmark.IsRunning()) {
+                    ImGui::SameLine();
+                    ImGui::Text("Measuring %s...", Renderer::Utils::RenderModeNames[static_cast<int>(benchmark.GetMode())]);
+                } else if (benchmark.HasResults()) {
+                    for (int mode = 0; mode < IM_ARRAYSIZE(Renderer::Utils::RenderModeNames); ++mode) {
+                        const Renderer::Utils::RenderBenchmark::Result& result = benchmark.GetResult(static_cast<Renderer::Utils::RenderMode>(mode));
+                        ImGui::Text("%s: %.2f ms, %.1f M points/s, %.1f M vertices/s", Renderer::Utils::RenderModeNames[mode],
+                            result.milliseconds, result.pointsPerSecond * 1e-6, result.verticesPerSecond * 1e-6);
+                    }
+                }
+            }
+
+            // FRUSTUM CULLING (COUNTS OF THE LAST FRAME)
+            TooltipInfoIcon(showTooltipIcons, "Skips groups of cubes outside the view and draws the rest front to back.", appContext);
+            ImGui::Checkbox("Frustum Culling", &appContext->cubeRenderer->GetFrustumCulling());
+            const Renderer::Utils::InstanceCuller& culler = appContext->cubeRenderer->GetInstanceCuller();
+            if (appContext->cubeRenderer->GetFrustumCulling() && !culler.Empty()) {
+                ImGui::Text("Drawn: %llu, Culled: %llu", static_cast<unsigned long long>(culler.GetDrawnCount()),
+                    static_cast<unsigned long long>(culler.GetCulledCount()));
+                ImGui::Text("Nodes: %zu / %zu visible (%.2f ms)", culler.VisibleNodeCount(), culler.NodeCount(), culler.GetMilliseconds());
+            }
+
+            // PER-INSTANCE GPU CULLING (THE SURVIVOR COUNT NEVER LEAVES THE DEVICE)
+            if (appContext->cubeRenderer->HasGpuCulling()) {
+                TooltipInfoIcon(showTooltipIcons, "Tests every cube on the GPU before drawing and drops cubes smaller than the minimum size on screen.", appContext);
+                ImGui::Checkbox("GPU Culling", &appContext->cubeRenderer->GetGpuCulling());
+                if (appContext->cubeRenderer->GetGpuCulling()) {
+                    TooltipInfoIcon(showTooltipIcons, "Cubes covering fewer pixels than this are not drawn, zero keeps every cube.", appContext);
+                    ImGui::SliderFloat("Min Cube Size", &appContext->cubeRenderer->GetInstanceCullPass().GetMinScreenSize(), 0.0f, 4.0f, "%.2f px");
+                }
+            }
+
+            // PROGRESSIVE REFINEMENT (REPLACES CULLING AND LEVEL OF DETAIL WHILE ENABLED)
+            if (appContext->cubeRenderer->HasProgressiveRefinement()) {
+                TooltipInfoIcon(showTooltipIcons, "Draws an evenly spread subset while the camera moves and fills in the rest once it stops.", appContext);
+                ImGui::Checkbox("Progressive Refinement", &appContext->cubeRenderer->GetProgressiveRefinement());
+                if (appContext->cubeRenderer->GetProgressiveRefinement()) {
+                    const Renderer::Utils::ProgressiveRefiner& refiner = appContext->cubeRenderer->GetProgressiveRefiner();
+                    TooltipInfoIcon(showTooltipIcons, "Cubes drawn per frame: only the first batch while moving, then one more batch per frame at rest until every cube is drawn.", appContext);
+                    ImGui::SliderInt("Batch Size", &appContext->cubeRenderer->GetRefinementBatchSize(), 100000, 10000000, "%d", ImGuiSliderFlags_Logarithmic);
+                    ImGui::Text("Accumulated: %llu / %llu%s", static_cast<unsigned long long>(refiner.GetAccumulatedCount()),
+                        static_cast<unsigned long long>(refiner.GetInstanceCount()), refiner.IsMoving() ? " (moving)" : "");
+                }
+            }
+
+            // VOXEL PYRAMID LEVEL (ONLY CHANGES HOW MANY BUFFERED POINTS ARE DRAWN), OR ONE LEVEL PER NODE WITH LEVEL OF DETAIL
+            if (appContext->cubeRenderer->HasVoxelPyramid()) {
+                const Spatial::VoxelPyramid& pyramid = appContext->cubeRenderer->GetVoxelPyramid();
+                TooltipInfoIcon(showTooltipIcons, "Picks a voxel level per region from its size on screen, within a point budget that follows the frame rate.", appContext);
+                ImGui::Checkbox("Level of Detail", &appContext->cubeRenderer->GetUseLod());
+                if (appContext->cubeRenderer->IsLodActive()) {
+                    Renderer::Utils::LodSelector& lodSelector = appContext->cubeRenderer->GetLodSelector();
+                    TooltipInfoIcon(showTooltipIcons, "Regions are refined until their voxels cover fewer pixels than this.", appContext);
+                    ImGui::SliderFloat("Max Voxel Error", &lodSelector.GetErrorThreshold(), 0.25f, 16.0f, "%.2f px");
+                    TooltipInfoIcon(showTooltipIcons, "The point budget shrinks below this frame rate and grows above it.", appContext);
+                    ImGui::SliderFloat("Target FPS", &lodSelector.GetTargetFps(), 15.0f, 240.0f, "%.0f");
+                    ImGui::Text("Points: %llu / %llu budget%s", static_cast<unsigned long long>(lodSelector.GetSelectedCount()),
+                        static_cast<unsigned long long>(lodSelector.GetPointBudget()), lodSelector.IsBudgetLimited() ? " (limited)" : "");
+                    ImGui::Text("Nodes: %zu / %zu visible (%.2f ms)", lodSelector.VisibleNodeCount(), pyramid.NodeCount(), lodSelector.GetMilliseconds());
+                } else {
+                    int level = appContext->cubeRenderer->GetPyramidLevel();
+                    TooltipInfoIcon(showTooltipIcons, "Switches between the precomputed voxel levels, finer levels over the render budget are not available.", appContext);
+                    if (ImGui::SliderInt("Voxel Level", &level, int(pyramid.FinestLevel()), int(pyramid.LevelCount()) - 1)) {
+                        appContext->cubeRenderer->SetPyramidLevel(level);
+                        appContext->budgetGovernor->UpdateVoxelSize(MAIN_DATASET, appContext->cubeRenderer->GetVoxelSize());
+                    }
+                    level = appContext->cubeRenderer->GetPyramidLevel();
+                    ImGui::Text("Level Voxel Size: %.3f (%llu points)", pyramid.LevelSize(uint32_t(level)),
+                        static_cast<unsigned long long>(pyramid.LevelPointCount(uint32_t(level))));
+                }
+            }
+        });
+    }
+
+    void DrawDatasetStatistics(Application::AppContext* appContext) {
+        CreateControlSection("Dataset Statistics", false, appContext, [&]() {
+            // THE READER THREAD WRITES THE STATISTICS WHEN IT FINISHES
+            const Data::DatasetStats& stats = appContext->datasetStats;
+            if (appContext->isReadingFlag.load(std::memory_order_acquire) || stats.Empty()) {
+                ImGui::TextDisabled("No statistics available");
+                return;
+            }
+
+            const glm::dvec3 extent = stats.maximum - stats.minimum;
+            ImGui::Text("Points: %llu", static_cast<unsigned long long>(stats.pointCount));
+            ImGui::Text("Extent: %.2f x %.2f x %.2f", extent.x, extent.y, extent.z);
+            ImGui::Text("Elevation: %.2f - %.2f", stats.minimum.z, stats.maximum.z);
+            ImGui::Text("Intensity: %u - %u", stats.minIntensity, stats.maxIntensity);
+            ImGui::Text("Mean Spacing: %.3f", stats.meanSpacing);
+
+            // NON-EMPTY CLASSIFICATION CODES AND RETURN NUMBERS
+            ImGui::SeparatorText("Classes");
+            for (size_t code = 0; code < Data::DatasetStats::ClassCount; ++code) {
+                if (stats.classCounts[code] == 0) continue;
+                ImGui::Text("Class %zu: %llu (%.1f%%)", code, static_cast<unsigned long long>(stats.classCounts[code]),
+                    100.0 * double(stats.classCounts[code]) / double(stats.pointCount));
+            }
+            ImGui::SeparatorText("Returns");
+            for (size_t number = 0; number < Data::DatasetStats::ReturnCount; ++number) {
+                if (stats.returnCounts[number] == 0) continue;
+                ImGui::Text("Return %zu: %llu", number, static_cast<unsigned long long>(stats.returnCounts[number]));
+            }
+        });
+    }
+
+    void DrawAttributeFilters(Application::AppContext* appContext) {
+        CreateControlSection("Attribute Filters", false, appContext, [&]() {
+            // OPTIONS COME FROM THE DATASET STATISTICS (WRITTEN BY THE READER THREAD WHEN IT FINISHES)
+            const Data::DatasetStats& stats = appContext->datasetStats;
+            if (appContext->isReadingFlag.load(std::memory_order_acquire) || stats.Empty()) {
+                ImGui::TextDisabled("No points loaded");
+                return;
+            }
+
+            // EVERY CONTROL ONLY REWRITES SHADER UNIFORMS, NOTHING IS RE-READ, RE-FILTERED OR RE-UPLOADED
+            Renderer::Utils::AttributeMask& mask = appContext->cubeRenderer->GetAttributeMask();
+            char label[64];
+
+            // CLASSES PRESENT IN THE DATASET
+            ImGui::SeparatorText("Classes");
+            for (uint32_t code = 0; code < Data::DatasetStats::ClassCount; ++code) {
+                if (stats.classCounts[code] == 0) continue;
+                const double percent = 100.0 * double(stats.classCounts[code]) / double(stats.pointCount);
+                if (code < IM_ARRAYSIZE(Renderer::Utils::ClassificationNames)) {
+                    snprintf(label, sizeof(label), "%s (%.1f%%)##Class%u", Renderer::Utils::ClassificationNames[code], percent, code);
+                } else {
+                    snprintf(label, sizeof(label), "Class %u (%.1f%%)##Class%u", code, percent, code);
+                }
+                bool visible = mask.IsClassVisible(code);
+                if (ImGui::Checkbox(label, &visible)) mask.SetClassVisible(code, visible);
+            }
+
+            // RETURN NUMBERS PRESENT IN THE DATASET
+            ImGui::SeparatorText("Returns");
+            for (uint32_t number = 0; number < Data::DatasetStats::ReturnCount; ++number) {
+                if (stats.returnCounts[number] == 0) continue;
+                snprintf(label, sizeof(label), "Return %u##Return%u", number, number);
+                bool visible = mask.IsReturnVisible(number);
+                if (ImGui::Checkbox(label, &visible)) mask.SetReturnVisible(number, visible);
+            }
+            TooltipInfoIcon(showTooltipIcons, "Hides every return except the last one of each pulse.", appContext);
+            ImGui::Checkbox("Last Returns Only", &mask.GetLastReturnOnly());
+
+            // INCLUSIVE WINDOWS
+            ImGui::SeparatorText("Ranges");
+            int sourceMinimum = int(mask.GetSourceRange().x);
+            int sourceMaximum = int(mask.GetSourceRange().y);
+            TooltipInfoIcon(showTooltipIcons, "Point source IDs (flight lines) to show.", appContext);
+            if (ImGui::DragIntRange2("Source ID", &sourceMinimum, &sourceMaximum, 1.0f, 0, UINT16_MAX)) {
+                mask.SetSourceRange(uint32_t(sourceMinimum), uint32_t(sourceMaximum));
+            }
+
+            int intensityMinimum = std::max(int(mask.GetIntensityRange().x), int(stats.minIntensity));
+            int intensityMaximum = std::min(int(mask.GetIntensityRange().y), int(stats.maxIntensity));
+            TooltipInfoIcon(showTooltipIcons, "Raw intensity window to show.", appContext);
+            if (ImGui::DragIntRange2("Intensity Window", &intensityMinimum, &intensityMaximum, 1.0f, stats.minIntensity, stats.maxIntensity)) {
+                // THE FULL DATASET RANGE LEAVES THE WINDOW OPEN
+                mask.SetIntensityRange(intensityMinimum <= stats.minIntensity ? 0u : uint32_t(intensityMinimum),
+                    intensityMaximum >= stats.maxIntensity ? uint32_t(UINT16_MAX) : uint32_t(intensityMaximum));
+            }
+
+            // ELEVATION IN FILE COORDINATES, THE SHADER COMPARES STORED (ORIGIN-CENTERED) HEIGHTS
+            const double originHeight = appContext->cubeRenderer->GetPointOrigin().z;
+            const float lowest = float(stats.minimum.z);
+            const float highest = float(stats.maximum.z);
+            float elevationMinimum = std::max(float(mask.GetElevationRange().x + originHeight), lowest);
+            float elevationMaximum = std::min(float(mask.GetElevationRange().y + originHeight), highest);
+            TooltipInfoIcon(showTooltipIcons, "Elevation window to show.", appContext);
+            if (ImGui::DragFloatRange2("Elevation Window", &elevationMinimum, &elevationMaximum, 0.1f, lowest, highest, "%.2f")) {
+                mask.SetElevationRange(elevationMinimum <= lowest ? -FLT_MAX : float(elevationMinimum - originHeight),
+                    elevationMaximum >= highest ? FLT_MAX : float(elevationMaximum - originHeight));
+            }
+
+            if (ImGui::Button("Show All")) mask.Reset();
+        });
+    }
+
+    void DrawPickedPoint(Application::AppContext* appContext) {
+        CreateControlSection("Picked Point", false, appContext, [&]() {
+            if (!appContext->hasPickedPoint) {
+                ImGui::TextDisabled("Click a point to inspect it");
+                return;
+            }
+
+            const PickedPoint& picked = appContext->pickedPoint;
+            ImGui::Text("Index: %llu", static_cast<unsigned long long>(picked.index));
+            ImGui::Text("X: %.3f", picked.worldPosition.x);
+            ImGui::Text("Y: %.3f", picked.worldPosition.y);
+            ImGui::Text("Z: %.3f", picked.worldPosition.z);
+            ImGui::Text("Intensity: %u", picked.intensity);
+            ImGui::Text("Camera Distance: %.2f", picked.distance);
+        });
+    }
+
+    void DrawProfileSettings(Application::AppContext* appContext) {
+        CreateControlSection("Profile", false, appContext, [&]() {
+            // NEEDS THE POINT INDEX (POINT PICKING) OF THE LOADED FILE
+            const bool hasIndex = !appContext->cubeRenderer->GetPointIndex().Empty();
+            ImGui::BeginDisabled(!hasIndex || appContext->isReadingFlag.load(std::memory_order_acquire));
+            TooltipInfoIcon(showTooltipIcons, "Drag with the left mouse button to cut a cross-section through the cloud.", appContext);
+            ImGui::Checkbox("Draw Profile", &appContext->profileMode);
+
+            TooltipInfoIcon(showTooltipIcons, "Width of the slab gathered around the profile line.", appContext);
+            if (ImGui::SliderFloat("Slab Width", &appContext->profileWidth, 0.1f, 20.0f, "%.1f", ImGuiSliderFlags_Logarithmic)) {
+                appContext->profileDirty = !appContext->profile.Empty();
+            }
+            ImGui::EndDisabled();
+
+            if (!hasIndex) {
+                ImGui::TextDisabled("Requires point picking");
+            } else if (!appContext->profile.Empty()) {
+                ImGui::Text("Points: %zu", appContext->profile.GetPoints().size());
+                ImGui::Text("Length: %.2f", appContext->profile.GetLength());
+                ImGui::Text("Cut Time: %.2f ms", appContext->profile.GetExtractMilliseconds());
+            }
+        });
+    }
+
+    void DrawProfileWindow(Application::AppContext* appContext) {
+        if (!appContext->profileMode) return;
+
+        // SLAB OUTLINE IN THE 3D VIEW (CORNERS ON THE ANCHOR'S HEIGHT, PROJECTED WITH THE ACTIVE CAMERA)
+        const glm::vec3 start = appContext->profileStart;
+        const glm::vec3 end = appContext->profileEnd;
+        const glm::vec2 delta(end.x - start.x, end.y - start.y);
+        const float length = std::sqrt(delta.x * delta.x + delta.y * delta.y);
+        if (length > 0.0f) {
+            const float halfWidth = 0.5f * appContext->profileWidth;
+            const glm::vec3 normal(-delta.y / length * halfWidth, delta.x / length * halfWidth, 0.0f);
+            const glm::vec3 corners[4] = { start - normal, end - normal, end + normal, start + normal };
+
+            const glm::mat4 viewProjection = appContext->activeCamera->GetViewProjection();
+            const ImVec2 displaySize = ImGui::GetIO().DisplaySize;
+            ImVec2 screenCorners[4];
+            bool visible = true;
+            for (int i = 0; i < 4; ++i) {
+                const glm::vec4 clip = viewProjection * glm::vec4(corners[i], 1.0f);
+                if (clip.w <= 0.0f) {
+                    visible = false;
+                    break;
+                }
+                screenCorners[i] = ImVec2((clip.x / clip.w * 0.5f + 0.5f) * displaySize.x, (0.5f - clip.y / clip.w * 0.5f) * displaySize.y);
+            }
+            if (visible) {
+                ImDrawList* drawList = ImGui::GetBackgroundDrawList();
+                drawList->AddQuadFilled(screenCorners[0], screenCorners[1], screenCorners[2], screenCorners[3], IM_COL32(255, 255, 0, 40));
+                drawList->AddQuad(screenCorners[0], screenCorners[1], screenCorners[2], screenCorners[3], IM_COL32(255, 255, 0, 200), 1.5f);
+            }
+        }
+
+        ImGui::SetNextWindowSize(ImVec2(640.0f, 260.0f), ImGuiCond_FirstUseEver);
+        if (!ImGui::Begin("Profile", &appContext->profileMode)) {
+            ImGui::End();
+            return;
+        }
+
+        Spatial::ProfileExtractor& profile = appContext->profile;
+        if (profile.Empty()) {
+            ImGui::TextDisabled("Drag in the view to cut a profile");
+            ImGui::End();
+            return;
+        }
+
+        // CANVAS: ONE CELL PER 2x2 PIXELS, CELLS COLORED BY THEIR MEAN INTENSITY
+        const float cellPixels = 2.0f;
+        ImVec2 canvasSize = ImGui::GetContentRegionAvail();
+        canvasSize.y -= ImGui::GetTextLineHeightWithSpacing();
+        if (canvasSize.x < 16.0f || canvasSize.y < 16.0f) {
+            ImGui::End();
+            return;
+        }
+        const ImVec2 canvasMin = ImGui::GetCursorScreenPos();
+        const ImVec2 canvasMax(canvasMin.x + canvasSize.x, canvasMin.y + canvasSize.y);
+        ImGui::InvisibleButton("##PROFILE_CANVAS", canvasSize);
+
+        const uint32_t columns = static_cast<uint32_t>(canvasSize.x / cellPixels);
+        const uint32_t rows = static_cast<uint32_t>(canvasSize.y / cellPixels);
+        profile.Rasterize(columns, rows);
+
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        drawList->AddRectFilled(canvasMin, canvasMax, IM_COL32(20, 20, 20, 255));
+        const std::vector<glm::vec3>& colorRamp = Data::ColorRamp::GetColorRamp(static_cast<Data::ColorRampType>(selectedColorRampIndex));
+        const float intensityRange = std::max(1.0f, float(profile.GetMaxIntensity()) - float(profile.GetMinIntensity()));
+        const std::vector<Spatial::ProfileCell>& cells = profile.GetCells();
+        for (uint32_t row = 0; row < profile.GetRows(); ++row) {
+            for (uint32_t column = 0; column < profile.GetColumns(); ++column) {
+                const Spatial::ProfileCell& cell = cells[size_t(row) * profile.GetColumns() + column];
+                if (cell.count == 0) continue;
+                const glm::vec3 color = Data::ColorMap((cell.meanIntensity - float(profile.GetMinIntensity())) / intensityRange, colorRamp);
+                const ImVec2 cellMin(canvasMin.x + column * cellPixels, canvasMin.y + row * cellPixels);
+                drawList->AddRectFilled(cellMin, ImVec2(cellMin.x + cellPixels, cellMin.y + cellPixels),
+                    ImGui::ColorConvertFloat4ToU32(ImVec4(color.r, color.g, color.b, 1.0f)));
+            }
+        }
+
+        // POSITION UNDER THE MOUSE (DISTANCE ALONG THE LINE, FILE HEIGHT)
+        const double originHeight = appContext->cubeRenderer->GetPointOrigin().z;
+        const float heightRange = profile.GetMaxHeight() - profile.GetMinHeight();
+        if (ImGui::IsItemHovered()) {
+            const ImVec2 mouse = ImGui::GetIO().MousePos;
+            const float along = (mouse.x - canvasMin.x) / canvasSize.x * profile.GetLength();
+            const float height = profile.GetMaxHeight() - (mouse.y - canvasMin.y) / canvasSize.y * heightRange;
+            ImGui::SetTooltip("Distance: %.2f\nHeight: %.2f", along, originHeight + height);
+        }
+
+        ImGui::Text("Length: %.2f   Height: %.2f - %.2f   Points: %zu", profile.GetLength(),
+            originHeight + profile.GetMinHeight(), originHeight + profile.GetMaxHeight(), profile.GetPoints().size());
+        ImGui::End();
+    }
+
+    void UpdateChangeView(Application::AppContext* appContext) {
+        CubeRenderer* cubeRenderer = appContext->cubeRenderer.get();
+
+        // THE SWAP IS ITS OWN INVERSE, RESTORE THE RAW INTENSITIES BEFORE APPLYING A NEW RANGE
+        if (appContext->changesApplied) {
+            cubeRenderer->SwapIntensities(appContext->swappedIntensities);
+            appContext->changesApplied = false;
+        }
+
+        // DISTANCES RUN THROUGH THE SAME LOOKUP TABLE AS INTENSITIES, LINEAR SO THE RAMP SPANS [0, changeRange]
+        const Filters::ChangeDetector& detector = appContext->changeDetector;
+        if (appContext->showChanges && detector.HasDistances()) {
+            detector.Quantize(appContext->changeRange, appContext->swappedIntensities);
+            cubeRenderer->SwapIntensities(appContext->swappedIntensities);
+            appContext->changesApplied = true;
+            cubeRenderer->SetIntensityMapping(Renderer::Utils::IntensityMapping::Linear, intensityClipPercent);
+        } else {
+            cubeRenderer->SetIntensityMapping(static_cast<Renderer::Utils::IntensityMapping>(selectedIntensityMappingIndex), intensityClipPercent);
+        }
+
+        cubeRenderer->VoxelDownsample();
+        appContext->budgetGovernor->UpdateVoxelSize(MAIN_DATASET, cubeRenderer->GetVoxelSize());
+        cubeRenderer->UpdateBuffers();
+    }
+
+    void DrawChangeDetection(Application::AppContext* appContext) {
+        CreateControlSection("Change Detection", false, appContext, [&]() {
+            const bool isReading = appContext->isReadingFlag.load(std::memory_order_acquire);
+            Filters::ChangeDetector& detector = appContext->changeDetector;
+
+            // REFERENCE SCAN (READ INTO THE MAIN FILE'S ORIGIN, THEN COMPARED ON THE READER THREAD)
+            ImGui::BeginDisabled(appContext->filepath.empty() || isReading);
+            TooltipInfoIcon(showTooltipIcons, "Loads an earlier scan of the same site and colors every point by its distance to the nearest reference point.", appContext);
+            if (ImGui::Button("Load Reference...")) {
+                const char* filters[] = { "*.las", "*.laz" };
+                const char* selected = tinyfd_openFileDialog(
+                    "Select a reference file", "",
+                    2, // NUMBER OF FILTERS
+                    filters,
+                    ".LAZ and .LAS files",
+                    0 // DO NOT ALLOW MULTIPLE SELECTIONS
+                );
+                std::shared_ptr<CustomReader::LazReader> reader;
+                if (selected) {
+                    reader = std::make_shared<CustomReader::LazReader>(
+                        selected,
+                        &detector.GetReferenceStore(),
+                        appContext->cubeRenderer->GetPointOrigin()
+                    );
+                }
+                if (reader && reader->GetHeader()) {
+                    std::shared_ptr<LazHeader> header = reader->GetHeader();
+
+                    // THE MAIN STORE IS COMPARED BY POSITION ONLY, PUT ITS RAW INTENSITIES BACK BEFORE THE READER THREAD STARTS
+                    if (appContext->changesApplied) {
+                        appContext->cubeRenderer->SwapIntensities(appContext->swappedIntensities);
+                        appContext->changesApplied = false;
+                    }
+                    detector.Clear();
+                    appContext->referencePath = selected;
+
+                    // DISTANCES AND SWAPPED INTENSITIES ARE HELD PER MAIN POINT, CHARGED TO THE MAIN FILE BEFORE THE REFERENCE IS PLANNED
+                    appContext->budgetGovernor->SetAuxiliaryHostBytes(MAIN_DATASET,
+                        appContext->cubeRenderer->GetPointStore().Size() * Filters::ChangeDetector::HostBytesPerComparedPoint);
+
+                    // THE REFERENCE SHARES THE RAM BUDGET WITH THE MAIN FILE (STORE + INDEX, NEVER RENDERED)
+                    bool compressPoints = appContext->cubeRenderer->GetCompressPoints();
+                    const Data::DatasetBudget& budget = appContext->budgetGovernor->PlanDataset(
+                        REFERENCE_DATASET,
+                        header->pointCount(),
+                        detector.GetReferenceStore().EstimatedBytesPerPoint(compressPoints) + Spatial::KdTree::BytesPerPoint
+                    );
+                    reader->SetDecimationStep(budget.decimationStep);
+
+                    float quantization = static_cast<float>(std::min({ header->scaleX, header->scaleY, header->scaleZ }));
+                    detector.GetReferenceStore().Reset(budget.loadedPointCount, compressPoints, quantization);
+
+                    std::thread([appContext, reader]() {
+                        appContext->isReadingFlag.store(true, std::memory_order_release);
+
+                        reader->ReadPointData();
+                        Data::AllocationStats compareStats;
+                        appContext->changeDetector.Compute(appContext->cubeRenderer->GetPointStore(), compareStats);
+
+                        appContext->doneComparingFlag.store(true, std::memory_order_release);
+                    }).detach();
+                }
+            }
+            ImGui::EndDisabled();
+
+            if (isReading || !detector.HasDistances()) {
+                ImGui::TextDisabled(isReading ? "Reading..." : "No reference loaded");
+                return;
+            }
+
+            TooltipInfoIcon(showTooltipIcons, "Colors points by their distance to the reference instead of intensity.", appContext);
+            if (ImGui::Checkbox("Show Changes", &appContext->showChanges)) UpdateChangeView(appContext);
+
+            // EVERY POINT IS RE-FILTERED AND RE-UPLOADED, SO THE RANGE APPLIES WHEN THE SLIDER IS RELEASED
+            ImGui::BeginDisabled(!appContext->showChanges);
+            TooltipInfoIcon(showTooltipIcons, "Distance mapped to the top of the gradient.", appContext);
+            ImGui::SliderFloat("Change Range", &appContext->changeRange, 0.01f, 100.0f, "%.2f", ImGuiSliderFlags_Logarithmic);
+            if (ImGui::IsItemDeactivatedAfterEdit()) UpdateChangeView(appContext);
+            ImGui::EndDisabled();
+
+            ImGui::TextWrapped("Reference: %s", appContext->referencePath.c_str());
+            ImGui::Text("Reference Points: %llu", static_cast<unsigned long long>(detector.GetReferenceCount()));
+            ImGui::Text("Mean Distance: %.3f", detector.GetMeanDistance());
+            ImGui::Text("95th Percentile: %.3f", detector.GetPercentileDistance());
+            ImGui::Text("Max Distance: %.3f", detector.GetMaxDistance());
+        });
+    }
+
+    void DrawTerrainSettings(Application::AppContext* appContext) {
+        CreateControlSection("Terrain", false, appContext, [&]() {
+            const bool isReading = appContext->isReadingFlag.load(std::memory_order_acquire);
+            ImGui::BeginDisabled(appContext->filepath.empty() || isReading);
+
+            // FAR FIELD (GRID BUILT ON THE FIRST ENABLE, THEN WITH EVERY DOWNSAMPLE)
+            bool useFarField = appContext->cubeRenderer->GetUseFarField();
+            TooltipInfoIcon(showTooltipIcons, "Draws distant terrain as a heightmap mesh instead of individual cubes.", appContext);
+            if (ImGui::Checkbox("Far-Field Terrain", &useFarField)) appContext->cubeRenderer->SetUseFarField(useFarField);
+            ImGui::BeginDisabled(!useFarField);
+            TooltipInfoIcon(showTooltipIcons, "Camera distance beyond which the heightmap replaces the cubes.", appContext);
+            ImGui::SliderFloat("Far Distance", &appContext->cubeRenderer->GetFarDistance(), 10.0f, 10000.0f, "%.0f", ImGuiSliderFlags_Logarithmic);
+            ImGui::EndDisabled();
+            if (useFarField) ImGui::Text("Heightmap Triangles: %d", int(appContext->cubeRenderer->GetFarFieldTriangleCount()));
+
+            // GEOTIFF EXPORT (MIN / MAX / MEAN ELEVATION AND MEAN INTENSITY BANDS)
+            TooltipInfoIcon(showTooltipIcons, "Writes the elevation grid (min, max, mean elevation and mean intensity) as a GeoTIFF.", appContext);
+            if (ImGui::Button("Export GeoTIFF...")) {
+                const char* filters[] = { "*.tif", "*.tiff" };
+                const char* selected = tinyfd_saveFileDialog(
+                    "Export elevation grid", "elevation.tif",
+                    2, // NUMBER OF FILTERS
+                    filters,
+                    "GeoTIFF files"
+                );
+                if (selected) {
+                    // THE FAR FIELD KEEPS THE GRID CURRENT, OTHERWISE BUILD IT FOR THIS EXPORT
+                    if (appContext->cubeRenderer->GetUseFarField() || appContext->cubeRenderer->BuildElevationGrid()) {
+                        Data::WriteElevationGeoTiff(selected, appContext->cubeRenderer->GetElevationGrid(), appContext->cubeRenderer->GetPointOrigin());
+                    }
+                }
+            }
+            ImGui::EndDisabled();
+
+            const Spatial::ElevationGrid& grid = appContext->cubeRenderer->GetElevationGrid();
+            if (!isReading && !grid.Empty()) {
+                ImGui::Text("Grid: %u x %u (Cell %.2f)", grid.GetColumns(), grid.GetRows(), grid.GetCellSize());
             }
         });
     }
@@ -240,6 +883,67 @@ namespace UserInterface {
         });
     }
 
+    void DrawMemoryBudget(Application::AppContext* appContext) {
+        CreateControlSection("Memory Budget", false, appContext, [&]() {
+            Data::BudgetGovernor* governor = appContext->budgetGovernor.get();
+            const Data::MemoryInfo& memoryInfo = governor->GetMemoryInfo();
+            const float gigabyte = 1024.0f * 1024.0f * 1024.0f;
+            const float megabyte = 1024.0f * 1024.0f;
+
+            // SYSTEM/DEVICE MEMORY
+            ImGui::Text("System RAM: %.1f / %.1f GB available",
+                memoryInfo.availableSystemBytes / gigabyte, memoryInfo.totalSystemBytes / gigabyte);
+            if (memoryInfo.deviceMemoryKnown) {
+                ImGui::Text("Video Memory: %.1f / %.1f GB available",
+                    memoryInfo.availableDeviceBytes / gigabyte, memoryInfo.totalDeviceBytes / gigabyte);
+            } else {
+                ImGui::Text("Video Memory: unknown (assuming %.1f GB)", Data::BudgetGovernor::FallbackDeviceBytes / gigabyte);
+            }
+            if (ImGui::Button("Refresh##MEMORY_BUDGET")) {
+                governor->UpdateMemoryInfo();
+            }
+
+            // SHARE OF AVAILABLE MEMORY (APPLIES TO THE NEXT PLAN)
+            TooltipInfoIcon(showTooltipIcons, "Share of the available system memory the viewer plans for, applies to the next selected file.", appContext);
+            ImGui::SliderFloat("Host Share", &governor->GetHostFraction(), 0.1f, 0.9f);
+            TooltipInfoIcon(showTooltipIcons, "Share of the available video memory the viewer plans for, applies to the next selected file.", appContext);
+            ImGui::SliderFloat("Device Share", &governor->GetDeviceFraction(), 0.1f, 0.9f);
+
+            // HEADROOM
+            uint64_t hostBudget = governor->GetHostBudget();
+            uint64_t deviceBudget = governor->GetDeviceBudget();
+            uint64_t hostUsage = governor->GetHostUsage();
+            uint64_t deviceUsage = governor->GetDeviceUsage();
+            char overlay[64];
+            snprintf(overlay, sizeof(overlay), "Host %.0f / %.0f MB", hostUsage / megabyte, hostBudget / megabyte);
+            ImGui::ProgressBar(hostBudget ? float(hostUsage) / float(hostBudget) : 0.0f, ImVec2(-1.0f, 0.0f), overlay);
+            snprintf(overlay, sizeof(overlay), "Device %.0f / %.0f MB", deviceUsage / megabyte, deviceBudget / megabyte);
+            ImGui::ProgressBar(deviceBudget ? float(deviceUsage) / float(deviceBudget) : 0.0f, ImVec2(-1.0f, 0.0f), overlay);
+
+            // DECISIONS PER DATASET
+            for (const Data::DatasetBudget& dataset : governor->GetDatasets()) {
+                ImGui::SeparatorText(dataset.name.c_str());
+                ImGui::Text("File Points: %llu", static_cast<unsigned long long>(dataset.filePointCount));
+                ImGui::Text("Decimation: every %llu (%llu loaded)",
+                    static_cast<unsigned long long>(dataset.decimationStep),
+                    static_cast<unsigned long long>(dataset.loadedPointCount));
+                ImGui::Text("Render Budget: %llu", static_cast<unsigned long long>(dataset.renderBudget));
+                if (dataset.voxelSize > 0.0f) {
+                    ImGui::Text("Voxel Size: %.3f", dataset.voxelSize);
+
+                    // GPU FILTERING REPORTS ITS SURVIVOR COUNT A FEW FRAMES LATER
+                    uint64_t renderedCount = 0;
+                    if (appContext->cubeRenderer->GetRenderedCount(renderedCount)) {
+                        ImGui::Text("Rendered Points: %llu", static_cast<unsigned long long>(renderedCount));
+                    } else {
+                        ImGui::Text("Rendered Points: pending");
+                    }
+                }
+                ImGui::Text("Estimated: %.0f MB host, %.0f MB device", dataset.hostBytes / megabyte, dataset.deviceBytes / megabyte);
+            }
+        });
+    }
+
     void RenderMainPanel(Application::AppContext* appContext) {
         ImVec2 minSize(float(MINIMUM_WINDOW_WIDTH) / 2.0f, float(MINIMUM_WINDOW_HEIGHT) / 2.0f);
         ImVec2 maxSize(FLT_MAX, FLT_MAX);
@@ -256,10 +960,20 @@ namespace UserInterface {
 
         DrawFileSelectionSettings(appContext);
         DrawCubeSettings(appContext);
+        DrawDatasetStatistics(appContext);
+        DrawAttributeFilters(appContext);
+        DrawPickedPoint(appContext);
+        DrawProfileSettings(appContext);
+        DrawChangeDetection(appContext);
+        DrawTerrainSettings(appContext);
         DrawOrbitalCameraSettings(appContext);
         DrawFreeCameraSettings(appContext);
+        DrawMemoryBudget(appContext);
 
         ImGui::End();
+
+        // FLOATING WINDOWS
+        DrawProfileWindow(appContext);
     }
 
 }
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+#include <SDL3/SDL.h>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <BudgetGovernor.hpp>
+#include <RendererHelper.hpp>
+
+// VENDOR MEMORY QUERIES (NOT PART OF CORE PROFILE HEADERS)
+#ifndef GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX
+#define GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX 0x9048
+#endif
+#ifndef GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX
+#define GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX 0x9049
+#endif
+#ifndef GL_VBO_FREE_MEMORY_ATI
+#define GL_VBO_FREE_MEMORY_ATI 0x87FB
+#endif
+
+namespace Data {
+
+    namespace {
+
+        void QuerySystemMemory(MemoryInfo& info) {
+#if defined(_WIN32)
+            MEMORYSTATUSEX status;
+            status.dwLength = sizeof(status);
+            if (GlobalMemoryStatusEx(&status)) {
+                info.totalSystemBytes = status.ullTotalPhys;
+                info.availableSystemBytes = status.ullAvailPhys;
+                return;
+            }
+#elif defined(__linux__)
+            std::ifstream meminfo("/proc/meminfo");
+            std::string key;
+            uint64_t value = 0;
+            std::string unit;
+            while (meminfo >> key >> value >> unit) {
+                if (key == "MemTotal:") info.totalSystemBytes = value * 1024;
+                if (key == "MemAvailable:") info.availableSystemBytes = value * 1024;
+            }
+            if (info.totalSystemBytes > 0 && info.availableSystemBytes > 0) return;
+#endif
+            // FALLBACK: TOTAL FROM SDL, ASSUME HALF OF IT IS AVAILABLE
+            info.totalSystemBytes = uint64_t(SDL_GetSystemRAM()) * 1024 * 1024;
+            info.availableSystemBytes = info.totalSystemBytes / 2;
+        }
+
+        // VIEWER DEFAULT BEFORE THE GOVERNOR: POWER LAW FROM 0.4 AT 50K POINTS TO 4.0 AT 8M POINTS, CLAMPED TO [0.25, 6]
+        float DefaultVoxelSize(uint64_t pointCount) {
+            const float lowerBoundVoxelSize = 0.4f;
+            const float lowerBoundPointCount = 50'000.0f;
+            const float upperBoundPointCount = 8'000'000.0f;
+            const float upperBoundVoxelSize = 4.0f;
+
+            float exponent =
+                std::log(upperBoundVoxelSize / lowerBoundVoxelSize) /
+                std::log(upperBoundPointCount / lowerBoundPointCount);
+            float pointRatio = float(pointCount) / lowerBoundPointCount;
+            return std::clamp(lowerBoundVoxelSize * std::pow(pointRatio, exponent), 0.25f, 6.0f);
+        }
+
+        void QueryDeviceMemory(MemoryInfo& info) {
+            info.deviceMemoryKnown = false;
+            info.totalDeviceBytes = 0;
+            info.availableDeviceBytes = 0;
+
+            // VALUES ARE REPORTED IN KILOBYTES
+            if (Renderer::HasExtension("GL_NVX_gpu_memory_info")) {
+                GLint totalKilobytes = 0;
+                GLint availableKilobytes = 0;
+                glGetIntegerv(GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX, &totalKilobytes);
+                glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &availableKilobytes);
+                info.totalDeviceBytes = uint64_t(totalKilobytes) * 1024;
+                info.availableDeviceBytes = uint64_t(availableKilobytes) * 1024;
+                info.deviceMemoryKnown = true;
+            } else if (Renderer::HasExtension("GL_ATI_meminfo")) {
+                GLint freeMemory[4] = { 0, 0, 0, 0 };
+                glGetIntegerv(GL_VBO_FREE_MEMORY_ATI, freeMemory);
+                info.availableDeviceBytes = uint64_t(freeMemory[0]) * 1024;
+                info.totalDeviceBytes = info.availableDeviceBytes;
+                info.deviceMemoryKnown = true;
+            }
+        }
+
+    }
+
+    void BudgetGovernor::UpdateMemoryInfo() {
+        QuerySystemMemory(memoryInfo);
+        QueryDeviceMemory(memoryInfo);
+    }
+
+    uint64_t BudgetGovernor::GetHostUsage() const {
+        uint64_t usage = 0;
+        for (const DatasetBudget& dataset : datasets) usage += dataset.hostBytes;
+        return usage;
+    }
+
+    uint64_t BudgetGovernor::GetDeviceUsage() const {
+        uint64_t usage = 0;
+        for (const DatasetBudget& dataset : datasets) usage += dataset.deviceBytes;
+        return usage;
+    }
+
+    uint64_t BudgetGovernor::GetHostBudget() const {
+        // MEMORY ALREADY HELD BY LOADED DATASETS COUNTS AS AVAILABLE TO THE VIEWER
+        return static_cast<uint64_t>((memoryInfo.availableSystemBytes + GetHostUsage()) * double(hostFraction));
+    }
+
+    uint64_t BudgetGovernor::GetDeviceBudget() const {
+        uint64_t available = memoryInfo.deviceMemoryKnown ? memoryInfo.availableDeviceBytes : FallbackDeviceBytes;
+        return static_cast<uint64_t>((available + GetDeviceUsage()) * double(deviceFraction));
+    }
+
+    DatasetBudget* BudgetGovernor::FindDataset(const std::string& name) {
+        for (DatasetBudget& dataset : datasets) {
+            if (dataset.name == name) return &dataset;
+        }
+        return nullptr;
+    }
+
+    const DatasetBudget& BudgetGovernor::PlanDataset(const std::string& name, uint64_t filePointCount, double storeBytesPerPoint) {
+        UpdateMemoryInfo();
+
+        DatasetBudget* dataset = FindDataset(name);
+        if (!dataset) {
+            datasets.push_back(DatasetBudget());
+            dataset = &datasets.back();
+            dataset->name = name;
+        }
+
+        // BUDGET LEFT AFTER THE OTHER DATASETS (THIS ONE IS BEING REPLACED)
+        uint64_t hostBudget = GetHostBudget();
+        uint64_t deviceBudget = GetDeviceBudget();
+        uint64_t otherHost = GetHostUsage() - dataset->hostBytes;
+        uint64_t otherDevice = GetDeviceUsage() - dataset->deviceBytes;
+        hostBudget = hostBudget > otherHost ? hostBudget - otherHost : 0;
+        deviceBudget = deviceBudget > otherDevice ? deviceBudget - otherDevice : 0;
+
+        // LOADED POINTS: 3/4 OF THE HOST BUDGET FOR THE STORE, 1/2 OF THE DEVICE BUDGET FOR THE FILTER INPUT
+        double storeBytes = std::max(storeBytesPerPoint, 1.0);
+        uint64_t maxLoadedHost = static_cast<uint64_t>(hostBudget * 0.75 / storeBytes);
+        uint64_t maxLoadedDevice = deviceBudget / 2 / DeviceBytesPerFilteredPoint;
+        uint64_t maxLoaded = std::max<uint64_t>(1, std::min(maxLoadedHost, maxLoadedDevice));
+
+        dataset->filePointCount = filePointCount;
+        dataset->decimationStep = std::max<uint64_t>(1, (filePointCount + maxLoaded - 1) / maxLoaded);
+        dataset->loadedPointCount = (filePointCount + dataset->decimationStep - 1) / dataset->decimationStep;
+
+        // RENDERED POINTS: WHATEVER IS LEFT ON BOTH SIDES
+        uint64_t loadedHost = static_cast<uint64_t>(dataset->loadedPointCount * storeBytes);
+        uint64_t loadedDevice = dataset->loadedPointCount * DeviceBytesPerFilteredPoint;
+        uint64_t renderHost = hostBudget > loadedHost ? (hostBudget - loadedHost) / HostBytesPerRenderedPoint : 0;
+        uint64_t renderDevice = deviceBudget > loadedDevice ? (deviceBudget - loadedDevice) / DeviceBytesPerRenderedPoint : 0;
+        dataset->renderBudget = std::max<uint64_t>(1, std::min({ renderHost, renderDevice, dataset->loadedPointCount }));
+
+        dataset->hostBytes = loadedHost + dataset->renderBudget * HostBytesPerRenderedPoint;
+        dataset->deviceBytes = loadedDevice + dataset->renderBudget * DeviceBytesPerRenderedPoint;
+        dataset->auxiliaryHostBytes = 0;
+        dataset->voxelSize = 0.0f;
+
+        const double megabyte = 1024.0 * 1024.0;
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+            "BUDGET PLAN (%s): %llu FILE POINTS, DECIMATION STEP %llu, RENDER BUDGET %llu, HOST %.1f/%.1f MB, DEVICE %.1f/%.1f MB%s",
+            name.c_str(),
+            static_cast<unsigned long long>(filePointCount),
+            static_cast<unsigned long long>(dataset->decimationStep),
+            static_cast<unsigned long long>(dataset->renderBudget),
+            dataset->hostBytes / megabyte, hostBudget / megabyte,
+            dataset->deviceBytes / megabyte, deviceBudget / megabyte,
+            memoryInfo.deviceMemoryKnown ? "" : " (DEVICE MEMORY ESTIMATED)");
+
+        return *dataset;
+    }
+
+    void BudgetGovernor::UpdateVoxelSize(const std::string& name, float voxelSize) {
+        DatasetBudget* dataset = FindDataset(name);
+        if (dataset) dataset->voxelSize = voxelSize;
+    }
+
+    void BudgetGovernor::SetAuxiliaryHostBytes(const std::string& name, uint64_t bytes) {
+        DatasetBudget* dataset = FindDataset(name);
+        if (!dataset) return;
+        dataset->hostBytes = dataset->hostBytes - dataset->auxiliaryHostBytes + bytes;
+        dataset->auxiliaryHostBytes = bytes;
+    }
+
+    void BudgetGovernor::RemoveDataset(const std::string& name) {
+        datasets.erase(
+            std::remove_if(datasets.begin(), datasets.end(), [&name](const DatasetBudget& dataset) { return dataset.name == name; }),
+            datasets.end()
+        );
+    }
+
+    float BudgetGovernor::VoxelSizeForBudget(uint64_t pointCount, glm::vec3 extent, uint64_t renderBudget) {
+        if (pointCount == 0) return MinVoxelSize;
+
+        // BUDGET COVERS EVERY POINT (OR THERE IS NONE), KEEP THE VIEWER'S DEFAULT SIZE
+        if (renderBudget == 0 || pointCount <= renderBudget) return DefaultVoxelSize(pointCount);
+
+        // AIRBORNE DATA IS CLOSE TO A 2.5D SURFACE: OCCUPIED CELLS ~ HORIZONTAL AREA / SIZE^2
+        float area = std::max(extent.x, 1.0f) * std::max(extent.y, 1.0f);
+        float size = std::sqrt(area / float(renderBudget));
+        return std::clamp(size, MinVoxelSize, MaxVoxelSize);
+    }
+
+}
@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+
+#include <DatasetStats.hpp>
+
+namespace Data {
+
+    namespace {
+
+        constexpr uint32_t StatsMagic = 0x5453564C;    // "LVST"
+        constexpr uint32_t StatsVersion = 1;
+
+        inline std::string SidecarPath(const std::string& filepath) { return filepath + ".stats"; }
+
+        template <typename T>
+        inline void WriteValue(std::ofstream& stream, const T& value) {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        inline bool ReadValue(std::ifstream& stream, T& value) {
+            stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+            return stream.good();
+        }
+
+    }
+
+    bool GetFileKey(const std::string& filepath, uint64_t decimationStep, FileKey& key) {
+        std::error_code error;
+        key.fileSize = std::filesystem::file_size(filepath, error);
+        if (error) return false;
+        key.modifiedTime = static_cast<int64_t>(std::filesystem::last_write_time(filepath, error).time_since_epoch().count());
+        if (error) return false;
+        key.decimationStep = decimationStep;
+        return true;
+    }
+
+    void StatsAccumulator::Reset(const glm::dvec3& minimum, const glm::dvec3& maximum) {
+        stats = DatasetStats();
+        stats.intensityHistogram.assign(DatasetStats::IntensityBins, 0);
+        occupancy.assign(size_t(SpacingGridSize) * SpacingGridSize / 64, 0);
+
+        const glm::dvec2 extent(std::max(maximum.x - minimum.x, 0.0), std::max(maximum.y - minimum.y, 0.0));
+        gridOrigin = glm::dvec2(minimum.x, minimum.y);
+        gridScale = glm::dvec2(
+            extent.x > 0.0 ? SpacingGridSize / extent.x : 0.0,
+            extent.y > 0.0 ? SpacingGridSize / extent.y : 0.0
+        );
+        cellArea = (extent.x / SpacingGridSize) * (extent.y / SpacingGridSize);
+    }
+
+    void StatsAccumulator::Finish(DatasetStats& output) const {
+        output = stats;
+        if (stats.pointCount == 0) return;
+
+        // OCCUPIED PLAN AREA SHARED BY THE POINTS (GAPS AND WATER DO NOT COUNT), MEASURED ON THE FINEST
+        // GRID WITH (MinPointsPerCell) POINTS PER OCCUPIED CELL (FINER CELLS ONLY MEASURE THE CELL SIZE)
+        uint32_t size = SpacingGridSize;
+        std::vector<uint8_t> cells(size_t(size) * size);
+        for (size_t cellIndex = 0; cellIndex < cells.size(); ++cellIndex) {
+            cells[cellIndex] = static_cast<uint8_t>((occupancy[cellIndex >> 6] >> (cellIndex & 63)) & 1);
+        }
+
+        double levelArea = cellArea;
+        uint64_t occupiedCells = 0;
+        while (true) {
+            occupiedCells = 0;
+            for (uint8_t cell : cells) occupiedCells += cell;
+            if (size == 1 || double(stats.pointCount) >= MinPointsPerCell * double(occupiedCells)) break;
+
+            // HALVE THE RESOLUTION (A CELL IS OCCUPIED WHEN ANY OF ITS FOUR CHILDREN IS)
+            const uint32_t half = size / 2;
+            for (uint32_t y = 0; y < half; ++y) {
+                for (uint32_t x = 0; x < half; ++x) {
+                    const size_t child = size_t(2 * y) * size + 2 * x;
+                    cells[size_t(y) * half + x] = cells[child] | cells[child + 1] | cells[child + size] | cells[child + size + 1];
+                }
+            }
+            cells.resize(size_t(half) * half);
+            size = half;
+            levelArea *= 4.0;
+        }
+        output.meanSpacing = std::sqrt(double(occupiedCells) * levelArea / double(stats.pointCount));
+    }
+
+    bool SaveDatasetStats(const std::string& filepath, uint64_t decimationStep, const DatasetStats& stats) {
+        FileKey key;
+        if (stats.Empty() || !GetFileKey(filepath, decimationStep, key)) return false;
+
+        std::ofstream stream(SidecarPath(filepath), std::ios::binary | std::ios::trunc);
+        if (!stream.is_open()) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "FAILED TO WRITE DATASET STATISTICS NEXT TO %s", filepath.c_str());
+            return false;
+        }
+
+        WriteValue(stream, StatsMagic);
+        WriteValue(stream, StatsVersion);
+        WriteValue(stream, key);
+        WriteValue(stream, stats.pointCount);
+        WriteValue(stream, stats.minimum);
+        WriteValue(stream, stats.maximum);
+        WriteValue(stream, stats.minIntensity);
+        WriteValue(stream, stats.maxIntensity);
+        WriteValue(stream, stats.meanSpacing);
+        WriteValue(stream, stats.classCounts);
+        WriteValue(stream, stats.returnCounts);
+
+        // ONLY THE OCCUPIED INTENSITY RANGE (MOST SENSORS USE 8 OR 12 BITS)
+        stream.write(reinterpret_cast<const char*>(stats.intensityHistogram.data() + stats.minIntensity),
+            (size_t(stats.maxIntensity) - stats.minIntensity + 1) * sizeof(uint64_t));
+        return stream.good();
+    }
+
+    bool LoadDatasetStats(const std::string& filepath, uint64_t decimationStep, DatasetStats& stats) {
+        FileKey key;
+        if (!GetFileKey(filepath, decimationStep, key)) return false;
+
+        std::ifstream stream(SidecarPath(filepath), std::ios::binary);
+        if (!stream.is_open()) return false;
+
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        FileKey storedKey;
+        if (!ReadValue(stream, magic) || magic != StatsMagic) return false;
+        if (!ReadValue(stream, version) || version != StatsVersion) return false;
+        if (!ReadValue(stream, storedKey) || !(storedKey == key)) return false;
+
+        DatasetStats loaded;
+        bool valid = ReadValue(stream, loaded.pointCount)
+            && ReadValue(stream, loaded.minimum)
+            && ReadValue(stream, loaded.maximum)
+            && ReadValue(stream, loaded.minIntensity)
+            && ReadValue(stream, loaded.maxIntensity)
+            && ReadValue(stream, loaded.meanSpacing)
+            && ReadValue(stream, loaded.classCounts)
+            && ReadValue(stream, loaded.returnCounts);
+        if (!valid || loaded.pointCount == 0 || loaded.minIntensity > loaded.maxIntensity) return false;
+
+        loaded.intensityHistogram.assign(DatasetStats::IntensityBins, 0);
+        stream.read(reinterpret_cast<char*>(loaded.intensityHistogram.data() + loaded.minIntensity),
+            (size_t(loaded.maxIntensity) - loaded.minIntensity + 1) * sizeof(uint64_t));
+        if (!stream.good()) return false;
+
+        stats = std::move(loaded);
+        return true;
+    }
+
+}
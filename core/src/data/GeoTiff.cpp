@@ -0,0 +1,171 @@
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+
+#include <ElevationGrid.hpp>
+#include <GeoTiff.hpp>
+
+namespace Data {
+
+    namespace {
+
+        enum TiffType : uint16_t {
+            TiffAscii = 2,
+            TiffShort = 3,
+            TiffLong = 4,
+            TiffDouble = 12
+        };
+
+        struct TiffEntry {
+            uint16_t tag;
+            uint16_t type;
+            std::vector<uint8_t> values;
+        };
+
+        inline uint32_t TypeSize(uint16_t type) {
+            return type == TiffShort ? 2 : (type == TiffLong ? 4 : (type == TiffDouble ? 8 : 1));
+        }
+
+        template <typename T>
+        TiffEntry MakeEntry(uint16_t tag, uint16_t type, const std::vector<T>& values) {
+            TiffEntry entry{ tag, type, std::vector<uint8_t>(values.size() * sizeof(T)) };
+            std::memcpy(entry.values.data(), values.data(), entry.values.size());
+            return entry;
+        }
+
+        template <typename T>
+        void Append(std::vector<uint8_t>& bytes, const T& value) {
+            const uint8_t* begin = reinterpret_cast<const uint8_t*>(&value);
+            bytes.insert(bytes.end(), begin, begin + sizeof(T));
+        }
+
+    }
+
+    bool WriteElevationGeoTiff(const std::string& filepath, const Spatial::ElevationGrid& grid, const glm::dvec3& origin) {
+        if (grid.Empty()) return false;
+        const uint32_t columns = grid.GetColumns();
+        const uint32_t rows = grid.GetRows();
+        const uint32_t samples = 4;
+        const uint32_t rowBytes = columns * samples * sizeof(float);
+
+        // ONE STRIP PER ROW, IMAGE DATA FOLLOWS THE DIRECTORY AND ITS OUT-OF-LINE VALUES
+        std::vector<uint32_t> stripOffsets(rows, 0);
+        std::vector<uint32_t> stripByteCounts(rows, rowBytes);
+
+        // RASTER SPACE: PIXEL (0, 0) IS THE TOP-LEFT (MAXIMUM Y) CORNER
+        const double cellSize = grid.GetCellSize();
+        const double left = origin.x + grid.GetOrigin().x;
+        const double top = origin.y + grid.GetOrigin().y + double(rows) * cellSize;
+
+        // GEOKEY DIRECTORY: VERSION 1.1.0, MODEL TYPE PROJECTED, RASTER TYPE PIXEL-IS-AREA
+        const std::vector<uint16_t> geoKeys = { 1, 1, 0, 2, 1024, 0, 1, 1, 1025, 0, 1, 1 };
+        const char noData[] = "-9999";
+
+        // TAGS IN ASCENDING ORDER (STRIP OFFSETS ARE PATCHED ONCE THE LAYOUT IS KNOWN)
+        std::vector<TiffEntry> entries;
+        entries.push_back(MakeEntry<uint32_t>(256, TiffLong, { columns }));
+        entries.push_back(MakeEntry<uint32_t>(257, TiffLong, { rows }));
+        entries.push_back(MakeEntry<uint16_t>(258, TiffShort, { 32, 32, 32, 32 }));
+        entries.push_back(MakeEntry<uint16_t>(259, TiffShort, { 1 }));
+        entries.push_back(MakeEntry<uint16_t>(262, TiffShort, { 1 }));
+        const size_t stripOffsetsEntry = entries.size();
+        entries.push_back(MakeEntry<uint32_t>(273, TiffLong, stripOffsets));
+        entries.push_back(MakeEntry<uint16_t>(277, TiffShort, { uint16_t(samples) }));
+        entries.push_back(MakeEntry<uint32_t>(278, TiffLong, { 1 }));
+        entries.push_back(MakeEntry<uint32_t>(279, TiffLong, stripByteCounts));
+        entries.push_back(MakeEntry<uint16_t>(284, TiffShort, { 1 }));
+        entries.push_back(MakeEntry<uint16_t>(338, TiffShort, { 0, 0, 0 }));
+        entries.push_back(MakeEntry<uint16_t>(339, TiffShort, { 3, 3, 3, 3 }));
+        entries.push_back(MakeEntry<double>(33550, TiffDouble, { cellSize, cellSize, 0.0 }));
+        entries.push_back(MakeEntry<double>(33922, TiffDouble, { 0.0, 0.0, 0.0, left, top, 0.0 }));
+        entries.push_back(MakeEntry<uint16_t>(34735, TiffShort, geoKeys));
+        entries.push_back(MakeEntry<char>(42113, TiffAscii, std::vector<char>(noData, noData + sizeof(noData))));
+
+        // LAYOUT: HEADER, DIRECTORY, OUT-OF-LINE VALUES (WORD ALIGNED), IMAGE DATA
+        const uint32_t directoryOffset = 8;
+        const uint32_t directorySize = 2 + uint32_t(entries.size()) * 12 + 4;
+        const uint32_t valuesOffset = (directoryOffset + directorySize + 3) & ~uint32_t(3);
+        uint32_t outOfLineSize = 0;
+        for (const TiffEntry& entry : entries) {
+            if (entry.values.size() > 4) outOfLineSize += uint32_t((entry.values.size() + 3) & ~size_t(3));
+        }
+        const uint64_t imageOffset = uint64_t(valuesOffset) + outOfLineSize;
+        if (imageOffset + uint64_t(rowBytes) * rows > UINT32_MAX) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "GEOTIFF EXPORT: %u x %u GRID EXCEEDS THE 4 GB CLASSIC TIFF LIMIT", columns, rows);
+            return false;
+        }
+        for (uint32_t row = 0; row < rows; ++row) stripOffsets[row] = uint32_t(imageOffset) + row * rowBytes;
+        entries[stripOffsetsEntry] = MakeEntry<uint32_t>(273, TiffLong, stripOffsets);
+
+        // HEADER + DIRECTORY + VALUES (LITTLE-ENDIAN HOST, MATCHES THE "II" BYTE ORDER MARK)
+        std::vector<uint8_t> bytes;
+        bytes.reserve(size_t(imageOffset));
+        bytes.push_back('I');
+        bytes.push_back('I');
+        Append<uint16_t>(bytes, 42);
+        Append<uint32_t>(bytes, directoryOffset);
+        Append<uint16_t>(bytes, uint16_t(entries.size()));
+        uint32_t nextValue = valuesOffset;
+        for (const TiffEntry& entry : entries) {
+            Append<uint16_t>(bytes, entry.tag);
+            Append<uint16_t>(bytes, entry.type);
+            Append<uint32_t>(bytes, uint32_t(entry.values.size() / TypeSize(entry.type)));
+            if (entry.values.size() <= 4) {
+                uint8_t inlineValue[4] = { 0, 0, 0, 0 };
+                std::memcpy(inlineValue, entry.values.data(), entry.values.size());
+                bytes.insert(bytes.end(), inlineValue, inlineValue + 4);
+            } else {
+                Append<uint32_t>(bytes, nextValue);
+                nextValue += uint32_t((entry.values.size() + 3) & ~size_t(3));
+            }
+        }
+        Append<uint32_t>(bytes, 0);
+        bytes.resize(valuesOffset, 0);
+        for (const TiffEntry& entry : entries) {
+            if (entry.values.size() <= 4) continue;
+            bytes.insert(bytes.end(), entry.values.begin(), entry.values.end());
+            bytes.resize((bytes.size() + 3) & ~size_t(3), 0);
+        }
+
+        std::ofstream stream(filepath, std::ios::binary | std::ios::trunc);
+        if (!stream.is_open()) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "FAILED TO WRITE GEOTIFF %s", filepath.c_str());
+            return false;
+        }
+        stream.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+
+        // ROWS TOP DOWN, ELEVATIONS BACK IN FILE COORDINATES
+        const std::vector<uint32_t>& counts = grid.GetCounts();
+        const float heightOffset = static_cast<float>(origin.z);
+        std::vector<float> rowValues(size_t(columns) * samples);
+        for (uint32_t row = 0; row < rows; ++row) {
+            const uint32_t gridRow = rows - 1 - row;
+            for (uint32_t column = 0; column < columns; ++column) {
+                const size_t cell = grid.CellIndex(column, gridRow);
+                float* pixel = rowValues.data() + size_t(column) * samples;
+                if (counts[cell] == 0) {
+                    pixel[0] = pixel[1] = pixel[2] = pixel[3] = GeoTiffNoData;
+                    continue;
+                }
+                pixel[0] = grid.GetMinimums()[cell] + heightOffset;
+                pixel[1] = grid.GetMaximums()[cell] + heightOffset;
+                pixel[2] = grid.GetMeans()[cell] + heightOffset;
+                pixel[3] = grid.GetIntensities()[cell];
+            }
+            stream.write(reinterpret_cast<const char*>(rowValues.data()), rowBytes);
+        }
+
+        if (!stream.good()) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "FAILED TO WRITE GEOTIFF %s", filepath.c_str());
+            return false;
+        }
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "GEOTIFF EXPORT: %u x %u CELLS (%.3f) WRITTEN TO %s", columns, rows, cellSize, filepath.c_str());
+        return true;
+    }
+
+}
@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <CubeInstance.hpp>
+#include <IntensityEqualizer.hpp>
+#include <MemoryPool.hpp>
+#include <Parallel.hpp>
+
+namespace Data {
+
+    void IntensityEqualizer::Build(const CubeInstance* points, size_t count, AllocationStats& loadStats) {
+        // A THREAD ONLY PAYS FOR ITS OWN HISTOGRAM WHEN IT COUNTS AT LEAST AS MANY POINTS AS THERE ARE BINS,
+        // DRAWN SETS USE A GLuint INSTANCE COUNT SO 32-BIT BINS CANNOT OVERFLOW
+        const unsigned threads = static_cast<unsigned>(std::min<size_t>(Parallel::ThreadCount(), std::max<size_t>(count / BinCount, 1)));
+        AcquireBuffer(threadHistograms, size_t(threads) * BinCount, loadStats);
+        AcquireBuffer(cumulative, BinCount, loadStats);
+        std::fill(threadHistograms.begin(), threadHistograms.end(), 0u);
+
+        Parallel::For(count, [&](size_t begin, size_t end, unsigned thread) {
+            uint32_t* bins = threadHistograms.data() + size_t(thread) * BinCount;
+            for (size_t i = begin; i < end; ++i) bins[points[i].intensity]++;
+        }, threads);
+
+        // MERGE BIN RANGES IN PARALLEL
+        Parallel::For(BinCount, [&](size_t begin, size_t end, unsigned) {
+            for (size_t bin = begin; bin < end; ++bin) {
+                uint64_t total = 0;
+                for (unsigned thread = 0; thread < threads; ++thread) total += threadHistograms[size_t(thread) * BinCount + bin];
+                cumulative[bin] = total;
+            }
+        });
+
+        // BUILD CUMULATIVE HISTOGRAM (CUMULATIVE DISTRIBUTION FUNCTION)
+        for (size_t bin = 1; bin < BinCount; ++bin) cumulative[bin] += cumulative[bin - 1];
+    }
+
+    size_t IntensityEqualizer::FirstBinReaching(uint64_t threshold) const {
+        return size_t(std::lower_bound(cumulative.begin(), cumulative.end(), threshold) - cumulative.begin());
+    }
+
+    void IntensityEqualizer::WriteTable(bool equalize, float lowFraction, float highFraction, float* table) const {
+        const uint64_t total = cumulative.empty() ? 0 : cumulative.back();
+        if (total == 0) {
+            std::fill(table, table + BinCount, 0.0f);
+            return;
+        }
+
+        // EQUALIZED VALUE = CDF(intensity) / POINT COUNT
+        if (equalize) {
+            const float totalInverse = 1.0f / float(total);
+            for (size_t bin = 0; bin < BinCount; ++bin) table[bin] = float(cumulative[bin]) * totalInverse;
+            return;
+        }
+
+        // LINEAR BETWEEN TWO PERCENTILES (0 AND 1 ARE THE MIN / MAX INTENSITY)
+        auto threshold = [total](float fraction) {
+            return std::clamp<uint64_t>(uint64_t(std::ceil(double(fraction) * double(total))), 1, total);
+        };
+        const size_t lowBin = FirstBinReaching(threshold(lowFraction));
+        const size_t highBin = FirstBinReaching(threshold(highFraction));
+        const float range = float(std::max(highBin, lowBin + 1) - lowBin);
+        for (size_t bin = 0; bin < BinCount; ++bin) {
+            table[bin] = std::clamp((float(bin) - float(lowBin)) / range, 0.0f, 1.0f);
+        }
+    }
+
+}
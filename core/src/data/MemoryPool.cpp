@@ -0,0 +1,54 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <MemoryPool.hpp>
+
+namespace Data {
+
+    void LoadArena::Reset(AllocationStats* loadStats) {
+        stats = loadStats;
+        currentChunk = 0;
+        for (Chunk& chunk : chunks) {
+            chunk.used = 0;
+        }
+    }
+
+    size_t LoadArena::CapacityBytes() const {
+        size_t capacity = 0;
+        for (const Chunk& chunk : chunks) {
+            capacity += chunk.size;
+        }
+        return capacity;
+    }
+
+    void* LoadArena::AllocateBytes(size_t bytes, size_t alignment) {
+        // FIRST RETAINED CHUNK (FROM THE CURRENT ONE) WITH ENOUGH SPACE
+        for (; currentChunk < chunks.size(); ++currentChunk) {
+            Chunk& chunk = chunks[currentChunk];
+            size_t offset = (chunk.used + alignment - 1) & ~(alignment - 1);
+            if (offset + bytes <= chunk.size) {
+                chunk.used = offset + bytes;
+                if (stats) stats->RecordReuse(bytes);
+                return chunk.memory.get() + offset;
+            }
+        }
+
+        // GROW THE ARENA (KEPT FOR LATER LOADS)
+        Chunk chunk;
+        chunk.size = std::max(chunkSize, bytes + alignment);
+        chunk.memory = std::make_unique<uint8_t[]>(chunk.size);
+        if (stats) stats->RecordAllocation(chunk.size);
+
+        size_t address = reinterpret_cast<size_t>(chunk.memory.get());
+        size_t offset = ((address + alignment - 1) & ~(alignment - 1)) - address;
+        chunk.used = offset + bytes;
+
+        chunks.push_back(std::move(chunk));
+        currentChunk = chunks.size() - 1;
+        return chunks.back().memory.get() + offset;
+    }
+
+}
@@ -0,0 +1,112 @@
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+
+#include <DatasetStats.hpp>
+#include <MemoryPool.hpp>
+#include <NormalCache.hpp>
+#include <Parallel.hpp>
+#include <PointStore.hpp>
+
+namespace Data {
+
+    namespace {
+
+        constexpr uint32_t NormalsMagic = 0x4D4E564C;  // "LVNM"
+        constexpr uint32_t NormalsVersion = 1;
+
+        inline std::string SidecarPath(const std::string& filepath) { return filepath + ".normals"; }
+
+        template <typename T>
+        inline void WriteValue(std::ofstream& stream, const T& value) {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        inline bool ReadValue(std::ifstream& stream, T& value) {
+            stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+            return stream.good();
+        }
+
+        // FNV-1A OVER THE POSITION BITS OF THE FIRST POINT OF EVERY BLOCK (CHANGES WITH ANY FILTER THAT REORDERS OR DROPS POINTS)
+        uint64_t LayoutHash(const PointStore& pointStore) {
+            uint64_t hash = 0xCBF29CE484222325ull;
+            auto mix = [&](const void* data, size_t size) {
+                const uint8_t* bytes = static_cast<const uint8_t*>(data);
+                for (size_t i = 0; i < size; ++i) {
+                    hash ^= bytes[i];
+                    hash *= 0x100000001B3ull;
+                }
+            };
+
+            // COMPRESSED BLOCKS ARE DECODED WHOLE, SO THE FIRST POSITIONS ARE GATHERED IN PARALLEL
+            std::vector<glm::vec3> firstPositions(pointStore.BlockCount(), glm::vec3(0.0f));
+            Parallel::For(firstPositions.size(), [&](size_t begin, size_t end, unsigned) {
+                for (size_t blockIndex = begin; blockIndex < end; ++blockIndex) {
+                    uint32_t count = 0;
+                    const CubeInstance* points = pointStore.GetBlock(blockIndex, count);
+                    if (count > 0) firstPositions[blockIndex] = points[0].position;
+                }
+            }, Parallel::ThreadCount());
+
+            const uint64_t pointCount = pointStore.Size();
+            mix(&pointCount, sizeof(pointCount));
+            mix(firstPositions.data(), firstPositions.size() * sizeof(glm::vec3));
+            return hash;
+        }
+
+    }
+
+    bool SavePointNormals(const std::string& filepath, uint64_t decimationStep, uint32_t neighborCount,
+        const PointStore& pointStore, const std::vector<uint16_t>& encodedNormals) {
+        FileKey key;
+        if (encodedNormals.empty() || encodedNormals.size() != pointStore.Size() || !GetFileKey(filepath, decimationStep, key)) return false;
+
+        std::ofstream stream(SidecarPath(filepath), std::ios::binary | std::ios::trunc);
+        if (!stream.is_open()) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "FAILED TO WRITE POINT NORMALS NEXT TO %s", filepath.c_str());
+            return false;
+        }
+
+        const uint64_t pointCount = encodedNormals.size();
+        WriteValue(stream, NormalsMagic);
+        WriteValue(stream, NormalsVersion);
+        WriteValue(stream, key);
+        WriteValue(stream, neighborCount);
+        WriteValue(stream, pointCount);
+        WriteValue(stream, LayoutHash(pointStore));
+        stream.write(reinterpret_cast<const char*>(encodedNormals.data()), pointCount * sizeof(uint16_t));
+        return stream.good();
+    }
+
+    bool LoadPointNormals(const std::string& filepath, uint64_t decimationStep, uint32_t neighborCount,
+        const PointStore& pointStore, std::vector<uint16_t>& encodedNormals, AllocationStats& loadStats) {
+        FileKey key;
+        if (pointStore.Empty() || !GetFileKey(filepath, decimationStep, key)) return false;
+
+        std::ifstream stream(SidecarPath(filepath), std::ios::binary);
+        if (!stream.is_open()) return false;
+
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        FileKey storedKey;
+        uint32_t storedNeighbors = 0;
+        uint64_t pointCount = 0;
+        uint64_t layoutHash = 0;
+        if (!ReadValue(stream, magic) || magic != NormalsMagic) return false;
+        if (!ReadValue(stream, version) || version != NormalsVersion) return false;
+        if (!ReadValue(stream, storedKey) || !(storedKey == key)) return false;
+        if (!ReadValue(stream, storedNeighbors) || storedNeighbors != neighborCount) return false;
+        if (!ReadValue(stream, pointCount) || pointCount != pointStore.Size()) return false;
+        if (!ReadValue(stream, layoutHash) || layoutHash != LayoutHash(pointStore)) return false;
+
+        AcquireBuffer(encodedNormals, pointCount, loadStats);
+        stream.read(reinterpret_cast<char*>(encodedNormals.data()), pointCount * sizeof(uint16_t));
+        return stream.good();
+    }
+
+}
@@ -0,0 +1,530 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define POINT_STORE_SSE2 1
+#endif
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+
+#include <CubeInstance.hpp>
+#include <Morton.hpp>
+#include <Parallel.hpp>
+#include <PointStore.hpp>
+#include <RadixSort.hpp>
+
+namespace Data {
+
+    namespace {
+
+        // TRAILING BYTES PER BLOCK SO UNALIGNED 8-BYTE LOADS NEVER READ PAST THE BLOCK
+        constexpr uint64_t BlockPadding = 8;
+
+        // PER-THREAD ENCODE/DECODE SCRATCH (ONE BLOCK OF POINTS)
+        struct BlockScratch {
+            std::vector<CubeInstance> points;
+            std::vector<uint32_t> values;
+            std::vector<int32_t> quantized[3];
+            std::vector<float> coordinates[3];
+
+            BlockScratch() {
+                points.resize(PointStore::BlockSize);
+                values.resize(PointStore::BlockSize);
+                for (std::vector<int32_t>& axis : quantized) axis.resize(PointStore::BlockSize);
+                for (std::vector<float>& axis : coordinates) axis.resize(PointStore::BlockSize);
+            }
+        };
+
+        inline BlockScratch& ThreadScratch() {
+            thread_local BlockScratch scratch;
+            return scratch;
+        }
+
+        inline uint8_t BitWidth(uint32_t value) {
+            uint8_t bits = 0;
+            while (value) {
+                ++bits;
+                value >>= 1;
+            }
+            return bits;
+        }
+
+        inline uint64_t PackedSize(uint32_t count, uint8_t bits) {
+            return (uint64_t(count) * bits + 7) / 8;
+        }
+
+        // OUTPUT MUST BE ZEROED AND PADDED BY (BlockPadding) BYTES
+        inline void PackValues(const uint32_t* values, uint32_t count, uint8_t bits, uint8_t* output) {
+            if (bits == 0) return;
+            uint64_t bitPosition = 0;
+            for (uint32_t i = 0; i < count; ++i) {
+                uint64_t word;
+                std::memcpy(&word, output + (bitPosition >> 3), sizeof(word));
+                word |= uint64_t(values[i]) << (bitPosition & 7);
+                std::memcpy(output + (bitPosition >> 3), &word, sizeof(word));
+                bitPosition += bits;
+            }
+        }
+
+#ifdef POINT_STORE_SSE2
+        // FOUR UNALIGNED 4-BYTE LOADS AT (group + offsets[k]) AS ONE VECTOR
+        inline __m128i LoadLanes(const uint8_t* group, const uint32_t* offsets) {
+            uint32_t words[4];
+            for (int k = 0; k < 4; ++k) std::memcpy(&words[k], group + offsets[k], sizeof(uint32_t));
+            return _mm_set_epi32(int(words[3]), int(words[2]), int(words[1]), int(words[0]));
+        }
+
+        // (words >> shift) PER LANE AS THE HIGH HALF OF ((words << 1) * 2^(31 - shift)), SSE2 HAS NO VARIABLE SHIFTS
+        // THE DOUBLING DROPS BIT 31, WHICH IS PAST THE VALUE WHILE shift + bits <= 31
+        inline __m128i ShiftLanes(__m128i words, __m128i multipliers) {
+            const __m128i doubled = _mm_slli_epi32(words, 1);
+            const __m128i even = _mm_mul_epu32(doubled, multipliers);
+            const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(doubled, 32), _mm_srli_epi64(multipliers, 32));
+            const __m128i oddHighMask = _mm_set_epi32(-1, 0, -1, 0);
+            return _mm_or_si128(_mm_srli_epi64(even, 32), _mm_and_si128(odd, oddHighMask));
+        }
+
+        // WIDTHS UP TO 24 BITS, 8 VALUES PER STEP: EVERY STEP STARTS ON A BYTE (8 * bits BITS), SO THE LANE OFFSETS AND
+        // SHIFTS ARE THE SAME FOR EVERY STEP AND EACH LANE FITS ONE 4-BYTE LOAD. RETURNS THE NUMBER OF VALUES WRITTEN
+        inline uint32_t UnpackValuesSse2(const uint8_t* input, uint32_t count, uint8_t bits, uint32_t* output) {
+            uint32_t offsets[8];
+            uint32_t multipliers[8];
+            for (uint32_t k = 0; k < 8; ++k) {
+                offsets[k] = (k * bits) >> 3;
+                multipliers[k] = 1u << (31 - ((k * bits) & 7));
+            }
+            const __m128i lowMultipliers = _mm_loadu_si128(reinterpret_cast<const __m128i*>(multipliers));
+            const __m128i highMultipliers = _mm_loadu_si128(reinterpret_cast<const __m128i*>(multipliers + 4));
+            const __m128i mask = _mm_set1_epi32(int((1u << bits) - 1));
+
+            uint32_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const uint8_t* group = input + ((uint64_t(i) * bits) >> 3);
+                __m128i low = _mm_and_si128(ShiftLanes(LoadLanes(group, offsets), lowMultipliers), mask);
+                __m128i high = _mm_and_si128(ShiftLanes(LoadLanes(group, offsets + 4), highMultipliers), mask);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), low);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i + 4), high);
+            }
+            return i;
+        }
+#endif
+
+        // BRANCH-FREE UNPACK (WIDTH <= 32 BITS, SO ONE 8-BYTE LOAD ALWAYS COVERS THE VALUE)
+        // SSE2 TAKES WHOLE STEPS OF 8 VALUES UP TO 24 BITS, THE SCALAR LOOP THE REST
+        inline void UnpackValues(const uint8_t* input, uint32_t count, uint8_t bits, uint32_t* output) {
+            if (bits == 0) {
+                std::fill(output, output + count, 0u);
+                return;
+            }
+            uint32_t first = 0;
+#ifdef POINT_STORE_SSE2
+            if (bits <= 24) first = UnpackValuesSse2(input, count, bits, output);
+#endif
+            const uint64_t mask = (uint64_t(1) << bits) - 1;
+            for (uint32_t i = first; i < count; ++i) {
+                uint64_t bitPosition = uint64_t(i) * bits;
+                uint64_t word;
+                std::memcpy(&word, input + (bitPosition >> 3), sizeof(word));
+                output[i] = static_cast<uint32_t>((word >> (bitPosition & 7)) & mask);
+            }
+        }
+
+        // DEQUANTIZE (BASE + DELTA) * QUANTIZATION INTO FLOATS
+        inline void Dequantize(const uint32_t* deltas, uint32_t count, int32_t base, float quantization, float* output) {
+            uint32_t i = 0;
+#ifdef POINT_STORE_SSE2
+            const __m128i baseVector = _mm_set1_epi32(base);
+            const __m128 scaleVector = _mm_set1_ps(quantization);
+            for (; i + 4 <= count; i += 4) {
+                __m128i delta = _mm_loadu_si128(reinterpret_cast<const __m128i*>(deltas + i));
+                __m128 value = _mm_cvtepi32_ps(_mm_add_epi32(baseVector, delta));
+                _mm_storeu_ps(output + i, _mm_mul_ps(value, scaleVector));
+            }
+#endif
+            for (; i < count; ++i) {
+                output[i] = float(base + int32_t(deltas[i])) * quantization;
+            }
+        }
+
+    }
+
+    void PointStore::Reset(uint64_t expectedCount, bool compress, float quantizationStep, AllocationStats* loadStats) {
+        compressed = compress;
+        quantization = quantizationStep > 0.0f ? quantizationStep : 0.001f;
+        pointCount = 0;
+        stats = loadStats;
+
+        points.clear();
+        blocks.clear();
+        packedBytes.clear();
+        normals.clear();
+        hasNormals = false;
+
+        AllocationStats unused;
+        AllocationStats& allocationStats = stats ? *stats : unused;
+        if (compressed) {
+            ReserveBuffer(points, size_t(BlockSize) * SortChunkBlocks, allocationStats);
+            ReserveBuffer(blocks, (expectedCount + BlockSize - 1) / BlockSize, allocationStats);
+            ReserveBuffer(packedBytes, static_cast<size_t>(expectedCount * packedBytesPerPoint), allocationStats);
+        } else {
+            ReserveBuffer(points, expectedCount, allocationStats);
+        }
+        reservedPackedBytes = packedBytes.capacity();
+    }
+
+    void PointStore::Clear() {
+        pointCount = 0;
+
+        points.clear();
+        blocks.clear();
+        packedBytes.clear();
+        normals.clear();
+        hasNormals = false;
+    }
+
+    void PointStore::Add(const glm::vec3& position, uint16_t intensity, uint32_t attributes) {
+        points.emplace_back(position, intensity, attributes);
+        ++pointCount;
+
+        if (compressed && points.size() == size_t(BlockSize) * SortChunkBlocks) {
+            FlushStaging();
+        }
+    }
+
+    void PointStore::Finalize() {
+        if (!compressed) {
+            uint64_t start = SDL_GetTicksNS();
+            SortSpatially(points, Parallel::ThreadCount());
+            uint64_t elapsed = SDL_GetTicksNS() - start;
+
+            // TINY STORES CAN SORT WITHIN ONE TICK
+            if (!points.empty()) {
+                double seconds = std::max(double(elapsed), 1.0) / 1.0e9;
+                SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+                    "POINT STORE: MORTON ORDER IN %.1f MS (%.1f M POINTS/S, %u THREADS, %s KEYS)",
+                    elapsed / 1.0e6, double(points.size()) / seconds / 1.0e6,
+                    Parallel::ThreadCount(), Spatial::HasBmi2() ? "BMI2" : "SCALAR");
+            }
+
+            // 12 BYTES PER POINT, TOO MUCH TO KEEP AROUND NEXT TO AN UNCOMPRESSED STORE
+            std::vector<uint64_t>().swap(sortKeys);
+            std::vector<uint32_t>().swap(sortOrder);
+            sortScratch = Spatial::SortScratch();
+            return;
+        }
+
+        FlushStaging();
+
+        // RECORD GROWTH PAST THE RESERVATION, REMEMBER THE RATIO FOR THE NEXT LOAD
+        if (stats && packedBytes.capacity() > reservedPackedBytes) {
+            stats->RecordAllocation(packedBytes.capacity());
+        }
+        if (pointCount > 0) {
+            packedBytesPerPoint = 1.05 * double(packedBytes.size()) / double(pointCount);
+        }
+    }
+
+    void PointStore::RemovePoints(const std::vector<uint8_t>& keepFlags) {
+        if (!compressed) {
+            size_t kept = 0;
+            for (size_t i = 0; i < points.size(); ++i) {
+                if (keepFlags[i]) points[kept++] = points[i];
+            }
+            points.resize(kept);
+            pointCount = kept;
+            return;
+        }
+
+        // RE-ENCODE FROM THE OLD STREAMS INTO NEW ONES (NEVER LARGER THAN THE OLD ONES)
+        std::vector<PointBlock> oldBlocks;
+        std::vector<uint8_t> oldBytes;
+        oldBlocks.swap(blocks);
+        oldBytes.swap(packedBytes);
+
+        AllocationStats unused;
+        AllocationStats& allocationStats = stats ? *stats : unused;
+        ReserveBuffer(blocks, oldBlocks.size(), allocationStats);
+        ReserveBuffer(packedBytes, oldBytes.size(), allocationStats);
+
+        std::vector<CubeInstance> decoded(BlockSize);
+        points.clear();
+        uint64_t firstIndex = 0;
+        uint64_t kept = 0;
+        for (const PointBlock& block : oldBlocks) {
+            DecodeBlock(block, oldBytes.data(), decoded.data());
+            for (uint32_t i = 0; i < block.count; ++i) {
+                if (!keepFlags[firstIndex + i]) continue;
+                points.push_back(decoded[i]);
+                if (points.size() == BlockSize) {
+                    EncodeBlock(points.data(), BlockSize);
+                    points.clear();
+                }
+                ++kept;
+            }
+            firstIndex += block.count;
+        }
+        if (!points.empty()) EncodeBlock(points.data(), static_cast<uint32_t>(points.size()));
+        points.clear();
+        pointCount = kept;
+
+        // THE NORMAL STREAM FOLLOWS THE SAME COMPACTION
+        if (!normals.empty()) {
+            size_t keptNormals = 0;
+            for (size_t i = 0; i < normals.size(); ++i) {
+                if (keepFlags[i]) normals[keptNormals++] = normals[i];
+            }
+            normals.resize(keptNormals);
+        }
+    }
+
+    void PointStore::SetNormals(const std::vector<uint16_t>& encodedNormals) {
+        if (encodedNormals.size() != pointCount) return;
+        hasNormals = true;
+        if (!compressed) {
+            Parallel::For(points.size(), [&](size_t begin, size_t end, unsigned) {
+                for (size_t i = begin; i < end; ++i) points[i].normal = encodedNormals[i];
+            }, Parallel::ThreadCount());
+            return;
+        }
+
+        AllocationStats unused;
+        AllocationStats& allocationStats = stats ? *stats : unused;
+        AcquireBuffer(normals, encodedNormals.size(), allocationStats);
+        std::copy(encodedNormals.begin(), encodedNormals.end(), normals.begin());
+    }
+
+    void PointStore::SwapIntensities(std::vector<uint16_t>& intensities) {
+        if (intensities.size() != pointCount) return;
+        if (!compressed) {
+            Parallel::For(points.size(), [&](size_t begin, size_t end, unsigned) {
+                for (size_t i = begin; i < end; ++i) std::swap(points[i].intensity, intensities[i]);
+            }, Parallel::ThreadCount());
+            return;
+        }
+
+        // RE-ENCODE BLOCK BY BLOCK (INTENSITY WIDTHS CHANGE, SO DO THE BLOCK SIZES), POSITIONS ROUND-TRIP EXACTLY
+        std::vector<PointBlock> oldBlocks;
+        std::vector<uint8_t> oldBytes;
+        oldBlocks.swap(blocks);
+        oldBytes.swap(packedBytes);
+
+        AllocationStats unused;
+        AllocationStats& allocationStats = stats ? *stats : unused;
+        ReserveBuffer(blocks, oldBlocks.size(), allocationStats);
+        ReserveBuffer(packedBytes, oldBytes.size(), allocationStats);
+
+        std::vector<CubeInstance> decoded(BlockSize);
+        uint64_t firstIndex = 0;
+        for (const PointBlock& block : oldBlocks) {
+            DecodeBlock(block, oldBytes.data(), decoded.data());
+            for (uint32_t i = 0; i < block.count; ++i) std::swap(decoded[i].intensity, intensities[firstIndex + i]);
+            EncodeBlock(decoded.data(), block.count);
+            firstIndex += block.count;
+        }
+    }
+
+    void PointStore::FlushStaging() {
+        if (points.empty()) return;
+
+        // SPATIALLY COHERENT BLOCKS HAVE SMALLER DELTAS, SO THEY PACK TIGHTER
+        SortSpatially(points, 1);
+        for (size_t first = 0; first < points.size(); first += BlockSize) {
+            uint32_t count = static_cast<uint32_t>(std::min<size_t>(BlockSize, points.size() - first));
+            EncodeBlock(points.data() + first, count);
+        }
+        points.clear();
+    }
+
+    void PointStore::SortSpatially(std::vector<CubeInstance>& input, unsigned threadCount) {
+        const size_t count = input.size();
+        if (count < 2) return;
+
+        // BOUNDS OF THE POINTS BEING SORTED
+        std::vector<glm::vec3> minimums(threadCount, glm::vec3(FLT_MAX));
+        std::vector<glm::vec3> maximums(threadCount, glm::vec3(-FLT_MAX));
+        Parallel::For(count, [&](size_t begin, size_t end, unsigned thread) {
+            for (size_t i = begin; i < end; ++i) {
+                minimums[thread] = glm::min(minimums[thread], input[i].position);
+                maximums[thread] = glm::max(maximums[thread], input[i].position);
+            }
+        }, threadCount);
+        glm::vec3 minimum = minimums[0];
+        glm::vec3 maximum = maximums[0];
+        for (unsigned thread = 1; thread < threadCount; ++thread) {
+            minimum = glm::min(minimum, minimums[thread]);
+            maximum = glm::max(maximum, maximums[thread]);
+        }
+        const Spatial::MortonGrid grid = Spatial::MortonGrid::FromBounds(minimum, maximum);
+
+        AllocationStats unused;
+        AllocationStats& allocationStats = stats ? *stats : unused;
+        AcquireBuffer(sortKeys, count, allocationStats);
+        AcquireBuffer(sortOrder, count, allocationStats);
+        AcquireBuffer(sortScratch.keys, count, allocationStats);
+        AcquireBuffer(sortScratch.values, count, allocationStats);
+
+        Parallel::For(count, [&](size_t begin, size_t end, unsigned) {
+            Spatial::ComputeMortonKeys(&input[begin].position, sizeof(CubeInstance), end - begin, grid, sortKeys.data() + begin);
+        }, threadCount);
+        Spatial::SortedOrder(sortKeys, sortOrder, sortScratch, Spatial::MortonKeyBits, threadCount);
+
+        // IN-PLACE CYCLE PERMUTATION, NO SECOND COPY OF THE POINTS
+        for (size_t i = 0; i < count; ++i) {
+            if (sortOrder[i] == i) continue;
+            CubeInstance first = input[i];
+            size_t current = i;
+            while (true) {
+                size_t next = sortOrder[current];
+                sortOrder[current] = static_cast<uint32_t>(current);
+                if (next == i) {
+                    input[current] = first;
+                    break;
+                }
+                input[current] = input[next];
+                current = next;
+            }
+        }
+    }
+
+    size_t PointStore::BlockCount() const {
+        if (compressed) return blocks.size();
+        return (points.size() + BlockSize - 1) / BlockSize;
+    }
+
+    size_t PointStore::ResidentBytes() const {
+        return points.capacity() * sizeof(CubeInstance)
+            + blocks.capacity() * sizeof(PointBlock)
+            + packedBytes.capacity()
+            + normals.capacity() * sizeof(uint16_t);
+    }
+
+    double PointStore::EstimatedBytesPerPoint(bool compress) const {
+        if (!compress) return double(sizeof(CubeInstance));
+        return packedBytesPerPoint + double(sizeof(PointBlock)) / double(BlockSize);
+    }
+
+    const CubeInstance* PointStore::GetBlock(size_t blockIndex, uint32_t& count) const {
+        if (!compressed) {
+            uint64_t first = uint64_t(blockIndex) * BlockSize;
+            count = static_cast<uint32_t>(std::min<uint64_t>(BlockSize, points.size() - first));
+            return points.data() + first;
+        }
+
+        BlockScratch& scratch = ThreadScratch();
+        const PointBlock& block = blocks[blockIndex];
+        DecodeBlock(block, packedBytes.data(), scratch.points.data());
+        count = block.count;
+        if (!normals.empty()) {
+            const uint16_t* blockNormals = normals.data() + uint64_t(blockIndex) * BlockSize;
+            for (uint32_t i = 0; i < count; ++i) scratch.points[i].normal = blockNormals[i];
+        }
+        return scratch.points.data();
+    }
+
+    void PointStore::EncodeBlock(const CubeInstance* input, uint32_t count) {
+        PointBlock block;
+        block.count = count;
+        block.byteOffset = packedBytes.size();
+
+        BlockScratch& scratch = ThreadScratch();
+        uint32_t* values = scratch.values.data();
+
+        // QUANTIZE POSITIONS, FIND BLOCK MINIMUM/MAXIMUM
+        std::vector<int32_t>* quantized = scratch.quantized;
+        glm::ivec3 minimum(INT32_MAX);
+        glm::ivec3 maximum(INT32_MIN);
+        for (int axis = 0; axis < 3; ++axis) {
+            for (uint32_t i = 0; i < count; ++i) {
+                int32_t value = static_cast<int32_t>(std::lround(input[i].position[axis] / quantization));
+                quantized[axis][i] = value;
+                minimum[axis] = std::min(minimum[axis], value);
+                maximum[axis] = std::max(maximum[axis], value);
+            }
+            block.positionBase[axis] = minimum[axis];
+            block.positionBits[axis] = BitWidth(static_cast<uint32_t>(int64_t(maximum[axis]) - minimum[axis]));
+        }
+
+        uint16_t minIntensity = UINT16_MAX;
+        uint16_t maxIntensity = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            minIntensity = std::min(minIntensity, input[i].intensity);
+            maxIntensity = std::max(maxIntensity, input[i].intensity);
+        }
+        block.intensityBase = minIntensity;
+        block.intensityBits = BitWidth(uint32_t(maxIntensity - minIntensity));
+
+        // PACKED ATTRIBUTES AS ONE VALUE (THE SOURCE ID IN THE HIGH BITS RARELY CHANGES WITHIN A BLOCK)
+        uint32_t minAttributes = UINT32_MAX;
+        uint32_t maxAttributes = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            minAttributes = std::min(minAttributes, input[i].attributes);
+            maxAttributes = std::max(maxAttributes, input[i].attributes);
+        }
+        block.attributeBase = minAttributes;
+        block.attributeBits = BitWidth(maxAttributes - minAttributes);
+
+        // ALLOCATE ZEROED STREAMS (X, Y, Z, INTENSITY, ATTRIBUTES) PLUS PADDING
+        uint64_t blockBytes = BlockPadding;
+        for (int axis = 0; axis < 3; ++axis) blockBytes += PackedSize(count, block.positionBits[axis]);
+        blockBytes += PackedSize(count, block.intensityBits);
+        blockBytes += PackedSize(count, block.attributeBits);
+        packedBytes.resize(packedBytes.size() + blockBytes, 0);
+
+        uint8_t* output = packedBytes.data() + block.byteOffset;
+        for (int axis = 0; axis < 3; ++axis) {
+            for (uint32_t i = 0; i < count; ++i) {
+                values[i] = static_cast<uint32_t>(int64_t(quantized[axis][i]) - block.positionBase[axis]);
+            }
+            PackValues(values, count, block.positionBits[axis], output);
+            output += PackedSize(count, block.positionBits[axis]);
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            values[i] = uint32_t(input[i].intensity - block.intensityBase);
+        }
+        PackValues(values, count, block.intensityBits, output);
+        output += PackedSize(count, block.intensityBits);
+        for (uint32_t i = 0; i < count; ++i) {
+            values[i] = input[i].attributes - block.attributeBase;
+        }
+        PackValues(values, count, block.attributeBits, output);
+
+        blocks.push_back(block);
+    }
+
+    void PointStore::DecodeBlock(const PointBlock& block, const uint8_t* bytes, CubeInstance* output) const {
+        BlockScratch& scratch = ThreadScratch();
+        const uint8_t* input = bytes + block.byteOffset;
+        const uint32_t count = block.count;
+
+        for (int axis = 0; axis < 3; ++axis) {
+            UnpackValues(input, count, block.positionBits[axis], scratch.values.data());
+            Dequantize(scratch.values.data(), count, block.positionBase[axis], quantization, scratch.coordinates[axis].data());
+            input += PackedSize(count, block.positionBits[axis]);
+        }
+        UnpackValues(input, count, block.intensityBits, scratch.values.data());
+        for (uint32_t i = 0; i < count; ++i) {
+            output[i].intensity = static_cast<uint16_t>(block.intensityBase + scratch.values[i]);
+        }
+        input += PackedSize(count, block.intensityBits);
+        UnpackValues(input, count, block.attributeBits, scratch.values.data());
+
+        // INTERLEAVE INTO THE OUTPUT POINTS
+        for (uint32_t i = 0; i < count; ++i) {
+            output[i].position = glm::vec3(
+                scratch.coordinates[0][i],
+                scratch.coordinates[1][i],
+                scratch.coordinates[2][i]
+            );
+            output[i].normal = 0;
+            output[i].attributes = block.attributeBase + scratch.values[i];
+        }
+    }
+
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <memory>
@@ -14,21 +15,51 @@
 #include <pdal/Streamable.hpp>
 #include <pdal/filters/StreamCallbackFilter.hpp>
 
+#include <CubeInstance.hpp>
 #include <CubeRenderer.hpp>
+#include <DatasetStats.hpp>
 #include <LazHeader.hpp>
 #include <LazReader.hpp>
+#include <PointStore.hpp>
 
 using namespace pdal;
 
 namespace CustomReader {
 
     // CONSTUCTOR
-    LazReader::LazReader(const std::string& filepath, CubeRenderer* cubeRenderer) {
+    LazReader::LazReader(const std::string& filepath, CubeRenderer* cubeRenderer, Data::DatasetStats* stats) {
         options.filepath = filepath;
         options.cubeRenderer = cubeRenderer;
+        options.stats = stats;
         options.header = GetLazHeader(filepath);
     }
 
+    LazReader::LazReader(const std::string& filepath, Data::PointStore* targetStore, const glm::dvec3& origin) {
+        options.filepath = filepath;
+        options.targetStore = targetStore;
+        options.hasOrigin = true;
+        options.origin = origin;
+        options.header = GetLazHeader(filepath);
+    }
+
+    bool LazReader::LoadCachedStats() {
+        cachedStats = options.stats && Data::LoadDatasetStats(options.filepath, options.decimationStep, *options.stats);
+        return cachedStats;
+    }
+
+    glm::dvec3 LazReader::GetOrigin() const {
+        if (options.hasOrigin) return options.origin;
+        if (cachedStats) return options.stats->Center();
+
+        // HEADER BOUNDS (NOT ALWAYS TIGHT, THE TRUE ONES ARE KNOWN AFTER THE FIRST LOAD)
+        const LazHeader& header = *options.header;
+        return glm::dvec3(
+            (header.minX + header.maxX) / 2.0,
+            (header.minY + header.maxY) / 2.0,
+            (header.minZ + header.maxZ) / 2.0
+        );
+    }
+
     std::shared_ptr<LazHeader> LazReader::GetLazHeader(const std::string& filepath) {
         std::ifstream inputStream(filepath, std::ios::binary);
         if (!(inputStream.is_open() && inputStream.good())) {
@@ -63,25 +94,60 @@ namespace CustomReader {
         StageFactory factory;
         Stage* lastStage = CreateLazReader(options.filepath, factory);
 
-        // DECIMATION FILTER
-        u_int64 pointCount = options.header->pointCount();
-        lastStage = AddDecimationFilter(&pointCount, lastStage, factory);
+        // DECIMATION FILTER (STEP PLANNED BY THE BUDGET GOVERNOR)
+        uint64_t pointCount = options.header->pointCount();
+        lastStage = AddDecimationFilter(options.decimationStep, &pointCount, lastStage, factory);
 
         // CREATE FINAL STREAM CALLBACK (FOR POINT PROCESSING)
         std::unique_ptr<pdal::StreamCallbackFilter> callback = CreateStreamCallback(lastStage, factory);
 
-        // CREATE FIXED POINT TABLE
-        FixedPointTable table(pointCount);
+        // CREATE FIXED POINT TABLE (ONE STREAMING CHUNK, NOT THE WHOLE FILE)
+        FixedPointTable table(std::min<uint64_t>(pointCount, StreamChunkSize));
+
+        // STATISTICS ARE GATHERED BY THE STREAM CALLBACK UNLESS A PREVIOUS LOAD CACHED THEM
+        if (options.stats && !cachedStats) {
+            const LazHeader& header = *options.header;
+            statsAccumulator.Reset(glm::dvec3(header.minX, header.minY, header.minZ), glm::dvec3(header.maxX, header.maxY, header.maxZ));
+        }
+
+        // STORED POSITIONS ARE CENTERED AROUND THE ORIGIN, PICKED POINTS ARE REPORTED IN FILE COORDINATES
+        // THE SOURCE FILE KEYS THE NORMAL SIDECAR WRITTEN WHILE FINALIZING
+        if (options.cubeRenderer) {
+            options.cubeRenderer->SetPointOrigin(GetOrigin());
+            options.cubeRenderer->SetSourceFile(options.filepath, options.decimationStep);
+        }
 
         // EXECUTE PIPELINE
         callback->prepare(table);
         callback->execute(table);
 
+        if (options.stats && !cachedStats) {
+            statsAccumulator.Finish(*options.stats);
+            Data::SaveDatasetStats(options.filepath, options.decimationStep, *options.stats);
+        }
+
+        // TRUE BOUNDS OF THE STORED (CENTERED) POSITIONS, THE VOXEL FILTER AND CAMERAS SKIP THEIR OWN SCAN
+        if (options.cubeRenderer && options.stats && !options.stats->Empty()) {
+            const glm::dvec3 origin = GetOrigin();
+            options.cubeRenderer->SetPointBounds(glm::vec3(options.stats->minimum - origin), glm::vec3(options.stats->maximum - origin));
+            SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+                "DATASET STATISTICS (%s): EXTENT %.2f x %.2f x %.2f, INTENSITY %u - %u, MEAN SPACING %.3f",
+                cachedStats ? "CACHED" : "COMPUTED",
+                options.stats->maximum.x - options.stats->minimum.x,
+                options.stats->maximum.y - options.stats->minimum.y,
+                options.stats->maximum.z - options.stats->minimum.z,
+                options.stats->minIntensity, options.stats->maxIntensity, options.stats->meanSpacing);
+        }
+
+        // FLUSH THE LAST (PARTIAL) POINT BLOCK
+        if (options.targetStore) options.targetStore->Finalize();
+        else options.cubeRenderer->FinalizePoints();
+
         auto end = std::chrono::steady_clock::now();
         double seconds = std::chrono::duration<double>(end - start).count();
         SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION,
             "TOTAL POINTS: %llu, FINISHED READING IN %.4f seconds (%llu pts/sec)",
-            pointCount, seconds, static_cast<unsigned long long>(pointCount / seconds));
+            static_cast<unsigned long long>(pointCount), seconds, static_cast<unsigned long long>(pointCount / seconds));
     }
 
     Stage* LazReader::CreateLazReader(const std::string& filepath, StageFactory& factory) {
@@ -97,21 +163,15 @@ namespace CustomReader {
         return reader;
     }
 
-    Stage* LazReader::AddDecimationFilter(uint64_t* pointCount, Stage* lastStage, StageFactory& factory) {
-        const uint64_t minPoints = 2'000'000;
-        const double minStep = 1.0;
-        const double maxStep = 10.0;
+    Stage* LazReader::AddDecimationFilter(uint64_t decimationStep, uint64_t* pointCount, Stage* lastStage, StageFactory& factory) {
+        if (decimationStep <= 1) return lastStage;
 
-        if (*pointCount <= minPoints) return lastStage;
-
-        // LOG SCALING
-        double decimationStep = std::log10(static_cast<double>(*pointCount) / minPoints) + minStep;
-        decimationStep = std::clamp(decimationStep, minStep, maxStep);
-        *pointCount = *pointCount / decimationStep;
+        // KEEPS EVERY N-TH POINT (FIRST POINT INCLUDED)
+        *pointCount = (*pointCount + decimationStep - 1) / decimationStep;
 
         Stage* decimationFilter = factory.createStage("filters.decimation");
         Options decimationOptions;
-        decimationOptions.add("step", 2.0f);
+        decimationOptions.add("step", decimationStep);
         decimationFilter->setOptions(decimationOptions);
         decimationFilter->setInput(*lastStage);
         return decimationFilter;
@@ -122,18 +182,17 @@ namespace CustomReader {
         
         std::shared_ptr<LazHeader> header = options.header;
         CubeRenderer* cubeRenderer = options.cubeRenderer;
-        glm::vec3 center(
-            (header->minX + header->maxX) / 2.0f,
-            (header->minY + header->maxY) / 2.0f,
-            (header->minZ + header->maxZ) / 2.0f
-        );
+        Data::PointStore* targetStore = options.targetStore;
+        Data::StatsAccumulator* accumulator = options.stats && !cachedStats ? &statsAccumulator : nullptr;
+        glm::dvec3 center = GetOrigin();
 
-        callbackFilter->setCallback([cubeRenderer, header, center](PointRef& point) -> bool {
+        callbackFilter->setCallback([cubeRenderer, targetStore, header, center, accumulator](PointRef& point) -> bool {
             // POINT POSITION CENTERED AROUND THE (0, 0, 0)
             double x = point.getFieldAs<double>(Dimension::Id::X);
             double y = point.getFieldAs<double>(Dimension::Id::Y);
             double z = point.getFieldAs<double>(Dimension::Id::Z);
-            glm::vec3 position = glm::vec3(x, y, z) - center;
+            // NOTE: CENTER IN DOUBLE PRECISION, LARGE PROJECTED COORDINATES DO NOT FIT IN A FLOAT
+            glm::vec3 position = glm::vec3(glm::dvec3(x, y, z) - center);
 
             // NORMALIZED COLOR AROUND (0.0 - 1.0) FOR THE GPU SHADERS
             glm::vec3 color = glm::vec3(1.0f);
@@ -145,9 +204,18 @@ namespace CustomReader {
                 );
             }
 
-            // ADD CUBE
+            // ADD CUBE (CLASSIFICATION, RETURNS AND SOURCE ID PACKED FOR THE GPU ATTRIBUTE MASKS)
             uint16_t intensity = point.getFieldAs<uint16_t>(Dimension::Id::Intensity);
-            cubeRenderer->AddCube(position, intensity);
+            uint8_t classification = point.getFieldAs<uint8_t>(Dimension::Id::Classification);
+            uint8_t returnNumber = point.getFieldAs<uint8_t>(Dimension::Id::ReturnNumber);
+            uint32_t attributes = CubeInstance::PackAttributes(classification, returnNumber,
+                point.getFieldAs<uint8_t>(Dimension::Id::NumberOfReturns),
+                point.getFieldAs<uint16_t>(Dimension::Id::PointSourceId));
+            if (targetStore) targetStore->Add(position, intensity, attributes);
+            else cubeRenderer->AddCube(position, intensity, attributes);
+
+            // SINGLE STREAMING CALLBACK, THE ACCUMULATOR NEEDS NO SYNCHRONIZATION
+            if (accumulator) accumulator->Add(glm::dvec3(x, y, z), intensity, classification, returnNumber);
 
             // TRUE TO KEEP POINT, FALSE TO DISCARD THE POINT
             return true;
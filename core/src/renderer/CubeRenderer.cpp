@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <chrono>
 #include <vector>
 #include <string>
@@ -8,16 +9,38 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <ColorLUT.hpp>
+#include <AttributeMask.hpp>
 #include <ColorRamp.hpp>
+#include <CpuVoxelDownsampleFilter.hpp>
 #include <CubeInstance.hpp>
 #include <CubeRenderer.hpp>
+#include <CubeStripPass.hpp>
+#include <ElevationGrid.hpp>
+#include <HeightmapMesh.hpp>
+#include <InstanceCullPass.hpp>
+#include <InstanceCuller.hpp>
+#include <IntensityMap.hpp>
+#include <KdTree.hpp>
+#include <LodSelector.hpp>
+#include <MemoryPool.hpp>
+#include <NormalCache.hpp>
+#include <NormalEstimator.hpp>
+#include <Parallel.hpp>
+#include <PointSplatPass.hpp>
+#include <PointStore.hpp>
+#include <ProgressiveRefiner.hpp>
+#include <RenderBenchmark.hpp>
 #include <RendererHelper.hpp>
+#include <StatisticalOutlierFilter.hpp>
 #include <VoxelDownsampleFilter.hpp>
+#include <VoxelFilter.hpp>
+#include <VoxelPyramid.hpp>
 
 using namespace Renderer;
 
 void CubeRenderer::Init(Data::ColorRampType rampType) {
     colorLUT.Init(rampType);
+    intensityMap.Init();
     cubeShader = CreateShaderProgramFromFiles(
         "../assets/shaders/cube/cube.vert",
         "../assets/shaders/cube/cube.frag"
@@ -26,6 +49,12 @@ void CubeRenderer::Init(Data::ColorRampType rampType) {
     glUseProgram(cubeShader);
     uViewProjectionLocation = glGetUniformLocation(cubeShader, "uViewProjection");
     uGlobalScaleLocation = glGetUniformLocation(cubeShader, "uGlobalScale");
+    uCameraPositionLocation = glGetUniformLocation(cubeShader, "uCameraPosition");
+    uFarDistanceLocation = glGetUniformLocation(cubeShader, "uFarDistance");
+    uUseNormalsLocation = glGetUniformLocation(cubeShader, "uUseNormals");
+    uPullInstancesLocation = glGetUniformLocation(cubeShader, "uPullInstances");
+    uFirstInstanceLocation = glGetUniformLocation(cubeShader, "uFirstInstance");
+    attributeMask.GetLocations(cubeShader);
     glUseProgram(0);
 
     // SETUP VAO, VBO, EBO, INSTANCE VARIABLES
@@ -34,6 +63,15 @@ void CubeRenderer::Init(Data::ColorRampType rampType) {
     glGenBuffers(1, &ebo);
     glGenBuffers(1, &instanceVBO);
     glGenBuffers(1, &instanceIntensityVBO);
+    glGenBuffers(1, &instanceAttributeVBO);
+    glGenBuffers(1, &drawCommandBuffer);
+
+    // INDIRECT DRAW PARAMETERS (INSTANCE COUNT WRITTEN BY THE HOST OR BY THE GPU FILTER)
+    Filters::DrawElementsIndirectCommand command;
+    command.count = 36;
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, drawCommandBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(command), &command, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
 
     glBindVertexArray(vao);
 
@@ -58,14 +96,30 @@ void CubeRenderer::Init(Data::ColorRampType rampType) {
         glVertexAttribDivisor(1 + i, 1);
     }
 
-    // SETUP INSTANCE INTENSITY BUFFER
+    // SETUP INSTANCE INTENSITY BUFFER (RAW UINT16, MAPPED IN THE VERTEX SHADER)
     glBindBuffer(GL_ARRAY_BUFFER, instanceIntensityVBO);
     glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
     glEnableVertexAttribArray(5);
-    glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)0);
+    glVertexAttribIPointer(5, 1, GL_UNSIGNED_SHORT, sizeof(uint16_t), (void*)0);
     glVertexAttribDivisor(5, 1);
 
+    // SETUP INSTANCE ATTRIBUTE BUFFER (OCTAHEDRAL NORMAL, PACKED LAS ATTRIBUTES, DECODED IN THE VERTEX SHADER)
+    glBindBuffer(GL_ARRAY_BUFFER, instanceAttributeVBO);
+    glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
+    glEnableVertexAttribArray(6);
+    glVertexAttribIPointer(6, 2, GL_UNSIGNED_INT, sizeof(glm::uvec2), (void*)0);
+    glVertexAttribDivisor(6, 1);
+
     glBindVertexArray(0);
+
+    instanceCuller.Init();
+    instanceCullPass.Init();
+    lodSelector.Init();
+    progressiveRefiner.Init();
+    splatPass.Init(instanceVBO, instanceIntensityVBO, instanceAttributeVBO);
+    stripPass.Init(instanceVBO, instanceIntensityVBO, instanceAttributeVBO);
+    renderBenchmark.Init();
+    farField.Init();
 }
 
 void CubeRenderer::Shutdown() {
@@ -75,148 +129,668 @@ void CubeRenderer::Shutdown() {
     if (ebo) glDeleteBuffers(1, &ebo);
     if (instanceVBO) glDeleteBuffers(1, &instanceVBO);
     if (instanceIntensityVBO) glDeleteBuffers(1, &instanceIntensityVBO);
+    if (instanceAttributeVBO) glDeleteBuffers(1, &instanceAttributeVBO);
+    if (drawCommandBuffer) glDeleteBuffers(1, &drawCommandBuffer);
+    if (renderedCountFence) glDeleteSync(renderedCountFence);
+    renderedCountFence = nullptr;
     
     colorLUT.Shutdown();
+    intensityMap.Shutdown();
+    instanceCuller.Shutdown();
+    instanceCullPass.Shutdown();
+    lodSelector.Shutdown();
+    progressiveRefiner.Shutdown();
+    splatPass.Shutdown();
+    stripPass.Shutdown();
+    renderBenchmark.Shutdown();
+    farField.Shutdown();
     
-    vao = vbo = ebo = instanceVBO = instanceIntensityVBO = cubeShader;
+    vao = vbo = ebo = instanceVBO = instanceIntensityVBO = instanceAttributeVBO = drawCommandBuffer = cubeShader = 0;
 }
 
-void CubeRenderer::Render(const glm::mat4& viewProjection, float globalScale) {
-    if(cubes.empty()) return;
+void CubeRenderer::Render(const glm::mat4& viewProjection, const glm::vec3& cameraPosition, float globalScale) {
+    // A BENCHMARK ONLY ADVANCES ON DRAWN FRAMES, ONE STARTED BEFORE THE POINTS WERE CLEARED IS DROPPED
+    if (maxDrawInstances == 0) {
+        if (renderBenchmark.IsRunning()) renderBenchmark.Cancel();
+        return;
+    }
+    PollRenderedCount();
+
+    // ZERO KEEPS EVERY CUBE (NO FAR FIELD)
+    const bool drawFarField = useFarField && !farField.Empty();
+    const bool useNormals = shadeNormals && pointStore.HasNormals();
+    const uint64_t drawLimit = instancesOnDevice ? std::min(renderedCount, maxDrawInstances) : GetDrawCount();
+
+    // RENDER MODE: A RUNNING BENCHMARK CYCLES THROUGH THE MODES WITH THE PLAIN DRAW OF EVERY POINT (NOTHING CULLED OR REFINED)
+    const bool benchmarking = renderBenchmark.IsRunning();
+    Utils::RenderMode mode = benchmarking ? renderBenchmark.GetMode() : static_cast<Utils::RenderMode>(renderMode);
+    if (!splatPass.IsAvailable()) mode = Utils::RenderMode::Cubes;
+    const bool drawSplats = mode == Utils::RenderMode::Splats;
+    const bool cubePaths = !benchmarking && !drawSplats;
+
+    // PROGRESSIVE REFINEMENT: A STRATIFIED SUBSET WHILE MOVING, THE REST ACCUMULATES AT REST (NO CULLING, NO LEVEL OF DETAIL)
+    const bool refine = cubePaths && IsRefining();
+    if (refine) {
+        progressiveRefiner.UpdateOrder(drawLimit, loadStats);
+
+        // THE REFINER COMPARES THE VIEW ITSELF, THE ACCUMULATED IMAGE ALSO DEPENDS ON THESE UNIFORMS
+        const float cubeFarDistance = drawFarField ? farDistance : 0.0f;
+        if (globalScale != refinedGlobalScale || cubeFarDistance != refinedFarDistance || useNormals != refinedUseNormals || attributeMask != refinedMask) {
+            refinedGlobalScale = globalScale;
+            refinedFarDistance = cubeFarDistance;
+            refinedUseNormals = useNormals;
+            refinedMask = attributeMask;
+            progressiveRefiner.Invalidate();
+        }
+    }
+
+    // LEVEL OF DETAIL: PYRAMID NODES PICK THEIR OWN LEVEL AND ARE DRAWN BY LEVEL, THE CULLING PASSES BELOW ARE SKIPPED
+    // COARSE PASS: VISIBLE INSTANCE RANGES FRONT TO BACK (DEVICE-WRITTEN COUNTS ARE CLAMPED TO THE CAPACITY)
+    // FINE PASS: EVERY INSTANCE OF THE VISIBLE NODES (OR OF THE WHOLE DRAW) AGAINST THE FRUSTUM AND THE MINIMUM SCREEN SIZE
+    const bool drawLod = cubePaths && IsLodActive();
+    const bool cullNodes = !benchmarking && !refine && !drawLod && frustumCulling && !instanceCuller.Empty();
+    const bool pullInstances = cubePaths && !refine && !drawLod && gpuCulling && instanceCullPass.IsAvailable();
+
+    // PROCEDURAL CUBES: 9-VERTEX STRIPS OF THE CAMERA-FACING FACES INSTEAD OF 36 INDICES, SAME IMAGE.
+    // MULTI-DRAW RECORDS NEED THE SHADER'S BASE INSTANCE, WITHOUT IT THOSE DRAWS STAY INDEXED
+    const bool stripCubes = !drawSplats && useStripCubes && stripPass.IsAvailable()
+        && (stripPass.HasBaseInstance() || refine || pullInstances || (!drawLod && !cullNodes));
+    const GLuint cubeIndexCount = stripCubes ? Utils::CubeStripPass::VertexCount : 36;
+    const GLenum cubePrimitive = stripCubes ? GL_TRIANGLE_STRIP : GL_TRIANGLES;
+
+    if (drawLod) lodSelector.Select(voxelPyramid, viewProjection, cameraPosition, globalScale, drawFarField ? farDistance : 0.0f, cubeIndexCount);
+    if (cullNodes) {
+        instanceCuller.Cull(viewProjection, cameraPosition, 0.5f * globalScale, drawFarField ? farDistance : 0.0f, drawLimit, cubeIndexCount);
+    }
+    if (pullInstances) {
+        instanceCullPass.Run(viewProjection, globalScale, instanceVBO, drawCommandBuffer, maxDrawInstances,
+            cullNodes ? instanceCuller.GetCommandBuffer() : 0, cullNodes ? GLuint(instanceCuller.VisibleNodeCount()) : 0, cubeIndexCount, loadStats);
+    }
 
     glEnable(GL_DEPTH_TEST);
+    colorLUT.Bind(0);
+    intensityMap.Bind(1);
+    if (benchmarking) renderBenchmark.BeginFrame();
+
+    if (drawSplats) {
+        // ONE POINT PER INSTANCE FROM THE SAME BUFFERS (THE VISIBLE NODES, OR EVERY DRAWN INSTANCE)
+        splatPass.Begin(viewProjection, cameraPosition, globalScale, drawFarField ? farDistance : 0.0f, useNormals, attributeMask, 0, 1);
+        if (cullNodes) splatPass.DrawNodes(instanceCuller);
+        else splatPass.Draw(0, drawLimit);
+        splatPass.End();
+    } else {
+        if (stripCubes) {
+            stripPass.Begin(viewProjection, cameraPosition, globalScale, drawFarField ? farDistance : 0.0f, useNormals, pullInstances || refine, attributeMask, 0, 1);
+        } else {
+            glUseProgram(cubeShader);
+            glBindVertexArray(vao);
+
+            glUniformMatrix4fv(uViewProjectionLocation, 1, GL_FALSE, glm::value_ptr(viewProjection));
+            glUniform1f(uGlobalScaleLocation, globalScale);
+
+            glUniform3fv(uCameraPositionLocation, 1, glm::value_ptr(cameraPosition));
+            glUniform1f(uFarDistanceLocation, drawFarField ? farDistance : 0.0f);
+            glUniform1i(uUseNormalsLocation, useNormals ? 1 : 0);
+            glUniform1i(uPullInstancesLocation, pullInstances || refine ? 1 : 0);
+            glUniform1ui(uFirstInstanceLocation, 0);
+            attributeMask.Apply();
+
+            glUniform1i(glGetUniformLocation(cubeShader, "uColorLUT"), 0);
+            glUniform1i(glGetUniformLocation(cubeShader, "uIntensityMap"), 1);
+        }
+
+        if (refine) {
+            // NEXT BATCH OF THE DRAW ORDER INTO THE PERSISTENT TARGET, THEN THE WHOLE TARGET ONTO THE SCREEN
+            uint64_t first = 0;
+            uint64_t count = 0;
+            progressiveRefiner.Begin(viewProjection, first, count);
+            if (count > 0) {
+                progressiveRefiner.BindOrder(0);
+                if (stripCubes) {
+                    stripPass.DrawPulled(first, count);
+                } else {
+                    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, instanceVBO);
+                    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, instanceIntensityVBO);
+                    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, instanceAttributeVBO);
+                    glUniform1ui(uFirstInstanceLocation, static_cast<GLuint>(first));
+                    glDrawElementsInstanced(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(count));
+                }
+            }
+            progressiveRefiner.End();
+        } else if (drawLod) {
+            // EACH LEVEL'S CUBES COVER THEIR VOXEL (SETS THE SCALE UNIFORM PER DRAW)
+            lodSelector.Draw(cubePrimitive, stripCubes ? stripPass.GetGlobalScaleLocation() : uGlobalScaleLocation);
+        } else if (pullInstances) {
+            // SURVIVOR COUNT STAYS ON THE DEVICE, THE VERTEX SHADER FETCHES EACH SURVIVOR THROUGH THE VISIBLE LIST
+            instanceCullPass.BindVisibleIndices(0);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, instanceVBO);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, instanceIntensityVBO);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, instanceAttributeVBO);
+            instanceCullPass.Draw(cubePrimitive);
+        } else if (cullNodes) {
+            instanceCuller.Draw(cubePrimitive);
+        } else if (stripCubes) {
+            stripPass.DrawIndirect(drawCommandBuffer);
+        } else {
+            // INSTANCE COUNT COMES FROM THE INDIRECT BUFFER (NO HOST ROUND-TRIP AFTER GPU FILTERING)
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, drawCommandBuffer);
+            glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        }
+
+        glBindVertexArray(0);
+        glUseProgram(0);
+    }
 
-    glUseProgram(cubeShader);
-    glBindVertexArray(vao);
+    if (benchmarking) renderBenchmark.EndFrame(drawLimit, drawSplats ? 1 : cubeIndexCount);
+    glDisable(GL_DEPTH_TEST);
 
-    glUniformMatrix4fv(uViewProjectionLocation, 1, GL_FALSE, glm::value_ptr(viewProjection));
-    glUniform1f(uGlobalScaleLocation, globalScale);
+    // SAME TEXTURE UNITS AS THE CUBES (STILL BOUND)
+    if (drawFarField) farField.Render(viewProjection, cameraPosition, farDistance, 0, 1);
+}
 
-    colorLUT.Bind(0);
-    glUniform1i(glGetUniformLocation(cubeShader, "uColorLUT"), 0);
+void CubeRenderer::UpdateBufferSize(uint64_t pointCount, float quantization) {
+    // START A NEW LOAD (POOLED BUFFERS KEEP THEIR CAPACITY)
+    loadStats.Reset();
 
-    glDrawElementsInstanced(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0, static_cast<GLsizei>(cubes.size()));
+    cubes.clear();
+    instancesOnDevice = false;
+    pyramidActive = false;
+    hasPointBounds = false;
+    maxDrawInstances = 0;
+    renderedCount = 0;
+
+    // MASKS REFER TO THE PREVIOUS DATASET'S CLASSES AND RANGES
+    attributeMask.Reset();
+    instanceCuller.Clear();
+
+    // INSTANCE BUFFERS ARE SIZED AFTER FILTERING, ONLY THE POINT STORE IS RESERVED UP FRONT
+    pointStore.Reset(pointCount, compressPoints, quantization, &loadStats);
+}
 
-    glBindVertexArray(0);
-    glUseProgram(0);
+void CubeRenderer::UpdateBuffers() {
+    progressiveRefiner.Invalidate();
 
-    glDisable(GL_DEPTH_TEST);
-}
+    // THE GPU FILTER ALREADY WROTE THE INSTANCE BUFFERS AND THE DRAW COMMAND
+    if (instancesOnDevice) return;
 
-void CubeRenderer::UpdateBufferSize(uint64_t pointCount) {
-    cubes.clear();
-    cubes.reserve(pointCount);
+    // THE FILTER OUTPUT IS HANDED TO THE UPLOAD AS IS, NO HOST INSTANCE ARRAYS SIT IN BETWEEN
+    EnsureInstanceCapacity(cubes.size());
+    WriteInstances(Data::Span<const CubeInstance> { cubes.data(), cubes.size() });
 
-    instanceModels.resize(pointCount);
-    instanceIntensities.resize(pointCount);
+    WriteDrawCommand(static_cast<GLuint>(GetDrawCount()));
+    maxDrawInstances = cubes.size();
+    renderedCount = GetDrawCount();
+    RebuildIntensityMap();
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
-    glBufferData(GL_ARRAY_BUFFER, pointCount * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+void CubeRenderer::RebuildIntensityMap() {
+    // ONLY THE DRAWN INSTANCES ARE COUNTED, THE DRAW COMMAND NEVER LEAVES THE DEVICE
+    if (intensityMap.IsAvailable()) {
+        intensityMap.Build(instanceIntensityVBO, drawCommandBuffer, maxDrawInstances, loadStats);
+    }
+    // CPU FALLBACK FROM THE HOST ARRAY (INSTANCES WRITTEN BY THE GPU FILTER HAVE NO HOST COPY, THEIR TABLE STAYS LINEAR)
+    else if (!instancesOnDevice) {
+        intensityMap.BuildOnHost(cubes.data(), std::min<uint64_t>(GetDrawCount(), cubes.size()), loadStats);
+    }
+    progressiveRefiner.Invalidate();
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, instanceIntensityVBO);
-    glBufferData(GL_ARRAY_BUFFER, pointCount * sizeof(float), instanceIntensities.data(), GL_DYNAMIC_DRAW);
+void CubeRenderer::SetIntensityMapping(Utils::IntensityMapping mapping, float clipPercent) {
+    intensityMap.SetMapping(mapping, clipPercent);
+    progressiveRefiner.Invalidate();
 }
 
-void CubeRenderer::UpdateBuffers() {
-    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
-    glBufferData(GL_ARRAY_BUFFER, instanceModels.size() * sizeof(glm::mat4), instanceModels.data(), GL_DYNAMIC_DRAW);
+void CubeRenderer::SwapIntensities(std::vector<uint16_t>& intensities) {
+    pointStore.SwapIntensities(intensities);
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, instanceIntensityVBO);
-    glBufferData(GL_ARRAY_BUFFER, instanceIntensities.size() * sizeof(float), instanceIntensities.data(), GL_DYNAMIC_DRAW);
+uint64_t CubeRenderer::GetDrawCount() const {
+    // PYRAMID LEVELS ARE PREFIXES OF THE RENDER BUFFER
+    if (pyramidActive) return voxelPyramid.LevelPointCount(uint32_t(pyramidLevel));
+    return cubes.size();
 }
 
-void CubeRenderer::AddCube(glm::vec3 position, uint16_t intensity) {
-    const uint64_t index = cubes.size();
+void CubeRenderer::SetPyramidLevel(int level) {
+    if (!pyramidActive) return;
 
-    // ADD CUBE
-    cubes.emplace_back(position, intensity);
+    // LEVELS FINER THAN THE BUFFERED ONE DID NOT FIT THE RENDER BUDGET
+    level = std::clamp(level, int(voxelPyramid.FinestLevel()), int(voxelPyramid.LevelCount()) - 1);
+    if (level == pyramidLevel) return;
+    pyramidLevel = level;
+
+    // NO RECOMPUTATION OR RE-UPLOAD, ONLY THE INSTANCE COUNT CHANGES (THE HISTOGRAM FOLLOWS THE DRAWN LEVEL)
+    renderedCount = GetDrawCount();
+    WriteDrawCommand(static_cast<GLuint>(renderedCount));
+    RebuildIntensityMap();
+}
+
+void CubeRenderer::EnsureInstanceCapacity(uint64_t instanceCount) {
+    // GROW ONLY, THE VAO KEEPS POINTING AT THE SAME BUFFER NAMES
+    if (instanceCount > instanceModelCapacity) {
+        instanceModelCapacity = instanceCount;
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, instanceModelCapacity * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+        loadStats.RecordDeviceAllocation(instanceModelCapacity * sizeof(glm::mat4));
+    }
+    if (instanceCount > instanceIntensityCapacity) {
+        instanceIntensityCapacity = instanceCount;
+        glBindBuffer(GL_ARRAY_BUFFER, instanceIntensityVBO);
+        glBufferData(GL_ARRAY_BUFFER, IntensityBufferBytes(instanceIntensityCapacity), nullptr, GL_DYNAMIC_DRAW);
+        loadStats.RecordDeviceAllocation(IntensityBufferBytes(instanceIntensityCapacity));
+    }
+    if (instanceCount > instanceAttributeCapacity) {
+        instanceAttributeCapacity = instanceCount;
+        glBindBuffer(GL_ARRAY_BUFFER, instanceAttributeVBO);
+        glBufferData(GL_ARRAY_BUFFER, instanceAttributeCapacity * sizeof(glm::uvec2), nullptr, GL_DYNAMIC_DRAW);
+        loadStats.RecordDeviceAllocation(instanceAttributeCapacity * sizeof(glm::uvec2));
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
-    // UPDATE INSTANCE BUFFERS
-    UpdateInstancePosition(index, position);
-    UpdateInstanceIntensity(index, intensity);
+void CubeRenderer::WriteDrawCommand(GLuint instanceCount) {
+    Filters::DrawElementsIndirectCommand command;
+    command.count = 36;
+    command.instanceCount = instanceCount;
+    command.survivorCount = instanceCount;
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, drawCommandBuffer);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(command), &command);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
 }
 
-void CubeRenderer::UpdateInstancePosition(uint64_t index, glm::vec3 position) {
-    instanceModels[index] = glm::translate(glm::mat4(1.0f), position);
+void CubeRenderer::PollRenderedCount() {
+    if (!renderedCountFence) return;
+
+    // READ THE DEVICE-SIDE COUNT ONLY ONCE THE GPU IS DONE WITH IT (NEVER STALLS)
+    GLenum status = glClientWaitSync(renderedCountFence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return;
+    glDeleteSync(renderedCountFence);
+    renderedCountFence = nullptr;
+
+    Filters::DrawElementsIndirectCommand command;
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, drawCommandBuffer);
+    glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(command), &command);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    renderedCount = command.survivorCount;
+
+    // MORE SURVIVORS THAN INSTANCE CAPACITY: GROW AND COMPACT AGAIN (THE FILTER STILL HOLDS ITS FLAGS),
+    // THE COUNT AND BLOCK RANGES ARE READ AGAIN ONCE THE RERUN'S OWN FENCE SIGNALS
+    if (instancesOnDevice && command.survivorCount > maxDrawInstances) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "GPU VOXEL DOWNSAMPLING: %u SURVIVORS EXCEED %llu INSTANCES, GROWING",
+            command.survivorCount, static_cast<unsigned long long>(maxDrawInstances));
+        EnsureInstanceCapacity(command.survivorCount);
+        gpuVoxelFilter.WriteInstances(instanceVBO, instanceIntensityVBO, instanceAttributeVBO, drawCommandBuffer, command.survivorCount, 36, loadStats);
+        maxDrawInstances = command.survivorCount;
+        RebuildIntensityMap();
+        renderedCountFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        return;
+    }
+
+    // INSTANCE RANGES OF THE STORE BLOCKS (COMPLETE WITH THE SAME FENCE)
+    if (instancesOnDevice && gpuVoxelFilter.ReadBlockOffsets(blockOffsets, loadStats)) BuildDeviceCullingNodes();
+
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+        "GPU VOXEL DOWNSAMPLING: %llu -> %llu POINTS (%.1f%% REDUCTION)",
+        static_cast<unsigned long long>(filterInputCount), static_cast<unsigned long long>(renderedCount),
+        (1.0 - double(renderedCount) / double(std::max<uint64_t>(filterInputCount, 1))) * 100.0);
 }
 
-void CubeRenderer::UpdateInstanceIntensity(uint64_t index, float intensity) {
-    instanceIntensities[index] = intensity;
+bool CubeRenderer::GetRenderedCount(uint64_t& count) const {
+    count = renderedCount;
+    return renderedCountFence == nullptr;
 }
 
-void CubeRenderer::NormalizeIntensities() {
+void CubeRenderer::BuildCullingNodes() {
+    instanceCuller.Clear();
     if (cubes.empty()) return;
 
-    const size_t BIN_COUNT = 65535;
-    std::vector<size_t> histogram(BIN_COUNT, 0);
+    // PYRAMID LEVELS ARE SEPARATE MORTON RUNS, NODES STOP AT EVERY LEVEL BOUNDARY SO A LEVEL PREFIX IS WHOLE NODES
+    if (pyramidActive) {
+        uint64_t first = 0;
+        for (uint32_t level = voxelPyramid.LevelCount(); level-- > voxelPyramid.FinestLevel();) {
+            const uint64_t end = voxelPyramid.LevelPointCount(level);
+            instanceCuller.AddInstances(cubes.data(), first, end - first);
+            first = end;
+        }
+    } else {
+        instanceCuller.AddInstances(cubes.data(), 0, cubes.size());
+    }
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "FRUSTUM CULLING: %zu NODES OVER %zu INSTANCES",
+        instanceCuller.NodeCount(), cubes.size());
+}
 
-    // BUILD COLOR HISTOGRAM
-    for (auto& cube : cubes) {
-        histogram[cube.intensity]++;
+void CubeRenderer::BuildDeviceCullingNodes() {
+    instanceCuller.Clear();
+
+    // ONE NODE PER STORE BLOCK, BOXED BY ALL OF THE BLOCK'S POINTS (A SUPERSET OF ITS SURVIVORS)
+    const std::vector<glm::vec3>& blockMinimum = gpuVoxelFilter.GetBlockMinimum();
+    const std::vector<glm::vec3>& blockMaximum = gpuVoxelFilter.GetBlockMaximum();
+    const uint64_t instanceCount = std::min(renderedCount, maxDrawInstances);
+    for (size_t block = 0; block + 1 < blockOffsets.size() && block < blockMinimum.size(); ++block) {
+        const uint64_t first = blockOffsets[block];
+        const uint64_t end = std::min<uint64_t>(blockOffsets[block + 1], instanceCount);
+        if (end <= first) continue;
+        instanceCuller.AddNode(static_cast<uint32_t>(first), static_cast<uint32_t>(end - first), blockMinimum[block], blockMaximum[block]);
     }
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "FRUSTUM CULLING: %zu NODES OVER %llu DEVICE INSTANCES",
+        instanceCuller.NodeCount(), static_cast<unsigned long long>(instanceCount));
+}
+
+void CubeRenderer::AddCube(glm::vec3 position, uint16_t intensity, uint32_t attributes) {
+    pointStore.Add(position, intensity, attributes);
+}
 
-    // BUILD CUMULATIVE HISTOGRAM (CUMULATIVE DISTRIBUTION FUNCTION)
-    std::vector<size_t> cumulativeHistogram(BIN_COUNT, 0);
-    cumulativeHistogram[0] = histogram[0];
-    for (size_t i = 1; i < BIN_COUNT; ++i) {
-        cumulativeHistogram[i] = cumulativeHistogram[i - 1] + histogram[i];
+void CubeRenderer::FinalizePoints() {
+    pointStore.Finalize();
+
+    const double residentMegabytes = double(pointStore.ResidentBytes()) / (1024.0 * 1024.0);
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+        "POINT STORE: %llu POINTS, %zu BLOCKS, %.1f MB RESIDENT (%s, %.2f BYTES/POINT)",
+        static_cast<unsigned long long>(pointStore.Size()), pointStore.BlockCount(), residentMegabytes,
+        pointStore.IsCompressed() ? "COMPRESSED" : "UNCOMPRESSED",
+        pointStore.Empty() ? 0.0 : double(pointStore.ResidentBytes()) / double(pointStore.Size()));
+
+    // THE OUTLIER FILTER SEARCHES THE SAME TREE, WHICH THEN DROPS THE REMOVED POINTS INSTEAD OF BEING REBUILT
+    const bool hasIndex = (buildPointIndex || removeOutliers || estimateNormals) && BuildPointIndex();
+    if (removeOutliers && hasIndex) RemoveOutliers();
+    if (estimateNormals && hasIndex) EstimateNormals();
+    if (!buildPointIndex) pointIndex.Clear();
+}
+
+void CubeRenderer::EstimateNormals() {
+    if (pointStore.Empty()) return;
+    auto start = std::chrono::steady_clock::now();
+
+    // THE SIDECAR ONLY MATCHES WHEN THE FILE, NEIGHBOR COUNT AND FILTERED STORE LAYOUT ARE UNCHANGED
+    const uint32_t neighborCount = normalEstimator.GetNeighborCount();
+    const bool cached = !sourceFile.empty()
+        && Data::LoadPointNormals(sourceFile, sourceDecimationStep, neighborCount, pointStore, encodedNormals, loadStats);
+    if (!cached) {
+        normalEstimator.Compute(pointIndex, pointStore, encodedNormals, loadStats);
+        if (!sourceFile.empty()) Data::SavePointNormals(sourceFile, sourceDecimationStep, neighborCount, pointStore, encodedNormals);
+    }
+    pointStore.SetNormals(encodedNormals);
+
+    auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    if (cached) normalEstimator.SetCached(seconds * 1000.0);
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "NORMALS: %llu POINTS %s IN %.4f SECONDS (%.1f NS/POINT, %.0f BYTES/POINT)",
+        static_cast<unsigned long long>(pointStore.Size()), cached ? "LOADED FROM CACHE" : "ESTIMATED", seconds,
+        seconds * 1.0e9 / double(pointStore.Size()), Filters::NormalEstimator::BytesPerPoint);
+}
+
+bool CubeRenderer::BuildElevationGrid() {
+    if (pointStore.Empty()) return false;
+    return elevationGrid.Build(pointStore, ElevationGridResolution, loadStats);
+}
+
+void CubeRenderer::BuildFarField() {
+    if (BuildElevationGrid()) farField.Build(elevationGrid);
+    else farField.Clear();
+}
+
+void CubeRenderer::SetUseFarField(bool enabled) {
+    useFarField = enabled;
+    if (useFarField && farField.Empty()) BuildFarField();
+}
+
+bool CubeRenderer::BuildPointIndex() {
+    if (pointStore.Empty()) return false;
+    if (pointStore.Size() > UINT32_MAX) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "POINT INDEX SUPPORTS AT MOST %u POINTS", UINT32_MAX);
+        pointIndex.Clear();
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    pointIndex.Build(pointStore, loadStats);
+    auto end = std::chrono::steady_clock::now();
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "POINT INDEX: %zu POINTS, %.1f MB IN %.4f SECONDS",
+        pointIndex.Size(), double(pointIndex.ResidentBytes()) / (1024.0 * 1024.0), std::chrono::duration<double>(end - start).count());
+    return true;
+}
+
+bool CubeRenderer::PickPoint(const glm::vec3& origin, const glm::vec3& direction, float pointRadius, PickedPoint& picked) const {
+    if (pointIndex.Empty() || pointIndex.Size() != pointStore.Size()) return false;
+    uint64_t start = SDL_GetTicksNS();
+
+    Spatial::KdRayHit hit;
+    if (!pointIndex.Raycast(origin, glm::normalize(direction), pointRadius, hit)) return false;
+
+    // INTENSITY FROM THE STORE (ONE BLOCK DECODE WHEN COMPRESSED)
+    uint32_t count = 0;
+    const CubeInstance* points = pointStore.GetBlock(hit.index / Data::PointStore::BlockSize, count);
+    const CubeInstance& point = points[hit.index % Data::PointStore::BlockSize];
+    picked.index = hit.index;
+    picked.position = point.position;
+    picked.worldPosition = pointOrigin + glm::dvec3(point.position);
+    picked.intensity = point.intensity;
+    picked.distance = hit.distance;
+
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "POINT PICK: INDEX %u AT %.3f IN %.3f MS", hit.index, hit.distance, (SDL_GetTicksNS() - start) / 1.0e6);
+    return true;
+}
+
+void CubeRenderer::RemoveOutliers() {
+    if (pointStore.Empty()) return;
+    auto start = std::chrono::steady_clock::now();
+
+    const uint64_t inputCount = pointStore.Size();
+    const uint64_t outlierCount = outlierFilter.MarkPoints(pointIndex, pointStore, outlierKeepFlags, loadStats);
+    if (outlierCount == 0) return;
+    pointStore.RemovePoints(outlierKeepFlags);
+    if (buildPointIndex || estimateNormals) pointIndex.RemovePoints(outlierKeepFlags);
+
+    // THE CAMERA AND THE VOXEL GRID FIT THE CLEANED CLOUD (STRAY POINTS NO LONGER STRETCH THE BOUNDS)
+    SetPointBounds(outlierFilter.GetMinimum(), outlierFilter.GetMaximum());
+
+    auto end = std::chrono::steady_clock::now();
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "OUTLIER REMOVAL: %llu -> %llu POINTS IN %.4f SECONDS",
+        static_cast<unsigned long long>(inputCount), static_cast<unsigned long long>(pointStore.Size()),
+        std::chrono::duration<double>(end - start).count());
+}
+
+void CubeRenderer::SetPointBounds(const glm::vec3& minimum, const glm::vec3& maximum) {
+    pointMinimum = minimum;
+    pointMaximum = maximum;
+    hasPointBounds = true;
+}
+
+bool CubeRenderer::GetPointBounds(glm::vec3& minimum, glm::vec3& maximum) const {
+    minimum = pointMinimum;
+    maximum = pointMaximum;
+    return hasPointBounds;
+}
+
+void CubeRenderer::WriteInstances(Data::Span<const CubeInstance> instances) {
+    if (instances.empty()) return;
+
+    // MAP EVERY INSTANCE BUFFER (PREVIOUS CONTENTS DISCARDED) AND CONVERT STRAIGHT INTO IT
+    const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+    auto mapBuffer = [access](GLuint buffer, size_t bytes) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        return glMapBufferRange(GL_ARRAY_BUFFER, 0, GLsizeiptr(bytes), access);
+    };
+    glm::mat4* models = static_cast<glm::mat4*>(mapBuffer(instanceVBO, instances.size * sizeof(glm::mat4)));
+    uint16_t* intensities = static_cast<uint16_t*>(mapBuffer(instanceIntensityVBO, IntensityBufferBytes(instances.size)));
+    glm::uvec2* attributes = static_cast<glm::uvec2*>(mapBuffer(instanceAttributeVBO, instances.size * sizeof(glm::uvec2)));
+
+    if (models && intensities && attributes) {
+        // TRANSLATION ONLY, EVERY COLUMN WRITTEN ONCE (MAPPED MEMORY MAY BE WRITE-COMBINED, NEVER READ BACK)
+        Parallel::For(instances.size, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) {
+                const CubeInstance& instance = instances[i];
+                models[i] = glm::mat4(
+                    glm::vec4(1.0f, 0.0f, 0.0f, 0.0f),
+                    glm::vec4(0.0f, 1.0f, 0.0f, 0.0f),
+                    glm::vec4(0.0f, 0.0f, 1.0f, 0.0f),
+                    glm::vec4(instance.position, 1.0f)
+                );
+                intensities[i] = instance.intensity;
+                attributes[i] = glm::uvec2(instance.normal, instance.attributes);
+            }
+        });
+    } else {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "FAILED TO MAP THE INSTANCE BUFFERS FOR %zu INSTANCES", instances.size);
     }
 
-    const float size_inv = 1.0f / float(cubes.size());
-    for (size_t i = 0; i < cubes.size(); ++i) {
-        float normalized = float(cumulativeHistogram[cubes[i].intensity]) * size_inv;
-        cubes[i].normalized_intensity = normalized;
-        instanceIntensities[i] = normalized;
+    // A FALSE RETURN MEANS THE STORE WAS LOST WHILE MAPPED (E.G. ON A DISPLAY MODE SWITCH)
+    bool intact = true;
+    auto unmapBuffer = [&intact](GLuint buffer, void* memory) {
+        if (!memory) return;
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        intact = glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE && intact;
+    };
+    unmapBuffer(instanceVBO, models);
+    unmapBuffer(instanceIntensityVBO, intensities);
+    unmapBuffer(instanceAttributeVBO, attributes);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (!intact) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "INSTANCE BUFFERS LOST THEIR CONTENTS WHILE MAPPED");
     }
 }
 
+void CubeRenderer::ReportLoadAllocations() const {
+    const double megabyte = 1024.0 * 1024.0;
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+        "LOAD ALLOCATIONS: %llu HOST (%.1f MB), %llu DEVICE (%.1f MB), %.1f MB REUSED FROM POOLS",
+        static_cast<unsigned long long>(loadStats.allocationCount), loadStats.allocatedBytes / megabyte,
+        static_cast<unsigned long long>(loadStats.deviceAllocationCount), loadStats.deviceAllocatedBytes / megabyte,
+        loadStats.reusedBytes / megabyte);
+}
+
 void CubeRenderer::UpdateColorRamp(Data::ColorRampType rampType) {
     colorLUT.Update(rampType);
+    progressiveRefiner.Invalidate();
+}
+
+bool CubeRenderer::BuildVoxelPyramid() {
+    // LEVELS THAT DO NOT FIT THE RENDER BUDGET ARE LEFT OUT OF THE BUFFER
+    voxelPyramid.Build(pointStore, PyramidBaseSize, PyramidLevelCount, cpuVoxelFilter.GetRenderBudget(), cubes, loadStats);
+    if (voxelPyramid.Empty()) return false;
+
+    pyramidActive = true;
+    pyramidLevel = int(voxelPyramid.FinestLevel());
+    return true;
 }
 
 void CubeRenderer::VoxelDownsample() {
-    if (cubes.empty()) return;
+    if (pointStore.Empty()) return;
+    if (useFarField) BuildFarField();
     auto start = std::chrono::steady_clock::now();
 
-    uint64_t inputCount = cubes.size();
+    uint64_t inputCount = pointStore.Size();
+    filterInputCount = inputCount;
+    pyramidActive = false;
+
+    // VOXEL PYRAMID: EVERY LEVEL IN ONE BUFFER, THE LEVEL IS PICKED AT DRAW TIME
+    if (useVoxelPyramid && BuildVoxelPyramid()) {
+        instancesOnDevice = false;
+        lastVoxelFilter = nullptr;
+        BuildCullingNodes();
+
+        auto end = std::chrono::steady_clock::now();
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+            "VOXEL PYRAMID: %llu -> %zu BUFFERED POINTS, LEVEL %d DRAWS %llu IN %.4f SECONDS",
+            static_cast<unsigned long long>(inputCount), cubes.size(), pyramidLevel,
+            static_cast<unsigned long long>(GetDrawCount()), std::chrono::duration<double>(end - start).count());
+        return;
+    }
 
-    // EXECUTE VOXEL DOWNSAMPLING FILTER
-    std::vector<CubeInstance> filteredCubes = voxelDownsampleFilter.ProcessPoints(cubes);
-    if (filteredCubes.empty()) return;
+    // VOXEL SIZE FROM THE TARGET-COUNT SOLVER OR THE GOVERNOR'S POWER LAW
+    gpuVoxelFilter.SetSolveVoxelSize(solveVoxelSize);
+    cpuVoxelFilter.SetSolveVoxelSize(solveVoxelSize);
+    gpuVoxelFilter.SetTargetPointCount(targetPointCount);
+    cpuVoxelFilter.SetTargetPointCount(targetPointCount);
+
+    // KNOWN BOUNDS SKIP THE CPU BOUNDS SCAN (COMPRESSED POSITIONS MAY SIT UP TO HALF A QUANTUM OUTSIDE)
+    if (hasPointBounds) {
+        const glm::vec3 padding(pointStore.IsCompressed() ? pointStore.GetQuantization() : 0.0f);
+        cpuVoxelFilter.SetKnownBounds(pointMinimum - padding, pointMaximum + padding);
+    } else {
+        cpuVoxelFilter.ClearKnownBounds();
+    }
 
-    UpdateBufferSize(filteredCubes.size());
-    for (const CubeInstance& cube : filteredCubes) {
-        AddCube(cube.position, cube.intensity);
+    // DEVICE-ONLY PATH: MARK, COMPACT INTO THE INSTANCE BUFFERS, DRAW INDIRECT (NO READBACK)
+    bool useGpu = static_cast<Filters::VoxelBackend>(voxelBackend) == Filters::VoxelBackend::GPU;
+    if (useGpu && gpuVoxelFilter.CanCompact() && gpuVoxelFilter.MarkPoints(pointStore, loadStats)) {
+        lastVoxelFilter = &gpuVoxelFilter;
+        cubes.clear();
+
+        // SIZE FOR THE RENDER BUDGET, NOT THE WORST CASE (ONE INSTANCE PER POINT),
+        // IF MORE VOXELS SURVIVE THE COMPACTION IS RERUN ONCE THE COUNT ARRIVES
+        uint64_t budget = gpuVoxelFilter.GetRenderBudget() > 0 ? gpuVoxelFilter.GetRenderBudget() : inputCount;
+        uint64_t capacity = std::min(gpuVoxelFilter.GetMaxSurvivorCount(), std::max<uint64_t>(budget + budget / 4, 65536));
+        EnsureInstanceCapacity(capacity);
+        gpuVoxelFilter.WriteInstances(instanceVBO, instanceIntensityVBO, instanceAttributeVBO, drawCommandBuffer, capacity, 36, loadStats);
+
+        // CULLING NODES ARE BUILT WHEN THE BLOCK RANGES ARRIVE WITH THE SURVIVOR COUNT
+        instanceCuller.Clear();
+        instancesOnDevice = true;
+        maxDrawInstances = capacity;
+        RebuildIntensityMap();
+        if (renderedCountFence) glDeleteSync(renderedCountFence);
+        renderedCountFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        auto end = std::chrono::steady_clock::now();
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+            "GPU VOXEL DOWNSAMPLING: %llu POINTS SUBMITTED IN %.4f SECONDS (SURVIVOR COUNT STAYS ON THE DEVICE)",
+            static_cast<unsigned long long>(inputCount), std::chrono::duration<double>(end - start).count());
+        return;
     }
-    UpdateBuffers();
+    instancesOnDevice = false;
 
-    // UPDATE INSTANCE BUFFERS
-    instanceModels.resize(cubes.size());
-    instanceIntensities.resize(cubes.size());
-    for (size_t i = 0; i < cubes.size(); ++i) {
-        instanceModels[i] = glm::translate(glm::mat4(1.0f), cubes[i].position);
-        instanceIntensities[i] = cubes[i].intensity;
+    // HOST PATH: SELECTED BACKEND FIRST, THE CPU BACKEND IF THE GPU ONE CANNOT RUN
+    Filters::VoxelFilter* filter = &cpuVoxelFilter;
+    if (useGpu && gpuVoxelFilter.IsAvailable()) {
+        filter = &gpuVoxelFilter;
     }
 
+    // EXECUTE VOXEL DOWNSAMPLING FILTER (SURVIVORS ARE WRITTEN STRAIGHT INTO THE POOLED RENDER BUFFER)
+    bool filtered = filter->ProcessPoints(pointStore, cubes, loadStats);
+    if (!filtered && filter != &cpuVoxelFilter) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "%s VOXEL DOWNSAMPLING FAILED, RETRYING ON THE CPU", filter->GetName());
+        filter = &cpuVoxelFilter;
+        filtered = filter->ProcessPoints(pointStore, cubes, loadStats);
+    }
+    lastVoxelFilter = filter;
+
+    if (!filtered) {
+        // FILTER FAILED, RENDER EVERY STORED POINT
+        Data::AcquireBuffer(cubes, inputCount, loadStats);
+        pointStore.ForEachBlock([this](const CubeInstance* points, uint32_t count, uint64_t firstIndex) {
+            std::copy(points, points + count, cubes.begin() + firstIndex);
+        });
+    }
+
+    BuildCullingNodes();
+
     auto end = std::chrono::steady_clock::now();
     double seconds = std::chrono::duration<double>(end - start).count();
     SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
-        "GPU VOXEL DOWNSAMPLING: %zu -> %zu POINTS (%.1f%% REDUCTION) IN %.4f SECONDS",
-        inputCount, cubes.size(),
+        "%s VOXEL DOWNSAMPLING: %zu -> %zu POINTS (%.1f%% REDUCTION) IN %.4f SECONDS",
+        filter->GetName(), inputCount, cubes.size(),
         (1.0f - static_cast<float>(cubes.size()) / static_cast<float>(inputCount)) * 100.0f,
         seconds);
 }
 
 void CubeRenderer::Clear() {
-    // CLEAR CPU INSTANCE INFORMATION
+    // CLEAR CPU INSTANCE INFORMATION (POOLED BUFFERS KEEP THEIR CAPACITY FOR THE NEXT LOAD)
+    pointStore.Clear();
     cubes.clear();
-    instanceModels.clear();
-    instanceIntensities.clear();
-
-    // FLUSH GPU BUFFERS
-    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
-    glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
-
-    glBindBuffer(GL_ARRAY_BUFFER, instanceIntensityVBO);
-    glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
+    instancesOnDevice = false;
+    pyramidActive = false;
+    hasPointBounds = false;
+    pointIndex.Clear();
+    voxelPyramid.Clear();
+    elevationGrid.Clear();
+    farField.Clear();
+    instanceCuller.Clear();
+    progressiveRefiner.Invalidate();
+    maxDrawInstances = 0;
+    renderedCount = 0;
+    if (renderedCountFence) glDeleteSync(renderedCountFence);
+    renderedCountFence = nullptr;
+
+    // NOTE: GPU INSTANCE BUFFERS ARE KEPT ALLOCATED, NOTHING IS DRAWN WHILE (maxDrawInstances) IS ZERO
 }
\ No newline at end of file
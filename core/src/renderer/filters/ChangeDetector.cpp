@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+
+#include <ChangeDetector.hpp>
+#include <CubeInstance.hpp>
+#include <KdTree.hpp>
+#include <MemoryPool.hpp>
+#include <Parallel.hpp>
+#include <PointStore.hpp>
+
+namespace Filters {
+
+    void ChangeDetector::Clear() {
+        referenceStore.Clear();
+        referenceIndex.Clear();
+        distances.clear();
+        meanDistance = 0.0f;
+        maxDistance = 0.0f;
+        percentileDistance = 0.0f;
+    }
+
+    bool ChangeDetector::Compute(const Data::PointStore& compared, Data::AllocationStats& loadStats) {
+        distances.clear();
+        meanDistance = 0.0f;
+        maxDistance = 0.0f;
+        percentileDistance = 0.0f;
+
+        const uint64_t pointCount = compared.Size();
+        if (pointCount == 0 || referenceStore.Size() == 0) return false;
+        if (referenceStore.Size() > UINT32_MAX) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "CHANGE DETECTION SUPPORTS AT MOST %u REFERENCE POINTS", UINT32_MAX);
+            return false;
+        }
+
+        const unsigned threads = Parallel::ThreadCount();
+        uint64_t start = SDL_GetTicksNS();
+        referenceIndex.Build(referenceStore, loadStats);
+        uint64_t built = SDL_GetTicksNS();
+
+        // NEAREST DISTANCES IN BLOCK ORDER (THE COMPARED STORE IS MORTON SORTED, SO CONSECUTIVE QUERIES SHARE LEAVES)
+        Data::AcquireBuffer(distances, pointCount, loadStats);
+        std::vector<double> sums(threads, 0.0);
+        std::vector<float> maximums(threads, 0.0f);
+        Parallel::For(compared.BlockCount(), [&](size_t begin, size_t end, unsigned thread) {
+            double sum = 0.0;
+            float maximum = 0.0f;
+            for (size_t blockIndex = begin; blockIndex < end; ++blockIndex) {
+                uint32_t count = 0;
+                const CubeInstance* points = compared.GetBlock(blockIndex, count);
+                float* blockDistances = distances.data() + uint64_t(blockIndex) * Data::PointStore::BlockSize;
+                for (uint32_t i = 0; i < count; ++i) {
+                    Spatial::KdNeighbor nearest;
+                    referenceIndex.FindClosest(points[i].position, nearest);
+                    const float distance = std::sqrt(nearest.distanceSquared);
+                    blockDistances[i] = distance;
+                    sum += distance;
+                    maximum = std::max(maximum, distance);
+                }
+            }
+            sums[thread] += sum;
+            maximums[thread] = std::max(maximums[thread], maximum);
+        }, threads);
+
+        double sum = 0.0;
+        for (unsigned thread = 0; thread < threads; ++thread) {
+            sum += sums[thread];
+            maxDistance = std::max(maxDistance, maximums[thread]);
+        }
+        meanDistance = static_cast<float>(sum / double(pointCount));
+
+        // PERCENTILE FROM A FIXED-WIDTH HISTOGRAM OVER [0, maxDistance] (PER-THREAD BINS, NO SORT)
+        if (maxDistance > 0.0f) {
+            const float binScale = float(HistogramBins) / maxDistance;
+            std::vector<uint64_t> bins(size_t(threads) * HistogramBins, 0);
+            Parallel::For(pointCount, [&](size_t begin, size_t end, unsigned thread) {
+                uint64_t* counts = bins.data() + size_t(thread) * HistogramBins;
+                for (size_t i = begin; i < end; ++i) counts[std::min(uint32_t(distances[i] * binScale), HistogramBins - 1)]++;
+            }, threads);
+
+            const uint64_t target = pointCount - pointCount / 20;
+            uint64_t running = 0;
+            for (uint32_t bin = 0; bin < HistogramBins; ++bin) {
+                for (unsigned thread = 0; thread < threads; ++thread) running += bins[size_t(thread) * HistogramBins + bin];
+                if (running >= target) {
+                    percentileDistance = float(bin + 1) / binScale;
+                    break;
+                }
+            }
+        }
+
+        uint64_t end = SDL_GetTicksNS();
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+            "CHANGE DETECTION: %llu POINTS AGAINST %llu REFERENCE POINTS (INDEX %.1f MS, SEARCH %.1f MS), MEAN %.4f, P95 %.4f, MAX %.4f, %u THREADS",
+            static_cast<unsigned long long>(pointCount), static_cast<unsigned long long>(referenceStore.Size()),
+            (built - start) / 1.0e6, (end - built) / 1.0e6, meanDistance, percentileDistance, maxDistance, threads);
+        return true;
+    }
+
+    void ChangeDetector::Quantize(float range, std::vector<uint16_t>& values) const {
+        values.resize(distances.size());
+        if (distances.empty()) return;
+        const float scale = range > 0.0f ? 65535.0f / range : 0.0f;
+        Parallel::For(distances.size(), [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) {
+                values[i] = static_cast<uint16_t>(std::min(distances[i] * scale, 65535.0f) + 0.5f);
+            }
+        }, Parallel::ThreadCount());
+    }
+
+}
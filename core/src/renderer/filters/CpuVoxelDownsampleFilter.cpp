@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+
+#include <CpuVoxelDownsampleFilter.hpp>
+#include <CubeInstance.hpp>
+#include <MemoryPool.hpp>
+#include <Parallel.hpp>
+#include <PointStore.hpp>
+#include <RadixSort.hpp>
+
+namespace Filters {
+
+    void CpuVoxelDownsampleFilter::CalculateBounds(const Data::PointStore& pointStore) {
+        if (hasKnownBounds) {
+            minPoint = knownMinimum;
+            maxPoint = knownMaximum;
+            return;
+        }
+
+        const unsigned threads = threadCount > 0 ? threadCount : Parallel::ThreadCount();
+        Data::Span<glm::vec3> minimums = workArena.Allocate<glm::vec3>(threads);
+        Data::Span<glm::vec3> maximums = workArena.Allocate<glm::vec3>(threads);
+        std::fill(minimums.begin(), minimums.end(), glm::vec3(FLT_MAX));
+        std::fill(maximums.begin(), maximums.end(), glm::vec3(-FLT_MAX));
+
+        // PER-THREAD REDUCTION OVER WHOLE BLOCKS, MERGED AFTERWARDS
+        Parallel::For(pointStore.BlockCount(), [&](size_t begin, size_t end, unsigned thread) {
+            glm::vec3 minimum = minimums[thread];
+            glm::vec3 maximum = maximums[thread];
+            for (size_t blockIndex = begin; blockIndex < end; ++blockIndex) {
+                uint32_t count = 0;
+                const CubeInstance* points = pointStore.GetBlock(blockIndex, count);
+                for (uint32_t i = 0; i < count; ++i) {
+                    minimum = glm::min(minimum, points[i].position);
+                    maximum = glm::max(maximum, points[i].position);
+                }
+            }
+            minimums[thread] = minimum;
+            maximums[thread] = maximum;
+        }, threads);
+
+        minPoint = minimums[0];
+        maxPoint = maximums[0];
+        for (unsigned thread = 1; thread < threads; ++thread) {
+            minPoint = glm::min(minPoint, minimums[thread]);
+            maxPoint = glm::max(maxPoint, maximums[thread]);
+        }
+    }
+
+    void CpuVoxelDownsampleFilter::GenerateKeys(const Data::PointStore& pointStore, Data::AllocationStats& loadStats) {
+        Data::AcquireBuffer(voxelKeys, pointCount, loadStats);
+        Data::AcquireBuffer(pointIndices, pointCount, loadStats);
+
+        // ROUNDING CAN REACH ONE CELL PAST THE GRID ON EACH AXIS
+        const glm::ivec3 maxCoord = glm::ivec3(voxelBounds);
+        const uint64_t strideY = uint64_t(maxCoord.x) + 1;
+        const uint64_t strideZ = strideY * (uint64_t(maxCoord.y) + 1);
+
+        Parallel::For(pointStore.BlockCount(), [&](size_t begin, size_t end, unsigned) {
+            for (size_t blockIndex = begin; blockIndex < end; ++blockIndex) {
+                uint32_t count = 0;
+                const CubeInstance* points = pointStore.GetBlock(blockIndex, count);
+                const uint64_t firstIndex = uint64_t(blockIndex) * Data::PointStore::BlockSize;
+                for (uint32_t i = 0; i < count; ++i) {
+                    glm::ivec3 coord = glm::clamp(VoxelCoord(points[i].position), glm::ivec3(0), maxCoord);
+                    voxelKeys[firstIndex + i] = uint64_t(coord.x) + uint64_t(coord.y) * strideY + uint64_t(coord.z) * strideZ;
+                    pointIndices[firstIndex + i] = static_cast<uint32_t>(firstIndex + i);
+                }
+            }
+        }, threadCount);
+    }
+
+    void CpuVoxelDownsampleFilter::SelectPoints(Data::AllocationStats& loadStats) {
+        // ONLY SORT AS MANY KEY BITS AS THE GRID CAN PRODUCE
+        const uint64_t maxKey = (uint64_t(voxelBounds.x) + 1) * (uint64_t(voxelBounds.y) + 1) * (uint64_t(voxelBounds.z) + 1);
+        uint32_t keyBits = 1;
+        while (keyBits < 64 && (maxKey >> keyBits) != 0) ++keyBits;
+
+        // STABLE SORT: WITHIN A VOXEL THE LOWEST POINT INDEX COMES FIRST
+        Data::AcquireBuffer(sortScratch.keys, pointCount, loadStats);
+        Data::AcquireBuffer(sortScratch.values, pointCount, loadStats);
+        Spatial::RadixSort(voxelKeys, pointIndices, sortScratch, keyBits, threadCount);
+
+        // FIRST POINT OF EVERY RUN OF EQUAL KEYS SURVIVES
+        keepFlags = workArena.Allocate<uint8_t>(pointCount);
+        Parallel::For(pointCount, [&](size_t begin, size_t end, unsigned) {
+            std::fill(keepFlags.begin() + begin, keepFlags.begin() + end, uint8_t(0));
+        }, threadCount);
+        Parallel::For(pointCount, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) {
+                if (i == 0 || voxelKeys[i] != voxelKeys[i - 1]) keepFlags[pointIndices[i]] = 1;
+            }
+        }, threadCount);
+    }
+
+    bool CpuVoxelDownsampleFilter::ProcessPoints(const Data::PointStore& pointStore, std::vector<CubeInstance>& output, Data::AllocationStats& loadStats) {
+        if (pointStore.Empty()) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "NO POINTS TO PROCESS IN VOXEL DOWNSAMPLING");
+            return false;
+        }
+        if (pointStore.Size() > UINT32_MAX) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "CPU VOXEL DOWNSAMPLING SUPPORTS AT MOST %u POINTS", UINT32_MAX);
+            return false;
+        }
+
+        pointCount = pointStore.Size();
+        workArena.Reset(&loadStats);
+        CalculateBounds(pointStore);
+        CalculateVoxelSize(pointStore, loadStats);
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+            "VOXEL SIZE: %.3f, VOXEL COUNT: %llu, POINT COUNT: %llu", voxelSize,
+            static_cast<unsigned long long>(voxelCount), static_cast<unsigned long long>(pointCount));
+
+        GenerateKeys(pointStore, loadStats);
+        SelectPoints(loadStats);
+
+        // KEPT POINTS PER BLOCK, THEN AN EXCLUSIVE PREFIX SUM GIVES EACH BLOCK ITS OUTPUT OFFSET
+        const size_t blockCount = pointStore.BlockCount();
+        blockOffsets = workArena.Allocate<uint32_t>(blockCount + 1);
+        Parallel::For(blockCount, [&](size_t begin, size_t end, unsigned) {
+            for (size_t blockIndex = begin; blockIndex < end; ++blockIndex) {
+                const uint64_t first = uint64_t(blockIndex) * Data::PointStore::BlockSize;
+                const uint64_t last = std::min<uint64_t>(first + Data::PointStore::BlockSize, pointCount);
+                uint32_t kept = 0;
+                for (uint64_t i = first; i < last; ++i) kept += keepFlags[i];
+                blockOffsets[blockIndex + 1] = kept;
+            }
+        }, threadCount);
+        blockOffsets[0] = 0;
+        for (size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex) {
+            blockOffsets[blockIndex + 1] += blockOffsets[blockIndex];
+        }
+
+        // COPY SURVIVORS IN STORE ORDER
+        Data::AcquireBuffer(output, blockOffsets[blockCount], loadStats);
+        Parallel::For(blockCount, [&](size_t begin, size_t end, unsigned) {
+            for (size_t blockIndex = begin; blockIndex < end; ++blockIndex) {
+                uint32_t count = 0;
+                const CubeInstance* points = pointStore.GetBlock(blockIndex, count);
+                const uint64_t first = uint64_t(blockIndex) * Data::PointStore::BlockSize;
+                size_t outputIndex = blockOffsets[blockIndex];
+                for (uint32_t i = 0; i < count; ++i) {
+                    if (keepFlags[first + i]) output[outputIndex++] = points[i];
+                }
+            }
+        }, threadCount);
+
+        return true;
+    }
+
+}
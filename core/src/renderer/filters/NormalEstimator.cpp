@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+
+#include <KdTree.hpp>
+#include <MemoryPool.hpp>
+#include <NormalEstimator.hpp>
+#include <Parallel.hpp>
+#include <PointStore.hpp>
+
+namespace Filters {
+
+    namespace {
+
+        const glm::vec3 UpNormal = glm::vec3(0.0f, 0.0f, 1.0f);
+
+        // EIGENVECTOR OF THE SMALLEST EIGENVALUE OF A SYMMETRIC 3x3 MATRIX (xx, xy, xz, yy, yz, zz)
+        // EIGENVALUES IN CLOSED FORM (TRIGONOMETRIC SOLUTION OF THE CHARACTERISTIC CUBIC), THE EIGENVECTOR IS THE
+        // LONGEST CROSS PRODUCT OF TWO ROWS OF (A - lambda I), WHICH SPAN THE PLANE ORTHOGONAL TO IT
+        glm::vec3 SmallestEigenvector(double xx, double xy, double xz, double yy, double yz, double zz) {
+            const double offDiagonal = xy * xy + xz * xz + yz * yz;
+            const double trace = (xx + yy + zz) / 3.0;
+            const double a = xx - trace;
+            const double b = yy - trace;
+            const double c = zz - trace;
+            const double p = std::sqrt((a * a + b * b + c * c + 2.0 * offDiagonal) / 6.0);
+            if (p < 1e-12) return UpNormal;
+
+            // DETERMINANT OF (A - trace I) / p, HALVED, GIVES THE ANGLE OF THE ROOTS
+            const double determinant = (a * (b * c - yz * yz) - xy * (xy * c - yz * xz) + xz * (xy * yz - b * xz)) / (p * p * p);
+            const double r = std::clamp(determinant * 0.5, -1.0, 1.0);
+            const double phi = std::acos(r) / 3.0;
+            const double smallest = trace + 2.0 * p * std::cos(phi + 2.0943951023931953);
+
+            const double rows[3][3] = {
+                { xx - smallest, xy, xz },
+                { xy, yy - smallest, yz },
+                { xz, yz, zz - smallest }
+            };
+            double best[3] = { 0.0, 0.0, 0.0 };
+            double bestLength = 0.0;
+            for (int first = 0; first < 2; ++first) {
+                for (int second = first + 1; second < 3; ++second) {
+                    const double* u = rows[first];
+                    const double* v = rows[second];
+                    const double cross[3] = {
+                        u[1] * v[2] - u[2] * v[1],
+                        u[2] * v[0] - u[0] * v[2],
+                        u[0] * v[1] - u[1] * v[0]
+                    };
+                    const double length = cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2];
+                    if (length > bestLength) {
+                        bestLength = length;
+                        best[0] = cross[0];
+                        best[1] = cross[1];
+                        best[2] = cross[2];
+                    }
+                }
+            }
+            if (bestLength < 1e-30) return UpNormal;
+            const double inverseLength = 1.0 / std::sqrt(bestLength);
+            return glm::vec3(float(best[0] * inverseLength), float(best[1] * inverseLength), float(best[2] * inverseLength));
+        }
+
+    }
+
+    void NormalEstimator::Compute(const Spatial::KdTree& tree, const Data::PointStore& pointStore, std::vector<uint16_t>& encodedNormals,
+        Data::AllocationStats& loadStats) {
+        const uint64_t pointCount = pointStore.Size();
+        milliseconds = 0.0;
+        nanosecondsPerPoint = 0.0;
+        if (pointCount == 0 || tree.Size() != pointCount) return;
+
+        const unsigned threads = Parallel::ThreadCount();
+        uint64_t start = SDL_GetTicksNS();
+
+        // QUERIED IN TREE ORDER SO CONSECUTIVE SEARCHES TOUCH THE SAME LEAVES (THE QUERY POINT IS ITS OWN NEIGHBOR,
+        // WHICH ONLY ADDS ITS OWN POSITION TO THE COVARIANCE), NEIGHBORHOODS ARE CENTERED ON THE QUERY FOR PRECISION
+        Data::AcquireBuffer(encodedNormals, pointCount, loadStats);
+        const uint16_t upEncoded = EncodeNormal(UpNormal);
+        Parallel::For(pointCount, [&](size_t begin, size_t end, unsigned) {
+            Spatial::KdNeighbor neighbors[MaxNeighbors];
+            glm::vec3 positions[MaxNeighbors];
+            for (size_t slot = begin; slot < end; ++slot) {
+                const Spatial::KdTree::Entry& entry = tree.GetEntry(slot);
+                const uint32_t found = tree.FindNearest(entry.position, neighborCount, neighbors, positions);
+                if (found < 3) {
+                    encodedNormals[entry.index] = upEncoded;
+                    continue;
+                }
+
+                double meanX = 0.0, meanY = 0.0, meanZ = 0.0;
+                for (uint32_t i = 0; i < found; ++i) {
+                    meanX += positions[i].x - entry.position.x;
+                    meanY += positions[i].y - entry.position.y;
+                    meanZ += positions[i].z - entry.position.z;
+                }
+                meanX /= double(found);
+                meanY /= double(found);
+                meanZ /= double(found);
+
+                double xx = 0.0, xy = 0.0, xz = 0.0, yy = 0.0, yz = 0.0, zz = 0.0;
+                for (uint32_t i = 0; i < found; ++i) {
+                    const double dx = double(positions[i].x - entry.position.x) - meanX;
+                    const double dy = double(positions[i].y - entry.position.y) - meanY;
+                    const double dz = double(positions[i].z - entry.position.z) - meanZ;
+                    xx += dx * dx;
+                    xy += dx * dy;
+                    xz += dx * dz;
+                    yy += dy * dy;
+                    yz += dy * dz;
+                    zz += dz * dz;
+                }
+
+                glm::vec3 normal = SmallestEigenvector(xx, xy, xz, yy, yz, zz);
+                if (normal.z < 0.0f) normal = -normal;
+                encodedNormals[entry.index] = EncodeNormal(normal);
+            }
+        }, threads);
+
+        uint64_t end = SDL_GetTicksNS();
+        milliseconds = (end - start) / 1.0e6;
+        nanosecondsPerPoint = double(end - start) / double(pointCount);
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+            "NORMAL ESTIMATION: %llu POINTS (K = %u) IN %.1f MS (%.1f NS/POINT, %.0f BYTES/POINT), %u THREADS",
+            static_cast<unsigned long long>(pointCount), neighborCount, milliseconds, nanosecondsPerPoint, BytesPerPoint, threads);
+    }
+
+}
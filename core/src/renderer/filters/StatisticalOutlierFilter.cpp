@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+
+#include <KdTree.hpp>
+#include <MemoryPool.hpp>
+#include <Parallel.hpp>
+#include <PointStore.hpp>
+#include <StatisticalOutlierFilter.hpp>
+
+namespace Filters {
+
+    uint64_t StatisticalOutlierFilter::MarkPoints(const Spatial::KdTree& tree, const Data::PointStore& pointStore, std::vector<uint8_t>& keepFlags,
+        Data::AllocationStats& loadStats) {
+        const uint64_t pointCount = pointStore.Size();
+        keepFlags.assign(pointCount, 1);
+        keptMinimum = glm::vec3(0.0f);
+        keptMaximum = glm::vec3(0.0f);
+        if (pointCount <= neighborCount || tree.Size() != pointCount) return 0;
+
+        const unsigned threads = Parallel::ThreadCount();
+        uint64_t start = SDL_GetTicksNS();
+
+        // MEAN NEIGHBOR DISTANCE, QUERIED IN TREE ORDER SO CONSECUTIVE SEARCHES TOUCH THE SAME LEAVES
+        // (k + 1) NEIGHBORS BECAUSE THE QUERY POINT FINDS ITSELF
+        Data::AcquireBuffer(meanDistances, pointCount, loadStats);
+        std::vector<double> sums(threads, 0.0);
+        std::vector<double> squareSums(threads, 0.0);
+        Parallel::For(pointCount, [&](size_t begin, size_t end, unsigned thread) {
+            Spatial::KdNeighbor neighbors[MaxNeighbors + 1];
+            double sum = 0.0;
+            double squareSum = 0.0;
+            for (size_t slot = begin; slot < end; ++slot) {
+                const Spatial::KdTree::Entry& entry = tree.GetEntry(slot);
+                const uint32_t found = tree.FindNearest(entry.position, neighborCount + 1, neighbors);
+
+                // SKIP THE POINT ITSELF (DUPLICATES MAY SORT AHEAD OF IT, THEN THE FARTHEST ONE IS DROPPED INSTEAD)
+                float distance = 0.0f;
+                uint32_t used = 0;
+                bool skippedSelf = false;
+                for (uint32_t i = 0; i < found && used < neighborCount; ++i) {
+                    if (!skippedSelf && neighbors[i].index == entry.index) {
+                        skippedSelf = true;
+                        continue;
+                    }
+                    distance += std::sqrt(neighbors[i].distanceSquared);
+                    ++used;
+                }
+                const float mean = used > 0 ? distance / float(used) : 0.0f;
+                meanDistances[entry.index] = mean;
+                sum += mean;
+                squareSum += double(mean) * mean;
+            }
+            sums[thread] += sum;
+            squareSums[thread] += squareSum;
+        }, threads);
+
+        double sum = 0.0;
+        double squareSum = 0.0;
+        for (unsigned thread = 0; thread < threads; ++thread) {
+            sum += sums[thread];
+            squareSum += squareSums[thread];
+        }
+        const double mean = sum / double(pointCount);
+        const double deviation = std::sqrt(std::max(0.0, squareSum / double(pointCount) - mean * mean));
+        const float threshold = static_cast<float>(mean + multiplier * deviation);
+
+        // FLAGS AND KEPT BOUNDS (WHOLE BLOCKS, BLOCK i STARTS AT i * BlockSize)
+        std::vector<uint64_t> outliers(threads, 0);
+        std::vector<glm::vec3> minimums(threads, glm::vec3(FLT_MAX));
+        std::vector<glm::vec3> maximums(threads, glm::vec3(-FLT_MAX));
+        Parallel::For(pointStore.BlockCount(), [&](size_t begin, size_t end, unsigned thread) {
+            for (size_t blockIndex = begin; blockIndex < end; ++blockIndex) {
+                uint32_t count = 0;
+                const CubeInstance* points = pointStore.GetBlock(blockIndex, count);
+                const uint64_t firstIndex = uint64_t(blockIndex) * Data::PointStore::BlockSize;
+                for (uint32_t i = 0; i < count; ++i) {
+                    if (meanDistances[firstIndex + i] > threshold) {
+                        keepFlags[firstIndex + i] = 0;
+                        outliers[thread]++;
+                        continue;
+                    }
+                    minimums[thread] = glm::min(minimums[thread], points[i].position);
+                    maximums[thread] = glm::max(maximums[thread], points[i].position);
+                }
+            }
+        }, threads);
+
+        uint64_t outlierCount = 0;
+        keptMinimum = glm::vec3(FLT_MAX);
+        keptMaximum = glm::vec3(-FLT_MAX);
+        for (unsigned thread = 0; thread < threads; ++thread) {
+            outlierCount += outliers[thread];
+            keptMinimum = glm::min(keptMinimum, minimums[thread]);
+            keptMaximum = glm::max(keptMaximum, maximums[thread]);
+        }
+
+        uint64_t end = SDL_GetTicksNS();
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+            "OUTLIER FILTER: %llu OF %llu POINTS REMOVED (K = %u, MEAN %.4f, SIGMA %.4f, THRESHOLD %.4f) IN %.1f MS, %u THREADS",
+            static_cast<unsigned long long>(outlierCount), static_cast<unsigned long long>(pointCount), neighborCount,
+            mean, deviation, threshold, (end - start) / 1.0e6, threads);
+        return outlierCount;
+    }
+
+}
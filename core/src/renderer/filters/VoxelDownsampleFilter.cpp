@@ -3,6 +3,8 @@
 #include <vector>
 #include <string>
 #include <cmath>
+#include <cfloat>
+#include <cstdint>
 
 #include <SDL3/SDL.h>
 #include <glad/glad.h>
@@ -11,6 +13,9 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <CubeInstance.hpp>
+#include <MemoryPool.hpp>
+#include <PointStore.hpp>
+#include <PrefixSum.hpp>
 #include <RendererHelper.hpp>
 #include <VoxelDownsampleFilter.hpp>
 
@@ -19,126 +24,288 @@ namespace Filters {
     // CONSTRUCTOR
     VoxelDownsampleFilter::VoxelDownsampleFilter() {
         computeProgram = Renderer::CreateComputeShaderProgram("../assets/shaders/compute/voxel_downsample_filter.comp");
+        if (!computeProgram) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "VOXEL DOWNSAMPLING COMPUTE PROGRAM UNAVAILABLE, USING THE CPU BACKEND");
+            return;
+        }
 
         glGenBuffers(1, &inputPointSSBO);
-        glGenBuffers(1, &outputFlagSSBO);
+        glGenBuffers(1, &inputAttributeSSBO);
+        glGenBuffers(1, &voxelTableSSBO);
+        glGenBuffers(1, &keepFlagSSBO);
 
         glUseProgram(computeProgram);
 
         uVoxelSize = glGetUniformLocation(computeProgram, "uVoxelSize");
-        uVoxelCount = glGetUniformLocation(computeProgram, "uVoxelCount");
         uVoxelOrigin = glGetUniformLocation(computeProgram, "uVoxelOrigin");
-        uVoxelBounds = glGetUniformLocation(computeProgram, "uVoxelBounds");
+        uTableMask = glGetUniformLocation(computeProgram, "uTableMask");
+        uPointCount = glGetUniformLocation(computeProgram, "uPointCount");
+        uPass = glGetUniformLocation(computeProgram, "uPass");
+
+        // STREAM COMPACTION (OPTIONAL, THE HOST READBACK PATH WORKS WITHOUT IT)
+        scatterProgram = Renderer::CreateComputeShaderProgram("../assets/shaders/compute/stream_compaction_scatter.comp");
+        prefixSum.Init();
+        if (!CanCompact()) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "GPU STREAM COMPACTION UNAVAILABLE, VOXEL DOWNSAMPLING WILL READ FLAGS BACK");
+            return;
+        }
+
+        glGenBuffers(1, &offsetSSBO);
+
+        uScatterPointCount = glGetUniformLocation(scatterProgram, "uPointCount");
+        uScatterCapacity = glGetUniformLocation(scatterProgram, "uCapacity");
+        uScatterIndexCount = glGetUniformLocation(scatterProgram, "uIndexCount");
+
+        // PER-BLOCK INSTANCE RANGES FOR FRUSTUM CULLING (OPTIONAL, THE RENDERER DRAWS EVERYTHING WITHOUT THEM)
+        blockOffsetProgram = Renderer::CreateComputeShaderProgram("../assets/shaders/compute/block_offsets.comp");
+        if (!blockOffsetProgram) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "BLOCK OFFSET PROGRAM UNAVAILABLE, DEVICE-WRITTEN INSTANCES WILL NOT BE CULLED");
+            return;
+        }
+        glGenBuffers(1, &blockOffsetSSBO);
+        uBlockPointCount = glGetUniformLocation(blockOffsetProgram, "uPointCount");
+        uBlockSize = glGetUniformLocation(blockOffsetProgram, "uBlockSize");
+        uBlockCount = glGetUniformLocation(blockOffsetProgram, "uBlockCount");
     }
 
     // DECONSTRUCTOR
     VoxelDownsampleFilter::~VoxelDownsampleFilter() {
         if (computeProgram) glDeleteProgram(computeProgram);
+        if (scatterProgram) glDeleteProgram(scatterProgram);
+        if (blockOffsetProgram) glDeleteProgram(blockOffsetProgram);
         if (inputPointSSBO) glDeleteBuffers(1, &inputPointSSBO);
-        if (outputFlagSSBO) glDeleteBuffers(1, &outputFlagSSBO);
+        if (inputAttributeSSBO) glDeleteBuffers(1, &inputAttributeSSBO);
+        if (voxelTableSSBO) glDeleteBuffers(1, &voxelTableSSBO);
+        if (keepFlagSSBO) glDeleteBuffers(1, &keepFlagSSBO);
+        if (offsetSSBO) glDeleteBuffers(1, &offsetSSBO);
+        if (blockOffsetSSBO) glDeleteBuffers(1, &blockOffsetSSBO);
+        prefixSum.Shutdown();
 
-        computeProgram = inputPointSSBO = outputFlagSSBO = 0;
+        computeProgram = scatterProgram = blockOffsetProgram = 0;
+        inputPointSSBO = inputAttributeSSBO = voxelTableSSBO = keepFlagSSBO = offsetSSBO = blockOffsetSSBO = 0;
     }
 
-    void VoxelDownsampleFilter::CalculateVoxelSize() {
-        if (pointData.empty()) return;
+    void VoxelDownsampleFilter::UploadPoints(const Data::PointStore& pointStore, Data::AllocationStats& loadStats) {
+        pointCount = pointStore.Size();
+        minPoint = glm::vec3(FLT_MAX);
+        maxPoint = glm::vec3(-FLT_MAX);
+        Data::AcquireBuffer(uploadBlock, Data::PointStore::BlockSize, loadStats);
+        Data::AcquireBuffer(uploadAttributes, Data::PointStore::BlockSize, loadStats);
+        blockCount = static_cast<GLuint>(pointStore.BlockCount());
+        Data::AcquireBuffer(blockMinimum, blockCount, loadStats);
+        Data::AcquireBuffer(blockMaximum, blockCount, loadStats);
 
-        glm::vec3 minPoint = pointData[0];
-        glm::vec3 maxPoint = pointData[0];
-        for (const glm::vec3& point : pointData) {
-            minPoint = glm::min(minPoint, point);
-            maxPoint = glm::max(maxPoint, point);
+        // INPUT BUFFER (POINT POSITIONS), FILLED ONE DECODED BLOCK AT A TIME
+        // RAW INTENSITY, ENCODED NORMAL AND PACKED LAS ATTRIBUTES IN A PARALLEL INTEGER BUFFER (ONLY READ BY THE COMPACTION PASS),
+        // FLOAT BITS WOULD BE NAN OR DENORMAL FOR MANY OF THOSE WORDS AND COULD BE CANONICALIZED OR FLUSHED ON THE WAY
+        if (pointCount > inputPointCapacity) {
+            inputPointCapacity = pointCount;
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, inputAttributeSSBO);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, inputPointCapacity * sizeof(glm::uvec2), nullptr, GL_DYNAMIC_DRAW);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, inputPointSSBO);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, inputPointCapacity * sizeof(glm::vec4), nullptr, GL_DYNAMIC_DRAW);
+            loadStats.RecordDeviceAllocation(inputPointCapacity * (sizeof(glm::vec4) + sizeof(glm::uvec2)));
         }
-        voxelOrigin = minPoint;
-
-        // CALCULATE THE VOXEL SIZE
-        float lowerBoundVoxelSize = 0.4f;
-        float lowerBoundPointCount = 50'000.0f;
-        float upperBoundPointCount = 8'000'000.0f;
-        float upperBoundVoxelSize = 4.0f;
-        
-        float exponent = 
-            std::log(upperBoundVoxelSize / lowerBoundVoxelSize) / 
-            std::log(upperBoundPointCount / lowerBoundPointCount);
-        float pointRatio = pointData.size() / lowerBoundPointCount;
-        float size = lowerBoundVoxelSize * std::pow(pointRatio, exponent);   
-        voxelSize = std::clamp(size, 0.25f, 6.0f);
-
-        // CALCULATE VOXEL BOUNDS, AND VOXEL COUNT
-        glm::vec3 extent = maxPoint - minPoint;
-        int numVoxelsX = static_cast<int>(std::ceil(extent.x / voxelSize));
-        int numVoxelsY = static_cast<int>(std::ceil(extent.y / voxelSize));
-        int numVoxelsZ = static_cast<int>(std::ceil(extent.z / voxelSize));
-        voxelBounds = glm::vec3(numVoxelsX, numVoxelsY, numVoxelsZ);
-        voxelCount = numVoxelsX * numVoxelsY * numVoxelsZ;
+
+        pointStore.ForEachBlock([this](const CubeInstance* points, uint32_t count, uint64_t firstIndex) {
+            glm::vec3 blockLow(FLT_MAX);
+            glm::vec3 blockHigh(-FLT_MAX);
+            for (uint32_t i = 0; i < count; ++i) {
+                const glm::vec3& position = points[i].position;
+                blockLow = glm::min(blockLow, position);
+                blockHigh = glm::max(blockHigh, position);
+                uploadBlock[i] = glm::vec4(position, 1.0f);
+                uploadAttributes[i] = glm::uvec2(uint32_t(points[i].intensity) | (uint32_t(points[i].normal) << 16), points[i].attributes);
+            }
+            const size_t block = size_t(firstIndex / Data::PointStore::BlockSize);
+            blockMinimum[block] = blockLow;
+            blockMaximum[block] = blockHigh;
+            minPoint = glm::min(minPoint, blockLow);
+            maxPoint = glm::max(maxPoint, blockHigh);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, inputAttributeSSBO);
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, firstIndex * sizeof(glm::uvec2), count * sizeof(glm::uvec2), uploadAttributes.data());
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, inputPointSSBO);
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, firstIndex * sizeof(glm::vec4), count * sizeof(glm::vec4), uploadBlock.data());
+        });
     }
 
-    void VoxelDownsampleFilter::UpdateBufferSize() {
-        // INPUT BUFFER (POINT POSITIONS)
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, inputPointSSBO);
-        glBufferData(GL_SHADER_STORAGE_BUFFER, pointData.size() * sizeof(glm::vec3), pointData.data(), GL_DYNAMIC_DRAW);
+    void VoxelDownsampleFilter::UpdateBufferSize(Data::AllocationStats& loadStats) {
+        // HASH TABLE: NEXT POWER OF TWO >= 2 * POINTS (LOAD FACTOR <= 0.5), INDEPENDENT OF THE EXTENT
+        voxelTableSize = 1;
+        while (voxelTableSize < 2 * pointCount && voxelTableSize < (1u << 31)) voxelTableSize <<= 1;
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, voxelTableSSBO);
+        if (voxelTableSize > voxelTableCapacity) {
+            voxelTableCapacity = voxelTableSize;
+            glBufferData(GL_SHADER_STORAGE_BUFFER, voxelTableCapacity * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+            loadStats.RecordDeviceAllocation(voxelTableCapacity * sizeof(GLuint));
+        }
+
+        // MARK EVERY SLOT EMPTY ON THE GPU (NO HOST-SIDE STAGING VECTOR)
+        const GLuint emptySlot = 0xFFFFFFFFu;
+        glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, 0, size_t(voxelTableSize) * sizeof(GLuint), GL_RED_INTEGER, GL_UNSIGNED_INT, &emptySlot);
 
-        // OUTPUT BUFFER (KEEP/REMOVE FLAGS)
-        std::vector<GLuint> outputFlags(voxelCount, 0);
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, outputFlagSSBO);
-        glBufferData(GL_SHADER_STORAGE_BUFFER, voxelCount * sizeof(GLuint), outputFlags.data(), GL_DYNAMIC_DRAW);
+        // KEEP FLAGS (ONE PER POINT, WRITTEN FOR EVERY POINT SO NO CLEAR IS NEEDED)
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, keepFlagSSBO);
+        if (pointCount > keepFlagCapacity) {
+            keepFlagCapacity = pointCount;
+            glBufferData(GL_SHADER_STORAGE_BUFFER, keepFlagCapacity * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+            loadStats.RecordDeviceAllocation(keepFlagCapacity * sizeof(GLuint));
+        }
 
         glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
     }
 
-    std::vector<CubeInstance> VoxelDownsampleFilter::ProcessPoints(std::vector<CubeInstance>& cubes) {
-        if (cubes.empty()) {
+    bool VoxelDownsampleFilter::MarkPoints(const Data::PointStore& pointStore, Data::AllocationStats& loadStats) {
+        if (!IsAvailable()) return false;
+        if (pointStore.Empty()) {
             SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "NO POINTS TO PROCESS IN VOXEL DOWNSAMPLING");
-            return {};
+            return false;
+        }
+        if (pointStore.Size() > UINT32_MAX) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "GPU VOXEL DOWNSAMPLING SUPPORTS AT MOST %u POINTS", UINT32_MAX);
+            return false;
         }
 
         // PREPARE INPUT DATA
-        pointData.clear();
-        pointData.reserve(cubes.size());
-        for (const CubeInstance& cube : cubes) {
-            pointData.push_back(cube.position);
-        }
+        UploadPoints(pointStore, loadStats);
 
-        CalculateVoxelSize();
-        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, 
-            "VOXEL SIZE: %.3f, VOXEL COUNT: %zu, POINT COUNT: %zu", voxelSize, voxelCount, pointData.size());
+        CalculateVoxelSize(pointStore, loadStats);
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+            "VOXEL SIZE: %.3f, VOXEL COUNT: %llu, POINT COUNT: %llu", voxelSize,
+            static_cast<unsigned long long>(voxelCount), static_cast<unsigned long long>(pointCount));
 
-        UpdateBufferSize();
+        UpdateBufferSize(loadStats);
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "VOXEL HASH TABLE: %u SLOTS (%.1f MB)",
+            voxelTableSize, voxelTableSize * sizeof(GLuint) / (1024.0 * 1024.0));
 
         glUseProgram(computeProgram);
 
         // SET UNIFORMS
         glUniform1f(uVoxelSize, voxelSize);
         glUniform3fv(uVoxelOrigin, 1, glm::value_ptr(voxelOrigin));
-        glUniform3fv(uVoxelBounds, 1, glm::value_ptr(voxelBounds));
-        glUniform1ui(uVoxelCount, static_cast<GLuint>(voxelCount));
+        glUniform1ui(uTableMask, voxelTableSize - 1);
+        glUniform1ui(uPointCount, static_cast<GLuint>(pointCount));
 
         // BIND BUFFERS
         glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, inputPointSSBO);
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, outputFlagSSBO);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, voxelTableSSBO);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, keepFlagSSBO);
 
-        // DISPATCH COMPUTE SHADER
-        GLuint workGroupsX = (static_cast<GLuint>(pointData.size()) + 63) / 64;
-        glDispatchCompute(workGroupsX, 1, 1);
+        // INSERT (EACH VOXEL ENDS UP HOLDING ITS LOWEST POINT INDEX), THEN RESOLVE THE KEEP FLAGS
+        const GLuint workGroups = (static_cast<GLuint>(pointCount) + 63) / 64;
+        glUniform1ui(uPass, 0u);
+        Renderer::DispatchCompute1D(workGroups);
         glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
-        // READ OUTPUT FLAGS (1 KEEP, 0 REMOVE)
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, outputFlagSSBO);
-        GLuint* outputFlags = static_cast<GLuint*>(
-            glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, pointData.size() * sizeof(GLuint), GL_MAP_READ_BIT)
-        );
-        
-        std::vector<CubeInstance> result;
-        result.reserve(cubes.size());
-        for (GLuint index = 0; index < cubes.size(); ++index) {
-            // KEEP POINT IF FLAGGED
-            if (outputFlags[index] > 0) {
-                result.push_back(cubes[index]);
+        glUniform1ui(uPass, 1u);
+        Renderer::DispatchCompute1D(workGroups);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        return true;
+    }
+
+    void VoxelDownsampleFilter::WriteInstances(GLuint modelBuffer, GLuint intensityBuffer, GLuint attributeBuffer, GLuint drawCommandBuffer, uint64_t instanceCapacity,
+        GLuint indexCount, Data::AllocationStats& loadStats) {
+        const GLuint count = static_cast<GLuint>(pointCount);
+
+        // OUTPUT OFFSETS: EXCLUSIVE PREFIX SUM OF THE KEEP FLAGS
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, offsetSSBO);
+        if (pointCount > offsetCapacity) {
+            offsetCapacity = pointCount;
+            glBufferData(GL_SHADER_STORAGE_BUFFER, offsetCapacity * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+            loadStats.RecordDeviceAllocation(offsetCapacity * sizeof(GLuint));
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, keepFlagSSBO);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, offsetSSBO);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, size_t(count) * sizeof(GLuint));
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+        prefixSum.Scan(offsetSSBO, count, false, loadStats);
+
+        // RAW INTENSITIES ARE PACKED TWO PER WORD WITH ATOMIC ORS, START FROM ZERO
+        const GLuint capacity = static_cast<GLuint>(std::min<uint64_t>(instanceCapacity, UINT32_MAX));
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, intensityBuffer);
+        glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, 0, (size_t(capacity) + 1) / 2 * sizeof(GLuint), GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+        // SCATTER SURVIVORS INTO THE INSTANCE BUFFERS, THREAD 0 WRITES THE DRAW COMMAND
+        glUseProgram(scatterProgram);
+        glUniform1ui(uScatterPointCount, count);
+        glUniform1ui(uScatterCapacity, capacity);
+        glUniform1ui(uScatterIndexCount, indexCount);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, inputPointSSBO);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, keepFlagSSBO);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, offsetSSBO);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, modelBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, intensityBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, drawCommandBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, attributeBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 7, inputAttributeSSBO);
+        Renderer::DispatchCompute1D((count + 255) / 256);
+
+        // FIRST OUTPUT SLOT OF EVERY STORE BLOCK (READ BACK BY THE RENDERER ONCE THE COMPACTION IS FENCED)
+        if (blockOffsetProgram) {
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, blockOffsetSSBO);
+            if (size_t(blockCount) + 1 > blockOffsetCapacity) {
+                blockOffsetCapacity = size_t(blockCount) + 1;
+                glBufferData(GL_SHADER_STORAGE_BUFFER, blockOffsetCapacity * sizeof(GLuint), nullptr, GL_DYNAMIC_READ);
+                loadStats.RecordDeviceAllocation(blockOffsetCapacity * sizeof(GLuint));
             }
+            glUseProgram(blockOffsetProgram);
+            glUniform1ui(uBlockPointCount, count);
+            glUniform1ui(uBlockSize, Data::PointStore::BlockSize);
+            glUniform1ui(uBlockCount, blockCount);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, keepFlagSSBO);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, offsetSSBO);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, blockOffsetSSBO);
+            Renderer::DispatchCompute1D((blockCount + 1 + 255) / 256);
         }
 
+        // INSTANCE ATTRIBUTES AND THE INDIRECT COMMAND ARE CONSUMED BY THE NEXT DRAW
+        glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+        glUseProgram(0);
+    }
+
+    bool VoxelDownsampleFilter::ReadBlockOffsets(std::vector<GLuint>& offsets, Data::AllocationStats& loadStats) const {
+        if (!blockOffsetProgram || blockCount == 0) return false;
+        Data::AcquireBuffer(offsets, size_t(blockCount) + 1, loadStats);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, blockOffsetSSBO);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, offsets.size() * sizeof(GLuint), offsets.data());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        return true;
+    }
+
+    bool VoxelDownsampleFilter::ProcessPoints(const Data::PointStore& pointStore, std::vector<CubeInstance>& output, Data::AllocationStats& loadStats) {
+        if (!MarkPoints(pointStore, loadStats)) return false;
+
+        // READ KEEP FLAGS (1 KEEP, 0 REMOVE)
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, keepFlagSSBO);
+        GLuint* keepFlags = static_cast<GLuint*>(
+            glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, pointCount * sizeof(GLuint), GL_MAP_READ_BIT)
+        );
+        if (!keepFlags) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "FAILED TO MAP VOXEL DOWNSAMPLING KEEP FLAGS");
+            return false;
+        }
+
+        // SIZE THE OUTPUT EXACTLY (POOLED), THEN COPY SURVIVORS STRAIGHT INTO IT
+        size_t keptCount = 0;
+        for (uint64_t index = 0; index < pointCount; ++index) {
+            keptCount += keepFlags[index] > 0 ? 1 : 0;
+        }
+        Data::AcquireBuffer(output, keptCount, loadStats);
+
+        size_t outputIndex = 0;
+        pointStore.ForEachBlock([&output, &outputIndex, keepFlags](const CubeInstance* points, uint32_t count, uint64_t firstIndex) {
+            for (uint32_t i = 0; i < count; ++i) {
+                // KEEP POINT IF FLAGGED
+                if (keepFlags[firstIndex + i] > 0) {
+                    output[outputIndex++] = points[i];
+                }
+            }
+        });
+
         glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-        return result;
+        return true;
     }
 
-}
\ No newline at end of file
+}
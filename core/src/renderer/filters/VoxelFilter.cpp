@@ -0,0 +1,48 @@
+#include <algorithm>
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+#include <BudgetGovernor.hpp>
+#include <MemoryPool.hpp>
+#include <PointStore.hpp>
+#include <VoxelFilter.hpp>
+#include <VoxelSizeSolver.hpp>
+
+namespace Filters {
+
+    void VoxelFilter::CalculateVoxelSize(const Data::PointStore& pointStore, Data::AllocationStats& loadStats) {
+        if (pointCount == 0) return;
+
+        voxelOrigin = minPoint;
+
+        // CALCULATE THE VOXEL SIZE (POLICY OWNED BY THE BUDGET GOVERNOR)
+        glm::vec3 extent = maxPoint - minPoint;
+        uint64_t budget = renderBudget > 0 ? renderBudget : pointCount;
+        uint64_t target = targetPointCount > 0 ? std::min(targetPointCount, budget) : budget;
+        if (solveVoxelSize && target < pointCount) {
+            voxelSize = sizeSolver.Solve(pointStore, minPoint, maxPoint, target, Data::BudgetGovernor::MinVoxelSize, loadStats).voxelSize;
+        } else {
+            voxelSize = Data::BudgetGovernor::VoxelSizeForBudget(pointCount, extent, budget);
+        }
+
+        // CALCULATE VOXEL BOUNDS, AND VOXEL COUNT (CELLS OF THE BOUNDING GRID, NOT ALLOCATED BY ANY BACKEND)
+        auto gridSize = [&extent](float size) {
+            return glm::max(glm::ceil(extent / size), glm::vec3(1.0f));
+        };
+
+        // KEEP LINEAR VOXEL KEYS WITHIN 62 BITS (ROUNDING ADDS ONE CELL PER AXIS), ONLY EXTREME EXTENTS GROW THE SIZE
+        const double maxKeyVoxels = double(1ull << 62);
+        auto keyVoxelCount = [&gridSize](float size) {
+            glm::vec3 grid = gridSize(size) + 1.0f;
+            return double(grid.x) * double(grid.y) * double(grid.z);
+        };
+        while (keyVoxelCount(voxelSize) > maxKeyVoxels) {
+            voxelSize *= 1.25f;
+        }
+
+        voxelBounds = gridSize(voxelSize);
+        voxelCount = uint64_t(voxelBounds.x) * uint64_t(voxelBounds.y) * uint64_t(voxelBounds.z);
+    }
+
+}
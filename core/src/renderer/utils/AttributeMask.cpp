@@ -0,0 +1,55 @@
+#include <cfloat>
+#include <cstdint>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <AttributeMask.hpp>
+
+namespace Renderer::Utils {
+
+    void AttributeMask::Reset() {
+        for (uint32_t& word : classMask) word = UINT32_MAX;
+        returnMask = (1u << ReturnCount) - 1u;
+        lastReturnOnly = false;
+        sourceRange = glm::uvec2(0u, UINT16_MAX);
+        intensityRange = glm::uvec2(0u, UINT16_MAX);
+        elevationRange = glm::vec2(-FLT_MAX, FLT_MAX);
+    }
+
+    bool AttributeMask::operator == (const AttributeMask& other) const {
+        for (uint32_t word = 0; word < ClassCount / 32; ++word) {
+            if (classMask[word] != other.classMask[word]) return false;
+        }
+        return returnMask == other.returnMask && lastReturnOnly == other.lastReturnOnly && sourceRange == other.sourceRange
+            && intensityRange == other.intensityRange && elevationRange == other.elevationRange;
+    }
+
+    void AttributeMask::CopyVisibility(const AttributeMask& other) {
+        for (uint32_t word = 0; word < ClassCount / 32; ++word) classMask[word] = other.classMask[word];
+        returnMask = other.returnMask;
+        lastReturnOnly = other.lastReturnOnly;
+        sourceRange = other.sourceRange;
+        intensityRange = other.intensityRange;
+        elevationRange = other.elevationRange;
+    }
+
+    void AttributeMask::GetLocations(GLuint program) {
+        uClassMask = glGetUniformLocation(program, "uClassMask");
+        uReturnMask = glGetUniformLocation(program, "uReturnMask");
+        uLastReturnOnly = glGetUniformLocation(program, "uLastReturnOnly");
+        uSourceRange = glGetUniformLocation(program, "uSourceRange");
+        uIntensityRange = glGetUniformLocation(program, "uIntensityRange");
+        uElevationRange = glGetUniformLocation(program, "uElevationRange");
+    }
+
+    void AttributeMask::Apply() const {
+        glUniform1uiv(uClassMask, ClassCount / 32, classMask);
+        glUniform1ui(uReturnMask, returnMask);
+        glUniform1i(uLastReturnOnly, lastReturnOnly ? 1 : 0);
+        glUniform2ui(uSourceRange, sourceRange.x, sourceRange.y);
+        glUniform2ui(uIntensityRange, intensityRange.x, intensityRange.y);
+        glUniform2f(uElevationRange, elevationRange.x, elevationRange.y);
+    }
+
+}
@@ -0,0 +1,140 @@
+#include <cstdint>
+
+#include <SDL3/SDL.h>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <AttributeMask.hpp>
+#include <CubeStripPass.hpp>
+#include <RendererHelper.hpp>
+
+namespace Renderer::Utils {
+
+    namespace {
+
+        // OFFSET OF instanceCount IN A DrawElementsIndirectCommand
+        constexpr GLintptr InstanceCountOffset = sizeof(GLuint);
+
+    }
+
+    bool CubeStripPass::Init(GLuint modelBuffer, GLuint intensityBuffer, GLuint attributeBuffer) {
+        if (stripShader) return true;
+
+        // cube_strip.vert READS THE INSTANCE BUFFERS (AND THE PULLED LIST) AS STORAGE BLOCKS
+        GLint vertexStorageBlocks = 0;
+        glGetIntegerv(GL_MAX_VERTEX_SHADER_STORAGE_BLOCKS, &vertexStorageBlocks);
+        if (vertexStorageBlocks < 4) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "PROCEDURAL CUBES UNAVAILABLE (%d VERTEX SHADER STORAGE BLOCKS)", vertexStorageBlocks);
+            return false;
+        }
+
+        stripShader = Renderer::CreateShaderProgramFromFiles(
+            "../assets/shaders/cube/cube_strip.vert",
+            "../assets/shaders/cube/cube.frag"
+        );
+        if (!stripShader) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "PROCEDURAL CUBE SHADER UNAVAILABLE, CUBES ARE ONLY DRAWN INDEXED");
+            return false;
+        }
+
+        // WITHOUT IT THE SHADER ASSUMES INSTANCE ZERO AS THE BASE, MULTI-DRAWS STAY ON THE INDEXED CUBES
+        hasBaseInstance = Renderer::HasExtension("GL_ARB_shader_draw_parameters");
+        if (!hasBaseInstance) {
+            SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "GL_ARB_shader_draw_parameters UNAVAILABLE, PROCEDURAL CUBES ONLY FOR SINGLE DRAWS");
+        }
+
+        uViewProjectionLocation = glGetUniformLocation(stripShader, "uViewProjection");
+        uGlobalScaleLocation = glGetUniformLocation(stripShader, "uGlobalScale");
+        uCameraPositionLocation = glGetUniformLocation(stripShader, "uCameraPosition");
+        uFarDistanceLocation = glGetUniformLocation(stripShader, "uFarDistance");
+        uUseNormalsLocation = glGetUniformLocation(stripShader, "uUseNormals");
+        uPullInstancesLocation = glGetUniformLocation(stripShader, "uPullInstances");
+        uFirstInstanceLocation = glGetUniformLocation(stripShader, "uFirstInstance");
+        uColorLUTLocation = glGetUniformLocation(stripShader, "uColorLUT");
+        uIntensityMapLocation = glGetUniformLocation(stripShader, "uIntensityMap");
+        stripMask.GetLocations(stripShader);
+
+        this->modelBuffer = modelBuffer;
+        this->intensityBuffer = intensityBuffer;
+        this->attributeBuffer = attributeBuffer;
+
+        // IDENTITY INDICES, SO ELEMENT DRAWS (AND THEIR INDIRECT COMMANDS) SEE gl_VertexID 0 - 8
+        GLuint indices[VertexCount];
+        for (GLuint i = 0; i < VertexCount; ++i) indices[i] = i;
+
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &ebo);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+        // WHOLE-DRAW COMMAND, ONLY THE INSTANCE COUNT IS REWRITTEN (COPIED FROM THE CUBE COMMAND)
+        const GLuint command[5] = { VertexCount, 0, 0, 0, 0 };
+        glGenBuffers(1, &commandBuffer);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(command), command, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        return true;
+    }
+
+    void CubeStripPass::Shutdown() {
+        if (stripShader) glDeleteProgram(stripShader);
+        if (vao) glDeleteVertexArrays(1, &vao);
+        if (ebo) glDeleteBuffers(1, &ebo);
+        if (commandBuffer) glDeleteBuffers(1, &commandBuffer);
+        stripShader = vao = ebo = commandBuffer = 0;
+        modelBuffer = intensityBuffer = attributeBuffer = 0;
+        hasBaseInstance = false;
+    }
+
+    void CubeStripPass::Begin(const glm::mat4& viewProjection, const glm::vec3& cameraPosition, float globalScale, float farDistance,
+        bool useNormals, bool pullInstances, const AttributeMask& mask, GLuint colorLUTUnit, GLuint intensityMapUnit) {
+        glUseProgram(stripShader);
+        glBindVertexArray(vao);
+
+        glUniformMatrix4fv(uViewProjectionLocation, 1, GL_FALSE, glm::value_ptr(viewProjection));
+        glUniform1f(uGlobalScaleLocation, globalScale);
+        glUniform3fv(uCameraPositionLocation, 1, glm::value_ptr(cameraPosition));
+        glUniform1f(uFarDistanceLocation, farDistance);
+        glUniform1i(uUseNormalsLocation, useNormals ? 1 : 0);
+        glUniform1i(uPullInstancesLocation, pullInstances ? 1 : 0);
+        glUniform1ui(uFirstInstanceLocation, 0);
+        glUniform1i(uColorLUTLocation, GLint(colorLUTUnit));
+        glUniform1i(uIntensityMapLocation, GLint(intensityMapUnit));
+
+        stripMask.CopyVisibility(mask);
+        stripMask.Apply();
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, modelBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, intensityBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, attributeBuffer);
+    }
+
+    void CubeStripPass::End() const {
+        glBindVertexArray(0);
+        glUseProgram(0);
+    }
+
+    void CubeStripPass::DrawIndirect(GLuint drawCommandBuffer) const {
+        // DEVICE-SIDE COPY, THE COUNT MAY HAVE BEEN WRITTEN BY THE GPU FILTER (NO HOST ROUND-TRIP)
+        glBindBuffer(GL_COPY_READ_BUFFER, drawCommandBuffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, commandBuffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, InstanceCountOffset, InstanceCountOffset, sizeof(GLuint));
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glDrawElementsIndirect(GL_TRIANGLE_STRIP, GL_UNSIGNED_INT, nullptr);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    void CubeStripPass::DrawPulled(uint64_t first, uint64_t count) const {
+        if (count == 0) return;
+        glUniform1ui(uFirstInstanceLocation, static_cast<GLuint>(first));
+        glDrawElementsInstanced(GL_TRIANGLE_STRIP, VertexCount, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(count));
+    }
+
+}
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <ElevationGrid.hpp>
+#include <HeightmapMesh.hpp>
+#include <RendererHelper.hpp>
+
+namespace Renderer::Utils {
+
+    bool HeightmapMesh::Init() {
+        if (shader) return true;
+        shader = Renderer::CreateShaderProgramFromFiles(
+            "../assets/shaders/heightmap/heightmap.vert",
+            "../assets/shaders/heightmap/heightmap.frag"
+        );
+        if (!shader) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "HEIGHTMAP SHADER UNAVAILABLE, FAR-FIELD TERRAIN DISABLED");
+            return false;
+        }
+
+        uViewProjectionLocation = glGetUniformLocation(shader, "uViewProjection");
+        uCameraPositionLocation = glGetUniformLocation(shader, "uCameraPosition");
+        uNearDistanceLocation = glGetUniformLocation(shader, "uNearDistance");
+        uColorLUTLocation = glGetUniformLocation(shader, "uColorLUT");
+        uIntensityMapLocation = glGetUniformLocation(shader, "uIntensityMap");
+
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+        glGenBuffers(1, &ebo);
+
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) offsetof(Vertex, position));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) offsetof(Vertex, intensity));
+        glBindVertexArray(0);
+        return true;
+    }
+
+    void HeightmapMesh::Shutdown() {
+        if (shader) glDeleteProgram(shader);
+        if (vao) glDeleteVertexArrays(1, &vao);
+        if (vbo) glDeleteBuffers(1, &vbo);
+        if (ebo) glDeleteBuffers(1, &ebo);
+        shader = vao = vbo = ebo = 0;
+        indexCount = 0;
+    }
+
+    void HeightmapMesh::Clear() {
+        indexCount = 0;
+        vertices.clear();
+        indices.clear();
+    }
+
+    void HeightmapMesh::Build(const Spatial::ElevationGrid& grid) {
+        Clear();
+        if (!vao || grid.Empty()) return;
+
+        // ONE VERTEX PER (stride x stride) CELL BLOCK, AT THE BLOCK CENTER
+        const uint32_t columns = grid.GetColumns();
+        const uint32_t rows = grid.GetRows();
+        const uint32_t stride = std::max(1u, (std::max(columns, rows) + MeshResolution - 1) / MeshResolution);
+        const uint32_t meshColumns = (columns + stride - 1) / stride;
+        const uint32_t meshRows = (rows + stride - 1) / stride;
+
+        const std::vector<uint32_t>& counts = grid.GetCounts();
+        std::vector<uint8_t> valid(size_t(meshColumns) * meshRows, 0);
+        vertices.resize(valid.size());
+        for (uint32_t meshRow = 0; meshRow < meshRows; ++meshRow) {
+            for (uint32_t meshColumn = 0; meshColumn < meshColumns; ++meshColumn) {
+                const uint32_t firstColumn = meshColumn * stride;
+                const uint32_t firstRow = meshRow * stride;
+                const uint32_t lastColumn = std::min(columns, firstColumn + stride);
+                const uint32_t lastRow = std::min(rows, firstRow + stride);
+
+                // POINT-WEIGHTED MEANS OVER THE BLOCK
+                double heightSum = 0.0;
+                double intensitySum = 0.0;
+                uint64_t total = 0;
+                for (uint32_t row = firstRow; row < lastRow; ++row) {
+                    for (uint32_t column = firstColumn; column < lastColumn; ++column) {
+                        const size_t cell = grid.CellIndex(column, row);
+                        heightSum += double(grid.GetMeans()[cell]) * counts[cell];
+                        intensitySum += double(grid.GetIntensities()[cell]) * counts[cell];
+                        total += counts[cell];
+                    }
+                }
+
+                const size_t vertexIndex = size_t(meshRow) * meshColumns + meshColumn;
+                valid[vertexIndex] = total > 0;
+                const float centerX = grid.GetOrigin().x + 0.5f * float(firstColumn + lastColumn) * grid.GetCellSize();
+                const float centerY = grid.GetOrigin().y + 0.5f * float(firstRow + lastRow) * grid.GetCellSize();
+                vertices[vertexIndex].position = glm::vec3(centerX, centerY, total > 0 ? float(heightSum / double(total)) : 0.0f);
+                vertices[vertexIndex].intensity = total > 0 ? float(intensitySum / double(total)) : 0.0f;
+            }
+        }
+
+        // TWO TRIANGLES PER QUAD OF FILLED VERTICES
+        for (uint32_t meshRow = 0; meshRow + 1 < meshRows; ++meshRow) {
+            for (uint32_t meshColumn = 0; meshColumn + 1 < meshColumns; ++meshColumn) {
+                const GLuint corner = GLuint(meshRow * meshColumns + meshColumn);
+                const GLuint right = corner + 1;
+                const GLuint up = corner + meshColumns;
+                const GLuint upRight = up + 1;
+                if (!valid[corner] || !valid[right] || !valid[up] || !valid[upRight]) continue;
+                indices.insert(indices.end(), { corner, right, upRight, upRight, up, corner });
+            }
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+        glBindVertexArray(0);
+        indexCount = GLsizei(indices.size());
+
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "HEIGHTMAP MESH: %u x %u VERTICES (STRIDE %u CELLS), %d TRIANGLES",
+            meshColumns, meshRows, stride, int(indexCount / 3));
+    }
+
+    void HeightmapMesh::Render(const glm::mat4& viewProjection, const glm::vec3& cameraPosition, float nearDistance,
+        GLuint colorLUTUnit, GLuint intensityMapUnit) const {
+        if (indexCount == 0) return;
+
+        glEnable(GL_DEPTH_TEST);
+        glUseProgram(shader);
+        glBindVertexArray(vao);
+
+        glUniformMatrix4fv(uViewProjectionLocation, 1, GL_FALSE, glm::value_ptr(viewProjection));
+        glUniform3fv(uCameraPositionLocation, 1, glm::value_ptr(cameraPosition));
+        glUniform1f(uNearDistanceLocation, nearDistance);
+        glUniform1i(uColorLUTLocation, GLint(colorLUTUnit));
+        glUniform1i(uIntensityMapLocation, GLint(intensityMapUnit));
+
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr);
+
+        glBindVertexArray(0);
+        glUseProgram(0);
+        glDisable(GL_DEPTH_TEST);
+    }
+
+}
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cstdint>
+
+#include <SDL3/SDL.h>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <InstanceCullPass.hpp>
+#include <MemoryPool.hpp>
+#include <RendererHelper.hpp>
+
+namespace Renderer::Utils {
+
+    bool InstanceCullPass::Init() {
+        if (cullProgram) return true;
+
+        // cube.vert READS THE VISIBLE INDICES AND THREE INSTANCE BUFFERS AS STORAGE BLOCKS
+        GLint vertexStorageBlocks = 0;
+        glGetIntegerv(GL_MAX_VERTEX_SHADER_STORAGE_BLOCKS, &vertexStorageBlocks);
+        if (vertexStorageBlocks < 4) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "GPU INSTANCE CULLING UNAVAILABLE (%d VERTEX SHADER STORAGE BLOCKS)", vertexStorageBlocks);
+            return false;
+        }
+
+        cullProgram = Renderer::CreateComputeShaderProgram("../assets/shaders/compute/instance_cull.comp");
+        if (cullProgram && !prefixSum.Init()) {
+            glDeleteProgram(cullProgram);
+            cullProgram = 0;
+        }
+        if (!cullProgram) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "GPU INSTANCE CULLING PROGRAM UNAVAILABLE, ONLY NODES ARE CULLED");
+            return false;
+        }
+
+        uPlanes = glGetUniformLocation(cullProgram, "uPlanes");
+        uDepthRow = glGetUniformLocation(cullProgram, "uDepthRow");
+        uRadius = glGetUniformLocation(cullProgram, "uRadius");
+        uProjectedSize = glGetUniformLocation(cullProgram, "uProjectedSize");
+        uMinScreenSize = glGetUniformLocation(cullProgram, "uMinScreenSize");
+        uCapacity = glGetUniformLocation(cullProgram, "uCapacity");
+        uUseNodes = glGetUniformLocation(cullProgram, "uUseNodes");
+        uNodeCount = glGetUniformLocation(cullProgram, "uNodeCount");
+        uPass = glGetUniformLocation(cullProgram, "uPass");
+
+        glGenBuffers(1, &visibleIndexSSBO);
+        glGenBuffers(1, &nodeSurvivorSSBO);
+        glGenBuffers(1, &culledCommandBuffer);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, culledCommandBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, 5 * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        return true;
+    }
+
+    void InstanceCullPass::Shutdown() {
+        if (cullProgram) glDeleteProgram(cullProgram);
+        if (visibleIndexSSBO) glDeleteBuffers(1, &visibleIndexSSBO);
+        if (culledCommandBuffer) glDeleteBuffers(1, &culledCommandBuffer);
+        if (nodeSurvivorSSBO) glDeleteBuffers(1, &nodeSurvivorSSBO);
+        prefixSum.Shutdown();
+        cullProgram = visibleIndexSSBO = culledCommandBuffer = nodeSurvivorSSBO = 0;
+        visibleIndexCapacity = nodeSurvivorCapacity = 0;
+    }
+
+    void InstanceCullPass::Run(const glm::mat4& viewProjection, float cubeSize, GLuint modelBuffer, GLuint drawCommandBuffer, uint64_t instanceCapacity,
+        GLuint nodeCommandBuffer, GLuint nodeCount, GLuint indexCount, Data::AllocationStats& loadStats) {
+        if (!IsAvailable()) return;
+        const GLuint capacity = static_cast<GLuint>(std::min<uint64_t>(instanceCapacity, UINT32_MAX));
+
+        // ONE INDEX PER INSTANCE IN THE WORST CASE (GROW ONLY)
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, visibleIndexSSBO);
+        if (capacity > visibleIndexCapacity) {
+            visibleIndexCapacity = capacity;
+            glBufferData(GL_SHADER_STORAGE_BUFFER, visibleIndexCapacity * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+            loadStats.RecordDeviceAllocation(visibleIndexCapacity * sizeof(GLuint));
+        }
+
+        // DRAW COMMAND WITH NO INSTANCES, THE PASS COUNTS THE SURVIVORS INTO IT
+        const GLuint command[5] = { indexCount, 0, 0, 0, 0 };
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, culledCommandBuffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(command), command);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        if (capacity == 0 || (nodeCommandBuffer && nodeCount == 0)) return;
+
+        glm::vec4 planes[6];
+        Renderer::ExtractFrustumPlanes(viewProjection, planes);
+        const glm::vec4 depthRow(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+        glUseProgram(cullProgram);
+        glUniform4fv(uPlanes, 6, &planes[0].x);
+        glUniform4f(uDepthRow, depthRow.x, depthRow.y, depthRow.z, depthRow.w);
+        glUniform1f(uRadius, cubeSize * 0.8660254f);
+        glUniform1f(uProjectedSize, cubeSize * Renderer::PixelsPerUnit(viewProjection));
+        glUniform1f(uMinScreenSize, minScreenSize);
+        glUniform1ui(uCapacity, capacity);
+        glUniform1i(uUseNodes, nodeCommandBuffer ? 1 : 0);
+        glUniform1ui(uNodeCount, nodeCommandBuffer ? nodeCount : 0);
+        glUniform1ui(uPass, 0);
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, modelBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, drawCommandBuffer);
+        if (nodeCommandBuffer) glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, nodeCommandBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, culledCommandBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, visibleIndexSSBO);
+
+        if (!nodeCommandBuffer) {
+            // ONE THREAD PER INSTANCE OF THE UNCULLED DRAW (INSTANCE ORDER WITHIN A GROUP)
+            Renderer::DispatchCompute1D((capacity + 255) / 256);
+        } else {
+            // ONE WORKGROUP PER NODE: COUNT, SCAN THE COUNTS, THEN WRITE EVERY NODE'S SURVIVORS AT ITS OFFSET (FRONT TO BACK)
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, nodeSurvivorSSBO);
+            if (nodeCount > nodeSurvivorCapacity) {
+                nodeSurvivorCapacity = nodeCount;
+                glBufferData(GL_SHADER_STORAGE_BUFFER, nodeSurvivorCapacity * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+                loadStats.RecordDeviceAllocation(nodeSurvivorCapacity * sizeof(GLuint));
+            }
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, nodeSurvivorSSBO);
+            Renderer::DispatchCompute1D(nodeCount);
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+            prefixSum.Scan(nodeSurvivorSSBO, nodeCount, true, loadStats);
+
+            // THE SCAN USES ITS OWN PROGRAMS AND BINDINGS
+            glUseProgram(cullProgram);
+            glUniform1ui(uPass, 1);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, modelBuffer);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, drawCommandBuffer);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, nodeCommandBuffer);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, culledCommandBuffer);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, visibleIndexSSBO);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, nodeSurvivorSSBO);
+            Renderer::DispatchCompute1D(nodeCount);
+        }
+
+        // THE INDICES ARE READ BY THE VERTEX SHADER, THE COUNT BY THE INDIRECT DRAW
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+        glUseProgram(0);
+    }
+
+    void InstanceCullPass::BindVisibleIndices(GLuint binding) const {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, visibleIndexSSBO);
+    }
+
+    void InstanceCullPass::Draw(GLenum primitive) const {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, culledCommandBuffer);
+        glDrawElementsIndirect(primitive, GL_UNSIGNED_INT, nullptr);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+}
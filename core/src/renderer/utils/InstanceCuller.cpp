@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define INSTANCE_CULLER_SSE2 1
+#endif
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <CubeInstance.hpp>
+#include <InstanceCuller.hpp>
+#include <RadixSort.hpp>
+#include <RendererHelper.hpp>
+
+namespace Renderer::Utils {
+
+    namespace {
+
+        // NON-NEGATIVE FLOATS ORDER THE SAME AS THEIR BIT PATTERNS
+        uint32_t FloatBits(float value) {
+            uint32_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+    }
+
+    void InstanceCuller::Init() {
+        glGenBuffers(1, &commandBuffer);
+    }
+
+    void InstanceCuller::Shutdown() {
+        if (commandBuffer) glDeleteBuffers(1, &commandBuffer);
+        commandBuffer = 0;
+        commandCapacity = 0;
+    }
+
+    void InstanceCuller::Clear() {
+        minX.clear();
+        minY.clear();
+        minZ.clear();
+        maxX.clear();
+        maxY.clear();
+        maxZ.clear();
+        nodeFirst.clear();
+        nodeCount.clear();
+        commands.clear();
+        drawnCount = 0;
+        culledCount = 0;
+    }
+
+    void InstanceCuller::AddInstances(const CubeInstance* instances, uint64_t first, uint64_t count) {
+        for (uint64_t begin = first; begin < first + count; begin += NodeSize) {
+            const uint64_t end = std::min<uint64_t>(begin + NodeSize, first + count);
+            glm::vec3 minimum(FLT_MAX);
+            glm::vec3 maximum(-FLT_MAX);
+            for (uint64_t index = begin; index < end; ++index) {
+                minimum = glm::min(minimum, instances[index].position);
+                maximum = glm::max(maximum, instances[index].position);
+            }
+            AddNode(static_cast<uint32_t>(begin), static_cast<uint32_t>(end - begin), minimum, maximum);
+        }
+    }
+
+    void InstanceCuller::AddNode(uint32_t first, uint32_t count, const glm::vec3& minimum, const glm::vec3& maximum) {
+        if (count == 0) return;
+        minX.push_back(minimum.x);
+        minY.push_back(minimum.y);
+        minZ.push_back(minimum.z);
+        maxX.push_back(maximum.x);
+        maxY.push_back(maximum.y);
+        maxZ.push_back(maximum.z);
+        nodeFirst.push_back(first);
+        nodeCount.push_back(count);
+    }
+
+    float InstanceCuller::DistanceSquared(size_t node, const glm::vec3& cameraPosition) const {
+        // CLOSEST POINT OF THE BOX OF INSTANCE CENTERS (ZERO INSIDE)
+        const float dx = std::max(std::max(minX[node] - cameraPosition.x, cameraPosition.x - maxX[node]), 0.0f);
+        const float dy = std::max(std::max(minY[node] - cameraPosition.y, cameraPosition.y - maxY[node]), 0.0f);
+        const float dz = std::max(std::max(minZ[node] - cameraPosition.z, cameraPosition.z - maxZ[node]), 0.0f);
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    bool InstanceCuller::IsVisible(size_t node, const glm::vec4* planes, const glm::vec3& cameraPosition, float halfExtent, float farDistanceSquared) const {
+        // THE BOX CORNER FURTHEST ALONG EACH PLANE NORMAL DECIDES (CONSERVATIVE NEAR FRUSTUM EDGES)
+        for (int plane = 0; plane < 6; ++plane) {
+            const glm::vec4& p = planes[plane];
+            const float x = p.x >= 0.0f ? maxX[node] + halfExtent : minX[node] - halfExtent;
+            const float y = p.y >= 0.0f ? maxY[node] + halfExtent : minY[node] - halfExtent;
+            const float z = p.z >= 0.0f ? maxZ[node] + halfExtent : minZ[node] - halfExtent;
+            if (p.x * x + p.y * y + p.z * z + p.w < 0.0f) return false;
+        }
+        return farDistanceSquared <= 0.0f || DistanceSquared(node, cameraPosition) <= farDistanceSquared;
+    }
+
+    void InstanceCuller::Cull(const glm::mat4& viewProjection, const glm::vec3& cameraPosition, float halfExtent, float farDistance,
+        uint64_t drawLimit, GLuint indexCount) {
+        auto start = std::chrono::steady_clock::now();
+        sortKeys.clear();
+        sortNodes.clear();
+        commands.clear();
+        drawnCount = 0;
+        culledCount = 0;
+        if (nodeFirst.empty()) return;
+
+        // CLIP PLANES POINTING INWARD (ONLY THE SIDE OF THE FURTHEST BOX CORNER IS TESTED)
+        glm::vec4 planes[6];
+        Renderer::ExtractFrustumPlanes(viewProjection, planes);
+        const float farDistanceSquared = farDistance > 0.0f ? farDistance * farDistance : 0.0f;
+
+        // NODES ARE ASCENDING, ONLY THOSE STARTING BELOW THE DRAW LIMIT TAKE PART (PYRAMID LEVELS, CLAMPED DEVICE COUNTS)
+        const size_t nodeLimit = size_t(std::lower_bound(nodeFirst.begin(), nodeFirst.end(), drawLimit) - nodeFirst.begin());
+        size_t node = 0;
+#ifdef INSTANCE_CULLER_SSE2
+        // FOUR NODES PER ITERATION, ONE PLANE AT A TIME (THE PLANE'S SIGNS PICK THE MIN OR MAX ARRAY FOR ALL FOUR LANES)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 extent = _mm_set1_ps(halfExtent);
+        const __m128 cameraX = _mm_set1_ps(cameraPosition.x);
+        const __m128 cameraY = _mm_set1_ps(cameraPosition.y);
+        const __m128 cameraZ = _mm_set1_ps(cameraPosition.z);
+        const __m128 farLimit = _mm_set1_ps(farDistanceSquared > 0.0f ? farDistanceSquared : FLT_MAX);
+        for (; node + 4 <= nodeLimit; node += 4) {
+            const __m128 lowX = _mm_loadu_ps(&minX[node]);
+            const __m128 lowY = _mm_loadu_ps(&minY[node]);
+            const __m128 lowZ = _mm_loadu_ps(&minZ[node]);
+            const __m128 highX = _mm_loadu_ps(&maxX[node]);
+            const __m128 highY = _mm_loadu_ps(&maxY[node]);
+            const __m128 highZ = _mm_loadu_ps(&maxZ[node]);
+
+            __m128 outside = zero;
+            for (int plane = 0; plane < 6; ++plane) {
+                const glm::vec4& p = planes[plane];
+                const __m128 x = p.x >= 0.0f ? _mm_add_ps(highX, extent) : _mm_sub_ps(lowX, extent);
+                const __m128 y = p.y >= 0.0f ? _mm_add_ps(highY, extent) : _mm_sub_ps(lowY, extent);
+                const __m128 z = p.z >= 0.0f ? _mm_add_ps(highZ, extent) : _mm_sub_ps(lowZ, extent);
+                const __m128 side = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.x), x), _mm_mul_ps(_mm_set1_ps(p.y), y)),
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.z), z), _mm_set1_ps(p.w)));
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(side, zero));
+            }
+
+            // DISTANCE TO THE BOX OF CENTERS (SORT KEY, FAR-FIELD TEST)
+            const __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(lowX, cameraX), _mm_sub_ps(cameraX, highX)), zero);
+            const __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(lowY, cameraY), _mm_sub_ps(cameraY, highY)), zero);
+            const __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(lowZ, cameraZ), _mm_sub_ps(cameraZ, highZ)), zero);
+            const __m128 distances = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            outside = _mm_or_ps(outside, _mm_cmpgt_ps(distances, farLimit));
+
+            const int visible = ~_mm_movemask_ps(outside) & 0xF;
+            if (!visible) continue;
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, distances);
+            for (int lane = 0; lane < 4; ++lane) {
+                if (!(visible & (1 << lane))) continue;
+                sortKeys.push_back(FloatBits(lanes[lane]));
+                sortNodes.push_back(static_cast<uint32_t>(node + lane));
+            }
+        }
+#endif
+        for (; node < nodeLimit; ++node) {
+            if (!IsVisible(node, planes, cameraPosition, halfExtent, farDistanceSquared)) continue;
+            sortKeys.push_back(FloatBits(DistanceSquared(node, cameraPosition)));
+            sortNodes.push_back(static_cast<uint32_t>(node));
+        }
+
+        // FRONT TO BACK (NEAR CUBES FILL THE DEPTH BUFFER FIRST, HIDDEN FRAGMENTS BEHIND THEM FAIL EARLY)
+        Spatial::RadixSort(sortKeys, sortNodes, sortScratch, 32, 1);
+
+        commands.resize(sortNodes.size());
+        for (size_t i = 0; i < sortNodes.size(); ++i) {
+            const uint32_t visibleNode = sortNodes[i];
+            NodeDrawCommand& command = commands[i];
+            command.count = indexCount;
+            command.instanceCount = static_cast<GLuint>(std::min<uint64_t>(nodeCount[visibleNode], drawLimit - nodeFirst[visibleNode]));
+            command.baseInstance = nodeFirst[visibleNode];
+            drawnCount += command.instanceCount;
+        }
+        if (nodeLimit > 0) {
+            const uint64_t candidateCount = std::min<uint64_t>(drawLimit, uint64_t(nodeFirst[nodeLimit - 1]) + nodeCount[nodeLimit - 1]);
+            culledCount = candidateCount - drawnCount;
+        }
+
+        // RE-SPECIFY ONLY WHEN THE VISIBLE SET OUTGROWS THE BUFFER
+        if (!commands.empty()) {
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+            if (commands.size() > commandCapacity) {
+                commandCapacity = nodeFirst.size();
+                glBufferData(GL_DRAW_INDIRECT_BUFFER, commandCapacity * sizeof(NodeDrawCommand), nullptr, GL_STREAM_DRAW);
+            }
+            glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commands.size() * sizeof(NodeDrawCommand), commands.data());
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    void InstanceCuller::Draw(GLenum primitive) const {
+        if (commands.empty()) return;
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glMultiDrawElementsIndirect(primitive, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(commands.size()), sizeof(NodeDrawCommand));
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+}
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glad/glad.h>
+
+#include <CubeInstance.hpp>
+#include <IntensityEqualizer.hpp>
+#include <IntensityMap.hpp>
+#include <MemoryPool.hpp>
+#include <PrefixSum.hpp>
+#include <RendererHelper.hpp>
+
+namespace Renderer::Utils {
+
+    bool IntensityMap::Init() {
+        if (tableTexture) return IsAvailable();
+
+        // LOOKUP TABLE AS A BUFFER TEXTURE (65536 TEXELS EXCEEDS THE GUARANTEED 1D TEXTURE SIZE)
+        std::vector<float> linear(BinCount);
+        for (GLuint bin = 0; bin < BinCount; ++bin) linear[bin] = float(bin) / float(BinCount - 1);
+
+        glGenBuffers(1, &tableBuffer);
+        glBindBuffer(GL_TEXTURE_BUFFER, tableBuffer);
+        glBufferData(GL_TEXTURE_BUFFER, BinCount * sizeof(float), linear.data(), GL_DYNAMIC_COPY);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+        glGenTextures(1, &tableTexture);
+        glBindTexture(GL_TEXTURE_BUFFER, tableTexture);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, tableBuffer);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+        histogramProgram = Renderer::CreateComputeShaderProgram("../assets/shaders/compute/intensity_histogram.comp");
+        mapProgram = Renderer::CreateComputeShaderProgram("../assets/shaders/compute/intensity_map.comp");
+        prefixSum.Init();
+        if (!IsAvailable()) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "GPU INTENSITY MAPPING UNAVAILABLE, INTENSITIES WILL BE MAPPED ON THE CPU");
+            return false;
+        }
+
+        uMapMode = glGetUniformLocation(mapProgram, "uMode");
+        uMapLowFraction = glGetUniformLocation(mapProgram, "uLowFraction");
+        uMapHighFraction = glGetUniformLocation(mapProgram, "uHighFraction");
+
+        glGenBuffers(1, &cumulativeSSBO);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, cumulativeSSBO);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, BinCount * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        return true;
+    }
+
+    void IntensityMap::Shutdown() {
+        if (histogramProgram) glDeleteProgram(histogramProgram);
+        if (mapProgram) glDeleteProgram(mapProgram);
+        if (cumulativeSSBO) glDeleteBuffers(1, &cumulativeSSBO);
+        if (tableBuffer) glDeleteBuffers(1, &tableBuffer);
+        if (tableTexture) glDeleteTextures(1, &tableTexture);
+        prefixSum.Shutdown();
+
+        histogramProgram = mapProgram = cumulativeSSBO = tableBuffer = tableTexture = 0;
+        hasHistogram = false;
+        hasHostHistogram = false;
+    }
+
+    void IntensityMap::Build(GLuint intensityBuffer, GLuint drawCommandBuffer, uint64_t instanceCapacity, Data::AllocationStats& loadStats) {
+        if (!IsAvailable()) return;
+
+        // HISTOGRAM OF THE DRAWN INSTANCES (THE COUNT IS READ FROM THE DRAW COMMAND ON THE DEVICE)
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, cumulativeSSBO);
+        glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, 0, BinCount * sizeof(GLuint), GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+        const GLuint capacity = static_cast<GLuint>(std::min<uint64_t>(instanceCapacity, UINT32_MAX));
+        if (capacity > 0) {
+            glUseProgram(histogramProgram);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, intensityBuffer);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, drawCommandBuffer);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, cumulativeSSBO);
+            Renderer::DispatchCompute1D((capacity + 255) / 256);
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        }
+
+        // CDF: INCLUSIVE PREFIX SUM IN PLACE
+        prefixSum.Scan(cumulativeSSBO, BinCount, true, loadStats);
+        hasHistogram = true;
+
+        UpdateTable();
+    }
+
+    void IntensityMap::BuildOnHost(const CubeInstance* instances, uint64_t count, Data::AllocationStats& loadStats) {
+        if (IsAvailable() || !tableBuffer) return;
+
+        hostEqualizer.Build(instances, size_t(count), loadStats);
+        Data::AcquireBuffer(hostTable, BinCount, loadStats);
+        hasHostHistogram = true;
+
+        UpdateTable();
+    }
+
+    void IntensityMap::SetMapping(IntensityMapping newMapping, float newClipPercent) {
+        mapping = newMapping;
+        clipPercent = std::clamp(newClipPercent, 0.0f, 49.0f);
+        UpdateTable();
+    }
+
+    void IntensityMap::UpdateTable() {
+        // LINEAR MIN / MAX IS THE 0% CLIP OF THE SAME RANGE MAPPING
+        const float clipFraction = mapping == IntensityMapping::PercentileClip ? clipPercent / 100.0f : 0.0f;
+
+        // CPU FALLBACK: SAME TABLE AS intensity_map.comp, UPLOADED (256 KB) INSTEAD OF WRITTEN ON THE DEVICE
+        if (!IsAvailable()) {
+            if (!hasHostHistogram) return;
+            hostEqualizer.WriteTable(mapping == IntensityMapping::Equalize, clipFraction, 1.0f - clipFraction, hostTable.data());
+            glBindBuffer(GL_TEXTURE_BUFFER, tableBuffer);
+            glBufferSubData(GL_TEXTURE_BUFFER, 0, BinCount * sizeof(float), hostTable.data());
+            glBindBuffer(GL_TEXTURE_BUFFER, 0);
+            return;
+        }
+        if (!hasHistogram) return;
+
+        glUseProgram(mapProgram);
+        glUniform1ui(uMapMode, mapping == IntensityMapping::Equalize ? 0u : 1u);
+        glUniform1f(uMapLowFraction, clipFraction);
+        glUniform1f(uMapHighFraction, 1.0f - clipFraction);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, cumulativeSSBO);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, tableBuffer);
+        Renderer::DispatchCompute1D(BinCount / 256);
+
+        // THE TABLE IS FETCHED AS A BUFFER TEXTURE BY THE NEXT DRAW
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+        glUseProgram(0);
+    }
+
+    void IntensityMap::Bind(GLuint textureUnit) const {
+        glActiveTexture(GL_TEXTURE0 + textureUnit);
+        glBindTexture(GL_TEXTURE_BUFFER, tableTexture);
+    }
+
+}
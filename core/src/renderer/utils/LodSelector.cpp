@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <InstanceCuller.hpp>
+#include <LodSelector.hpp>
+#include <RendererHelper.hpp>
+#include <VoxelPyramid.hpp>
+
+namespace Renderer::Utils {
+
+    namespace {
+
+        // FRAME RATES WITHIN THIS FRACTION OF THE TARGET LEAVE THE BUDGET ALONE (NO OSCILLATION AROUND IT)
+        constexpr float FpsTolerance = 0.1f;
+
+        // LARGEST BUDGET CHANGE PER FRAME-RATE SAMPLE
+        constexpr float MinBudgetScale = 0.5f;
+        constexpr float GrowBudgetScale = 1.25f;
+
+        // NODES CONTAINING THE CAMERA ARE TREATED AS THIS CLOSE (FINITE ERROR)
+        constexpr float MinNodeDistance = 0.001f;
+
+    }
+
+    void LodSelector::Init() {
+        glGenBuffers(1, &commandBuffer);
+    }
+
+    void LodSelector::Shutdown() {
+        if (commandBuffer) glDeleteBuffers(1, &commandBuffer);
+        commandBuffer = 0;
+        commandCapacity = 0;
+    }
+
+    void LodSelector::AdaptBudget(float fps) {
+        // THE FRAME RATE IS SAMPLED A FEW TIMES PER SECOND, REACT ONCE PER SAMPLE
+        if (fps <= 0.0f || fps == lastFps || pointBudget == 0) return;
+        lastFps = fps;
+
+        if (fps < targetFps * (1.0f - FpsTolerance)) {
+            const float scale = std::max(fps / targetFps, MinBudgetScale);
+            pointBudget = static_cast<uint64_t>(double(pointBudget) * scale);
+        } else if (fps > targetFps * (1.0f + FpsTolerance) && budgetLimited) {
+            pointBudget = static_cast<uint64_t>(double(pointBudget) * GrowBudgetScale);
+        }
+    }
+
+    void LodSelector::Select(const Spatial::VoxelPyramid& pyramid, const glm::mat4& viewProjection, const glm::vec3& cameraPosition,
+        float globalScale, float farDistance, GLuint indexCount) {
+        auto start = std::chrono::steady_clock::now();
+        visibleNodes.clear();
+        nodeDistances.clear();
+        commands.clear();
+        groups.clear();
+        selectedCount = 0;
+        budgetLimited = false;
+        if (pyramid.Empty() || pyramid.NodeCount() == 0) return;
+
+        const uint32_t coarsestLevel = pyramid.LevelCount() - 1;
+        const uint32_t finestLevel = pyramid.FinestLevel();
+
+        // THE FIRST SELECTION STARTS FROM EVERY BUFFERED POINT, THE FRAME RATE TRIMS IT FROM THERE
+        const uint64_t minimumBudget = pyramid.LevelPointCount(coarsestLevel);
+        const uint64_t maximumBudget = pyramid.LevelPointCount(finestLevel);
+        if (pointBudget == 0) pointBudget = maximumBudget;
+        pointBudget = std::clamp(pointBudget, minimumBudget, maximumBudget);
+
+        glm::vec4 planes[6];
+        Renderer::ExtractFrustumPlanes(viewProjection, planes);
+        const float pixelsPerUnit = Renderer::PixelsPerUnit(viewProjection);
+
+        // COARSEST CUBES ARE THE WIDEST, THEIR EXTENT KEEPS THE NODE TEST CONSERVATIVE AT EVERY LEVEL
+        const float halfExtent = 0.5f * std::max(globalScale, pyramid.LevelSize(coarsestLevel));
+        const size_t nodeCount = pyramid.NodeCount();
+        for (size_t node = 0; node < nodeCount; ++node) {
+            const glm::vec3& minimum = pyramid.NodeMinimum(node);
+            const glm::vec3& maximum = pyramid.NodeMaximum(node);
+            bool visible = true;
+            for (int plane = 0; plane < 6 && visible; ++plane) {
+                const glm::vec4& p = planes[plane];
+                const float x = p.x >= 0.0f ? maximum.x + halfExtent : minimum.x - halfExtent;
+                const float y = p.y >= 0.0f ? maximum.y + halfExtent : minimum.y - halfExtent;
+                const float z = p.z >= 0.0f ? maximum.z + halfExtent : minimum.z - halfExtent;
+                visible = p.x * x + p.y * y + p.z * z + p.w >= 0.0f;
+            }
+            if (!visible) continue;
+
+            const glm::vec3 offset = glm::max(glm::max(minimum - cameraPosition, cameraPosition - maximum), glm::vec3(0.0f));
+            const float distance = glm::length(offset);
+            if (farDistance > 0.0f && distance > farDistance) continue;
+
+            visibleNodes.push_back(static_cast<uint32_t>(node));
+            nodeDistances.push_back(std::max(distance, MinNodeDistance));
+        }
+
+        // PROJECTED VOXEL SIZE IN PIXELS AT THE NEAREST POINT OF THE NODE
+        auto errorOf = [&](size_t visible, uint32_t level) {
+            return pyramid.LevelSize(level) * pixelsPerUnit / nodeDistances[visible];
+        };
+
+        // EVERY VISIBLE NODE STARTS COARSE, THE COARSEST LEVEL IS ALWAYS DRAWN (IT ALONE MAY EXCEED THE BUDGET)
+        nodeLevels.assign(visibleNodes.size(), coarsestLevel);
+        std::priority_queue<std::pair<float, uint32_t>> refinements;
+        for (size_t visible = 0; visible < visibleNodes.size(); ++visible) {
+            selectedCount += pyramid.NodePointCount(visibleNodes[visible], coarsestLevel);
+            if (coarsestLevel > finestLevel) refinements.emplace(errorOf(visible, coarsestLevel), static_cast<uint32_t>(visible));
+        }
+
+        // LARGEST ERROR FIRST, A NODE THAT DOES NOT FIT THE BUDGET STAYS WHERE IT IS
+        while (!refinements.empty()) {
+            const auto [error, visible] = refinements.top();
+            refinements.pop();
+            if (error <= errorThreshold) break;
+
+            const uint32_t node = visibleNodes[visible];
+            const uint32_t level = nodeLevels[visible];
+            const uint64_t cost = pyramid.NodePointCount(node, level - 1) - pyramid.NodePointCount(node, level);
+            if (selectedCount + cost > pointBudget) {
+                budgetLimited = true;
+                continue;
+            }
+            selectedCount += cost;
+            nodeLevels[visible] = level - 1;
+            if (level - 1 > finestLevel) refinements.emplace(errorOf(visible, level - 1), visible);
+        }
+
+        // GROUPED BY LEVEL (ONE SCALE UNIFORM PER DRAW), FINE LEVELS FIRST AND FRONT TO BACK WITHIN EACH
+        drawOrder.resize(visibleNodes.size());
+        for (size_t visible = 0; visible < drawOrder.size(); ++visible) drawOrder[visible] = static_cast<uint32_t>(visible);
+        std::sort(drawOrder.begin(), drawOrder.end(), [&](uint32_t a, uint32_t b) {
+            if (nodeLevels[a] != nodeLevels[b]) return nodeLevels[a] < nodeLevels[b];
+            return nodeDistances[a] < nodeDistances[b];
+        });
+
+        // A NODE AT LEVEL (L) DRAWS ONE RANGE PER RANK >= L
+        for (uint32_t visible : drawOrder) {
+            const uint32_t level = nodeLevels[visible];
+            if (groups.empty() || groups.back().level != level) {
+                LevelGroup group;
+                group.level = level;
+                group.first = commands.size();
+                groups.push_back(group);
+            }
+            for (uint32_t rank = level; rank <= coarsestLevel; ++rank) {
+                const Spatial::VoxelPyramid::NodeRange& range = pyramid.GetNodeRange(visibleNodes[visible], rank);
+                if (range.count == 0) continue;
+                NodeDrawCommand command;
+                command.count = indexCount;
+                command.instanceCount = range.count;
+                command.baseInstance = range.first;
+                commands.push_back(command);
+            }
+            groups.back().count = commands.size() - groups.back().first;
+        }
+
+        // RE-SPECIFY ONLY WHEN THE SELECTION OUTGROWS THE BUFFER
+        if (!commands.empty()) {
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+            if (commands.size() > commandCapacity) {
+                commandCapacity = nodeCount * pyramid.LevelCount();
+                glBufferData(GL_DRAW_INDIRECT_BUFFER, commandCapacity * sizeof(NodeDrawCommand), nullptr, GL_STREAM_DRAW);
+            }
+            glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commands.size() * sizeof(NodeDrawCommand), commands.data());
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        }
+
+        // THE SCALES DEPEND ON THE PYRAMID, KEEP THEM WITH THE GROUPS
+        for (LevelGroup& group : groups) group.scale = std::max(globalScale, pyramid.LevelSize(group.level));
+
+        auto end = std::chrono::steady_clock::now();
+        milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    void LodSelector::Draw(GLenum primitive, GLint scaleLocation) const {
+        if (commands.empty()) return;
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        for (const LevelGroup& group : groups) {
+            if (group.count == 0) continue;
+            glUniform1f(scaleLocation, group.scale);
+            const void* offset = reinterpret_cast<const void*>(group.first * sizeof(NodeDrawCommand));
+            glMultiDrawElementsIndirect(primitive, GL_UNSIGNED_INT, offset, static_cast<GLsizei>(group.count), sizeof(NodeDrawCommand));
+        }
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+}
@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <AttributeMask.hpp>
+#include <InstanceCuller.hpp>
+#include <PointSplatPass.hpp>
+#include <RendererHelper.hpp>
+
+namespace Renderer::Utils {
+
+    bool PointSplatPass::Init(GLuint modelBuffer, GLuint intensityBuffer, GLuint attributeBuffer) {
+        if (splatShader) return true;
+        splatShader = Renderer::CreateShaderProgramFromFiles(
+            "../assets/shaders/splat/splat.vert",
+            "../assets/shaders/splat/splat.frag"
+        );
+        if (!splatShader) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "SPLAT SHADER UNAVAILABLE, POINTS ARE ONLY DRAWN AS CUBES");
+            return false;
+        }
+
+        uViewProjectionLocation = glGetUniformLocation(splatShader, "uViewProjection");
+        uGlobalScaleLocation = glGetUniformLocation(splatShader, "uGlobalScale");
+        uCameraPositionLocation = glGetUniformLocation(splatShader, "uCameraPosition");
+        uFarDistanceLocation = glGetUniformLocation(splatShader, "uFarDistance");
+        uPixelsPerUnitLocation = glGetUniformLocation(splatShader, "uPixelsPerUnit");
+        uMaxPointSizeLocation = glGetUniformLocation(splatShader, "uMaxPointSize");
+        uUseNormalsLocation = glGetUniformLocation(splatShader, "uUseNormals");
+        uShapeLocation = glGetUniformLocation(splatShader, "uShape");
+        uColorLUTLocation = glGetUniformLocation(splatShader, "uColorLUT");
+        uIntensityMapLocation = glGetUniformLocation(splatShader, "uIntensityMap");
+        splatMask.GetLocations(splatShader);
+
+        // LARGEST SIZE THE DRIVER RASTERIZES (LARGER SPLATS ARE CLAMPED)
+        GLfloat sizeRange[2] = { 1.0f, 1.0f };
+        glGetFloatv(GL_POINT_SIZE_RANGE, sizeRange);
+        pointSizeLimit = std::max(sizeRange[1], 1.0f);
+        maxPointSize = std::min(maxPointSize, pointSizeLimit);
+
+        // SAME BUFFERS AS THE CUBE VAO WITHOUT DIVISORS: ONE VERTEX PER INSTANCE, THE TRANSLATION COLUMN IS THE ONLY MATRIX PART READ
+        glGenVertexArrays(1, &vao);
+        glBindVertexArray(vao);
+
+        glBindBuffer(GL_ARRAY_BUFFER, modelBuffer);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(sizeof(glm::vec4) * 3));
+
+        glBindBuffer(GL_ARRAY_BUFFER, intensityBuffer);
+        glEnableVertexAttribArray(1);
+        glVertexAttribIPointer(1, 1, GL_UNSIGNED_SHORT, sizeof(uint16_t), (void*)0);
+
+        glBindBuffer(GL_ARRAY_BUFFER, attributeBuffer);
+        glEnableVertexAttribArray(2);
+        glVertexAttribIPointer(2, 2, GL_UNSIGNED_INT, sizeof(glm::uvec2), (void*)0);
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return true;
+    }
+
+    void PointSplatPass::Shutdown() {
+        if (splatShader) glDeleteProgram(splatShader);
+        if (vao) glDeleteVertexArrays(1, &vao);
+        splatShader = vao = 0;
+    }
+
+    void PointSplatPass::Begin(const glm::mat4& viewProjection, const glm::vec3& cameraPosition, float globalScale, float farDistance,
+        bool useNormals, const AttributeMask& mask, GLuint colorLUTUnit, GLuint intensityMapUnit) {
+        glUseProgram(splatShader);
+        glBindVertexArray(vao);
+
+        glUniformMatrix4fv(uViewProjectionLocation, 1, GL_FALSE, glm::value_ptr(viewProjection));
+        glUniform1f(uGlobalScaleLocation, globalScale);
+        glUniform3fv(uCameraPositionLocation, 1, glm::value_ptr(cameraPosition));
+        glUniform1f(uFarDistanceLocation, farDistance);
+        glUniform1f(uPixelsPerUnitLocation, Renderer::PixelsPerUnit(viewProjection));
+        glUniform1f(uMaxPointSizeLocation, std::clamp(maxPointSize, 1.0f, pointSizeLimit));
+        glUniform1i(uUseNormalsLocation, useNormals ? 1 : 0);
+        glUniform1i(uShapeLocation, shape);
+        glUniform1i(uColorLUTLocation, GLint(colorLUTUnit));
+        glUniform1i(uIntensityMapLocation, GLint(intensityMapUnit));
+
+        splatMask.CopyVisibility(mask);
+        splatMask.Apply();
+
+        // SIZE COMES FROM gl_PointSize (ATTENUATED BY DISTANCE IN THE VERTEX SHADER)
+        glEnable(GL_PROGRAM_POINT_SIZE);
+    }
+
+    void PointSplatPass::End() const {
+        glDisable(GL_PROGRAM_POINT_SIZE);
+        glBindVertexArray(0);
+        glUseProgram(0);
+    }
+
+    void PointSplatPass::Draw(uint64_t first, uint64_t count) const {
+        if (count == 0) return;
+        glDrawArrays(GL_POINTS, static_cast<GLint>(first), static_cast<GLsizei>(count));
+    }
+
+    void PointSplatPass::DrawNodes(const InstanceCuller& culler) {
+        // THE CULLER'S COMMANDS ARE ALREADY FRONT TO BACK, ONLY THE LAYOUT DIFFERS
+        const std::vector<NodeDrawCommand>& commands = culler.GetCommands();
+        if (commands.empty()) return;
+        nodeFirsts.resize(commands.size());
+        nodeCounts.resize(commands.size());
+        for (size_t i = 0; i < commands.size(); ++i) {
+            nodeFirsts[i] = static_cast<GLint>(commands[i].baseInstance);
+            nodeCounts[i] = static_cast<GLsizei>(commands[i].instanceCount);
+        }
+        glMultiDrawArrays(GL_POINTS, nodeFirsts.data(), nodeCounts.data(), static_cast<GLsizei>(commands.size()));
+    }
+
+}
@@ -0,0 +1,92 @@
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glad/glad.h>
+
+#include <MemoryPool.hpp>
+#include <PrefixSum.hpp>
+#include <RendererHelper.hpp>
+
+namespace Renderer::Utils {
+
+    bool PrefixSum::Init() {
+        if (IsAvailable()) return true;
+
+        localProgram = Renderer::CreateComputeShaderProgram("../assets/shaders/compute/prefix_sum_local.comp");
+        addProgram = Renderer::CreateComputeShaderProgram("../assets/shaders/compute/prefix_sum_add.comp");
+        if (!IsAvailable()) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "FAILED TO BUILD THE PREFIX SUM COMPUTE PROGRAMS");
+            return false;
+        }
+
+        uLocalCount = glGetUniformLocation(localProgram, "uCount");
+        uLocalInclusive = glGetUniformLocation(localProgram, "uInclusive");
+        uAddCount = glGetUniformLocation(addProgram, "uCount");
+
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+        if (offsetAlignment <= 0) offsetAlignment = 256;
+
+        glGenBuffers(1, &scratchSSBO);
+        return true;
+    }
+
+    void PrefixSum::Shutdown() {
+        if (localProgram) glDeleteProgram(localProgram);
+        if (addProgram) glDeleteProgram(addProgram);
+        if (scratchSSBO) glDeleteBuffers(1, &scratchSSBO);
+
+        localProgram = addProgram = scratchSSBO = 0;
+        scratchCapacity = 0;
+    }
+
+    void PrefixSum::Scan(GLuint buffer, GLuint count, bool inclusive, Data::AllocationStats& loadStats) {
+        if (!IsAvailable() || count == 0) return;
+
+        // ONE ALIGNED RANGE OF GROUP TOTALS PER LEVEL, UNTIL A SINGLE GROUP COVERS A LEVEL
+        levelOffsets.clear();
+        size_t scratchBytes = 0;
+        GLuint levelCount = count;
+        while (true) {
+            GLuint groupCount = (levelCount + GroupSize - 1) / GroupSize;
+            levelOffsets.push_back(static_cast<GLintptr>(scratchBytes));
+            scratchBytes += (groupCount * sizeof(GLuint) + offsetAlignment - 1) / offsetAlignment * offsetAlignment;
+            if (groupCount == 1) break;
+            levelCount = groupCount;
+        }
+
+        if (scratchBytes > scratchCapacity) {
+            scratchCapacity = scratchBytes;
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, scratchSSBO);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, scratchCapacity, nullptr, GL_DYNAMIC_COPY);
+            loadStats.RecordDeviceAllocation(scratchCapacity);
+        }
+
+        ScanLevel(buffer, 0, count, inclusive, 0);
+    }
+
+    void PrefixSum::ScanLevel(GLuint buffer, GLintptr offset, GLuint count, bool inclusive, size_t level) {
+        const GLuint groupCount = (count + GroupSize - 1) / GroupSize;
+
+        // SCAN WITHIN EACH GROUP, WRITE GROUP TOTALS
+        glUseProgram(localProgram);
+        glUniform1ui(uLocalCount, count);
+        glUniform1ui(uLocalInclusive, inclusive ? 1u : 0u);
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, buffer, offset, count * sizeof(GLuint));
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, scratchSSBO, levelOffsets[level], groupCount * sizeof(GLuint));
+        Renderer::DispatchCompute1D(groupCount);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        if (groupCount == 1) return;
+
+        // EXCLUSIVE SCAN OF THE GROUP TOTALS, THEN ADD EACH GROUP'S BASE BACK
+        ScanLevel(scratchSSBO, levelOffsets[level], groupCount, false, level + 1);
+
+        glUseProgram(addProgram);
+        glUniform1ui(uAddCount, count);
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, buffer, offset, count * sizeof(GLuint));
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, scratchSSBO, levelOffsets[level], groupCount * sizeof(GLuint));
+        Renderer::DispatchCompute1D(groupCount);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+}
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+
+#include <SDL3/SDL.h>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <MemoryPool.hpp>
+#include <Parallel.hpp>
+#include <ProgressiveRefiner.hpp>
+#include <RendererHelper.hpp>
+
+namespace Renderer::Utils {
+
+    namespace {
+
+        // FRACTIONAL PART OF THE GOLDEN RATIO, CONSECUTIVE MULTIPLES MOD ONE STAY AS EVENLY SPREAD AS POSSIBLE
+        constexpr double GoldenFraction = 0.6180339887498949;
+
+        // TEXTURE UNITS OF THE COMPOSITE PASS
+        constexpr GLint CompositeColorUnit = 2;
+        constexpr GLint CompositeDepthUnit = 3;
+
+    }
+
+    bool ProgressiveRefiner::Init() {
+        if (compositeShader) return true;
+
+        // cube.vert FETCHES THE ORDER AND THE INSTANCE DATA AS STORAGE BLOCKS
+        GLint vertexStorageBlocks = 0;
+        glGetIntegerv(GL_MAX_VERTEX_SHADER_STORAGE_BLOCKS, &vertexStorageBlocks);
+        if (vertexStorageBlocks < 4) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "PROGRESSIVE REFINEMENT UNAVAILABLE (%d VERTEX SHADER STORAGE BLOCKS)", vertexStorageBlocks);
+            return false;
+        }
+
+        compositeShader = Renderer::CreateShaderProgramFromFiles(
+            "../assets/shaders/composite/composite.vert",
+            "../assets/shaders/composite/composite.frag"
+        );
+        if (!compositeShader) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "COMPOSITE SHADER UNAVAILABLE, PROGRESSIVE REFINEMENT DISABLED");
+            return false;
+        }
+        uColorLocation = glGetUniformLocation(compositeShader, "uColor");
+        uDepthLocation = glGetUniformLocation(compositeShader, "uDepth");
+        uViewportOriginLocation = glGetUniformLocation(compositeShader, "uViewportOrigin");
+
+        // THE FULL-SCREEN TRIANGLE IS GENERATED FROM gl_VertexID (EMPTY VAO)
+        glGenVertexArrays(1, &vao);
+        glGenFramebuffers(1, &framebuffer);
+        glGenTextures(1, &colorTexture);
+        glGenTextures(1, &depthTexture);
+        glGenBuffers(1, &orderSSBO);
+        return true;
+    }
+
+    void ProgressiveRefiner::Shutdown() {
+        if (compositeShader) glDeleteProgram(compositeShader);
+        if (vao) glDeleteVertexArrays(1, &vao);
+        if (framebuffer) glDeleteFramebuffers(1, &framebuffer);
+        if (colorTexture) glDeleteTextures(1, &colorTexture);
+        if (depthTexture) glDeleteTextures(1, &depthTexture);
+        if (orderSSBO) glDeleteBuffers(1, &orderSSBO);
+        compositeShader = vao = framebuffer = colorTexture = depthTexture = orderSSBO = 0;
+        targetWidth = targetHeight = 0;
+        orderCount = 0;
+        orderCapacity = 0;
+        restart = true;
+    }
+
+    void ProgressiveRefiner::UpdateOrder(uint64_t instanceCount, Data::AllocationStats& loadStats) {
+        if (!IsAvailable() || instanceCount == orderCount) return;
+        orderCount = std::min<uint64_t>(instanceCount, UINT32_MAX);
+        restart = true;
+        if (orderCount == 0) return;
+
+        // STRIDE NEAR (n / PHI) AND COPRIME WITH (n), SO i -> (i * stride) MOD n VISITS EVERY INSTANCE ONCE
+        uint64_t stride = std::max<uint64_t>(1, static_cast<uint64_t>(std::llround(double(orderCount) * GoldenFraction)));
+        while (std::gcd(stride, orderCount) != 1) ++stride;
+
+        // RE-SPECIFY ONLY WHEN THE ORDER GROWS, THEN WRITE IT STRAIGHT INTO THE MAPPED BUFFER (NO HOST COPY)
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, orderSSBO);
+        if (orderCount > orderCapacity) {
+            orderCapacity = size_t(orderCount);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, orderCapacity * sizeof(GLuint), nullptr, GL_STATIC_DRAW);
+            loadStats.RecordDeviceAllocation(orderCapacity * sizeof(GLuint));
+        }
+        GLuint* order = static_cast<GLuint*>(glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, orderCount * sizeof(GLuint),
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT));
+        if (!order) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "PROGRESSIVE REFINEMENT: FAILED TO MAP THE DRAW ORDER");
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+            orderCount = 0;
+            return;
+        }
+        const uint64_t count = orderCount;
+        Parallel::For(size_t(count), [&](size_t begin, size_t end, unsigned) {
+            uint64_t value = (uint64_t(begin) * stride) % count;
+            for (size_t i = begin; i < end; ++i) {
+                order[i] = static_cast<GLuint>(value);
+                value += stride;
+                if (value >= count) value -= count;
+            }
+        });
+        glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    void ProgressiveRefiner::ResizeTarget(GLsizei width, GLsizei height) {
+        targetWidth = width;
+        targetHeight = height;
+
+        glBindTexture(GL_TEXTURE_2D, colorTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        glBindTexture(GL_TEXTURE_2D, depthTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "PROGRESSIVE REFINEMENT: INCOMPLETE TARGET (%d x %d)", width, height);
+        }
+    }
+
+    void ProgressiveRefiner::Begin(const glm::mat4& viewProjection, uint64_t& first, uint64_t& count) {
+        first = 0;
+        count = 0;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+        glGetIntegerv(GL_VIEWPORT, previousViewport);
+        const GLsizei width = std::max(previousViewport[2], 1);
+        const GLsizei height = std::max(previousViewport[3], 1);
+
+        // ANY CHANGE OF THE VIEW (EITHER CAMERA, INCLUDING ITS INERTIA) COUNTS AS MOTION
+        moving = std::memcmp(&viewProjection, &lastViewProjection, sizeof(glm::mat4)) != 0;
+        lastViewProjection = viewProjection;
+        if (moving) restart = true;
+
+        if (width != targetWidth || height != targetHeight) {
+            ResizeTarget(width, height);
+            restart = true;
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glViewport(0, 0, width, height);
+        if (restart) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            accumulatedCount = 0;
+            restart = false;
+        }
+
+        // NEXT BATCH OF THE ORDER (ALWAYS THE FIRST ONE WHILE MOVING)
+        first = accumulatedCount;
+        count = std::min<uint64_t>(uint64_t(std::max(batchSize, 1)), orderCount - accumulatedCount);
+        accumulatedCount += count;
+    }
+
+    void ProgressiveRefiner::End() {
+        glBindFramebuffer(GL_FRAMEBUFFER, GLuint(previousFramebuffer));
+        glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+
+        // EMPTY TEXELS (DEPTH STILL CLEARED) ARE DISCARDED, THE REST DEPTH-TESTS WITH ITS ACCUMULATED DEPTH (gl_FragDepth),
+        // SO ANYTHING ALREADY DRAWN IN FRONT OF THE CUBES STAYS
+        // UNITS 0 AND 1 STAY WITH THE CUBE RENDERER'S TABLES (THE FAR FIELD DRAWS WITH THEM AFTERWARDS)
+        glUseProgram(compositeShader);
+        glActiveTexture(GL_TEXTURE0 + CompositeColorUnit);
+        glBindTexture(GL_TEXTURE_2D, colorTexture);
+        glUniform1i(uColorLocation, CompositeColorUnit);
+        glActiveTexture(GL_TEXTURE0 + CompositeDepthUnit);
+        glBindTexture(GL_TEXTURE_2D, depthTexture);
+        glUniform1i(uDepthLocation, CompositeDepthUnit);
+        glActiveTexture(GL_TEXTURE0);
+        glUniform2i(uViewportOriginLocation, previousViewport[0], previousViewport[1]);
+
+        glBindVertexArray(vao);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glBindVertexArray(0);
+        glUseProgram(0);
+    }
+
+    void ProgressiveRefiner::BindOrder(GLuint binding) const {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, orderSSBO);
+    }
+
+}
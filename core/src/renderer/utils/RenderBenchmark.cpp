@@ -0,0 +1,123 @@
+#include <cstdint>
+
+#include <SDL3/SDL.h>
+#include <glad/glad.h>
+
+#include <PointSplatPass.hpp>
+#include <RenderBenchmark.hpp>
+
+namespace Renderer::Utils {
+
+    void RenderBenchmark::Init() {
+        for (Query& query : queries) glGenQueries(1, &query.id);
+    }
+
+    void RenderBenchmark::Shutdown() {
+        for (Query& query : queries) {
+            if (query.id) glDeleteQueries(1, &query.id);
+            query = Query();
+        }
+        running = issuing = false;
+        activeQuery = -1;
+    }
+
+    void RenderBenchmark::Start() {
+        if (!queries[0].id) return;
+
+        // RESULTS OF AN EARLIER RUN STILL IN FLIGHT ARE NEVER READ
+        for (Query& query : queries) query.pending = false;
+        for (uint32_t mode = 0; mode < ModeCount; ++mode) {
+            totals[mode] = Totals();
+            results[mode] = Result();
+        }
+        running = true;
+        issuing = true;
+        finished = false;
+        modeIndex = 0;
+        modeFrames = 0;
+        activeQuery = -1;
+    }
+
+    void RenderBenchmark::Cancel() {
+        for (Query& query : queries) query.pending = false;
+        running = issuing = finished = false;
+        activeQuery = -1;
+    }
+
+    void RenderBenchmark::BeginFrame() {
+        Collect();
+        activeQuery = -1;
+        if (!issuing || modeFrames < WarmupFrames) return;
+
+        // A FRAME WITHOUT A FREE QUERY IS SIMPLY NOT MEASURED
+        for (uint32_t slot = 0; slot < QueryCount; ++slot) {
+            if (queries[slot].pending) continue;
+            glBeginQuery(GL_TIME_ELAPSED, queries[slot].id);
+            activeQuery = int(slot);
+            return;
+        }
+    }
+
+    void RenderBenchmark::EndFrame(uint64_t pointCount, uint32_t verticesPerPoint) {
+        if (!issuing) return;
+        if (activeQuery >= 0) {
+            glEndQuery(GL_TIME_ELAPSED);
+            Query& query = queries[activeQuery];
+            query.pending = true;
+            query.mode = modeIndex;
+            query.pointCount = pointCount;
+            query.vertexCount = pointCount * verticesPerPoint;
+            activeQuery = -1;
+        }
+
+        // NEXT MODE AFTER ITS WARM-UP AND MEASURED FRAMES, THE LAST MODE STAYS SELECTED UNTIL EVERY QUERY IS READ
+        if (++modeFrames < WarmupFrames + MeasuredFrames) return;
+        modeFrames = 0;
+        if (++modeIndex == ModeCount) {
+            modeIndex = ModeCount - 1;
+            issuing = false;
+        }
+    }
+
+    void RenderBenchmark::Collect() {
+        bool pending = false;
+        for (Query& query : queries) {
+            if (!query.pending) continue;
+            GLint available = 0;
+            glGetQueryObjectiv(query.id, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) {
+                pending = true;
+                continue;
+            }
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(query.id, GL_QUERY_RESULT, &nanoseconds);
+            Totals& total = totals[query.mode];
+            total.frameCount++;
+            total.nanoseconds += nanoseconds;
+            total.pointCount += query.pointCount;
+            total.vertexCount += query.vertexCount;
+            query.pending = false;
+        }
+        if (running && !issuing && !pending) Finish();
+    }
+
+    void RenderBenchmark::Finish() {
+        running = false;
+        finished = true;
+        for (uint32_t mode = 0; mode < ModeCount; ++mode) {
+            const Totals& total = totals[mode];
+            Result& result = results[mode];
+            result.frameCount = total.frameCount;
+            if (total.frameCount == 0 || total.nanoseconds == 0) continue;
+
+            const double seconds = double(total.nanoseconds) * 1e-9;
+            result.milliseconds = seconds * 1000.0 / double(total.frameCount);
+            result.pointsPerSecond = double(total.pointCount) / seconds;
+            result.verticesPerSecond = double(total.vertexCount) / seconds;
+            SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+                "RENDER BENCHMARK (%s): %.3f MS PER FRAME, %.1f M POINTS/S, %.1f M VERTICES/S OVER %u FRAMES",
+                RenderModeNames[mode], result.milliseconds, result.pointsPerSecond * 1e-6, result.verticesPerSecond * 1e-6, result.frameCount);
+        }
+    }
+
+}
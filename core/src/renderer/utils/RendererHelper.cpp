@@ -1,9 +1,12 @@
+#include <cmath>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <string>
 
 #include <glad/glad.h>
 #include <SDL3/SDL.h>
+#include <glm/glm.hpp>
 
 #include <RendererHelper.hpp>
 
@@ -20,6 +23,43 @@ namespace Renderer {
         return stream.str();
     }
 
+    namespace {
+
+        // NESTED INCLUDES ARE EXPANDED TOO, THE LIMIT ONLY STOPS A FILE FROM INCLUDING ITSELF FOREVER
+        constexpr int MaxIncludeDepth = 8;
+
+        std::string ExpandIncludes(const std::string& source, const std::string& filepath, int depth) {
+            const std::string directive = "#include";
+            size_t slash = filepath.find_last_of("/\\");
+            std::string directory = slash == std::string::npos ? "" : filepath.substr(0, slash + 1);
+
+            std::istringstream lines(source);
+            std::string line;
+            std::string expanded;
+            while (std::getline(lines, line)) {
+                size_t start = line.find_first_not_of(" \t");
+                size_t open = line.find('"');
+                size_t close = open == std::string::npos ? std::string::npos : line.find('"', open + 1);
+                bool isInclude = start != std::string::npos && line.compare(start, directive.size(), directive) == 0 && close != std::string::npos;
+
+                if (isInclude && depth < MaxIncludeDepth) {
+                    std::string includePath = directory + line.substr(open + 1, close - open - 1);
+                    expanded += ExpandIncludes(LoadTextFile(includePath), includePath, depth + 1);
+                } else {
+                    if (isInclude) SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SHADER INCLUDES NESTED TOO DEEP: %s", filepath.c_str());
+                    expanded += line;
+                }
+                expanded += '\n';
+            }
+            return expanded;
+        }
+
+    }
+
+    std::string LoadShaderSource(const std::string& filepath) {
+        return ExpandIncludes(LoadTextFile(filepath), filepath, 0);
+    }
+
     GLuint CreateShader(const std::string& source, GLenum type) {
         GLuint shader = glCreateShader(type);
         const char* src = source.c_str();
@@ -50,8 +90,8 @@ namespace Renderer {
     }
 
     GLuint CreateShaderProgramFromFiles(const std::string& vertexPath, const std::string& fragmentPath) {
-        std::string vertexSource   = Renderer::LoadTextFile(vertexPath);
-        std::string fragmentSource = Renderer::LoadTextFile(fragmentPath);
+        std::string vertexSource   = Renderer::LoadShaderSource(vertexPath);
+        std::string fragmentSource = Renderer::LoadShaderSource(fragmentPath);
 
         GLuint vertexShader   = Renderer::CreateShader(vertexSource, GL_VERTEX_SHADER);
         GLuint fragmentShader = Renderer::CreateShader(fragmentSource, GL_FRAGMENT_SHADER);
@@ -71,7 +111,7 @@ namespace Renderer {
     }
     
     GLuint CreateComputeShaderProgram(const std::string& computeShaderPath) {
-        std::string computeShaderSource = Renderer::LoadTextFile(computeShaderPath);
+        std::string computeShaderSource = Renderer::LoadShaderSource(computeShaderPath);
 
         GLuint computeShader = Renderer::CreateShader(computeShaderSource, GL_COMPUTE_SHADER);
 
@@ -86,4 +126,51 @@ namespace Renderer {
         return shaderProgram;
     }
 
+    void DispatchCompute1D(GLuint groupCount) {
+        if (groupCount == 0) return;
+        const GLuint maxGroupsX = 65535;
+        GLuint groupsX = groupCount < maxGroupsX ? groupCount : maxGroupsX;
+        GLuint groupsY = (groupCount + groupsX - 1) / groupsX;
+        glDispatchCompute(groupsX, groupsY, 1);
+    }
+
+
+    bool HasExtension(const char* name) {
+        GLint extensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+        for (GLint i = 0; i < extensionCount; ++i) {
+            const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            if (extension && std::strcmp(extension, name) == 0) return true;
+        }
+        return false;
+    }
+
+    void ExtractFrustumPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6]) {
+        // ROWS OF THE COLUMN-MAJOR MATRIX
+        glm::vec4 rows[4];
+        for (int row = 0; row < 4; ++row) {
+            rows[row] = glm::vec4(viewProjection[0][row], viewProjection[1][row], viewProjection[2][row], viewProjection[3][row]);
+        }
+        planes[0] = rows[3] + rows[0];
+        planes[1] = rows[3] - rows[0];
+        planes[2] = rows[3] + rows[1];
+        planes[3] = rows[3] - rows[1];
+        planes[4] = rows[3] + rows[2];
+        planes[5] = rows[3] - rows[2];
+        for (int plane = 0; plane < 6; ++plane) {
+            const glm::vec4& p = planes[plane];
+            const float length = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+            if (length > 0.0f) planes[plane] = p * (1.0f / length);
+        }
+    }
+
+    float PixelsPerUnit(const glm::mat4& viewProjection) {
+        // THE SECOND ROW IS THE VERTICAL PROJECTION SCALE TIMES A UNIT VIEW AXIS
+        const float scale = std::sqrt(viewProjection[0][1] * viewProjection[0][1]
+            + viewProjection[1][1] * viewProjection[1][1] + viewProjection[2][1] * viewProjection[2][1]);
+        GLint viewport[4] = { 0, 0, 0, 0 };
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        return scale * 0.5f * float(viewport[3]);
+    }
+
 }
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+
+#include <CubeInstance.hpp>
+#include <ElevationGrid.hpp>
+#include <MemoryPool.hpp>
+#include <Parallel.hpp>
+#include <PointStore.hpp>
+
+namespace Spatial {
+
+    void ElevationGrid::Clear() {
+        columns = 0;
+        rows = 0;
+        cellSize = 0.0f;
+        origin = glm::vec2(0.0f);
+        filledCount = 0;
+        counts.clear();
+        minimums.clear();
+        maximums.clear();
+        means.clear();
+        intensities.clear();
+    }
+
+    bool ElevationGrid::Build(const Data::PointStore& pointStore, uint32_t resolution, Data::AllocationStats& loadStats) {
+        Clear();
+        if (pointStore.Empty() || resolution == 0) return false;
+        uint64_t start = SDL_GetTicksNS();
+
+        resolution = std::min(resolution, MaxResolution);
+        const unsigned threads = Parallel::ThreadCount();
+        const size_t blockCount = pointStore.BlockCount();
+
+        // HORIZONTAL BOUNDS (PER-THREAD REDUCTION OVER WHOLE BLOCKS)
+        std::vector<glm::vec2> boundMinimums(threads, glm::vec2(FLT_MAX));
+        std::vector<glm::vec2> boundMaximums(threads, glm::vec2(-FLT_MAX));
+        Parallel::For(blockCount, [&](size_t begin, size_t end, unsigned thread) {
+            for (size_t blockIndex = begin; blockIndex < end; ++blockIndex) {
+                uint32_t count = 0;
+                const CubeInstance* points = pointStore.GetBlock(blockIndex, count);
+                for (uint32_t i = 0; i < count; ++i) {
+                    boundMinimums[thread].x = std::min(boundMinimums[thread].x, points[i].position.x);
+                    boundMinimums[thread].y = std::min(boundMinimums[thread].y, points[i].position.y);
+                    boundMaximums[thread].x = std::max(boundMaximums[thread].x, points[i].position.x);
+                    boundMaximums[thread].y = std::max(boundMaximums[thread].y, points[i].position.y);
+                }
+            }
+        }, threads);
+        glm::vec2 minimum = boundMinimums[0];
+        glm::vec2 maximum = boundMaximums[0];
+        for (unsigned thread = 1; thread < threads; ++thread) {
+            minimum.x = std::min(minimum.x, boundMinimums[thread].x);
+            minimum.y = std::min(minimum.y, boundMinimums[thread].y);
+            maximum.x = std::max(maximum.x, boundMaximums[thread].x);
+            maximum.y = std::max(maximum.y, boundMaximums[thread].y);
+        }
+
+        // SQUARE CELLS, THE LONGER AXIS GETS (resolution) OF THEM
+        const float extent = std::max(maximum.x - minimum.x, maximum.y - minimum.y);
+        cellSize = extent > 0.0f ? extent / float(resolution) : 1.0f;
+        origin = minimum;
+        columns = std::clamp(uint32_t(std::ceil((maximum.x - minimum.x) / cellSize)), 1u, resolution);
+        rows = std::clamp(uint32_t(std::ceil((maximum.y - minimum.y) / cellSize)), 1u, resolution);
+
+        const uint32_t tileColumns = (columns + TileSize - 1) / TileSize;
+        const uint32_t tileRows = (rows + TileSize - 1) / TileSize;
+        const size_t tileCount = size_t(tileColumns) * tileRows;
+        const size_t tileCells = size_t(TileSize) * TileSize;
+        const float inverseCellSize = 1.0f / cellSize;
+
+        // EVERY ENTRY IS RESET, NOT ONLY THOSE OF THE WORKERS THAT RUN (FEWER BLOCKS THAN THREADS LEAVES SOME IDLE)
+        threadTiles.resize(threads);
+        for (ThreadTiles& tiles : threadTiles) {
+            tiles.slots.assign(tileCount, -1);
+            tiles.cells.clear();
+        }
+
+        // ACCUMULATE (THE POINT'S TILE IS OPENED IN THIS THREAD'S STORAGE THE FIRST TIME IT IS HIT)
+        Parallel::For(blockCount, [&](size_t begin, size_t end, unsigned thread) {
+            ThreadTiles& tiles = threadTiles[thread];
+            for (size_t blockIndex = begin; blockIndex < end; ++blockIndex) {
+                uint32_t count = 0;
+                const CubeInstance* points = pointStore.GetBlock(blockIndex, count);
+                for (uint32_t i = 0; i < count; ++i) {
+                    const glm::vec3& position = points[i].position;
+                    const uint32_t column = std::min(uint32_t(std::max(0.0f, (position.x - origin.x) * inverseCellSize)), columns - 1);
+                    const uint32_t row = std::min(uint32_t(std::max(0.0f, (position.y - origin.y) * inverseCellSize)), rows - 1);
+                    const size_t tile = size_t(row / TileSize) * tileColumns + column / TileSize;
+
+                    int32_t& slot = tiles.slots[tile];
+                    if (slot < 0) {
+                        slot = int32_t(tiles.cells.size() / tileCells);
+                        tiles.cells.resize(tiles.cells.size() + tileCells, CellAccumulator{ FLT_MAX, -FLT_MAX, 0.0, 0, 0 });
+                    }
+
+                    CellAccumulator& cell = tiles.cells[size_t(slot) * tileCells + (row % TileSize) * TileSize + column % TileSize];
+                    cell.minimum = std::min(cell.minimum, position.z);
+                    cell.maximum = std::max(cell.maximum, position.z);
+                    cell.heightSum += position.z;
+                    cell.intensitySum += points[i].intensity;
+                    cell.count++;
+                }
+            }
+        }, threads);
+
+        // MERGE EVERY TILE ACROSS THREADS (TILES ARE DISJOINT, NO SYNCHRONIZATION)
+        const size_t cellCount = size_t(columns) * rows;
+        Data::AcquireBuffer(counts, cellCount, loadStats);
+        Data::AcquireBuffer(minimums, cellCount, loadStats);
+        Data::AcquireBuffer(maximums, cellCount, loadStats);
+        Data::AcquireBuffer(means, cellCount, loadStats);
+        Data::AcquireBuffer(intensities, cellCount, loadStats);
+        std::vector<uint64_t> filled(threads, 0);
+        Parallel::For(tileCount, [&](size_t begin, size_t end, unsigned worker) {
+            for (size_t tile = begin; tile < end; ++tile) {
+                const uint32_t firstColumn = uint32_t(tile % tileColumns) * TileSize;
+                const uint32_t firstRow = uint32_t(tile / tileColumns) * TileSize;
+                const uint32_t tileWidth = std::min(TileSize, columns - firstColumn);
+                const uint32_t tileHeight = std::min(TileSize, rows - firstRow);
+                for (uint32_t localRow = 0; localRow < tileHeight; ++localRow) {
+                    for (uint32_t localColumn = 0; localColumn < tileWidth; ++localColumn) {
+                        CellAccumulator merged{ FLT_MAX, -FLT_MAX, 0.0, 0, 0 };
+                        for (const ThreadTiles& tiles : threadTiles) {
+                            if (tiles.slots.empty() || tiles.slots[tile] < 0) continue;
+                            const CellAccumulator& cell = tiles.cells[size_t(tiles.slots[tile]) * tileCells + localRow * TileSize + localColumn];
+                            merged.minimum = std::min(merged.minimum, cell.minimum);
+                            merged.maximum = std::max(merged.maximum, cell.maximum);
+                            merged.heightSum += cell.heightSum;
+                            merged.intensitySum += cell.intensitySum;
+                            merged.count += cell.count;
+                        }
+
+                        const size_t index = CellIndex(firstColumn + localColumn, firstRow + localRow);
+                        counts[index] = merged.count;
+                        if (merged.count == 0) {
+                            minimums[index] = maximums[index] = means[index] = intensities[index] = 0.0f;
+                            continue;
+                        }
+                        minimums[index] = merged.minimum;
+                        maximums[index] = merged.maximum;
+                        means[index] = static_cast<float>(merged.heightSum / merged.count);
+                        intensities[index] = static_cast<float>(double(merged.intensitySum) / merged.count);
+                        filled[worker]++;
+                    }
+                }
+            }
+        }, threads);
+        for (unsigned thread = 0; thread < threads; ++thread) filledCount += filled[thread];
+
+        // OPENED TILE MEMORY (THE POOLED TILES KEEP THEIR CAPACITY FOR THE NEXT BUILD)
+        size_t tileBytes = 0;
+        for (const ThreadTiles& tiles : threadTiles) tileBytes += tiles.cells.size() * sizeof(CellAccumulator);
+
+        uint64_t end = SDL_GetTicksNS();
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+            "ELEVATION GRID: %u x %u CELLS (%.3f), %llu FILLED FROM %llu POINTS, %.1f MB OF THREAD TILES IN %.1f MS, %u THREADS",
+            columns, rows, cellSize, static_cast<unsigned long long>(filledCount), static_cast<unsigned long long>(pointStore.Size()),
+            double(tileBytes) / (1024.0 * 1024.0), (end - start) / 1.0e6, threads);
+        return true;
+    }
+
+}
@@ -0,0 +1,447 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#define KD_TREE_SSE2 1
+#endif
+
+#include <glm/glm.hpp>
+
+#include <CubeInstance.hpp>
+#include <KdTree.hpp>
+#include <MemoryPool.hpp>
+#include <Parallel.hpp>
+#include <PointStore.hpp>
+
+namespace Spatial {
+
+    void KdTree::Clear() {
+        depth = 0;
+        std::vector<Entry>().swap(entries);
+        std::vector<size_t>().swap(leafOffsets);
+        std::vector<uint8_t>().swap(splitAxes);
+        std::vector<glm::vec3>().swap(nodeMinimums);
+        std::vector<glm::vec3>().swap(nodeMaximums);
+        std::vector<uint32_t>().swap(indexRemap);
+    }
+
+    size_t KdTree::ResidentBytes() const {
+        return entries.capacity() * sizeof(Entry)
+            + leafOffsets.capacity() * sizeof(size_t)
+            + splitAxes.capacity()
+            + (nodeMinimums.capacity() + nodeMaximums.capacity()) * sizeof(glm::vec3)
+            + indexRemap.capacity() * sizeof(uint32_t);
+    }
+
+    void KdTree::Build(const Data::PointStore& pointStore, Data::AllocationStats& loadStats) {
+        Data::AcquireBuffer(entries, pointStore.Size(), loadStats);
+
+        // GATHER WHOLE BLOCKS IN PARALLEL (BLOCK i STARTS AT i * BlockSize)
+        Parallel::For(pointStore.BlockCount(), [&](size_t begin, size_t end, unsigned) {
+            for (size_t blockIndex = begin; blockIndex < end; ++blockIndex) {
+                uint32_t count = 0;
+                const CubeInstance* points = pointStore.GetBlock(blockIndex, count);
+                const uint64_t firstIndex = uint64_t(blockIndex) * Data::PointStore::BlockSize;
+                for (uint32_t i = 0; i < count; ++i) {
+                    entries[firstIndex + i] = { points[i].position, static_cast<uint32_t>(firstIndex + i) };
+                }
+            }
+        }, Parallel::ThreadCount());
+        BuildNodes(loadStats);
+    }
+
+    void KdTree::Build(const std::vector<CubeInstance>& points, Data::AllocationStats& loadStats) {
+        Data::AcquireBuffer(entries, points.size(), loadStats);
+        Parallel::For(points.size(), [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) entries[i] = { points[i].position, static_cast<uint32_t>(i) };
+        }, Parallel::ThreadCount());
+        BuildNodes(loadStats);
+    }
+
+    void KdTree::BuildNodes(Data::AllocationStats& loadStats) {
+        const unsigned threads = Parallel::ThreadCount();
+        const size_t count = entries.size();
+
+        // EVERY LEAF SITS AT THE SAME DEPTH AND HOLDS AT MOST ABOUT (LeafSize) POINTS
+        depth = 0;
+        while ((count >> depth) > LeafSize) ++depth;
+        const size_t leafCount = size_t(1) << depth;
+        const size_t nodeCount = 2 * leafCount - 1;
+        Data::AcquireBuffer(splitAxes, leafCount - 1, loadStats);
+        Data::AcquireBuffer(nodeMinimums, nodeCount, loadStats);
+        Data::AcquireBuffer(nodeMaximums, nodeCount, loadStats);
+
+        // BALANCED RANGES: EVERY NODE SPLITS ITS RANGE IN HALF
+        Data::AcquireBuffer(leafOffsets, leafCount + 1, loadStats);
+        leafOffsets[0] = 0;
+        leafOffsets[leafCount] = count;
+        for (uint32_t level = 0; level < depth; ++level) {
+            const size_t span = leafCount >> level;
+            for (size_t levelIndex = 0; levelIndex < (size_t(1) << level); ++levelIndex) {
+                const size_t begin = leafOffsets[levelIndex * span];
+                const size_t end = leafOffsets[(levelIndex + 1) * span];
+                leafOffsets[levelIndex * span + span / 2] = begin + (end - begin) / 2;
+            }
+        }
+
+        // ONE LEVEL AT A TIME, NODES OF A LEVEL OWN DISJOINT RANGES
+        for (uint32_t level = 0; level < depth; ++level) {
+            const size_t firstNode = (size_t(1) << level) - 1;
+            const size_t levelNodes = size_t(1) << level;
+            Parallel::For(levelNodes, [&](size_t begin, size_t end, unsigned) {
+                for (size_t node = firstNode + begin; node < firstNode + end; ++node) {
+                    size_t rangeBegin = 0;
+                    size_t rangeEnd = 0;
+                    NodeRange(node, level, rangeBegin, rangeEnd);
+
+                    // SPLIT ALONG THE WIDEST SPREAD OF THE NODE'S OWN POINTS (A CELL BOX STRETCHED BY A FEW
+                    // OUTLIERS WOULD PICK A USELESS AXIS AND LEAVE LONG, THIN CELLS)
+                    glm::vec3 spreadMinimum(FLT_MAX);
+                    glm::vec3 spreadMaximum(-FLT_MAX);
+                    for (size_t i = rangeBegin; i < rangeEnd; ++i) {
+                        spreadMinimum = glm::min(spreadMinimum, entries[i].position);
+                        spreadMaximum = glm::max(spreadMaximum, entries[i].position);
+                    }
+                    const glm::vec3 extent = spreadMaximum - spreadMinimum;
+                    const uint8_t axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+                    splitAxes[node] = axis;
+                    if (rangeEnd - rangeBegin < 2) continue;
+
+                    const size_t middle = rangeBegin + (rangeEnd - rangeBegin) / 2;
+                    std::nth_element(entries.begin() + rangeBegin, entries.begin() + middle, entries.begin() + rangeEnd,
+                        [axis](const Entry& a, const Entry& b) { return a.position[axis] < b.position[axis]; });
+                }
+            }, std::min<unsigned>(threads, static_cast<unsigned>(std::min<size_t>(levelNodes, UINT32_MAX))));
+        }
+        RefitBoxes();
+    }
+
+    void KdTree::RefitBoxes() {
+        if (entries.empty()) return;
+        const unsigned threads = Parallel::ThreadCount();
+        const size_t leafCount = size_t(1) << depth;
+        const size_t firstLeaf = leafCount - 1;
+
+        // EMPTY LEAVES GET AN INVERTED BOX THAT NO QUERY ENTERS AND THAT NEVER WIDENS ITS PARENT
+        Parallel::For(leafCount, [&](size_t begin, size_t end, unsigned) {
+            for (size_t leaf = begin; leaf < end; ++leaf) {
+                glm::vec3 minimum(FLT_MAX);
+                glm::vec3 maximum(-FLT_MAX);
+                for (size_t slot = leafOffsets[leaf]; slot < leafOffsets[leaf + 1]; ++slot) {
+                    minimum = glm::min(minimum, entries[slot].position);
+                    maximum = glm::max(maximum, entries[slot].position);
+                }
+                nodeMinimums[firstLeaf + leaf] = minimum;
+                nodeMaximums[firstLeaf + leaf] = maximum;
+            }
+        }, threads);
+
+        for (int level = int(depth) - 1; level >= 0; --level) {
+            const size_t firstNode = (size_t(1) << level) - 1;
+            Parallel::For(size_t(1) << level, [&](size_t begin, size_t end, unsigned) {
+                for (size_t node = firstNode + begin; node < firstNode + end; ++node) {
+                    nodeMinimums[node] = glm::min(nodeMinimums[2 * node + 1], nodeMinimums[2 * node + 2]);
+                    nodeMaximums[node] = glm::max(nodeMaximums[2 * node + 1], nodeMaximums[2 * node + 2]);
+                }
+            }, threads);
+        }
+    }
+
+    void KdTree::RemovePoints(const std::vector<uint8_t>& keepFlags) {
+        if (entries.empty()) return;
+
+        // NEW SOURCE INDEX OF EVERY KEPT POINT (EXCLUSIVE PREFIX COUNT OF THE FLAGS)
+        indexRemap.resize(keepFlags.size());
+        uint32_t kept = 0;
+        for (size_t i = 0; i < keepFlags.size(); ++i) {
+            indexRemap[i] = kept;
+            kept += keepFlags[i] ? 1 : 0;
+        }
+
+        // STABLE COMPACTION, LEAVES SHRINK IN PLACE AND KEEP THEIR ORDER
+        const size_t leafCount = size_t(1) << depth;
+        size_t write = 0;
+        for (size_t leaf = 0; leaf < leafCount; ++leaf) {
+            const size_t begin = leafOffsets[leaf];
+            const size_t end = leafOffsets[leaf + 1];
+            leafOffsets[leaf] = write;
+            for (size_t slot = begin; slot < end; ++slot) {
+                const Entry entry = entries[slot];
+                if (!keepFlags[entry.index]) continue;
+                entries[write++] = { entry.position, indexRemap[entry.index] };
+            }
+        }
+        leafOffsets[leafCount] = write;
+        entries.resize(write);
+        std::vector<uint32_t>().swap(indexRemap);
+
+        // SPLITS STILL SEPARATE THE SURVIVORS, ONLY THE BOXES SHRINK
+        RefitBoxes();
+    }
+
+    uint32_t KdTree::FindNearest(const glm::vec3& position, uint32_t k, KdNeighbor* neighbors, glm::vec3* positions) const {
+        if (entries.empty() || k == 0) return 0;
+        uint32_t found = 0;
+        SearchNearest(0, 0, position, k, neighbors, positions, found);
+        return found;
+    }
+
+    void KdTree::SearchNearest(size_t node, uint32_t level, const glm::vec3& position, uint32_t k, KdNeighbor* neighbors, glm::vec3* positions,
+        uint32_t& found) const {
+        // LEAF: INSERTION INTO THE SORTED NEIGHBOR LIST
+        if (level == depth) {
+            size_t begin = 0;
+            size_t end = 0;
+            NodeRange(node, level, begin, end);
+            for (size_t slot = begin; slot < end; ++slot) {
+                const glm::vec3 delta = entries[slot].position - position;
+                const float distanceSquared = delta.x * delta.x + delta.y * delta.y + delta.z * delta.z;
+                if (found == k && distanceSquared >= neighbors[k - 1].distanceSquared) continue;
+
+                uint32_t insert = found < k ? found++ : k - 1;
+                while (insert > 0 && neighbors[insert - 1].distanceSquared > distanceSquared) {
+                    neighbors[insert] = neighbors[insert - 1];
+                    if (positions) positions[insert] = positions[insert - 1];
+                    --insert;
+                }
+                neighbors[insert] = { distanceSquared, entries[slot].index };
+                if (positions) positions[insert] = entries[slot].position;
+            }
+            return;
+        }
+
+        // NEARER CHILD FIRST, A CHILD IS SKIPPED ONCE ITS BOX IS FARTHER THAN THE CURRENT K-TH NEIGHBOR
+        size_t first = 2 * node + 1;
+        size_t second = 2 * node + 2;
+        float firstDistance = BoxDistanceSquared(first, position);
+        float secondDistance = BoxDistanceSquared(second, position);
+        if (secondDistance < firstDistance) {
+            std::swap(first, second);
+            std::swap(firstDistance, secondDistance);
+        }
+        if (found < k || firstDistance < neighbors[k - 1].distanceSquared) SearchNearest(first, level + 1, position, k, neighbors, positions, found);
+        if (found < k || secondDistance < neighbors[k - 1].distanceSquared) SearchNearest(second, level + 1, position, k, neighbors, positions, found);
+    }
+
+    bool KdTree::FindClosest(const glm::vec3& position, KdNeighbor& nearest) const {
+        if (entries.empty()) return false;
+        nearest.distanceSquared = FLT_MAX;
+        SearchClosest(0, 0, position, nearest);
+        return nearest.distanceSquared < FLT_MAX;
+    }
+
+    void KdTree::SearchClosest(size_t node, uint32_t level, const glm::vec3& position, KdNeighbor& nearest) const {
+        if (level < depth) {
+            size_t first = 2 * node + 1;
+            size_t second = 2 * node + 2;
+            float firstDistance = BoxDistanceSquared(first, position);
+            float secondDistance = BoxDistanceSquared(second, position);
+            if (secondDistance < firstDistance) {
+                std::swap(first, second);
+                std::swap(firstDistance, secondDistance);
+            }
+            if (firstDistance < nearest.distanceSquared) SearchClosest(first, level + 1, position, nearest);
+            if (secondDistance < nearest.distanceSquared) SearchClosest(second, level + 1, position, nearest);
+            return;
+        }
+
+        size_t begin = 0;
+        size_t end = 0;
+        NodeRange(node, level, begin, end);
+        size_t slot = begin;
+#ifdef KD_TREE_SSE2
+        // FOUR 16-BYTE ENTRIES TRANSPOSED INTO X/Y/Z LANES (THE INDEX LANE IS NEVER USED AS A FLOAT)
+        static_assert(sizeof(Entry) == 4 * sizeof(float), "KD-TREE ENTRIES MUST PACK INTO ONE SSE REGISTER");
+        const __m128 queryX = _mm_set1_ps(position.x);
+        const __m128 queryY = _mm_set1_ps(position.y);
+        const __m128 queryZ = _mm_set1_ps(position.z);
+        for (; slot + 4 <= end; slot += 4) {
+            __m128 row0 = _mm_loadu_ps(reinterpret_cast<const float*>(&entries[slot]));
+            __m128 row1 = _mm_loadu_ps(reinterpret_cast<const float*>(&entries[slot + 1]));
+            __m128 row2 = _mm_loadu_ps(reinterpret_cast<const float*>(&entries[slot + 2]));
+            __m128 row3 = _mm_loadu_ps(reinterpret_cast<const float*>(&entries[slot + 3]));
+            _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+            const __m128 deltaX = _mm_sub_ps(row0, queryX);
+            const __m128 deltaY = _mm_sub_ps(row1, queryY);
+            const __m128 deltaZ = _mm_sub_ps(row2, queryZ);
+            const __m128 distances = _mm_add_ps(_mm_add_ps(_mm_mul_ps(deltaX, deltaX), _mm_mul_ps(deltaY, deltaY)), _mm_mul_ps(deltaZ, deltaZ));
+            if (!_mm_movemask_ps(_mm_cmplt_ps(distances, _mm_set1_ps(nearest.distanceSquared)))) continue;
+
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, distances);
+            for (int lane = 0; lane < 4; ++lane) {
+                if (lanes[lane] < nearest.distanceSquared) nearest = { lanes[lane], entries[slot + lane].index };
+            }
+        }
+#endif
+        for (; slot < end; ++slot) {
+            const glm::vec3 delta = entries[slot].position - position;
+            const float distanceSquared = delta.x * delta.x + delta.y * delta.y + delta.z * delta.z;
+            if (distanceSquared < nearest.distanceSquared) nearest = { distanceSquared, entries[slot].index };
+        }
+    }
+
+    void KdTree::FindInRadius(const glm::vec3& position, float radius, std::vector<KdNeighbor>& neighbors) const {
+        neighbors.clear();
+        if (entries.empty() || radius < 0.0f) return;
+        SearchRadius(0, 0, position, radius * radius, neighbors);
+        std::sort(neighbors.begin(), neighbors.end(), [](const KdNeighbor& a, const KdNeighbor& b) { return a.distanceSquared < b.distanceSquared; });
+    }
+
+    void KdTree::SearchRadius(size_t node, uint32_t level, const glm::vec3& position, float radiusSquared, std::vector<KdNeighbor>& neighbors) const {
+        if (BoxDistanceSquared(node, position) > radiusSquared) return;
+        if (level < depth) {
+            SearchRadius(2 * node + 1, level + 1, position, radiusSquared, neighbors);
+            SearchRadius(2 * node + 2, level + 1, position, radiusSquared, neighbors);
+            return;
+        }
+
+        size_t begin = 0;
+        size_t end = 0;
+        NodeRange(node, level, begin, end);
+        for (size_t slot = begin; slot < end; ++slot) {
+            const glm::vec3 delta = entries[slot].position - position;
+            const float distanceSquared = delta.x * delta.x + delta.y * delta.y + delta.z * delta.z;
+            if (distanceSquared <= radiusSquared) neighbors.push_back({ distanceSquared, entries[slot].index });
+        }
+    }
+
+    void KdTree::FindInSlab(const glm::vec2& start, const glm::vec2& end, float halfWidth, std::vector<uint64_t>& indices) const {
+        indices.clear();
+        if (entries.empty() || halfWidth < 0.0f) return;
+
+        // DEGENERATE SEGMENTS CUT ALONG X
+        Slab slab;
+        const float deltaX = end.x - start.x;
+        const float deltaY = end.y - start.y;
+        const float length = std::sqrt(deltaX * deltaX + deltaY * deltaY);
+        slab.centerX = 0.5f * (start.x + end.x);
+        slab.centerY = 0.5f * (start.y + end.y);
+        slab.axisX = length > 0.0f ? deltaX / length : 1.0f;
+        slab.axisY = length > 0.0f ? deltaY / length : 0.0f;
+        slab.normalX = -slab.axisY;
+        slab.normalY = slab.axisX;
+        slab.halfLength = 0.5f * length;
+        slab.halfWidth = halfWidth;
+
+        // ONE RESULT LIST PER SUBTREE, CONCATENATED AFTERWARDS
+        const uint32_t taskLevel = std::min(depth, SlabTaskLevel);
+        const size_t firstNode = (size_t(1) << taskLevel) - 1;
+        const size_t taskCount = size_t(1) << taskLevel;
+        std::vector<std::vector<uint64_t>> taskIndices(taskCount);
+        Parallel::For(taskCount, [&](size_t begin, size_t end, unsigned) {
+            for (size_t task = begin; task < end; ++task) SearchSlab(firstNode + task, taskLevel, slab, taskIndices[task]);
+        }, Parallel::ThreadCount());
+
+        size_t total = 0;
+        for (const std::vector<uint64_t>& task : taskIndices) total += task.size();
+        indices.reserve(total);
+        for (const std::vector<uint64_t>& task : taskIndices) indices.insert(indices.end(), task.begin(), task.end());
+    }
+
+    void KdTree::SearchSlab(size_t node, uint32_t level, const Slab& slab, std::vector<uint64_t>& indices) const {
+        const glm::vec3& minimum = nodeMinimums[node];
+        const glm::vec3& maximum = nodeMaximums[node];
+        if (minimum.x > maximum.x) return;
+
+        // SEPARATING AXES: THE SLAB AXIS, ITS NORMAL, THEN X AND Y
+        const float halfX = 0.5f * (maximum.x - minimum.x);
+        const float halfY = 0.5f * (maximum.y - minimum.y);
+        const float offsetX = 0.5f * (minimum.x + maximum.x) - slab.centerX;
+        const float offsetY = 0.5f * (minimum.y + maximum.y) - slab.centerY;
+        const float along = std::fabs(offsetX * slab.axisX + offsetY * slab.axisY);
+        const float across = std::fabs(offsetX * slab.normalX + offsetY * slab.normalY);
+        const float radiusAlong = halfX * std::fabs(slab.axisX) + halfY * std::fabs(slab.axisY);
+        const float radiusAcross = halfX * std::fabs(slab.normalX) + halfY * std::fabs(slab.normalY);
+        if (along - radiusAlong > slab.halfLength || across - radiusAcross > slab.halfWidth) return;
+        if (std::fabs(offsetX) > halfX + slab.halfLength * std::fabs(slab.axisX) + slab.halfWidth * std::fabs(slab.normalX)) return;
+        if (std::fabs(offsetY) > halfY + slab.halfLength * std::fabs(slab.axisY) + slab.halfWidth * std::fabs(slab.normalY)) return;
+
+        // FULLY INSIDE: EVERY ENTRY BELOW THE NODE
+        size_t begin = 0;
+        size_t end = 0;
+        if (along + radiusAlong <= slab.halfLength && across + radiusAcross <= slab.halfWidth) {
+            NodeRange(node, level, begin, end);
+            for (size_t slot = begin; slot < end; ++slot) indices.push_back(entries[slot].index);
+            return;
+        }
+
+        if (level < depth) {
+            SearchSlab(2 * node + 1, level + 1, slab, indices);
+            SearchSlab(2 * node + 2, level + 1, slab, indices);
+            return;
+        }
+
+        NodeRange(node, level, begin, end);
+        for (size_t slot = begin; slot < end; ++slot) {
+            const float pointX = entries[slot].position.x - slab.centerX;
+            const float pointY = entries[slot].position.y - slab.centerY;
+            if (std::fabs(pointX * slab.axisX + pointY * slab.axisY) > slab.halfLength) continue;
+            if (std::fabs(pointX * slab.normalX + pointY * slab.normalY) > slab.halfWidth) continue;
+            indices.push_back(entries[slot].index);
+        }
+    }
+
+    bool KdTree::Raycast(const glm::vec3& origin, const glm::vec3& direction, float pointRadius, KdRayHit& hit) const {
+        if (entries.empty()) return false;
+
+        // AXIS-PARALLEL RAYS GET AN INFINITE INVERSE, THE SLAB TEST STILL HOLDS
+        const glm::vec3 inverseDirection(
+            direction.x != 0.0f ? 1.0f / direction.x : FLT_MAX,
+            direction.y != 0.0f ? 1.0f / direction.y : FLT_MAX,
+            direction.z != 0.0f ? 1.0f / direction.z : FLT_MAX
+        );
+        hit.distance = FLT_MAX;
+        bool found = false;
+        SearchRay(0, 0, origin, inverseDirection, direction, pointRadius, hit, found);
+        return found;
+    }
+
+    void KdTree::SearchRay(size_t node, uint32_t level, const glm::vec3& origin, const glm::vec3& inverseDirection, const glm::vec3& direction,
+        float pointRadius, KdRayHit& hit, bool& found) const {
+        // SLAB TEST AGAINST THE BOX GROWN BY THE POINT RADIUS, SKIPPED WHEN IT STARTS BEHIND THE CURRENT HIT
+        if (nodeMinimums[node].x > nodeMaximums[node].x) return;
+        float entry = 0.0f;
+        float exit = hit.distance;
+        for (int axis = 0; axis < 3; ++axis) {
+            float nearPlane = (nodeMinimums[node][axis] - pointRadius - origin[axis]) * inverseDirection[axis];
+            float farPlane = (nodeMaximums[node][axis] + pointRadius - origin[axis]) * inverseDirection[axis];
+            if (nearPlane > farPlane) std::swap(nearPlane, farPlane);
+            entry = std::max(entry, nearPlane);
+            exit = std::min(exit, farPlane);
+            if (entry > exit) return;
+        }
+
+        if (level < depth) {
+            // FRONT CHILD FIRST SO THE BACK ONE IS USUALLY CULLED BY THE HIT DISTANCE
+            const bool leftFirst = direction[splitAxes[node]] >= 0.0f;
+            SearchRay(leftFirst ? 2 * node + 1 : 2 * node + 2, level + 1, origin, inverseDirection, direction, pointRadius, hit, found);
+            SearchRay(leftFirst ? 2 * node + 2 : 2 * node + 1, level + 1, origin, inverseDirection, direction, pointRadius, hit, found);
+            return;
+        }
+
+        // RAY / SPHERE: ENTRY DISTANCE = PROJECTION - HALF CHORD
+        const float radiusSquared = pointRadius * pointRadius;
+        size_t begin = 0;
+        size_t end = 0;
+        NodeRange(node, level, begin, end);
+        for (size_t slot = begin; slot < end; ++slot) {
+            const glm::vec3 toPoint = entries[slot].position - origin;
+            const float along = glm::dot(toPoint, direction);
+            const float perpendicularSquared = glm::dot(toPoint, toPoint) - along * along;
+            if (perpendicularSquared > radiusSquared) continue;
+
+            const float distance = along - std::sqrt(radiusSquared - perpendicularSquared);
+            if (distance < 0.0f || distance >= hit.distance) continue;
+            hit = { distance, entries[slot].index };
+            found = true;
+        }
+    }
+
+}
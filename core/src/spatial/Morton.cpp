@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SPATIAL_BMI2_TARGET
+#else
+#define SPATIAL_BMI2_TARGET __attribute__((target("bmi2")))
+#endif
+#define SPATIAL_BMI2 1
+#endif
+
+#include <glm/glm.hpp>
+
+#include <Morton.hpp>
+
+namespace Spatial {
+
+    namespace {
+
+        template <typename Encoder>
+        inline void EncodeKeys(const glm::vec3* positions, size_t stride, size_t count, const MortonGrid& grid, uint64_t* keys, Encoder encode) {
+            const unsigned char* input = reinterpret_cast<const unsigned char*>(positions);
+            for (size_t i = 0; i < count; ++i) {
+                glm::uvec3 cell = grid.Cell(*reinterpret_cast<const glm::vec3*>(input + i * stride));
+                keys[i] = encode(cell.x, cell.y, cell.z);
+            }
+        }
+
+#ifdef SPATIAL_BMI2
+        SPATIAL_BMI2_TARGET
+        void ComputeKeysBmi2(const glm::vec3* positions, size_t stride, size_t count, const MortonGrid& grid, uint64_t* keys) {
+            const unsigned char* input = reinterpret_cast<const unsigned char*>(positions);
+            for (size_t i = 0; i < count; ++i) {
+                glm::uvec3 cell = grid.Cell(*reinterpret_cast<const glm::vec3*>(input + i * stride));
+                keys[i] = _pdep_u64(cell.x, 0x1249249249249249ull)
+                    | _pdep_u64(cell.y, 0x2492492492492492ull)
+                    | _pdep_u64(cell.z, 0x4924924924924924ull);
+            }
+        }
+
+        bool DetectBmi2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+            int info[4] = { 0, 0, 0, 0 };
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 8)) != 0;
+#else
+            return __builtin_cpu_supports("bmi2");
+#endif
+        }
+#endif
+
+    }
+
+    MortonGrid MortonGrid::FromBounds(const glm::vec3& minimum, const glm::vec3& maximum) {
+        MortonGrid grid;
+        grid.origin = minimum;
+
+        // UNIFORM SCALE KEEPS CELLS CUBIC SO THE CURVE DOES NOT STRETCH ALONG ONE AXIS
+        glm::vec3 extent = maximum - minimum;
+        float largest = std::max({ extent.x, extent.y, extent.z });
+        grid.scale = largest > 0.0f ? float(MortonAxisMax) / largest : 1.0f;
+        return grid;
+    }
+
+    bool HasBmi2() {
+#ifdef SPATIAL_BMI2
+        static const bool supported = DetectBmi2();
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+    void ComputeMortonKeys(const glm::vec3* positions, size_t stride, size_t count, const MortonGrid& grid, uint64_t* keys) {
+#ifdef SPATIAL_BMI2
+        if (HasBmi2()) {
+            ComputeKeysBmi2(positions, stride, count, grid, keys);
+            return;
+        }
+#endif
+        EncodeKeys(positions, stride, count, grid, keys, MortonEncode);
+    }
+
+}
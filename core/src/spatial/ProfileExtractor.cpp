@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+
+#include <CubeInstance.hpp>
+#include <KdTree.hpp>
+#include <Morton.hpp>
+#include <Parallel.hpp>
+#include <PointStore.hpp>
+#include <ProfileExtractor.hpp>
+#include <RadixSort.hpp>
+
+namespace Spatial {
+
+    void ProfileExtractor::Clear() {
+        points.clear();
+        cells.clear();
+        length = 0.0f;
+        rasterValid = false;
+    }
+
+    size_t ProfileExtractor::Extract(const KdTree& index, const Data::PointStore& pointStore, const glm::vec2& start, const glm::vec2& end, float width) {
+        Clear();
+        if (index.Empty() || index.Size() != pointStore.Size()) return 0;
+        uint64_t startTime = SDL_GetTicksNS();
+
+        const unsigned threads = Parallel::ThreadCount();
+        const float deltaX = end.x - start.x;
+        const float deltaY = end.y - start.y;
+        length = std::sqrt(deltaX * deltaX + deltaY * deltaY);
+        index.FindInSlab(start, end, 0.5f * width, hitIndices);
+        const size_t hitCount = hitIndices.size();
+        if (hitCount == 0) return 0;
+
+        // STORE ORDER, SO EVERY (COMPRESSED) BLOCK IS DECODED ONCE PER THREAD THAT TOUCHES IT
+        hitSlots.resize(hitCount);
+        RadixSort(hitIndices, hitSlots, sortScratch, HighestBit(pointStore.Size()) + 1, threads);
+
+        const float axisX = length > 0.0f ? deltaX / length : 1.0f;
+        const float axisY = length > 0.0f ? deltaY / length : 0.0f;
+        points.resize(hitCount);
+        Parallel::For(hitCount, [&](size_t begin, size_t end, unsigned) {
+            size_t currentBlock = SIZE_MAX;
+            const CubeInstance* blockPoints = nullptr;
+            for (size_t i = begin; i < end; ++i) {
+                const uint64_t pointIndex = hitIndices[i];
+                const size_t blockIndex = size_t(pointIndex / Data::PointStore::BlockSize);
+                if (blockIndex != currentBlock) {
+                    uint32_t count = 0;
+                    blockPoints = pointStore.GetBlock(blockIndex, count);
+                    currentBlock = blockIndex;
+                }
+                const CubeInstance& point = blockPoints[pointIndex % Data::PointStore::BlockSize];
+                const float along = (point.position.x - start.x) * axisX + (point.position.y - start.y) * axisY;
+                points[i] = { std::clamp(along, 0.0f, length), point.position.z, point.intensity };
+            }
+        }, threads);
+
+        minHeight = FLT_MAX;
+        maxHeight = -FLT_MAX;
+        minIntensity = UINT16_MAX;
+        maxIntensity = 0;
+        for (const ProfilePoint& point : points) {
+            minHeight = std::min(minHeight, point.height);
+            maxHeight = std::max(maxHeight, point.height);
+            minIntensity = std::min(minIntensity, point.intensity);
+            maxIntensity = std::max(maxIntensity, point.intensity);
+        }
+
+        extractMilliseconds = (SDL_GetTicksNS() - startTime) / 1.0e6;
+        return hitCount;
+    }
+
+    void ProfileExtractor::Rasterize(uint32_t columnCount, uint32_t rowCount) {
+        if (columnCount == 0 || rowCount == 0 || points.empty()) return;
+        if (rasterValid && columnCount == columns && rowCount == rows) return;
+        columns = columnCount;
+        rows = rowCount;
+
+        // PER-THREAD COUNTS AND INTENSITY SUMS, MERGED CELL BY CELL
+        const unsigned threads = std::max(1u, std::min<unsigned>(Parallel::ThreadCount(), static_cast<unsigned>(points.size() / 65536 + 1)));
+        const size_t cellCount = size_t(columns) * rows;
+        threadCounts.assign(cellCount * threads, 0);
+        threadSums.assign(cellCount * threads, 0.0f);
+
+        const float columnScale = length > 0.0f ? float(columns) / length : 0.0f;
+        const float heightRange = maxHeight - minHeight;
+        const float rowScale = heightRange > 0.0f ? float(rows) / heightRange : 0.0f;
+        Parallel::For(points.size(), [&](size_t begin, size_t end, unsigned thread) {
+            uint32_t* counts = threadCounts.data() + cellCount * thread;
+            float* sums = threadSums.data() + cellCount * thread;
+            for (size_t i = begin; i < end; ++i) {
+                const uint32_t column = std::min(columns - 1, static_cast<uint32_t>(points[i].along * columnScale));
+                const uint32_t fromBottom = std::min(rows - 1, static_cast<uint32_t>((points[i].height - minHeight) * rowScale));
+                const size_t cell = size_t(rows - 1 - fromBottom) * columns + column;
+                counts[cell]++;
+                sums[cell] += float(points[i].intensity);
+            }
+        }, threads);
+
+        cells.assign(cellCount, ProfileCell());
+        for (size_t cell = 0; cell < cellCount; ++cell) {
+            uint32_t count = 0;
+            float sum = 0.0f;
+            for (unsigned thread = 0; thread < threads; ++thread) {
+                count += threadCounts[cellCount * thread + cell];
+                sum += threadSums[cellCount * thread + cell];
+            }
+            cells[cell].count = count;
+            cells[cell].meanIntensity = count > 0 ? sum / float(count) : 0.0f;
+        }
+        rasterValid = true;
+    }
+
+}
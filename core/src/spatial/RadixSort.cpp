@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+#include <Parallel.hpp>
+#include <RadixSort.hpp>
+
+namespace Spatial {
+
+    namespace {
+
+        constexpr uint32_t DigitBits = 8;
+        constexpr uint32_t DigitCount = 1u << DigitBits;
+        constexpr uint32_t MaxPasses = 64 / DigitBits;
+
+        // BELOW THIS MANY KEYS PER THREAD THE THREAD START-UP COSTS MORE THAN IT SAVES
+        constexpr size_t MinKeysPerThread = 1 << 16;
+
+        using Histogram = std::array<size_t, DigitCount>;
+
+        inline uint32_t Digit(uint64_t key, uint32_t pass) {
+            return static_cast<uint32_t>(key >> (pass * DigitBits)) & (DigitCount - 1);
+        }
+
+    }
+
+    void RadixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values, SortScratch& scratch, uint32_t keyBits, unsigned threadCount) {
+        const size_t count = keys.size();
+        if (values.size() != count) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "RADIX SORT: KEY COUNT (%zu) DOES NOT MATCH VALUE COUNT (%zu)", count, values.size());
+            return;
+        }
+        if (count < 2) return;
+
+        const uint32_t passCount = std::min<uint32_t>((std::min<uint32_t>(keyBits, 64) + DigitBits - 1) / DigitBits, MaxPasses);
+        if (threadCount == 0) threadCount = Parallel::ThreadCount();
+        threadCount = static_cast<unsigned>(std::clamp<size_t>((count + MinKeysPerThread - 1) / MinKeysPerThread, 1, threadCount));
+
+        scratch.keys.resize(count);
+        scratch.values.resize(count);
+
+        // ONE READ BUILDS THE HISTOGRAM OF EVERY PASS FOR EVERY THREAD RANGE
+        std::vector<Histogram> histograms(size_t(threadCount) * passCount);
+        for (Histogram& histogram : histograms) histogram.fill(0);
+        Parallel::For(count, [&](size_t begin, size_t end, unsigned thread) {
+            Histogram* threadHistograms = histograms.data() + size_t(thread) * passCount;
+            for (size_t i = begin; i < end; ++i) {
+                const uint64_t key = keys[i];
+                for (uint32_t pass = 0; pass < passCount; ++pass) {
+                    threadHistograms[pass][Digit(key, pass)]++;
+                }
+            }
+        }, threadCount);
+
+        // SKIP PASSES WHERE ONE DIGIT HOLDS EVERY KEY (HIGH BITS OF SMALL EXTENTS)
+        std::vector<uint32_t> activePasses;
+        for (uint32_t pass = 0; pass < passCount; ++pass) {
+            bool uniform = false;
+            for (uint32_t digit = 0; digit < DigitCount && !uniform; ++digit) {
+                size_t total = 0;
+                for (unsigned thread = 0; thread < threadCount; ++thread) {
+                    total += histograms[size_t(thread) * passCount + pass][digit];
+                }
+                uniform = total == count;
+            }
+            if (!uniform) activePasses.push_back(pass);
+        }
+
+        uint64_t* sourceKeys = keys.data();
+        uint32_t* sourceValues = values.data();
+        uint64_t* targetKeys = scratch.keys.data();
+        uint32_t* targetValues = scratch.values.data();
+
+        std::vector<Histogram> offsets(threadCount);
+        for (size_t activeIndex = 0; activeIndex < activePasses.size(); ++activeIndex) {
+            const uint32_t pass = activePasses[activeIndex];
+
+            // THREAD RANGES ONLY MATCH THE INITIAL HISTOGRAMS BEFORE THE FIRST SCATTER
+            if (activeIndex > 0) {
+                Parallel::For(count, [&](size_t begin, size_t end, unsigned thread) {
+                    Histogram& histogram = histograms[size_t(thread) * passCount + pass];
+                    histogram.fill(0);
+                    for (size_t i = begin; i < end; ++i) histogram[Digit(sourceKeys[i], pass)]++;
+                }, threadCount);
+            }
+
+            // DIGIT-MAJOR, THREAD-MINOR PREFIX SUM KEEPS THE SORT STABLE
+            size_t running = 0;
+            for (uint32_t digit = 0; digit < DigitCount; ++digit) {
+                for (unsigned thread = 0; thread < threadCount; ++thread) {
+                    offsets[thread][digit] = running;
+                    running += histograms[size_t(thread) * passCount + pass][digit];
+                }
+            }
+
+            Parallel::For(count, [&](size_t begin, size_t end, unsigned thread) {
+                Histogram& offset = offsets[thread];
+                for (size_t i = begin; i < end; ++i) {
+                    const uint64_t key = sourceKeys[i];
+                    const size_t target = offset[Digit(key, pass)]++;
+                    targetKeys[target] = key;
+                    targetValues[target] = sourceValues[i];
+                }
+            }, threadCount);
+
+            std::swap(sourceKeys, targetKeys);
+            std::swap(sourceValues, targetValues);
+        }
+
+        // ODD NUMBER OF PASSES: THE RESULT IS IN THE SCRATCH BUFFERS
+        if (sourceKeys != keys.data()) {
+            std::swap(keys, scratch.keys);
+            std::swap(values, scratch.values);
+        }
+    }
+
+    void SortedOrder(std::vector<uint64_t>& keys, std::vector<uint32_t>& order, SortScratch& scratch, uint32_t keyBits, unsigned threadCount) {
+        order.resize(keys.size());
+        std::iota(order.begin(), order.end(), 0u);
+        RadixSort(keys, order, scratch, keyBits, threadCount);
+    }
+
+}
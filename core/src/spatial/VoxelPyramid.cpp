@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+
+#include <CubeInstance.hpp>
+#include <MemoryPool.hpp>
+#include <Morton.hpp>
+#include <Parallel.hpp>
+#include <PointStore.hpp>
+#include <RadixSort.hpp>
+#include <VoxelPyramid.hpp>
+
+namespace Spatial {
+
+    void VoxelPyramid::Clear() {
+        cellSize = 0.0f;
+        finestLevel = 0;
+        levelCounts.clear();
+        nodeMinimum.clear();
+        nodeMaximum.clear();
+        nodeRanges.clear();
+        nodeLevelCounts.clear();
+    }
+
+    void VoxelPyramid::Build(const Data::PointStore& pointStore, float baseSize, uint32_t levelCount, uint64_t maxOutput,
+        std::vector<CubeInstance>& output, Data::AllocationStats& loadStats) {
+        Clear();
+        output.clear();
+
+        const uint64_t pointCount = pointStore.Size();
+        if (pointCount == 0 || levelCount == 0 || baseSize <= 0.0f) return;
+        if (pointCount > UINT32_MAX) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "VOXEL PYRAMID SUPPORTS AT MOST %u POINTS", UINT32_MAX);
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+
+        levelCount = std::min(levelCount, MaxLevels);
+        const unsigned threads = Parallel::ThreadCount();
+        const size_t blockCount = pointStore.BlockCount();
+
+        // BOUNDS (PER-THREAD REDUCTION OVER WHOLE BLOCKS)
+        std::vector<glm::vec3> minimums(threads, glm::vec3(FLT_MAX));
+        std::vector<glm::vec3> maximums(threads, glm::vec3(-FLT_MAX));
+        Parallel::For(blockCount, [&](size_t begin, size_t end, unsigned thread) {
+            for (size_t blockIndex = begin; blockIndex < end; ++blockIndex) {
+                uint32_t count = 0;
+                const CubeInstance* points = pointStore.GetBlock(blockIndex, count);
+                for (uint32_t i = 0; i < count; ++i) {
+                    minimums[thread] = glm::min(minimums[thread], points[i].position);
+                    maximums[thread] = glm::max(maximums[thread], points[i].position);
+                }
+            }
+        }, threads);
+        glm::vec3 minimum = minimums[0];
+        glm::vec3 maximum = maximums[0];
+        for (unsigned thread = 1; thread < threads; ++thread) {
+            minimum = glm::min(minimum, minimums[thread]);
+            maximum = glm::max(maximum, maximums[thread]);
+        }
+
+        // THE FINEST LEVEL MUST FIT THE 21-BIT MORTON AXES, ONLY VERY LARGE EXTENTS DOUBLE IT
+        const glm::vec3 extent = maximum - minimum;
+        const float largestExtent = std::max(extent.x, std::max(extent.y, extent.z));
+        cellSize = baseSize;
+        while (largestExtent / cellSize >= float(MortonAxisMax)) cellSize *= 2.0f;
+        if (cellSize != baseSize) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "VOXEL PYRAMID: BASE CELL GROWN FROM %.3f TO %.3f TO FIT THE EXTENT", baseSize, cellSize);
+        }
+
+        // MORTON KEYS ON THE FINEST GRID, LEVEL (L) IS THE KEY SHIFTED RIGHT BY (3 * L)
+        MortonGrid grid;
+        grid.origin = minimum;
+        grid.scale = 1.0f / cellSize;
+        Data::AcquireBuffer(mortonKeys, pointCount, loadStats);
+        Parallel::For(blockCount, [&](size_t begin, size_t end, unsigned) {
+            for (size_t blockIndex = begin; blockIndex < end; ++blockIndex) {
+                uint32_t count = 0;
+                const CubeInstance* points = pointStore.GetBlock(blockIndex, count);
+                const uint64_t firstIndex = uint64_t(blockIndex) * Data::PointStore::BlockSize;
+                ComputeMortonKeys(&points[0].position, sizeof(CubeInstance), count, grid, mortonKeys.data() + firstIndex);
+            }
+        }, threads);
+
+        Data::AcquireBuffer(sortedOrder, pointCount, loadStats);
+        Data::AcquireBuffer(sortScratch.keys, pointCount, loadStats);
+        Data::AcquireBuffer(sortScratch.values, pointCount, loadStats);
+        SortedOrder(mortonKeys, sortedOrder, sortScratch, MortonKeyBits, threads);
+
+        // RANK: COARSEST LEVEL WHERE A POINT OPENS A NEW CELL (-1 WHEN IT SHARES A FINEST CELL WITH ITS PREDECESSOR)
+        // A POINT THAT OPENS A CELL AT LEVEL (L) OPENS ONE AT EVERY FINER LEVEL, SO LEVEL (L) IS EVERY POINT OF RANK >= L
+        const int coarsestLevel = int(levelCount) - 1;
+        auto rankOf = [&](size_t sortedIndex) -> int {
+            if (sortedIndex == 0) return coarsestLevel;
+            const uint64_t difference = mortonKeys[sortedIndex] ^ mortonKeys[sortedIndex - 1];
+            if (difference == 0) return -1;
+            return std::min(int(HighestBit(difference) / 3), coarsestLevel);
+        };
+
+        // PER-THREAD RANK HISTOGRAMS (BUCKET = RANK + 1)
+        const size_t bucketCount = MaxLevels + 1;
+        std::vector<uint64_t> rankCounts(size_t(threads) * bucketCount, 0);
+        Parallel::For(pointCount, [&](size_t begin, size_t end, unsigned thread) {
+            uint64_t* counts = rankCounts.data() + size_t(thread) * bucketCount;
+            for (size_t i = begin; i < end; ++i) counts[rankOf(i) + 1]++;
+        }, threads);
+
+        levelCounts.assign(levelCount, 0);
+        for (int level = coarsestLevel; level >= 0; --level) {
+            uint64_t total = level < coarsestLevel ? levelCounts[level + 1] : 0;
+            for (unsigned thread = 0; thread < threads; ++thread) total += rankCounts[size_t(thread) * bucketCount + level + 1];
+            levelCounts[level] = total;
+        }
+
+        // FINEST LEVEL THAT FITS THE OUTPUT LIMIT (THE COARSEST ONE IS ALWAYS KEPT)
+        const uint64_t limit = maxOutput > 0 ? maxOutput : pointCount;
+        finestLevel = uint32_t(coarsestLevel);
+        while (finestLevel > 0 && levelCounts[finestLevel - 1] <= limit) --finestLevel;
+        const uint64_t outputCount = levelCounts[finestLevel];
+
+        // RANK-DESCENDING, THREAD-MINOR OFFSETS KEEP MORTON ORDER WITHIN EACH RANK
+        std::vector<uint64_t> offsets(rankCounts.size(), 0);
+        uint64_t running = 0;
+        for (int rank = coarsestLevel; rank >= int(finestLevel); --rank) {
+            for (unsigned thread = 0; thread < threads; ++thread) {
+                offsets[size_t(thread) * bucketCount + rank + 1] = running;
+                running += rankCounts[size_t(thread) * bucketCount + rank + 1];
+            }
+        }
+
+        // DESTINATION OF EVERY STORE INDEX (THE SORT SCRATCH IS FREE AGAIN)
+        std::vector<uint32_t>& destinations = sortScratch.values;
+        Parallel::For(pointCount, [&](size_t begin, size_t end, unsigned thread) {
+            uint64_t* offset = offsets.data() + size_t(thread) * bucketCount;
+            for (size_t i = begin; i < end; ++i) {
+                const int rank = rankOf(i);
+                destinations[sortedOrder[i]] = rank >= int(finestLevel) ? static_cast<uint32_t>(offset[rank + 1]++) : UINT32_MAX;
+            }
+        }, threads);
+
+        // GATHER IN STORE ORDER (SEQUENTIAL BLOCK READS, SCATTERED WRITES)
+        Data::AcquireBuffer(output, outputCount, loadStats);
+        Parallel::For(blockCount, [&](size_t begin, size_t end, unsigned) {
+            for (size_t blockIndex = begin; blockIndex < end; ++blockIndex) {
+                uint32_t count = 0;
+                const CubeInstance* points = pointStore.GetBlock(blockIndex, count);
+                const uint64_t firstIndex = uint64_t(blockIndex) * Data::PointStore::BlockSize;
+                for (uint32_t i = 0; i < count; ++i) {
+                    const uint32_t destination = destinations[firstIndex + i];
+                    if (destination != UINT32_MAX) output[destination] = points[i];
+                }
+            }
+        }, threads);
+
+        BuildNodes(output, coarsestLevel, loadStats);
+
+        auto end = std::chrono::steady_clock::now();
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+            "VOXEL PYRAMID: %u LEVELS (%.3f - %.3f), %llu POINTS BUFFERED FROM LEVEL %u IN %.4f SECONDS",
+            levelCount, LevelSize(0), LevelSize(coarsestLevel), static_cast<unsigned long long>(outputCount), finestLevel,
+            std::chrono::duration<double>(end - start).count());
+        for (uint32_t level = 0; level < levelCount; ++level) {
+            SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "  LEVEL %u: VOXEL SIZE %.3f, %llu POINTS%s", level, LevelSize(level),
+                static_cast<unsigned long long>(levelCounts[level]), level < finestLevel ? " (OVER BUDGET)" : "");
+        }
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "  LOD NODES: %zu", NodeCount());
+    }
+
+    void VoxelPyramid::BuildNodes(const std::vector<CubeInstance>& output, int coarsestLevel, Data::AllocationStats& loadStats) {
+        // THE SORTED KEYS ARE STILL IN (mortonKeys), A NEW CELL OF LEVEL (L) STARTS WHERE THE HIGHEST DIFFERING DIGIT IS >= L
+        const size_t pointCount = sortedOrder.size();
+        uint64_t digitCounts[MortonAxisBits + 1] = {};
+        for (size_t i = 1; i < pointCount; ++i) {
+            const uint64_t difference = mortonKeys[i] ^ mortonKeys[i - 1];
+            if (difference != 0) digitCounts[HighestBit(difference) / 3]++;
+        }
+
+        // COARSEN THE NODE CELLS UNTIL THEY FIT (MaxNodes), NEVER FINER THAN THE COARSEST LEVEL
+        uint32_t nodeLevel = uint32_t(coarsestLevel);
+        uint64_t nodeCount = 0;
+        for (;; ++nodeLevel) {
+            nodeCount = 1;
+            for (uint32_t digit = nodeLevel; digit <= MortonAxisBits; ++digit) nodeCount += digitCounts[digit];
+            if (nodeCount <= MaxNodes || nodeLevel >= MortonAxisBits) break;
+        }
+
+        // THE FIRST POINT OF EVERY CELL IS BUFFERED (ITS RANK IS THE COARSEST LEVEL), SO EVERY NODE HAS A POINT
+        // WALK THE SORTED POINTS ONCE, BUFFER POSITIONS GROW MONOTONICALLY WITHIN A RANK SO EACH (NODE, RANK) IS ONE RANGE
+        const size_t levelCount = levelCounts.size();
+        Data::AcquireBuffer(nodeRanges, size_t(nodeCount) * levelCount, loadStats);
+        std::fill(nodeRanges.begin(), nodeRanges.end(), NodeRange());
+        const std::vector<uint32_t>& destinations = sortScratch.values;
+        size_t node = 0;
+        for (size_t i = 0; i < pointCount; ++i) {
+            if (i > 0) {
+                const uint64_t difference = mortonKeys[i] ^ mortonKeys[i - 1];
+                if (difference != 0 && HighestBit(difference) / 3 >= nodeLevel) ++node;
+            }
+            const uint32_t destination = destinations[sortedOrder[i]];
+            if (destination == UINT32_MAX) continue;
+
+            // RANK FROM THE BUFFER POSITION (LEVEL PREFIXES ARE NESTED)
+            uint32_t rank = finestLevel;
+            while (rank + 1 < levelCount && destination < levelCounts[rank + 1]) ++rank;
+            NodeRange& range = nodeRanges[node * levelCount + rank];
+            if (range.count == 0) range.first = destination;
+            range.count++;
+        }
+
+        // BOUNDS OF THE BUFFERED POINTS AND CUMULATIVE COUNTS (LEVEL L DRAWS EVERY RANK >= L)
+        Data::AcquireBuffer(nodeMinimum, size_t(nodeCount), loadStats);
+        Data::AcquireBuffer(nodeMaximum, size_t(nodeCount), loadStats);
+        Data::AcquireBuffer(nodeLevelCounts, size_t(nodeCount) * levelCount, loadStats);
+        Parallel::For(size_t(nodeCount), [&](size_t begin, size_t end, unsigned) {
+            for (size_t index = begin; index < end; ++index) {
+                glm::vec3 minimum(FLT_MAX);
+                glm::vec3 maximum(-FLT_MAX);
+                uint64_t running = 0;
+                for (size_t rank = levelCount; rank-- > 0;) {
+                    const NodeRange& range = nodeRanges[index * levelCount + rank];
+                    for (uint32_t offset = 0; offset < range.count; ++offset) {
+                        minimum = glm::min(minimum, output[range.first + offset].position);
+                        maximum = glm::max(maximum, output[range.first + offset].position);
+                    }
+                    running += range.count;
+                    nodeLevelCounts[index * levelCount + rank] = running;
+                }
+                nodeMinimum[index] = minimum;
+                nodeMaximum[index] = maximum;
+            }
+        });
+    }
+
+}
@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+
+#include <CubeInstance.hpp>
+#include <MemoryPool.hpp>
+#include <Morton.hpp>
+#include <Parallel.hpp>
+#include <PointStore.hpp>
+#include <RadixSort.hpp>
+#include <VoxelSizeSolver.hpp>
+
+namespace Spatial {
+
+    namespace {
+
+        // DISTINCT KEYS AND THE RUNS SEEN ONCE/TWICE (INPUTS OF THE CHAO1 ESTIMATOR)
+        struct RunCounts {
+            uint64_t distinct = 0;
+            uint64_t singletons = 0;
+            uint64_t doubletons = 0;
+
+            inline void Close(uint64_t length) {
+                distinct++;
+                if (length == 1) singletons++;
+                else if (length == 2) doubletons++;
+            }
+
+            // BIAS-CORRECTED CHAO1: CELLS SEEN ONCE VS TWICE IN THE SAMPLE ESTIMATE THE ONES NEVER SEEN
+            inline uint64_t Estimate(uint64_t sampleStride, uint64_t pointCount) const {
+                if (sampleStride == 1) return distinct;
+                double unseen = double(singletons) * double(singletons > 0 ? singletons - 1 : 0) / (2.0 * double(doubletons + 1));
+                return std::min<uint64_t>(pointCount, distinct + uint64_t(unseen));
+            }
+        };
+
+        // SPLITMIX64 FINALIZER, SPREADS PACKED CELL KEYS OVER ALL 64 BITS
+        inline uint64_t HashKey(uint64_t key) {
+            key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ull;
+            key = (key ^ (key >> 27)) * 0x94D049BB133111EBull;
+            return key ^ (key >> 31);
+        }
+
+    }
+
+    void VoxelSizeSolver::DrawSample(const Data::PointStore& pointStore, Data::AllocationStats& loadStats) {
+        // EVERY (sampleStride)-TH POINT, THE STORE IS MORTON ORDERED SO THE SAMPLE IS SPATIALLY EVEN
+        const uint64_t sampleCount = (pointCount + sampleStride - 1) / sampleStride;
+        Data::AcquireBuffer(samples, sampleCount, loadStats);
+
+        Parallel::For(pointStore.BlockCount(), [&](size_t begin, size_t end, unsigned) {
+            for (size_t blockIndex = begin; blockIndex < end; ++blockIndex) {
+                const uint64_t firstIndex = uint64_t(blockIndex) * Data::PointStore::BlockSize;
+                const uint64_t firstSample = (firstIndex + sampleStride - 1) / sampleStride;
+                if (firstSample * sampleStride >= firstIndex + Data::PointStore::BlockSize) continue;
+
+                uint32_t count = 0;
+                const CubeInstance* points = pointStore.GetBlock(blockIndex, count);
+                for (uint64_t sample = firstSample; sample * sampleStride < firstIndex + count; ++sample) {
+                    samples[sample] = points[sample * sampleStride - firstIndex].position;
+                }
+            }
+        });
+    }
+
+    uint32_t VoxelSizeSolver::CountMortonLevels(const glm::vec3& minPoint, const glm::vec3& maxPoint, float& cellSize, std::vector<uint64_t>& levelCounts) {
+        const MortonGrid grid = MortonGrid::FromBounds(minPoint, maxPoint);
+        cellSize = 1.0f / grid.scale;
+
+        sampleKeys.resize(samples.size());
+        Parallel::For(samples.size(), [&](size_t begin, size_t end, unsigned) {
+            ComputeMortonKeys(samples.data() + begin, sizeof(glm::vec3), end - begin, grid, sampleKeys.data() + begin);
+        });
+        SortedOrder(sampleKeys, sampleOrder, sortScratch, MortonKeyBits);
+
+        // ONE PASS OVER THE SORTED KEYS CLOSES A RUN AT EVERY LEVEL THE NEIGHBOURS DO NOT SHARE
+        const uint32_t levelCount = MortonAxisBits + 1;
+        std::vector<RunCounts> runs(levelCount);
+        std::vector<uint64_t> runLengths(levelCount, 1);
+        for (size_t i = 1; i < sampleKeys.size(); ++i) {
+            const uint64_t difference = sampleKeys[i] ^ sampleKeys[i - 1];
+            const uint32_t lastSplit = difference == 0 ? 0 : HighestBit(difference) / 3 + 1;
+            for (uint32_t level = 0; level < levelCount; ++level) {
+                if (level < lastSplit) {
+                    runs[level].Close(runLengths[level]);
+                    runLengths[level] = 1;
+                } else {
+                    runLengths[level]++;
+                }
+            }
+        }
+
+        levelCounts.resize(levelCount);
+        uint32_t reliableLevel = levelCount - 1;
+        for (uint32_t level = levelCount; level-- > 0;) {
+            runs[level].Close(runLengths[level]);
+            levelCounts[level] = runs[level].Estimate(sampleStride, pointCount);
+            if (runs[level].distinct * MinSamplesPerCell <= samples.size()) reliableLevel = level;
+        }
+        return reliableLevel;
+    }
+
+    uint64_t VoxelSizeSolver::CountVoxels(const Data::PointStore& pointStore, float voxelSize, const glm::vec3& minPoint, const glm::vec3& maxPoint) {
+        // 21 BITS PER AXIS (THE SOLVER KEEPS THE SIZE ABOVE EXTENT / 2^21)
+        const glm::ivec3 maxCoord = glm::ivec3(glm::max(glm::ceil((maxPoint - minPoint) / voxelSize), glm::vec3(1.0f)));
+        const float inverseSize = 1.0f / voxelSize;
+
+        // ONE HYPERLOGLOG SKETCH PER THREAD, MERGED WITH MAX
+        const unsigned threads = Parallel::ThreadCount();
+        sketches.assign(size_t(threads) * SketchRegisters, 0);
+        Parallel::For(pointStore.BlockCount(), [&](size_t begin, size_t end, unsigned thread) {
+            uint8_t* registers = sketches.data() + size_t(thread) * SketchRegisters;
+            for (size_t blockIndex = begin; blockIndex < end; ++blockIndex) {
+                uint32_t count = 0;
+                const CubeInstance* points = pointStore.GetBlock(blockIndex, count);
+                for (uint32_t i = 0; i < count; ++i) {
+                    // OFFSETS FROM THE MINIMUM ARE NON-NEGATIVE, TRUNCATION IS THE FLOOR OF VoxelFilter::VoxelCoord
+                    glm::ivec3 coord = glm::ivec3((points[i].position - minPoint) * inverseSize + 0.5f);
+                    coord = glm::min(coord, maxCoord);
+                    const uint64_t hash = HashKey(uint64_t(coord.x) | (uint64_t(coord.y) << MortonAxisBits) | (uint64_t(coord.z) << (2 * MortonAxisBits)));
+
+                    // TOP BITS PICK THE REGISTER, THE REST CONTRIBUTE THEIR LEADING ZERO RUN
+                    const uint64_t remainder = hash << SketchBits;
+                    const uint8_t rank = remainder == 0 ? uint8_t(64 - SketchBits + 1) : uint8_t(64 - HighestBit(remainder));
+                    uint8_t& slot = registers[hash >> (64 - SketchBits)];
+                    slot = std::max(slot, rank);
+                }
+            }
+        }, threads);
+
+        double inverseSum = 0.0;
+        uint32_t emptyRegisters = 0;
+        for (uint32_t index = 0; index < SketchRegisters; ++index) {
+            uint8_t value = sketches[index];
+            for (unsigned thread = 1; thread < threads; ++thread) value = std::max(value, sketches[size_t(thread) * SketchRegisters + index]);
+            inverseSum += std::ldexp(1.0, -int(value));
+            if (value == 0) emptyRegisters++;
+        }
+
+        // RAW ESTIMATE, LINEAR COUNTING WHILE MANY REGISTERS ARE STILL EMPTY
+        const double registers = double(SketchRegisters);
+        double estimate = (0.7213 / (1.0 + 1.079 / registers)) * registers * registers / inverseSum;
+        if (estimate <= 2.5 * registers && emptyRegisters > 0) {
+            estimate = registers * std::log(registers / double(emptyRegisters));
+        }
+        return std::min<uint64_t>(pointCount, uint64_t(estimate + 0.5));
+    }
+
+    VoxelSizeSolution VoxelSizeSolver::Solve(const Data::PointStore& pointStore, const glm::vec3& minPoint, const glm::vec3& maxPoint,
+        uint64_t targetCount, float minVoxelSize, Data::AllocationStats& loadStats) {
+        VoxelSizeSolution solution;
+        pointCount = pointStore.Size();
+
+        // COARSEST PACKED KEY THE COUNTING PASS CAN HOLD
+        const glm::vec3 extent = maxPoint - minPoint;
+        const float largestExtent = std::max(extent.x, std::max(extent.y, extent.z));
+        minVoxelSize = std::max(minVoxelSize, largestExtent / float(MortonAxisMax - 1));
+        solution.voxelSize = minVoxelSize;
+
+        // BUDGET COVERS EVERY POINT, ONLY MERGE NEAR-DUPLICATES
+        if (pointCount == 0 || targetCount == 0 || targetCount >= pointCount) {
+            solution.estimatedCount = pointCount;
+            return solution;
+        }
+        auto start = std::chrono::steady_clock::now();
+
+        sampleStride = std::max<uint64_t>(1, pointCount / BracketSamples);
+        DrawSample(pointStore, loadStats);
+        Data::AcquireBuffer(sampleKeys, samples.size(), loadStats);
+        Data::AcquireBuffer(sampleOrder, samples.size(), loadStats);
+        Data::AcquireBuffer(sortScratch.keys, samples.size(), loadStats);
+        Data::AcquireBuffer(sortScratch.values, samples.size(), loadStats);
+
+        // BRACKET: FIRST POWER-OF-TWO LEVEL WITH FEWER OCCUPIED CELLS THAN THE TARGET
+        float cellSize = 0.0f;
+        std::vector<uint64_t> levelCounts;
+        const uint32_t reliableLevel = CountMortonLevels(minPoint, maxPoint, cellSize, levelCounts);
+        uint32_t upper = 0;
+        while (upper + 1 < levelCounts.size() && levelCounts[upper] >= targetCount) ++upper;
+
+        // INITIAL GUESS: OCCUPIED COUNT ~ SIZE^-SLOPE BETWEEN THE BRACKETING LEVELS,
+        // EXTRAPOLATED FROM THE FINEST WELL-SAMPLED PAIR WHEN THE BRACKET ITSELF IS UNDERSAMPLED
+        const uint32_t lower = std::min<uint32_t>(std::max<uint32_t>(upper, reliableLevel + 1), uint32_t(levelCounts.size()) - 1) - 1;
+        const double lowerCount = double(std::max<uint64_t>(levelCounts[lower], 1));
+        const double upperCount = double(std::max<uint64_t>(levelCounts[lower + 1], 1));
+        auto clampSlope = [](double value) { return std::clamp(value, 0.5, 3.5); };
+        double slope = clampSlope(lowerCount > upperCount ? std::log2(lowerCount / upperCount) : 2.0);
+        double size = double(cellSize) * double(1ull << lower);
+        size = std::max(double(minVoxelSize), size * std::pow(lowerCount / double(targetCount), 1.0 / slope));
+        double count = 0.0;
+
+        // SECANT STEPS IN LOG-LOG SPACE ON THE FILTER'S OWN GRID (SLOPE FROM THE LAST TWO COUNTS)
+        double bestError = HUGE_VAL;
+        double previousSize = 0.0;
+        double previousCount = 0.0;
+        for (uint32_t iteration = 0; iteration < MaxIterations; ++iteration) {
+            const uint64_t estimate = CountVoxels(pointStore, float(size), minPoint, maxPoint);
+            const double error = std::fabs(double(estimate) / double(targetCount) - 1.0);
+            solution.iterations = iteration + 1;
+            if (error < bestError) {
+                bestError = error;
+                solution.voxelSize = float(size);
+                solution.estimatedCount = estimate;
+            }
+            if (error <= Tolerance || estimate == 0) break;
+
+            count = double(estimate);
+            if (previousSize > 0.0 && previousCount != count && previousSize != size) {
+                slope = clampSlope(-std::log(count / previousCount) / std::log(size / previousSize));
+            }
+            previousSize = size;
+            previousCount = count;
+
+            const double nextSize = std::max(double(minVoxelSize), size * std::pow(count / double(targetCount), 1.0 / slope));
+            if (nextSize == size) break;
+            size = nextSize;
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+            "VOXEL SIZE SOLVER: TARGET %llu -> SIZE %.4f (~%llu VOXELS, %.1f%% OFF) IN %u PASSES, %.4f SECONDS",
+            static_cast<unsigned long long>(targetCount), solution.voxelSize, static_cast<unsigned long long>(solution.estimatedCount),
+            bestError * 100.0, solution.iterations, std::chrono::duration<double>(end - start).count());
+        return solution;
+    }
+
+}